@@ -0,0 +1,95 @@
+/**
+ * @brief Check of the prediction cache: hits, CLOCK eviction and invalidation after training.
+ */
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "ml/cache/prediction_cache.h"
+#include "ml/dense_layer/dense_layer.h"
+#include "ml/neural_network/single_layer.h"
+
+namespace
+{
+/**
+ * @brief Print the result of a check.
+ * 
+ * @param[in] description Description of the check.
+ * @param[in] passed True if the check passed, false otherwise.
+ * 
+ * @return The result of the check.
+ */
+bool check(const char* description, const bool passed)
+{
+    std::cout << (passed ? "[ok]     " : "[FAILED] ") << description << "\n";
+    return passed;
+}
+} // namespace
+
+/**
+ * @brief Run a sequence of predictions through a small cache and check its statistics after
+ *        each step.
+ * 
+ * @return 0 if all checks passed, -1 otherwise.
+ */
+int main()
+{
+    // Create training data vectors.
+    const std::vector<std::vector<double>> trainInput{{0,0}, {0,1}, {1,0}, {1,1}};
+    const std::vector<std::vector<double>> trainOutput{{0}, {1}, {1}, {0}};
+
+    ml::dense_layer::DenseLayer hiddenLayer{8U, 2U, ml::ActFunc::Tanh, 1U};
+    ml::dense_layer::DenseLayer outputLayer{1U, 8U, ml::ActFunc::Tanh, 2U};
+    ml::neural_network::SingleLayer network{hiddenLayer, outputLayer, trainInput, trainOutput};
+
+    // The cache holds four predictions, inputs within 0.01 of each other share an entry.
+    ml::cache::PredictionCache cache{network, {&hiddenLayer, &outputLayer}, 4U, 0.01};
+    const std::vector<double> a{0.1, 0.2}, b{0.3, 0.4}, c{0.5, 0.6}, d{0.7, 0.8}, e{0.9, 1.0};
+    bool passed{true};
+
+    // Repeated and near-identical inputs are returned from the cache.
+    const auto expected{network.predict(a)};
+    passed &= check("first prediction is computed by the network",
+                    (cache.predict(a) == expected) && (1U == cache.missCount()));
+    passed &= check("repeated input is a hit",
+                    (cache.predict(a) == expected) && (1U == cache.hitCount()));
+    passed &= check("near-identical input shares the entry",
+                    (cache.predict({0.101, 0.199}) == expected) && (2U == cache.hitCount()));
+
+    // Fill the cache; the next new input evicts the first unreferenced entry (b), since the
+    // clock hand gives the referenced entry (a) a second chance.
+    for (const auto* input : {&b, &c, &d}) { cache.predict(*input); }
+    passed &= check("cache is full without evictions",
+                    (4U == cache.size()) && (0U == cache.evictionCount()));
+    cache.predict(e);
+    passed &= check("new input evicts one entry", 1U == cache.evictionCount());
+    cache.predict(a);
+    passed &= check("referenced entry survives eviction", 3U == cache.hitCount());
+    const auto missCount{cache.missCount()};
+    cache.predict(b);
+    passed &= check("unreferenced entry was evicted", missCount + 1U == cache.missCount());
+
+    // Training changes the layer versions, so the cached predictions are stale.
+    network.train(10U, 0.1);
+    const auto trained{network.predict(a)};
+    const auto hitCount{cache.hitCount()};
+    passed &= check("training invalidates the cache",
+                    (cache.predict(a) == trained) && (hitCount == cache.hitCount()) &&
+                    (1U == cache.invalidationCount()) && (1U == cache.size()));
+
+    // Inputs that can't be quantized and failed predictions are passed through uncached.
+    const std::vector<double> nan{std::nan(""), 0.2}, huge{1.0e300, 0.2}, invalid{0.1};
+    const auto hugeExpected{network.predict(huge)};
+    passed &= check("non-finite input bypasses the cache",
+                    (1U == cache.predict(nan).size()) && (1U == cache.size()));
+    passed &= check("out-of-range input bypasses the cache",
+                    (cache.predict(huge) == hugeExpected) && (1U == cache.size()));
+    passed &= check("failed prediction is not cached",
+                    cache.predict(invalid).empty() && cache.predict(invalid).empty() &&
+                    (1U == cache.size()));
+
+    std::cout << "Hits: " << cache.hitCount() << ", misses: " << cache.missCount()
+              << ", evictions: " << cache.evictionCount()
+              << ", invalidations: " << cache.invalidationCount() << "\n";
+    return passed ? 0 : -1;
+}
@@ -0,0 +1,129 @@
+/**
+ * @brief Demonstration of incremental crash-safe checkpoints saved during training.
+ */
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "ml/checkpoint/checkpoint.h"
+#include "ml/dense_layer/dense_layer.h"
+#include "ml/neural_network/single_layer.h"
+
+namespace
+{
+/**
+ * @brief Check whether two layers hold bitwise identical parameters.
+ *
+ * @param[in] first The first layer.
+ * @param[in] second The second layer.
+ *
+ * @return True if the parameters are identical, false otherwise.
+ */
+bool isIdentical(const ml::dense_layer::DenseLayer& first,
+                 const ml::dense_layer::DenseLayer& second) noexcept
+{
+    return (first.bias() == second.bias()) && (first.weights() == second.weights());
+}
+} // namespace
+
+/**
+ * @brief Train a network to predict a two-bit XOR pattern while saving checkpoints, then
+ *        restore the latest checkpoint into a fresh network and resume training.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int main()
+{
+    // Implement the network and training parameters as compile-time constants.
+    constexpr std::size_t hiddenCount{512U};
+    constexpr std::size_t epochsPerCheckpoint{200U};
+    constexpr std::size_t checkpointCount{5U};
+    constexpr double learningRate{0.01};
+    constexpr const char* directory{"checkpoints"};
+
+    // Create training data vectors.
+    const std::vector<std::vector<double>> trainInput{{0,0}, {0,1}, {1,0}, {1,1}};
+    const std::vector<std::vector<double>> trainOutput{{0}, {1}, {1}, {0}};
+
+    ml::dense_layer::DenseLayer hiddenLayer{hiddenCount, 2U, ml::ActFunc::Tanh, 1U};
+    ml::dense_layer::DenseLayer outputLayer{1U, hiddenCount, ml::ActFunc::Tanh, 2U};
+    ml::neural_network::SingleLayer network{hiddenLayer, outputLayer, trainInput, trainOutput};
+    ml::checkpoint::Writer writer{directory, {&hiddenLayer, &outputLayer}};
+
+    // The generator is not used by the network itself, it is saved to show resumable state.
+    std::mt19937 generator{42U};
+
+    for (std::size_t i{1U}; i <= checkpointCount; ++i)
+    {
+        const auto trainStart{std::chrono::steady_clock::now()};
+        network.train(epochsPerCheckpoint, learningRate);
+        const auto saveStart{std::chrono::steady_clock::now()};
+
+        // Save the checkpoint; the files are written while the next round of training runs.
+        std::ostringstream randomState{};
+        randomState << generator;
+        if (!writer.save({i * epochsPerCheckpoint, learningRate, randomState.str()}))
+        {
+            std::cout << "Failed to write checkpoint!\n";
+            return -1;
+        }
+        const auto saveEnd{std::chrono::steady_clock::now()};
+        const std::chrono::duration<double, std::micro> trainTime{saveStart - trainStart};
+        const std::chrono::duration<double, std::micro> saveTime{saveEnd - saveStart};
+
+        std::cout << "Epoch " << i * epochsPerCheckpoint << ": training took " << trainTime.count()
+                  << " us, save call took " << saveTime.count() << " us ("
+                  << writer.changedLayerCount() << " layers written)\n";
+    }
+
+    // Change the output layer only (same values, new version): just that layer is written.
+    outputLayer.setParameters(outputLayer.bias(), outputLayer.weights());
+    std::ostringstream randomState{};
+    randomState << generator;
+    if (!writer.save({checkpointCount * epochsPerCheckpoint, learningRate, randomState.str()}) ||
+        !writer.wait())
+    {
+        std::cout << "Failed to write checkpoint!\n";
+        return -1;
+    }
+    const auto fileCount{std::distance(std::filesystem::directory_iterator{directory},
+                                       std::filesystem::directory_iterator{})};
+    std::cout << "Single changed layer: " << writer.changedLayerCount() << " layer written, "
+              << fileCount << " files in " << directory << "\n";
+    if ((1U != writer.changedLayerCount()) || (3 != fileCount))
+    {
+        std::cout << "Expected 1 layer written and 3 files (manifest and 2 layers)!\n";
+        return -1;
+    }
+
+    // Restore the latest checkpoint into a freshly initialized network.
+    ml::dense_layer::DenseLayer restoredHidden{hiddenCount, 2U, ml::ActFunc::Tanh, 3U};
+    ml::dense_layer::DenseLayer restoredOutput{1U, hiddenCount, ml::ActFunc::Tanh, 4U};
+    ml::neural_network::SingleLayer restoredNetwork{restoredHidden, restoredOutput, trainInput,
+                                                    trainOutput};
+    ml::checkpoint::State state{};
+    std::mt19937 restoredGenerator{};
+
+    if (!ml::checkpoint::restore(directory, {&restoredHidden, &restoredOutput}, state))
+    {
+        return -1;
+    }
+    std::istringstream{state.randomState} >> restoredGenerator;
+
+    std::cout << "Restored epoch " << state.epoch << ", learning rate " << state.learningRate
+              << ", random state " << (generator == restoredGenerator ? "identical" : "differs")
+              << "\n";
+
+    // Resume training of both networks, the results shall be bitwise identical.
+    network.train(epochsPerCheckpoint, learningRate);
+    restoredNetwork.train(epochsPerCheckpoint, state.learningRate);
+
+    const bool identical{isIdentical(hiddenLayer, restoredHidden) &&
+                         isIdentical(outputLayer, restoredOutput)};
+    std::cout << "Resumed training is " << (identical ? "identical" : "NOT identical") << "\n";
+    return identical ? 0 : -1;
+}
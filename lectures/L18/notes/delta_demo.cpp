@@ -0,0 +1,88 @@
+/**
+ * @brief Check of incremental (delta) feedforward against full recomputation.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ml/dense_layer/dense_layer.h"
+
+/**
+ * @brief Feed a slowly changing input through two identical layers, one with incremental
+ *        feedforward and one with full feedforward, and compare the outputs after every step.
+ * 
+ *        The check runs over several refresh intervals and includes an optimization step, so that
+ *        both the drift refresh and the invalidation after changed weights are exercised.
+ *
+ * @return 0 if the outputs match, -1 otherwise.
+ */
+int main()
+{
+    // Implement the layer and check parameters as compile-time constants.
+    constexpr std::size_t nodeCount{256U}, weightCount{4096U}, changedCount{8U};
+    constexpr std::size_t refreshInterval{100U}, stepCount{350U}, optimizeStep{175U};
+    constexpr double tolerance{1e-9}, learningRate{1e-4};
+    constexpr unsigned seed{1U};
+
+    ml::dense_layer::DenseLayer incremental{nodeCount, weightCount, ml::ActFunc::Tanh, seed};
+    ml::dense_layer::DenseLayer full{nodeCount, weightCount, ml::ActFunc::Tanh, seed};
+    incremental.setIncremental(true);
+    incremental.setRefreshInterval(refreshInterval);
+
+    std::mt19937 generator{2U};
+    std::uniform_real_distribution<double> distribution{-0.01, 0.01};
+    std::uniform_int_distribution<std::size_t> indexDistribution{0U, weightCount - 1U};
+    std::vector<double> input(weightCount), reference(nodeCount, 0.5), deltas(changedCount);
+    std::vector<std::size_t> indices(changedCount);
+    for (auto& value : input) { value = distribution(generator); }
+
+    if (!incremental.feedforward(input) || !full.feedforward(input)) { return -1; }
+
+    double maxError{}, incrementalTime{}, fullTime{};
+
+    for (std::size_t step{1U}; step <= stepCount; ++step)
+    {
+        // Change a few input values, as a sensor or a sliding feature window would.
+        for (std::size_t k{}; k < changedCount; ++k)
+        {
+            indices[k] = indexDistribution(generator);
+            deltas[k]  = distribution(generator);
+            input[indices[k]] += deltas[k];
+        }
+
+        const auto start{std::chrono::steady_clock::now()};
+        if (!incremental.feedforward(indices, deltas)) { return -1; }
+        const auto middle{std::chrono::steady_clock::now()};
+        if (!full.feedforward(input)) { return -1; }
+        const auto end{std::chrono::steady_clock::now()};
+
+        incrementalTime += std::chrono::duration<double, std::micro>{middle - start}.count();
+        fullTime += std::chrono::duration<double, std::micro>{end - middle}.count();
+
+        for (std::size_t i{}; i < nodeCount; ++i)
+        {
+            maxError = std::max(maxError, std::abs(incremental.output()[i] - full.output()[i]));
+        }
+
+        // Change the weights of both layers, the stored sums of the incremental layer are stale.
+        if (optimizeStep == step)
+        {
+            for (auto* layer : {&incremental, &full})
+            {
+                layer->backpropagate(reference);
+                layer->optimize(input, learningRate);
+            }
+        }
+    }
+
+    const bool match{tolerance > maxError};
+    std::cout << stepCount << " steps (refresh interval " << refreshInterval << ", weights changed "
+              << "at step " << optimizeStep << "): max difference " << maxError << " ("
+              << (match ? "match" : "MISMATCH") << ")\n";
+    std::cout << "Mean time per step: incremental " << incrementalTime / stepCount
+              << " us, full " << fullTime / stepCount << " us\n";
+    return match ? 0 : -1;
+}
@@ -0,0 +1,107 @@
+/**
+ * @brief Benchmark of synchronous versus Hogwild training with sparse input data.
+ */
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "ml/dense_layer/dense_layer.h"
+#include "ml/train/parallel_trainer.h"
+
+namespace
+{
+/**
+ * @brief Create sparse training data.
+ * 
+ *        Each sample has a few active inputs (set to 1). The output is 1 if any of the first
+ *        tenth of the inputs is active, otherwise 0.
+ * 
+ * @param[out] input Vector to store the input data in.
+ * @param[out] output Vector to store the output data in.
+ * @param[in] sampleCount The number of samples to create.
+ * @param[in] inputCount The number of inputs per sample.
+ * @param[in] activeCount The number of active inputs per sample.
+ */
+void createSparseData(std::vector<std::vector<double>>& input,
+                      std::vector<std::vector<double>>& output, const std::size_t sampleCount,
+                      const std::size_t inputCount, const std::size_t activeCount)
+{
+    std::mt19937 generator{1U};
+    std::uniform_int_distribution<std::size_t> distribution{0U, inputCount - 1U};
+
+    input.assign(sampleCount, std::vector<double>(inputCount, 0.0));
+    output.assign(sampleCount, std::vector<double>{0.0});
+
+    // Activate a few random inputs per sample, set the output accordingly.
+    for (std::size_t i{}; i < sampleCount; ++i)
+    {
+        for (std::size_t k{}; k < activeCount; ++k)
+        {
+            const auto index{distribution(generator)};
+            input[i][index] = 1.0;
+            if (index < inputCount / 10U) { output[i][0U] = 1.0; }
+        }
+    }
+}
+
+/**
+ * @brief Train a freshly initialized network and print the throughput and the resulting loss.
+ * 
+ * @param[in] mode The training mode to use.
+ * @param[in] threadCount The number of worker threads.
+ * @param[in] input Training input data.
+ * @param[in] output Training output data.
+ */
+void benchmark(const ml::train::Mode mode, const std::size_t threadCount,
+               const std::vector<std::vector<double>>& input,
+               const std::vector<std::vector<double>>& output)
+{
+    // Implement the network and training parameters as compile-time constants.
+    constexpr std::size_t hiddenCount{32U};
+    constexpr std::size_t epochCount{20U};
+    constexpr double learningRate{0.01};
+
+    // Use the same seeds every run, so that each mode starts from identical parameters.
+    ml::dense_layer::DenseLayer hiddenLayer{hiddenCount, input[0U].size(), ml::ActFunc::Tanh, 1U};
+    ml::dense_layer::DenseLayer outputLayer{1U, hiddenCount, ml::ActFunc::Tanh, 2U};
+    ml::train::ParallelTrainer trainer{{&hiddenLayer, &outputLayer}, input, output, threadCount};
+
+    const auto start{std::chrono::steady_clock::now()};
+    trainer.train(epochCount, learningRate, mode);
+    const std::chrono::duration<double> duration{std::chrono::steady_clock::now() - start};
+
+    std::cout << std::left << std::setw(14) 
+              << (ml::train::Mode::Hogwild == mode ? "hogwild" : "synchronous")
+              << std::setw(10) << threadCount << std::setw(16) << std::fixed 
+              << std::setprecision(0) << epochCount * input.size() / duration.count()
+              << std::setprecision(4) << trainer.loss() << "\n";
+}
+} // namespace
+
+/**
+ * @brief Compare synchronous and Hogwild training with an increasing number of threads.
+ * 
+ * @return 0 on success.
+ */
+int main()
+{
+    std::vector<std::vector<double>> input{}, output{};
+    createSparseData(input, output, 2000U, 500U, 5U);
+
+    std::cout << std::left << std::setw(14) << "mode" << std::setw(10) << "threads" 
+              << std::setw(16) << "samples/s" << "loss\n";
+
+    // Double the number of threads up to the hardware concurrency (at least 4 threads).
+    const std::size_t maxThreadCount{std::max(4U, std::thread::hardware_concurrency())};
+
+    for (std::size_t threadCount{1U}; threadCount <= maxThreadCount; threadCount *= 2U)
+    {
+        benchmark(ml::train::Mode::Synchronous, threadCount, input, output);
+        benchmark(ml::train::Mode::Hogwild, threadCount, input, output);
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+/**
+ * @brief Activation functions for machine learning.
+ */
+#pragma once
+
+#include <cmath>
+#include <iostream>
+
+#include "ml/types.h"
+
+namespace ml
+{
+/**
+ * @brief Compute the output of the given activation function.
+ * 
+ * @param[in] actFunc The activation function to use.
+ * @param[in] input The input value.
+ * 
+ * @return The output of the activation function.
+ */
+inline double actFuncOutput(const ml::ActFunc actFunc, const double input) noexcept
+{
+    // Compute activation function output for the given input value.
+    switch (actFunc)
+    {
+        case ml::ActFunc::Relu:
+             // ReLU: f(x) = max(0, x) - return input if positive, zero otherwise.
+             return 0.0 < input ? input : 0.0;
+        case ml::ActFunc::Tanh:
+             // Hyperbolic tangent: f(x) = tanh(x) - output range [-1, 1].
+             return std::tanh(input);
+        default:
+            std::cout << "Invalid activation function!\n";
+            return 0.0;
+    }
+}
+
+/**
+ * @brief Compute the derivative of the given activation function.
+ * 
+ * @param[in] actFunc The activation function to use.
+ * @param[in] input The input value.
+ * 
+ * @return The derivative of the activation function.
+ */
+inline double actFuncDelta(const ml::ActFunc actFunc, const double input) noexcept
+{
+    // Calculate how much the activation function changes (needed for learning).
+    switch (actFunc)
+    {
+        case ml::ActFunc::Relu:
+             // ReLU derivative: f'(x) = 1 if x > 0, else 0.
+             return 0.0 < input ? 1.0 : 0.0;
+        case ml::ActFunc::Tanh:
+             // Tanh derivative: f'(x) = 1 - tanh²(x).
+             return 1.0 - std::tanh(input) * std::tanh(input);
+        default:
+            std::cout << "Invalid activation function!\n";
+            return 0.0;
+    }
+}
+} // namespace ml
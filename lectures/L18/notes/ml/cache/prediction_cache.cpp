@@ -0,0 +1,210 @@
+/**
+ * @brief Prediction cache implementation details.
+ */
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "ml/cache/prediction_cache.h"
+
+namespace ml::cache
+{
+namespace
+{
+/** FNV-1a offset basis (64-bit). */
+constexpr std::uint64_t FnvOffset{14695981039346656037ULL};
+
+/** FNV-1a prime (64-bit). */
+constexpr std::uint64_t FnvPrime{1099511628211ULL};
+
+/** Magnitude limit of quantized values, well within the range of std::int64_t (2^62). */
+constexpr double MaxQuantizedValue{4611686018427387904.0};
+
+// -----------------------------------------------------------------------------
+constexpr std::uint64_t hashValue(std::uint64_t hash, const std::uint64_t value) noexcept
+{
+    // Mix the value into the hash byte by byte.
+    for (std::size_t i{}; i < sizeof(value); ++i)
+    {
+        hash ^= (value >> (8U * i)) & 0xFFU;
+        hash *= FnvPrime;
+    }
+    return hash;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+PredictionCache::PredictionCache(ml::neural_network::Interface& network,
+                                 const std::vector<const ml::dense_layer::DenseLayer*>& layers,
+                                 const std::size_t capacity, const double precision)
+    : myNetwork{network}
+    , myLayers{layers}
+    , myEntries(capacity)
+    , myIndex{}
+    , myKey{}
+    , myPrecision{precision}
+    , myHand{}
+    , mySize{}
+    , myVersion{}
+    , myHitCount{}
+    , myMissCount{}
+    , myEvictionCount{}
+    , myInvalidationCount{}
+{
+    // Make sure the cache can hold at least one prediction and the precision is usable.
+    if ((0U == capacity) || (0.0 >= precision))
+    {
+        throw std::invalid_argument(
+            "Invalid prediction cache parameters: capacity and precision must be > 0!");
+    }
+    // Make sure all layers are valid.
+    for (const auto* layer : layers)
+    {
+        if (nullptr == layer)
+        {
+            throw std::invalid_argument("Invalid prediction cache parameters: null layer!");
+        }
+    }
+    // Reserve space for all entries to avoid rehashing.
+    myIndex.reserve(capacity);
+    myVersion = layerVersion();
+}
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& PredictionCache::predict(const std::vector<double>& input)
+{
+    // Remove all cached predictions if the network has been changed since the latest call.
+    const auto version{layerVersion()};
+
+    if (version != myVersion)
+    {
+        if (0U < mySize) { ++myInvalidationCount; }
+        clear();
+        myVersion = version;
+    }
+
+    // Bypass the cache if the input can't be quantized, for instance if it holds NaN.
+    std::uint64_t hash{};
+    if (!quantize(input, hash))
+    {
+        ++myMissCount;
+        return myNetwork.predict(input);
+    }
+
+    // Return the cached prediction if the quantized input has been predicted before.
+    const auto it{myIndex.find(hash)};
+
+    if ((myIndex.end() != it) && (myEntries[it->second].key == myKey))
+    {
+        auto& entry{myEntries[it->second]};
+        entry.referenced = true;
+        ++myHitCount;
+        return entry.output;
+    }
+    ++myMissCount;
+
+    // Predict with the network, failed (empty) predictions are not cached.
+    const auto& prediction{myNetwork.predict(input)};
+    if (prediction.empty()) { return prediction; }
+
+    // Reuse the entry on hash collision, else take a free entry (evict one if the cache is full).
+    const auto index{myIndex.end() != it ? it->second : nextEntry()};
+    auto& entry{myEntries[index]};
+
+    // Store the prediction.
+    entry.key        = myKey;
+    entry.output     = prediction;
+    entry.hash       = hash;
+    entry.referenced = false;
+    entry.used       = true;
+    myIndex[hash]    = index;
+    return entry.output;
+}
+
+// -----------------------------------------------------------------------------
+void PredictionCache::clear() noexcept
+{
+    // Mark all entries as unused, the allocated memory is kept for reuse.
+    for (auto& entry : myEntries)
+    {
+        entry.referenced = false;
+        entry.used       = false;
+    }
+    myIndex.clear();
+    myHand = 0U;
+    mySize = 0U;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t PredictionCache::size() const noexcept { return mySize; }
+
+// -----------------------------------------------------------------------------
+std::size_t PredictionCache::hitCount() const noexcept { return myHitCount; }
+
+// -----------------------------------------------------------------------------
+std::size_t PredictionCache::missCount() const noexcept { return myMissCount; }
+
+// -----------------------------------------------------------------------------
+std::size_t PredictionCache::evictionCount() const noexcept { return myEvictionCount; }
+
+// -----------------------------------------------------------------------------
+std::size_t PredictionCache::invalidationCount() const noexcept { return myInvalidationCount; }
+
+// -----------------------------------------------------------------------------
+double PredictionCache::hitRate() const noexcept
+{
+    // Return the share of predictions returned from the cache.
+    const auto total{myHitCount + myMissCount};
+    return 0U < total ? static_cast<double>(myHitCount) / total : 0.0;
+}
+
+// -----------------------------------------------------------------------------
+bool PredictionCache::quantize(const std::vector<double>& input, std::uint64_t& hash)
+{
+    // Round each input value to the nearest multiple of the precision, hash the result.
+    myKey.resize(input.size());
+    hash = hashValue(FnvOffset, input.size());
+
+    for (std::size_t i{}; i < input.size(); ++i)
+    {
+        // Reject values that are not finite or don't fit in the quantized key.
+        const auto value{input[i] / myPrecision};
+        if (!std::isfinite(value) || (MaxQuantizedValue <= std::abs(value))) { return false; }
+
+        myKey[i] = static_cast<std::int64_t>(std::llround(value));
+        hash     = hashValue(hash, static_cast<std::uint64_t>(myKey[i]));
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t PredictionCache::nextEntry() noexcept
+{
+    // Entries are filled in order after the cache has been cleared, use the next free one.
+    if (mySize < myEntries.size()) { return mySize++; }
+
+    // Advance the clock hand, give referenced entries a second chance.
+    while (myEntries[myHand].referenced)
+    {
+        myEntries[myHand].referenced = false;
+        myHand = (myHand + 1U) % myEntries.size();
+    }
+
+    // Evict the first unreferenced entry.
+    const auto index{myHand};
+    myIndex.erase(myEntries[index].hash);
+    myHand = (myHand + 1U) % myEntries.size();
+    ++myEvictionCount;
+    return index;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t PredictionCache::layerVersion() const noexcept
+{
+    // Sum the layer versions; the sum changes whenever any layer is changed.
+    std::size_t version{};
+    for (const auto* layer : myLayers) { version += layer->version(); }
+    return version;
+}
+} // namespace ml::cache
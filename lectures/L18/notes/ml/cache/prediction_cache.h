@@ -0,0 +1,196 @@
+/**
+ * @brief Prediction cache implementation.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "ml/dense_layer/dense_layer.h"
+#include "ml/neural_network/interface.h"
+
+namespace ml::cache
+{
+/**
+ * @brief Bounded prediction cache placed in front of a neural network.
+ * 
+ *        Input values are quantized to a configurable precision, so near-identical inputs share
+ *        the same cache entry. When the cache is full, entries are evicted using the CLOCK
+ *        algorithm (an approximation of least recently used). The cache is cleared automatically 
+ *        as soon as any of the given layers has been changed, for instance via optimize.
+ */
+class PredictionCache final
+{
+public:
+    /**
+     * @brief Create a new prediction cache.
+     * 
+     * @param[in] network The network to predict with on cache misses.
+     * @param[in] layers The layers of the network, used to detect changed parameters.
+     * @param[in] capacity The maximum number of cached predictions. Must exceed 0.
+     * @param[in] precision Quantization step of the input values. Must exceed 0.
+     */
+    explicit PredictionCache(ml::neural_network::Interface& network,
+                             const std::vector<const ml::dense_layer::DenseLayer*>& layers,
+                             const std::size_t capacity, const double precision);
+
+    /**
+     * @brief Delete the prediction cache.
+     */
+    ~PredictionCache() noexcept = default;
+
+    /**
+     * @brief Perform prediction with the given input.
+     * 
+     *        A cached prediction is returned if the quantized input has been predicted before.
+     *        Inputs that can't be quantized (non-finite or out of range) bypass the cache, and
+     *        failed (empty) predictions are never cached.
+     * 
+     * @param[in] input Input values with which to predict.
+     * 
+     * @return Vector holding the predicted output values.
+     */
+    const std::vector<double>& predict(const std::vector<double>& input);
+
+    /**
+     * @brief Remove all cached predictions.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Get the number of cached predictions.
+     * 
+     * @return The number of cached predictions.
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * @brief Get the number of predictions returned from the cache.
+     * 
+     * @return The number of cache hits.
+     */
+    std::size_t hitCount() const noexcept;
+
+    /**
+     * @brief Get the number of predictions that had to be computed by the network.
+     * 
+     * @return The number of cache misses.
+     */
+    std::size_t missCount() const noexcept;
+
+    /**
+     * @brief Get the number of predictions evicted to make room for new ones.
+     * 
+     * @return The number of evictions.
+     */
+    std::size_t evictionCount() const noexcept;
+
+    /**
+     * @brief Get the number of times the cache was cleared due to changed parameters.
+     * 
+     * @return The number of invalidations.
+     */
+    std::size_t invalidationCount() const noexcept;
+
+    /**
+     * @brief Get the hit rate of the cache.
+     * 
+     * @return The hit rate in the range [0.0, 1.0], or 0.0 if no predictions have been made.
+     */
+    double hitRate() const noexcept;
+
+    PredictionCache()                                  = delete; // No default constructor.
+    PredictionCache(const PredictionCache&)            = delete; // No copy constructor.
+    PredictionCache(PredictionCache&&)                 = delete; // No move constructor.
+    PredictionCache& operator=(const PredictionCache&) = delete; // No copy assignment.
+    PredictionCache& operator=(PredictionCache&&)      = delete; // No move assignment.
+
+private:
+    /**
+     * @brief Structure holding a cached prediction.
+     */
+    struct Entry
+    {
+        /** Quantized input values. */
+        std::vector<std::int64_t> key;
+
+        /** Predicted output values. */
+        std::vector<double> output;
+
+        /** Hash of the quantized input values. */
+        std::uint64_t hash;
+
+        /** Indicate whether the entry has been used since the clock hand last passed it. */
+        bool referenced;
+
+        /** Indicate whether the entry holds a prediction. */
+        bool used;
+    };
+
+    /**
+     * @brief Quantize the given input and store the result in myKey.
+     * 
+     * @param[in] input The input values to quantize.
+     * @param[out] hash Hash of the quantized input values.
+     * 
+     * @return True if the input was quantized, false if any value is not finite or too large
+     *         to quantize with the given precision.
+     */
+    bool quantize(const std::vector<double>& input, std::uint64_t& hash);
+
+    /**
+     * @brief Get the index of the entry to replace, evict a prediction if the cache is full.
+     * 
+     * @return Index of the entry to replace.
+     */
+    std::size_t nextEntry() noexcept;
+
+    /**
+     * @brief Get the sum of the parameter versions of the network layers.
+     * 
+     * @return The sum of the parameter versions.
+     */
+    std::size_t layerVersion() const noexcept;
+
+    /** The network to predict with on cache misses. */
+    ml::neural_network::Interface& myNetwork;
+
+    /** The layers of the network, used to detect changed parameters. */
+    const std::vector<const ml::dense_layer::DenseLayer*> myLayers;
+
+    /** Cache entries. */
+    std::vector<Entry> myEntries;
+
+    /** Map holding the entry index of each cached hash. */
+    std::unordered_map<std::uint64_t, std::size_t> myIndex;
+
+    /** Buffer holding the quantized input of the latest prediction. */
+    std::vector<std::int64_t> myKey;
+
+    /** Quantization step of the input values. */
+    const double myPrecision;
+
+    /** Position of the clock hand. */
+    std::size_t myHand;
+
+    /** The number of cached predictions. */
+    std::size_t mySize;
+
+    /** Sum of the layer versions when the cache was last validated. */
+    std::size_t myVersion;
+
+    /** The number of cache hits. */
+    std::size_t myHitCount;
+
+    /** The number of cache misses. */
+    std::size_t myMissCount;
+
+    /** The number of evictions. */
+    std::size_t myEvictionCount;
+
+    /** The number of invalidations. */
+    std::size_t myInvalidationCount;
+};
+} // namespace ml::cache
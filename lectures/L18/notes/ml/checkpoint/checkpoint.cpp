@@ -0,0 +1,352 @@
+/**
+ * @brief Checkpoint implementation details.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ml/checkpoint/checkpoint.h"
+
+namespace ml::checkpoint
+{
+namespace
+{
+/** Identifier written first in every layer file. */
+constexpr char LayerMagic[4U]{'M', 'L', 'C', 'K'};
+
+/** Name of the manifest file. */
+constexpr const char* ManifestName{"manifest.txt"};
+
+/** Identifier written first in the manifest. */
+constexpr const char* ManifestHeader{"ml-checkpoint"};
+
+/**
+ * @brief Structure holding the contents of a manifest.
+ */
+struct Manifest
+{
+    /** Sequence number of the checkpoint. */
+    std::size_t sequence;
+
+    /** The saved training state. */
+    State state;
+
+    /** File name of each layer. */
+    std::vector<std::string> files;
+};
+
+// -----------------------------------------------------------------------------
+std::string path(const std::string& directory, const std::string& file)
+{
+    return (std::filesystem::path{directory} / file).string();
+}
+
+// -----------------------------------------------------------------------------
+bool contains(const std::vector<std::string>& files, const std::string& file) noexcept
+{
+    return files.end() != std::find(files.begin(), files.end(), file);
+}
+
+// -----------------------------------------------------------------------------
+bool syncDirectory(const std::string& directory) noexcept
+{
+    // Flush the directory entry, so that renamed files survive a power loss.
+    const int fd{::open(directory.c_str(), O_RDONLY)};
+    if (0 > fd) { return false; }
+    const bool result{0 == ::fsync(fd)};
+    ::close(fd);
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+bool writeFile(const std::string& filePath, const void* data, const std::size_t size,
+               const void* header = nullptr, const std::size_t headerSize = 0U) noexcept
+{
+    // Write to a temporary file, which is renamed once the data is safely on disk.
+    const auto tempPath{filePath + ".tmp"};
+    std::FILE* file{std::fopen(tempPath.c_str(), "wb")};
+    if (nullptr == file) { return false; }
+
+    bool result{(0U == headerSize) || (1U == std::fwrite(header, headerSize, 1U, file))};
+    result = result && ((0U == size) || (1U == std::fwrite(data, size, 1U, file)));
+    result = result && (0 == std::fflush(file)) && (0 == ::fsync(::fileno(file)));
+    result = (0 == std::fclose(file)) && result;
+
+    // Replace the target atomically, remove the temporary file on failure.
+    if (result) { result = 0 == std::rename(tempPath.c_str(), filePath.c_str()); }
+    if (!result) { std::remove(tempPath.c_str()); }
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+bool writeLayer(const std::string& filePath, const std::size_t nodeCount,
+                const std::size_t weightCount, const std::vector<double>& parameters) noexcept
+{
+    // Header: identifier, node count and weight count.
+    char header[sizeof(LayerMagic) + 2U * sizeof(std::uint64_t)];
+    const std::uint64_t dimensions[2U]{nodeCount, weightCount};
+    std::memcpy(header, LayerMagic, sizeof(LayerMagic));
+    std::memcpy(header + sizeof(LayerMagic), dimensions, sizeof(dimensions));
+
+    // The parameters are written in binary form, so that they are restored exactly.
+    return writeFile(filePath, parameters.data(), parameters.size() * sizeof(double), header,
+                     sizeof(header));
+}
+
+// -----------------------------------------------------------------------------
+bool readLayer(const std::string& filePath, ml::dense_layer::DenseLayer& layer)
+{
+    std::ifstream file{filePath, std::ios::binary};
+    char magic[sizeof(LayerMagic)]{};
+    std::uint64_t dimensions[2U]{};
+
+    // Read and validate the header.
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(dimensions), sizeof(dimensions));
+
+    if (!file || (0 != std::memcmp(magic, LayerMagic, sizeof(magic))) ||
+        (dimensions[0U] != layer.nodeCount()) || (dimensions[1U] != layer.weightCount()))
+    {
+        std::cout << "Invalid checkpoint layer file " << filePath << "!\n";
+        return false;
+    }
+
+    // Read the bias values followed by the weights of each node.
+    std::vector<double> bias(layer.nodeCount());
+    std::vector<std::vector<double>> weights(layer.nodeCount(),
+                                             std::vector<double>(layer.weightCount()));
+    file.read(reinterpret_cast<char*>(bias.data()), bias.size() * sizeof(double));
+    for (auto& nodeWeights : weights)
+    {
+        file.read(reinterpret_cast<char*>(nodeWeights.data()), nodeWeights.size() * sizeof(double));
+    }
+    if (!file)
+    {
+        std::cout << "Truncated checkpoint layer file " << filePath << "!\n";
+        return false;
+    }
+    return layer.setParameters(bias, weights);
+}
+
+// -----------------------------------------------------------------------------
+bool writeManifest(const std::string& directory, const Manifest& manifest) noexcept
+{
+    std::uint64_t learningRateBits{};
+    std::memcpy(&learningRateBits, &manifest.state.learningRate, sizeof(learningRateBits));
+
+    // The learning rate is stored as its bit pattern, so that it is restored exactly.
+    std::string content{std::string{ManifestHeader} + " 1\n"};
+    content += "sequence " + std::to_string(manifest.sequence) + "\n";
+    content += "epoch " + std::to_string(manifest.state.epoch) + "\n";
+    content += "learning_rate_bits " + std::to_string(learningRateBits) + "\n";
+    content += "layers " + std::to_string(manifest.files.size()) + "\n";
+    for (const auto& file : manifest.files) { content += file + "\n"; }
+    content += "random_state " + std::to_string(manifest.state.randomState.size()) + "\n";
+    content += manifest.state.randomState + "\n";
+
+    return writeFile(path(directory, ManifestName), content.data(), content.size());
+}
+
+// -----------------------------------------------------------------------------
+bool readManifest(const std::string& directory, Manifest& manifest)
+{
+    std::ifstream file{path(directory, ManifestName)};
+    std::string header{}, key{};
+    std::size_t version{}, layerCount{}, stateSize{};
+    std::uint64_t learningRateBits{};
+
+    // Read the fields in the order they were written.
+    file >> header >> version;
+    file >> key >> manifest.sequence;
+    file >> key >> manifest.state.epoch;
+    file >> key >> learningRateBits;
+    file >> key >> layerCount;
+    if (!file || (ManifestHeader != header) || (1U != version)) { return false; }
+
+    manifest.files.resize(layerCount);
+    for (auto& fileName : manifest.files) { file >> fileName; }
+
+    // The random state may contain blank spaces, read it as raw characters.
+    file >> key >> stateSize;
+    file.ignore(1U);
+    manifest.state.randomState.resize(stateSize);
+    file.read(manifest.state.randomState.data(), stateSize);
+    std::memcpy(&manifest.state.learningRate, &learningRateBits, sizeof(learningRateBits));
+    return static_cast<bool>(file);
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+Writer::Writer(const std::string& directory,
+               const std::vector<const ml::dense_layer::DenseLayer*>& layers)
+    : myDirectory{directory}
+    , myLayers{layers}
+    , myVersions(layers.size(), 0U)
+    , myFiles(layers.size())
+    , myCommittedFiles{}
+    , mySequence{}
+    , myChangedCount{}
+    , mySaved{false}
+    , myResult{true}
+    , myPending{}
+{
+    // Make sure all layers are valid.
+    for (const auto* layer : layers)
+    {
+        if (nullptr == layer)
+        {
+            throw std::invalid_argument("Invalid checkpoint parameters: null layer!");
+        }
+    }
+    // Create the directory if missing.
+    std::filesystem::create_directories(directory);
+
+    // Continue the sequence of an existing checkpoint, so that its files are never overwritten;
+    // they are removed once the first checkpoint of this writer has been committed.
+    Manifest manifest{};
+    if (readManifest(directory, manifest))
+    {
+        mySequence       = manifest.sequence + 1U;
+        myCommittedFiles = std::move(manifest.files);
+    }
+}
+
+// -----------------------------------------------------------------------------
+Writer::~Writer() noexcept { wait(); }
+
+// -----------------------------------------------------------------------------
+bool Writer::save(const State& state)
+{
+    // Complete the previous checkpoint; if it failed, every layer is written this time.
+    const bool previousResult{wait()};
+    std::vector<Snapshot> snapshots{};
+
+    // Files of the committed checkpoint (and any left by a failed one) may become obsolete.
+    auto previousFiles{myCommittedFiles};
+    previousFiles.insert(previousFiles.end(), myFiles.begin(), myFiles.end());
+
+    // Copy the parameters of the layers changed since the previous checkpoint.
+    for (std::size_t i{}; i < myLayers.size(); ++i)
+    {
+        const auto* layer{myLayers[i]};
+        if (mySaved && (layer->version() == myVersions[i])) { continue; }
+
+        Snapshot snapshot{i, layer->nodeCount(), layer->weightCount(), {}};
+        snapshot.parameters.reserve(layer->nodeCount() * (layer->weightCount() + 1U));
+        snapshot.parameters.insert(snapshot.parameters.end(), layer->bias().begin(),
+                                   layer->bias().end());
+        for (const auto& nodeWeights : layer->weights())
+        {
+            snapshot.parameters.insert(snapshot.parameters.end(), nodeWeights.begin(),
+                                       nodeWeights.end());
+        }
+        snapshots.push_back(std::move(snapshot));
+
+        // Changed layers get new files, the old ones are removed once the manifest is updated.
+        myFiles[i]    = "layer" + std::to_string(i) + "_" + std::to_string(mySequence) + ".bin";
+        myVersions[i] = layer->version();
+    }
+    myChangedCount = snapshots.size();
+    mySaved        = true;
+
+    // Previous files not referred to by the new manifest are obsolete.
+    std::vector<std::string> obsoleteFiles{};
+    for (const auto& file : previousFiles)
+    {
+        if (!file.empty() && !contains(myFiles, file) && !contains(obsoleteFiles, file))
+        {
+            obsoleteFiles.push_back(file);
+        }
+    }
+
+    // Write the files in the background.
+    Manifest manifest{mySequence++, state, myFiles};
+    myPending = std::async(std::launch::async,
+        [directory = myDirectory, snapshots = std::move(snapshots),
+         manifest = std::move(manifest), obsoleteFiles = std::move(obsoleteFiles)]() {
+            // Write the changed layers first.
+            for (const auto& snapshot : snapshots)
+            {
+                const auto& fileName{manifest.files[snapshot.index]};
+                if (!writeLayer(path(directory, fileName), snapshot.nodeCount,
+                                snapshot.weightCount, snapshot.parameters))
+                {
+                    return false;
+                }
+            }
+            // Commit the checkpoint by replacing the manifest.
+            if (!writeManifest(directory, manifest) || !syncDirectory(directory)) { return false; }
+
+            // Remove layer files no longer referred to by the manifest.
+            for (const auto& file : obsoleteFiles)
+            {
+                std::error_code error{};
+                std::filesystem::remove(path(directory, file), error);
+            }
+            return true;
+        });
+    return previousResult;
+}
+
+// -----------------------------------------------------------------------------
+bool Writer::wait()
+{
+    // Collect the result of the pending checkpoint, if any. A committed checkpoint is the base
+    // of the next one, after a failure the next checkpoint writes every layer again.
+    if (myPending.valid())
+    {
+        const bool committed{myPending.get()};
+        if (committed) { myCommittedFiles = myFiles; }
+        myResult = committed && myResult;
+        mySaved  = committed && mySaved;
+    }
+    const auto result{myResult};
+    myResult = true;
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Writer::changedLayerCount() const noexcept { return myChangedCount; }
+
+// -----------------------------------------------------------------------------
+bool restore(const std::string& directory, const std::vector<ml::dense_layer::DenseLayer*>& layers,
+             State& state)
+{
+    // Read the manifest of the latest completed checkpoint.
+    Manifest manifest{};
+    if (!readManifest(directory, manifest))
+    {
+        std::cout << "No valid checkpoint found in " << directory << "!\n";
+        return false;
+    }
+    if (manifest.files.size() != layers.size())
+    {
+        std::cout << "Checkpoint layer count mismatch: expected " << layers.size()
+                  << ", actual: " << manifest.files.size() << "!\n";
+        return false;
+    }
+
+    // Restore the parameters of each layer, then the training state.
+    for (std::size_t i{}; i < layers.size(); ++i)
+    {
+        if ((nullptr == layers[i]) || !readLayer(path(directory, manifest.files[i]), *layers[i]))
+        {
+            return false;
+        }
+    }
+    state = manifest.state;
+    return true;
+}
+} // namespace ml::checkpoint
@@ -0,0 +1,153 @@
+/**
+ * @brief Crash-safe training checkpoints for dense layers.
+ */
+#pragma once
+
+#include <cstddef>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "ml/dense_layer/dense_layer.h"
+
+namespace ml::checkpoint
+{
+/**
+ * @brief Structure holding the training state saved alongside the layer parameters.
+ */
+struct State
+{
+    /** The number of epochs trained so far. */
+    std::size_t epoch;
+
+    /** The learning rate in use (the optimizer state of plain gradient descent). */
+    double learningRate;
+
+    /** Random generator state used during training, e.g. written via std::mt19937::operator<<. */
+    std::string randomState;
+};
+
+/**
+ * @brief Checkpoint writer.
+ * 
+ *        Each checkpoint consists of one file per layer and a manifest listing which layer files
+ *        belong to the checkpoint. Only layers changed since the previous checkpoint are written;
+ *        unchanged layers keep referring to their existing files. Files are never overwritten: 
+ *        new files are written under new names and the manifest is replaced atomically (via rename)
+ *        once all files have been written. A crash at any point therefore leaves the previous
+ *        checkpoint intact.
+ * 
+ *        The parameters of the changed layers are copied when save is called; the files are then
+ *        written in a background thread, so that training can continue immediately.
+ */
+class Writer final
+{
+public:
+    /**
+     * @brief Create a new checkpoint writer.
+     * 
+     * @param[in] directory The directory to store the checkpoints in. Created if missing.
+     * @param[in] layers The layers to save, in feedforward order.
+     */
+    explicit Writer(const std::string& directory,
+                    const std::vector<const ml::dense_layer::DenseLayer*>& layers);
+
+    /**
+     * @brief Delete the checkpoint writer. Any pending checkpoint is completed first.
+     */
+    ~Writer() noexcept;
+
+    /**
+     * @brief Save a checkpoint.
+     * 
+     *        The changed layers are copied immediately, the files are written in the background.
+     *        If the previous checkpoint is still being written, it is completed first.
+     * 
+     * @param[in] state The training state to save.
+     * 
+     * @return True if the checkpoint was started, or false if the previous checkpoint failed.
+     */
+    bool save(const State& state);
+
+    /**
+     * @brief Wait for the pending checkpoint (if any) to be written.
+     * 
+     * @return True if all checkpoints so far were written successfully, false otherwise.
+     */
+    bool wait();
+
+    /**
+     * @brief Get the number of layers written by the latest checkpoint.
+     * 
+     * @return The number of layers written by the latest checkpoint.
+     */
+    std::size_t changedLayerCount() const noexcept;
+
+    Writer()                         = delete; // No default constructor.
+    Writer(const Writer&)            = delete; // No copy constructor.
+    Writer(Writer&&)                 = delete; // No move constructor.
+    Writer& operator=(const Writer&) = delete; // No copy assignment.
+    Writer& operator=(Writer&&)      = delete; // No move assignment.
+
+private:
+    /**
+     * @brief Structure holding a snapshot of a layer's parameters.
+     */
+    struct Snapshot
+    {
+        /** Index of the layer. */
+        std::size_t index;
+
+        /** The number of nodes in the layer. */
+        std::size_t nodeCount;
+
+        /** The number of weights per node in the layer. */
+        std::size_t weightCount;
+
+        /** Bias values followed by the weights, node by node. */
+        std::vector<double> parameters;
+    };
+
+    /** The directory to store the checkpoints in. */
+    const std::string myDirectory;
+
+    /** The layers to save. */
+    const std::vector<const ml::dense_layer::DenseLayer*> myLayers;
+
+    /** Layer version at the latest checkpoint (used to detect changed layers). */
+    std::vector<std::size_t> myVersions;
+
+    /** File name of each layer in the latest checkpoint. */
+    std::vector<std::string> myFiles;
+
+    /** File name of each layer in the latest committed (successfully written) checkpoint. */
+    std::vector<std::string> myCommittedFiles;
+
+    /** Sequence number of the next checkpoint. */
+    std::size_t mySequence;
+
+    /** The number of layers written by the latest checkpoint. */
+    std::size_t myChangedCount;
+
+    /** Indicate whether the first checkpoint (which writes all layers) has been saved. */
+    bool mySaved;
+
+    /** Indicate whether all checkpoints so far were written successfully. */
+    bool myResult;
+
+    /** Result of the checkpoint being written in the background. */
+    std::future<bool> myPending;
+};
+
+/**
+ * @brief Restore the latest checkpoint from the given directory.
+ * 
+ * @param[in] directory The directory holding the checkpoints.
+ * @param[in] layers The layers to restore, in feedforward order. The dimensions must match.
+ * @param[out] state The restored training state.
+ * 
+ * @return True if the checkpoint was restored, or false on error.
+ */
+bool restore(const std::string& directory, const std::vector<ml::dense_layer::DenseLayer*>& layers,
+             State& state);
+} // namespace ml::checkpoint
@@ -1,13 +1,14 @@
 /**
  * @brief Dense layer implementation details.
  */
-#include <cmath>
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
+#include <random>
 #include <stdexcept>
 #include <vector>
 
+#include "ml/act_func.h"
 #include "ml/dense_layer/dense_layer.h"
 #include "ml/types.h"
 
@@ -15,6 +16,9 @@ namespace ml::dense_layer
 {
 namespace
 {
+/** Default number of incremental feedforwards between full recomputations. */
+constexpr std::size_t DefaultRefreshInterval{1000U};
+
 // -----------------------------------------------------------------------------
 void initRandom() noexcept
 {
@@ -40,38 +44,27 @@ double randomStartVal() noexcept
 }
 
 // -----------------------------------------------------------------------------
-double actFuncOutput(const ml::ActFunc actFunc, const double input) noexcept
+void checkParameters(const std::size_t nodeCount, const std::size_t weightCount)
 {
-    // Compute activation function output for the given input value.
-    switch (actFunc)
+    // Make sure we have at least 1 node and 1 weight per node.
+    if ((0U == nodeCount) || (0U == weightCount))
     {
-        case ml::ActFunc::Relu:
-             // ReLU: f(x) = max(0, x) - return input if positive, zero otherwise.
-             return 0.0 < input ? input : 0.0;
-        case ml::ActFunc::Tanh:
-             // Hyperbolic tangent: f(x) = tanh(x) - output range [-1, 1].
-             return std::tanh(input);
-        default:
-            std::cout << "Invalid activation function!\n";
-            return 0.0;
+        throw std::invalid_argument(
+            "Invalid dense layer parameters: nodeCount and weightCount must be > 0!");
     }
 }
 
 // -----------------------------------------------------------------------------
-double actFuncDelta(const ActFunc actFunc, const double input) noexcept
+template <typename RandomFunc>
+void initParameters(std::vector<double>& bias, std::vector<std::vector<double>>& weights,
+                    RandomFunc&& randomVal)
 {
-    // Calculate how much the activation function changes (needed for learning).
-    switch (actFunc)
+    // Initialize all biases and weights with random starting values.
+    for (std::size_t i{}; i < bias.size(); ++i)
     {
-        case ml::ActFunc::Relu:
-             // ReLU derivative: f'(x) = 1 if x > 0, else 0.
-             return 0.0 < input ? 1.0 : 0.0;
-        case ml::ActFunc::Tanh:
-             // Tanh derivative: f'(x) = 1 - tanh²(x).
-             return 1.0 - std::tanh(input) * std::tanh(input);
-        default:
-            std::cout << "Invalid activation function!\n";
-            return 0.0;
+        bias[i] = randomVal();
+
+        for (auto& weight : weights[i]) { weight = randomVal(); }
     }
 }
 } // namespace 
@@ -84,27 +77,51 @@ DenseLayer::DenseLayer(const std::size_t nodeCount, const std::size_t weightCoun
     , myBias(nodeCount, 0.0)
     , myWeights(nodeCount, std::vector<double>(weightCount, 0.0))
     , myActFunc{actFunc}
+    , mySum(nodeCount, 0.0)
+    , myInput{}
+    , myDeltaCount{}
+    , myRefreshInterval{DefaultRefreshInterval}
+    , myIncremental{false}
+    , myInputValid{false}
+    , mySumValid{false}
+    , myVersion{}
 {
     // Make sure we have at least 1 node and 1 weight per node.
-    if ((0U == nodeCount) || (0U == weightCount))
-    {
-        throw std::invalid_argument(
-            "Invalid dense layer parameters: nodeCount and weightCount must be > 0!");
-    }
+    checkParameters(nodeCount, weightCount);
 
     // Initialize the random number generator (only done once).
     initRandom();
 
     // Initialize all biases and weights with random starting values.
-    for (std::size_t i{}; i < nodeCount; ++i)
-    {
-        myBias[i] = randomStartVal();
+    initParameters(myBias, myWeights, randomStartVal);
+}
 
-        for (std::size_t j{}; j < weightCount; ++j)
-        {
-            myWeights[i][j] = randomStartVal();
-        }
-    }
+// -----------------------------------------------------------------------------
+DenseLayer::DenseLayer(const std::size_t nodeCount, const std::size_t weightCount,
+                       const ml::ActFunc actFunc, const unsigned seed)
+    : myOutput(nodeCount, 0.0)
+    , myError(nodeCount, 0.0)
+    , myBias(nodeCount, 0.0)
+    , myWeights(nodeCount, std::vector<double>(weightCount, 0.0))
+    , myActFunc{actFunc}
+    , mySum(nodeCount, 0.0)
+    , myInput{}
+    , myDeltaCount{}
+    , myRefreshInterval{DefaultRefreshInterval}
+    , myIncremental{false}
+    , myInputValid{false}
+    , mySumValid{false}
+    , myVersion{}
+{
+    // Make sure we have at least 1 node and 1 weight per node.
+    checkParameters(nodeCount, weightCount);
+
+    // Use a local generator so that the same seed always yields the same starting values.
+    std::mt19937 generator{seed};
+    std::uniform_real_distribution<double> distribution{0.0, 1.0};
+
+    // Initialize all biases and weights with random values in range [0.0, 1.0].
+    initParameters(myBias, myWeights, [&]() { return distribution(generator); });
 }
 
 // -----------------------------------------------------------------------------
@@ -149,6 +166,20 @@ const std::vector<std::vector<double>>& DenseLayer::weights() const noexcept
     return myWeights;
 }
 
+// -----------------------------------------------------------------------------
+ml::ActFunc DenseLayer::actFunc() const noexcept
+{
+    // Return the activation function used in this layer.
+    return myActFunc;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t DenseLayer::version() const noexcept
+{
+    // Return the number of times the parameters have been changed.
+    return myVersion;
+}
+
 // -----------------------------------------------------------------------------
 bool DenseLayer::feedforward(const std::vector<double>& input) noexcept 
 {
@@ -160,6 +191,89 @@ bool DenseLayer::feedforward(const std::vector<double>& input) noexcept
         return false;
     }
 
+    // Store the input for incremental feedforward only if enabled, since the copy is wasted
+    // otherwise; then compute the output value for each node in this layer.
+    if (myIncremental)
+    {
+        myInput      = input;
+        myInputValid = true;
+    }
+    computeOutput(input);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool DenseLayer::feedforward(const std::vector<std::size_t>& indices,
+                             const std::vector<double>& deltas) noexcept
+{
+    // Make sure a full feedforward has been performed with incremental feedforward enabled.
+    if (!myInputValid)
+    {
+        std::cout << "Incremental feedforward requires a preceding full feedforward!\n";
+        return false;
+    }
+
+    // Validate that each changed input has a corresponding delta and a valid index.
+    if (indices.size() != deltas.size())
+    {
+        std::cout << "Delta dimension mismatch: expected " << indices.size() 
+                  << ", actual: " << deltas.size() << "!\n"; 
+        return false;
+    }
+    for (const auto& index : indices)
+    {
+        if (index >= weightCount())
+        {
+            std::cout << "Invalid input index " << index << "!\n";
+            return false;
+        }
+    }
+
+    // Apply the changes to the stored input.
+    for (std::size_t k{}; k < indices.size(); ++k) { myInput[indices[k]] += deltas[k]; }
+
+    // Recompute everything if the sums are stale or the refresh interval has been reached.
+    if (!mySumValid || (myDeltaCount >= myRefreshInterval))
+    {
+        computeOutput(myInput);
+        return true;
+    }
+
+    // Only add the contributions of the changed inputs to the stored sums.
+    for (std::size_t i{}; i < nodeCount(); ++i)
+    {
+        auto sum{mySum[i]};
+
+        for (std::size_t k{}; k < indices.size(); ++k)
+        {
+            sum += deltas[k] * myWeights[i][indices[k]];
+        }
+        mySum[i]    = sum;
+        myOutput[i] = actFuncOutput(myActFunc, sum);
+    }
+    ++myDeltaCount;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void DenseLayer::setIncremental(const bool enable) noexcept
+{
+    // Allocate the stored input only when needed, a full feedforward must then fill it.
+    myIncremental = enable;
+    myInputValid  = false;
+    myInput.resize(enable ? weightCount() : 0U);
+}
+
+// -----------------------------------------------------------------------------
+void DenseLayer::setRefreshInterval(const std::size_t refreshInterval) noexcept
+{
+    // Ignore invalid intervals, since at least one incremental feedforward must be allowed.
+    if (0U < refreshInterval) { myRefreshInterval = refreshInterval; }
+}
+
+// -----------------------------------------------------------------------------
+void DenseLayer::computeOutput(const std::vector<double>& input) noexcept
+{
     // Compute the output value for each node in this layer.
     for (std::size_t i{}; i < nodeCount(); ++i)
     {
@@ -171,10 +285,15 @@ bool DenseLayer::feedforward(const std::vector<double>& input) noexcept
         {
             sum += input[j] * myWeights[i][j];
         }
+        // Store the sum for incremental feedforward.
+        mySum[i] = sum;
+
         // Pass the sum through the activation function to get the final output.
         myOutput[i] = actFuncOutput(myActFunc, sum);
     }
-    return true;
+    // The stored sums are now exact, restart the drift counter.
+    myDeltaCount = 0U;
+    mySumValid   = true;
 }
 
 // -----------------------------------------------------------------------------
@@ -260,7 +379,44 @@ bool DenseLayer::optimize(const std::vector<double>& input, const double learnin
             myWeights[i][j] += myError[i] * learningRate * input[j];
         }
     }
+    // The stored sums no longer match the weights, recompute on next incremental feedforward.
+    mySumValid = false;
+
+    // Increment the version to indicate that the parameters have been changed.
+    ++myVersion;
+
     // Return true to indicate success.
     return true;
 }
+
+// -----------------------------------------------------------------------------
+bool DenseLayer::setParameters(const std::vector<double>& bias,
+                               const std::vector<std::vector<double>>& weights) noexcept
+{
+    // Validate that the parameters match the dimensions of this layer.
+    if ((bias.size() != nodeCount()) || (weights.size() != nodeCount()))
+    {
+        std::cout << "Parameter dimension mismatch: expected " << nodeCount() 
+                  << " nodes!\n"; 
+        return false;
+    }
+    for (const auto& nodeWeights : weights)
+    {
+        if (nodeWeights.size() != weightCount())
+        {
+            std::cout << "Parameter dimension mismatch: expected " << weightCount() 
+                      << " weights per node, actual: " << nodeWeights.size() << "!\n"; 
+            return false;
+        }
+    }
+
+    // Copy the parameters (the vectors keep their allocated memory).
+    myBias = bias;
+    for (std::size_t i{}; i < nodeCount(); ++i) { myWeights[i] = weights[i]; }
+
+    // The parameters have been changed, invalidate the stored sums and increment the version.
+    mySumValid = false;
+    ++myVersion;
+    return true;
+}
 } // namespace ml::dense_layer
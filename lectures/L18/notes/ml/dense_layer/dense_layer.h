@@ -26,6 +26,20 @@ public:
     explicit DenseLayer(const std::size_t nodeCount, const std::size_t weightCount,
                         const ml::ActFunc actFunc = ml::ActFunc::Relu);
 
+    /**
+     * @brief Create a new dense layer with reproducible starting values.
+     *
+     *        The bias and weight values are generated from the given seed rather than from the
+     *        global random generator, which makes it safe to create layers in multiple threads.
+     *
+     * @param[in] nodeCount The number of nodes in the layer. Must exceed 0.
+     * @param[in] weightCount The number of weights in the layer. Must exceed 0.
+     * @param[in] actFunc The activation to use for this layer.
+     * @param[in] seed Seed used to generate the starting values.
+     */
+    explicit DenseLayer(const std::size_t nodeCount, const std::size_t weightCount,
+                        const ml::ActFunc actFunc, const unsigned seed);
+
     /**
      * @brief Delete the dense layer.
      */
@@ -73,6 +87,23 @@ public:
      */
     const std::vector<std::vector<double>>& weights() const noexcept override;
 
+    /**
+     * @brief Get the activation function of the dense layer.
+     * 
+     * @return The activation function of the dense layer.
+     */
+    ml::ActFunc actFunc() const noexcept;
+
+    /**
+     * @brief Get the parameter version of the dense layer.
+     * 
+     *        The version is incremented every time the bias or weight values are changed, which
+     *        makes it possible to detect when results computed by the layer have become stale.
+     * 
+     * @return The parameter version of the dense layer.
+     */
+    std::size_t version() const noexcept;
+
     /**
      * @brief Perform feedforward with the given input.
      * 
@@ -114,6 +145,55 @@ public:
      */
     bool optimize(const std::vector<double>& input, const double learningRate) noexcept override;
 
+    /**
+     * @brief Perform feedforward when only a few input values have changed.
+     * 
+     *        The weighted sums of the previous feedforward are kept, so only the contributions of 
+     *        the changed inputs are updated, i.e. O(changed inputs x nodes) instead of 
+     *        O(weights x nodes). To bound floating-point drift, a full feedforward is performed 
+     *        every refresh interval, as well as after the weights have been changed via optimize.
+     * 
+     *        Incremental feedforward must have been enabled via setIncremental, and a full
+     *        feedforward must have been performed since, before this method is used.
+     * 
+     * @param[in] indices Indices of the changed input values.
+     * @param[in] deltas The change of each input value (new value - previous value).
+     * 
+     * @return True if feedforward was performed, or false on error.
+     */
+    bool feedforward(const std::vector<std::size_t>& indices,
+                     const std::vector<double>& deltas) noexcept;
+
+    /**
+     * @brief Replace the bias and weight values of the dense layer.
+     * 
+     *        Used to restore trained parameters, e.g. after parallel training or from a file.
+     * 
+     * @param[in] bias The new bias values, one per node.
+     * @param[in] weights The new weights, one vector of weightCount() values per node.
+     * 
+     * @return True if the parameters were replaced, or false on dimension mismatch.
+     */
+    bool setParameters(const std::vector<double>& bias,
+                       const std::vector<std::vector<double>>& weights) noexcept;
+
+    /**
+     * @brief Enable or disable incremental feedforward (disabled by default).
+     * 
+     *        When enabled, every full feedforward keeps a copy of the input, which incremental
+     *        feedforward builds upon. When disabled, this copy is skipped.
+     * 
+     * @param[in] enable True to enable incremental feedforward, false to disable it.
+     */
+    void setIncremental(const bool enable) noexcept;
+
+    /**
+     * @brief Set the number of incremental feedforwards between full recomputations.
+     * 
+     * @param[in] refreshInterval The refresh interval. Must exceed 0.
+     */
+    void setRefreshInterval(const std::size_t refreshInterval) noexcept;
+
     DenseLayer()                             = delete; // No default constructor.
     DenseLayer(const DenseLayer&)            = delete; // No copy constructor.
     DenseLayer(DenseLayer&&)                 = delete; // No move constructor.
@@ -121,6 +201,13 @@ public:
     DenseLayer& operator=(DenseLayer&&)      = delete; // No move assignment.
 
 private:
+    /**
+     * @brief Compute the weighted sums and the output values from the given input.
+     * 
+     * @param[in] input Input values with which to compute the output.
+     */
+    void computeOutput(const std::vector<double>& input) noexcept;
+
     /** Vector holding the node outputs. */
     std::vector<double> myOutput;
 
@@ -135,5 +222,29 @@ private:
 
     /** The activation function to use in this layer. */
     const ml::ActFunc myActFunc;
+
+    /** Vector holding the weighted sums (before activation) of the latest feedforward. */
+    std::vector<double> mySum;
+
+    /** Vector holding the input values of the latest feedforward (incremental mode only). */
+    std::vector<double> myInput;
+
+    /** The number of incremental feedforwards since the latest full feedforward. */
+    std::size_t myDeltaCount;
+
+    /** The number of incremental feedforwards between full recomputations. */
+    std::size_t myRefreshInterval;
+
+    /** Indicate whether incremental feedforward is enabled. */
+    bool myIncremental;
+
+    /** Indicate whether the stored input holds the input of the latest feedforward. */
+    bool myInputValid;
+
+    /** Indicate whether the stored weighted sums match the current weights and input. */
+    bool mySumValid;
+
+    /** Parameter version, incremented every time the bias or weight values are changed. */
+    std::size_t myVersion;
 };
 } // namespace ml::dense_layer
\ No newline at end of file
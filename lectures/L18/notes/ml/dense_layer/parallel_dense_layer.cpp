@@ -0,0 +1,205 @@
+/**
+ * @brief Parallel dense layer implementation details.
+ */
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "ml/act_func.h"
+#include "ml/dense_layer/parallel_dense_layer.h"
+
+namespace ml::dense_layer
+{
+// -----------------------------------------------------------------------------
+ParallelDenseLayer::ParallelDenseLayer(const std::size_t nodeCount, const std::size_t weightCount,
+                                       ml::utils::WorkStealingPool& pool,
+                                       const ml::ActFunc actFunc, const unsigned seed)
+    : myPool{pool}
+    , myOutput(nodeCount, 0.0)
+    , myError(nodeCount, 0.0)
+    , myBias(nodeCount, 0.0)
+    , myWeights(nodeCount)
+    , myActFunc{actFunc}
+    , myShardCount{std::min(nodeCount, pool.threadCount())}
+{
+    // Make sure we have at least 1 node and 1 weight per node.
+    if ((0U == nodeCount) || (0U == weightCount))
+    {
+        throw std::invalid_argument(
+            "Invalid dense layer parameters: nodeCount and weightCount must be > 0!");
+    }
+
+    // Reserve the task slots of a run, so that the noexcept passes never allocate memory.
+    myPool.reserve(myShardCount);
+
+    // Generate the starting values in the same order as DenseLayer, one shard at a time.
+    std::mt19937 generator{seed};
+    std::uniform_real_distribution<double> distribution{0.0, 1.0};
+    std::vector<double> values{};
+
+    for (std::size_t shard{}; shard < myShardCount; ++shard)
+    {
+        const auto begin{shardBegin(shard)}, end{shardBegin(shard + 1U)};
+        values.resize((end - begin) * (weightCount + 1U));
+        for (auto& value : values) { value = distribution(generator); }
+
+        // Let the owner of the shard allocate and write the weights (first touch).
+        myPool.runOnEach([&](const std::size_t worker) {
+            if (shard % myPool.threadCount() != worker) { return; }
+            auto value{values.begin()};
+
+            for (auto i{begin}; i < end; ++i)
+            {
+                myBias[i] = *value++;
+                myWeights[i].assign(value, value + weightCount);
+                value += weightCount;
+            }
+        });
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t ParallelDenseLayer::nodeCount() const noexcept { return myOutput.size(); }
+
+// -----------------------------------------------------------------------------
+std::size_t ParallelDenseLayer::weightCount() const noexcept { return myWeights[0U].size(); }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& ParallelDenseLayer::output() const noexcept { return myOutput; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& ParallelDenseLayer::error() const noexcept { return myError; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& ParallelDenseLayer::bias() const noexcept { return myBias; }
+
+// -----------------------------------------------------------------------------
+const std::vector<std::vector<double>>& ParallelDenseLayer::weights() const noexcept
+{
+    return myWeights;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t ParallelDenseLayer::shardCount() const noexcept { return myShardCount; }
+
+// -----------------------------------------------------------------------------
+bool ParallelDenseLayer::feedforward(const std::vector<double>& input) noexcept
+{
+    // Validate that we have the correct number of inputs.
+    if (input.size() != weightCount())
+    {
+        std::cout << "Input dimension mismatch: expected " << weightCount()
+                  << ", actual: " << input.size() << "!\n";
+        return false;
+    }
+
+    // Compute the output of the nodes of each shard in parallel.
+    myPool.run(myShardCount, [&](const std::size_t shard) {
+        for (auto i{shardBegin(shard)}; i < shardBegin(shard + 1U); ++i)
+        {
+            const auto& weights{myWeights[i]};
+            auto sum{myBias[i]};
+
+            for (std::size_t j{}; j < input.size(); ++j) { sum += input[j] * weights[j]; }
+            myOutput[i] = ml::actFuncOutput(myActFunc, sum);
+        }
+    });
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ParallelDenseLayer::backpropagate(const std::vector<double>& reference) noexcept
+{
+    // Validate reference vector size matches number of output nodes.
+    if (reference.size() != nodeCount())
+    {
+        std::cout << "Output dimension mismatch: expected " << nodeCount()
+                  << ", actual: " << reference.size() << "!\n";
+        return false;
+    }
+
+    // Compute the output errors of each shard in parallel.
+    myPool.run(myShardCount, [&](const std::size_t shard) {
+        for (auto i{shardBegin(shard)}; i < shardBegin(shard + 1U); ++i)
+        {
+            myError[i] = (reference[i] - myOutput[i]) * ml::actFuncDelta(myActFunc, myOutput[i]);
+        }
+    });
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ParallelDenseLayer::backpropagate(const Interface& nextLayer) noexcept
+{
+    // Validate that the layers connect properly.
+    if (nextLayer.weightCount() != nodeCount())
+    {
+        std::cout << "Layer dimension mismatch: expected " << nodeCount()
+                  << ", actual: " << nextLayer.weightCount() << "!\n";
+        return false;
+    }
+
+    // Compute the errors of the nodes of each shard in parallel.
+    const auto& nextError{nextLayer.error()};
+    const auto& nextWeights{nextLayer.weights()};
+
+    myPool.run(myShardCount, [&](const std::size_t shard) {
+        const auto begin{shardBegin(shard)}, end{shardBegin(shard + 1U)};
+        std::fill(myError.begin() + begin, myError.begin() + end, 0.0);
+
+        // Traverse the weights of the next layer row by row, only reading this shard's columns.
+        for (std::size_t k{}; k < nextError.size(); ++k)
+        {
+            const auto& weights{nextWeights[k]};
+            for (auto i{begin}; i < end; ++i) { myError[i] += nextError[k] * weights[i]; }
+        }
+        for (auto i{begin}; i < end; ++i)
+        {
+            myError[i] *= ml::actFuncDelta(myActFunc, myOutput[i]);
+        }
+    });
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ParallelDenseLayer::optimize(const std::vector<double>& input,
+                                  const double learningRate) noexcept
+{
+    // Validate learning rate and input dimensions.
+    if (0.0 >= learningRate)
+    {
+        std::cout << "Invalid learning rate " << learningRate << "!\n";
+        return false;
+    }
+    if (input.size() != weightCount())
+    {
+        std::cout << "Input dimension mismatch: expected " << weightCount()
+                  << ", actual: " << input.size() << "!\n";
+        return false;
+    }
+
+    // Update the parameters of each shard in parallel.
+    myPool.run(myShardCount, [&](const std::size_t shard) {
+        for (auto i{shardBegin(shard)}; i < shardBegin(shard + 1U); ++i)
+        {
+            auto& weights{myWeights[i]};
+            myBias[i] += myError[i] * learningRate;
+
+            for (std::size_t j{}; j < input.size(); ++j)
+            {
+                weights[j] += myError[i] * learningRate * input[j];
+            }
+        }
+    });
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t ParallelDenseLayer::shardBegin(const std::size_t shard) const noexcept
+{
+    // Divide the nodes as evenly as possible.
+    return shard * nodeCount() / myShardCount;
+}
+} // namespace ml::dense_layer
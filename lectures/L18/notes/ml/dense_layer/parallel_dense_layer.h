@@ -0,0 +1,173 @@
+/**
+ * @brief Dense layer with the nodes split across worker threads.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "ml/dense_layer/interface.h"
+#include "ml/types.h"
+#include "ml/utils/work_stealing_pool.h"
+
+namespace ml::dense_layer
+{
+/**
+ * @brief Dense layer with the nodes split across worker threads (intra-layer model parallelism).
+ * 
+ *        The nodes are divided into one contiguous shard per worker of a work-stealing pool.
+ *        Feedforward, backpropagation and optimization process each shard as a separate task,
+ *        which is queued on the worker owning the shard. The weights of each shard are allocated
+ *        and initialized by its owner, so that they are placed in memory local to that worker
+ *        on NUMA systems (first-touch placement). The results are identical to those of a
+ *        DenseLayer created with the same seed.
+ * 
+ *        Intended for very wide layers; for small layers, the cost of dispatching the tasks
+ *        exceeds the gain.
+ */
+class ParallelDenseLayer final : public Interface
+{
+public:
+    /**
+     * @brief Create a new parallel dense layer.
+     *
+     *        The bias and weight values are generated from the given seed in the same order as
+     *        DenseLayer does, so both layer types start from the same values.
+     *
+     * @param[in] nodeCount The number of nodes in the layer. Must exceed 0.
+     * @param[in] weightCount The number of weights in the layer. Must exceed 0.
+     * @param[in] pool Pool executing the shards. Must outlive the layer.
+     * @param[in] actFunc The activation to use for this layer (default = ReLU).
+     * @param[in] seed Seed used to generate the starting values (default = 0).
+     */
+    explicit ParallelDenseLayer(const std::size_t nodeCount, const std::size_t weightCount,
+                                ml::utils::WorkStealingPool& pool,
+                                const ml::ActFunc actFunc = ml::ActFunc::Relu,
+                                const unsigned seed = 0U);
+
+    /**
+     * @brief Delete the parallel dense layer.
+     */
+    ~ParallelDenseLayer() noexcept override = default;
+
+    /**
+     * @brief Get the number of nodes in the dense layer.
+     * 
+     * @return The number of nodes in the dense layer.
+     */
+    std::size_t nodeCount() const noexcept override;
+
+    /**
+     * @brief Get the number of weights per node in the dense layer.
+     * 
+     * @return The number of weights per node in the dense layer.
+     */
+    std::size_t weightCount() const noexcept override;
+
+    /**
+     * @brief Get the output values of the dense layer.
+     * 
+     * @return Vector holding the output values of the dense layer.
+     */
+    const std::vector<double>& output() const noexcept override;
+
+    /**
+     * @brief Get the error values of the dense layer.
+     * 
+     * @return Vector holding the error values of the dense layer.
+     */
+    const std::vector<double>& error() const noexcept override;
+
+    /**
+     * @brief Get the bias values of the dense layer.
+     * 
+     * @return Vector holding the bias values of the dense layer.
+     */
+    const std::vector<double>& bias() const noexcept override;
+
+    /**
+     * @brief Get the weights of the dense layer.
+     * 
+     * @return Vector holding the weights of the dense layer.
+     */
+    const std::vector<std::vector<double>>& weights() const noexcept override;
+
+    /**
+     * @brief Get the number of shards the nodes are divided into.
+     * 
+     * @return The number of shards.
+     */
+    std::size_t shardCount() const noexcept;
+
+    /**
+     * @brief Perform feedforward with the given input.
+     * 
+     * @param[in] input Input values with which to perform feedforward.
+     * 
+     * @return True if feedforward was performed, or false on error.
+     */
+    bool feedforward(const std::vector<double>& input) noexcept override;
+
+    /**
+     * @brief Perform backpropagation with the given reference values.
+     * 
+     *        This method is appropriate for output layers only.
+     * 
+     * @param[in] reference Reference values with which to perform backpropagation.
+     * 
+     * @return True if backpropagation was performed, or false on error.
+     */
+    bool backpropagate(const std::vector<double>& reference) noexcept override;
+
+    /**
+     * @brief Perform backpropagation with the given next layer.
+     * 
+     *        This method is appropriate for hidden layers only.
+     * 
+     * @param[in] nextLayer The next consecutive layer.
+     * 
+     * @return True if backpropagation was performed, or false on error.
+     */
+    bool backpropagate(const Interface& nextLayer) noexcept override;
+
+    /**
+     * @brief Perform optimization with the given input.
+     * 
+     * @param[in] input Input values with which to perform optimization.
+     * @param[in] learningRate Learning rate to use for optimization.
+     * 
+     * @return True if optimization was performed, or false on error.
+     */
+    bool optimize(const std::vector<double>& input, const double learningRate) noexcept override;
+
+    ParallelDenseLayer()                                     = delete; // No default constructor.
+    ParallelDenseLayer(const ParallelDenseLayer&)            = delete; // No copy constructor.
+    ParallelDenseLayer(ParallelDenseLayer&&)                 = delete; // No move constructor.
+    ParallelDenseLayer& operator=(const ParallelDenseLayer&) = delete; // No copy assignment.
+    ParallelDenseLayer& operator=(ParallelDenseLayer&&)      = delete; // No move assignment.
+
+private:
+    std::size_t shardBegin(const std::size_t shard) const noexcept;
+
+    /** Pool executing the shards. */
+    ml::utils::WorkStealingPool& myPool;
+
+    /** Vector holding the node outputs. */
+    std::vector<double> myOutput;
+
+    /** Vector holding the node errors. */
+    std::vector<double> myError;
+
+    /** Vector holding the node bias values. */
+    std::vector<double> myBias;
+
+    /** Vector holding the node weights (each row allocated by the worker owning the node). */
+    std::vector<std::vector<double>> myWeights;
+
+    /** The activation function of the layer. */
+    ml::ActFunc myActFunc;
+
+    /** The number of shards the nodes are divided into. */
+    std::size_t myShardCount;
+};
+} // namespace ml::dense_layer
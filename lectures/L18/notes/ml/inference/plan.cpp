@@ -0,0 +1,301 @@
+/**
+ * @brief Frozen inference plan implementation details.
+ */
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "ml/inference/plan.h"
+
+namespace ml::inference
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+template <ml::ActFunc actFunc>
+constexpr double activate(const double input) noexcept
+{
+    // Select the activation function at compile time to avoid branching per node.
+    if constexpr (ml::ActFunc::Relu == actFunc) { return 0.0 < input ? input : 0.0; }
+    else { return std::tanh(input); }
+}
+
+// -----------------------------------------------------------------------------
+template <ml::ActFunc actFunc, std::size_t SampleCount>
+void runPanel(const double* const (&inputs)[SampleCount], double* const (&outputs)[SampleCount],
+              const double* bias, const double* panelWeights,
+              const std::size_t weightCount) noexcept
+{
+    double sum[SampleCount][PanelWidth];
+
+    // Start with the bias values of the nodes in the panel.
+    for (std::size_t s{}; s < SampleCount; ++s)
+    {
+        for (std::size_t k{}; k < PanelWidth; ++k) { sum[s][k] = bias[k]; }
+    }
+
+    // Add the weighted inputs; the weights of each input are contiguous for all nodes, and each
+    // loaded weight is used for every sample.
+    for (std::size_t j{}; j < weightCount; ++j)
+    {
+        const double* w{panelWeights + j * PanelWidth};
+
+        for (std::size_t s{}; s < SampleCount; ++s)
+        {
+            const double x{inputs[s][j]};
+            for (std::size_t k{}; k < PanelWidth; ++k) { sum[s][k] += x * w[k]; }
+        }
+    }
+
+    // Apply the activation function before the sums leave the registers.
+    for (std::size_t s{}; s < SampleCount; ++s)
+    {
+        for (std::size_t k{}; k < PanelWidth; ++k) { outputs[s][k] = activate<actFunc>(sum[s][k]); }
+    }
+}
+
+// -----------------------------------------------------------------------------
+template <ml::ActFunc actFunc>
+void runLayer(const double* input, double* output, const double* bias, const double* weights,
+              const std::size_t weightCount, const std::size_t panelCount) noexcept
+{
+    // Compute one panel of nodes at a time.
+    for (std::size_t p{}; p < panelCount; ++p)
+    {
+        const double* inputs[1U]{input};
+        double* const outputs[1U]{output + p * PanelWidth};
+        runPanel<actFunc>(inputs, outputs, bias + p * PanelWidth,
+                          weights + p * weightCount * PanelWidth, weightCount);
+    }
+}
+
+// -----------------------------------------------------------------------------
+template <ml::ActFunc actFunc, typename InputFunc>
+void runLayerBatch(InputFunc&& inputOf, double* output, const std::size_t outputStride,
+                   const std::size_t batchSize, const double* bias, const double* weights,
+                   const std::size_t weightCount, const std::size_t panelCount) noexcept
+{
+    // Stream each panel once for the whole batch; it stays in the cache between the samples.
+    for (std::size_t p{}; p < panelCount; ++p)
+    {
+        const double* panelBias{bias + p * PanelWidth};
+        const double* panelWeights{weights + p * weightCount * PanelWidth};
+        std::size_t b{};
+
+        // Compute two samples per pass, so that each weight is loaded once for both.
+        for (; b + 1U < batchSize; b += 2U)
+        {
+            const double* inputs[2U]{inputOf(b), inputOf(b + 1U)};
+            double* const outputs[2U]{output + b * outputStride + p * PanelWidth,
+                                      output + (b + 1U) * outputStride + p * PanelWidth};
+            runPanel<actFunc>(inputs, outputs, panelBias, panelWeights, weightCount);
+        }
+
+        // Compute the last sample if the batch size is odd.
+        if (b < batchSize)
+        {
+            const double* inputs[1U]{inputOf(b)};
+            double* const outputs[1U]{output + b * outputStride + p * PanelWidth};
+            runPanel<actFunc>(inputs, outputs, panelBias, panelWeights, weightCount);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+template <typename InputFunc>
+void runLayerBatch(const ml::ActFunc actFunc, InputFunc&& inputOf, double* output,
+                   const std::size_t outputStride, const std::size_t batchSize,
+                   const double* bias, const double* weights, const std::size_t weightCount,
+                   const std::size_t panelCount) noexcept
+{
+    // Dispatch once per layer to the kernel with the activation function fused.
+    switch (actFunc)
+    {
+        case ml::ActFunc::Relu:
+            runLayerBatch<ml::ActFunc::Relu>(inputOf, output, outputStride, batchSize, bias,
+                                             weights, weightCount, panelCount);
+            break;
+        case ml::ActFunc::Tanh:
+            runLayerBatch<ml::ActFunc::Tanh>(inputOf, output, outputStride, batchSize, bias,
+                                             weights, weightCount, panelCount);
+            break;
+    }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+Plan::Plan(std::vector<Layer> layers)
+    : myLayers{std::move(layers)}
+    , myScratchSize{scratchSizeOf(myLayers)}
+{}
+
+// -----------------------------------------------------------------------------
+std::size_t Plan::inputCount() const noexcept { return myLayers.front().weightCount; }
+
+// -----------------------------------------------------------------------------
+std::size_t Plan::outputCount() const noexcept { return myLayers.back().nodeCount; }
+
+// -----------------------------------------------------------------------------
+std::size_t Plan::layerCount() const noexcept { return myLayers.size(); }
+
+// -----------------------------------------------------------------------------
+std::size_t Plan::scratchSize() const noexcept { return myScratchSize; }
+
+// -----------------------------------------------------------------------------
+std::size_t Plan::scratchSize(const std::size_t batchSize) const noexcept
+{
+    return myScratchSize * batchSize;
+}
+
+// -----------------------------------------------------------------------------
+void Plan::predict(const double* input, double* output, double* scratch) const noexcept
+{
+    // Alternate between the two halves of the scratch buffer.
+    double* buffers[2U]{scratch, scratch + myScratchSize / 2U};
+    const double* layerInput{input};
+
+    for (std::size_t i{}; i < myLayers.size(); ++i)
+    {
+        const auto& layer{myLayers[i]};
+        double* layerOutput{buffers[i % 2U]};
+
+        // Dispatch once per layer to the kernel with the activation function fused.
+        switch (layer.actFunc)
+        {
+            case ml::ActFunc::Relu:
+                runLayer<ml::ActFunc::Relu>(layerInput, layerOutput, layer.bias.data(),
+                                            layer.weights.data(), layer.weightCount,
+                                            layer.panelCount);
+                break;
+            case ml::ActFunc::Tanh:
+                runLayer<ml::ActFunc::Tanh>(layerInput, layerOutput, layer.bias.data(),
+                                            layer.weights.data(), layer.weightCount,
+                                            layer.panelCount);
+                break;
+        }
+        layerInput = layerOutput;
+    }
+    // Copy the output values without the panel padding.
+    std::copy(layerInput, layerInput + outputCount(), output);
+}
+
+// -----------------------------------------------------------------------------
+void Plan::predict(const double* const* inputs, double* const* outputs,
+                   const std::size_t batchSize, double* scratch) const noexcept
+{
+    // Alternate between the two halves of the scratch buffer, each holding one row per sample.
+    const auto stride{myScratchSize / 2U};
+    double* buffers[2U]{scratch, scratch + stride * batchSize};
+
+    for (std::size_t i{}; i < myLayers.size(); ++i)
+    {
+        const auto& layer{myLayers[i]};
+        const double* layerInput{buffers[(i + 1U) % 2U]};
+
+        // The first layer reads the caller's inputs, the other layers the previous layer's rows.
+        if (0U == i)
+        {
+            runLayerBatch(layer.actFunc, [inputs](const std::size_t b) { return inputs[b]; },
+                          buffers[i % 2U], stride, batchSize, layer.bias.data(),
+                          layer.weights.data(), layer.weightCount, layer.panelCount);
+        }
+        else
+        {
+            runLayerBatch(layer.actFunc,
+                          [layerInput, stride](const std::size_t b) {
+                              return layerInput + b * stride;
+                          },
+                          buffers[i % 2U], stride, batchSize, layer.bias.data(),
+                          layer.weights.data(), layer.weightCount, layer.panelCount);
+        }
+    }
+    // Copy the output values without the panel padding.
+    const double* result{buffers[(myLayers.size() - 1U) % 2U]};
+    for (std::size_t b{}; b < batchSize; ++b)
+    {
+        std::copy(result + b * stride, result + b * stride + outputCount(), outputs[b]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool Plan::predict(const std::vector<double>& input, std::vector<double>& output,
+                   std::vector<double>& scratch) const
+{
+    // Validate that we have the correct number of inputs.
+    if (input.size() != inputCount())
+    {
+        std::cout << "Input dimension mismatch: expected " << inputCount() 
+                  << ", actual: " << input.size() << "!\n"; 
+        return false;
+    }
+    // Make sure the buffers are large enough, then predict.
+    output.resize(outputCount());
+    if (scratch.size() < myScratchSize) { scratch.resize(myScratchSize); }
+    predict(input.data(), output.data(), scratch.data());
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Plan::scratchSizeOf(const std::vector<Layer>& layers) noexcept
+{
+    // Two buffers are required, since each layer reads the output of the previous one.
+    std::size_t maxCount{};
+    for (const auto& layer : layers)
+    {
+        maxCount = std::max(maxCount, layer.panelCount * PanelWidth);
+    }
+    return 2U * maxCount;
+}
+
+// -----------------------------------------------------------------------------
+Plan Plan::freeze(const std::vector<const ml::dense_layer::DenseLayer*>& layers)
+{
+    // Make sure the layers are valid and properly connected.
+    if (layers.empty())
+    {
+        throw std::invalid_argument("Cannot freeze inference plan: no layers given!");
+    }
+    for (std::size_t i{}; i < layers.size(); ++i)
+    {
+        if ((nullptr == layers[i]) ||
+            ((0U < i) && (layers[i]->weightCount() != layers[i - 1U]->nodeCount())))
+        {
+            throw std::invalid_argument("Cannot freeze inference plan: layer mismatch!");
+        }
+    }
+
+    std::vector<Layer> compiled{};
+    compiled.reserve(layers.size());
+
+    // Pack the parameters of each layer, pad the node count to a multiple of the panel width.
+    for (const auto* layer : layers)
+    {
+        const auto nodeCount{layer->nodeCount()};
+        const auto weightCount{layer->weightCount()};
+        const auto panelCount{(nodeCount + PanelWidth - 1U) / PanelWidth};
+
+        Layer packed{nodeCount, weightCount, panelCount, layer->actFunc(),
+                     std::vector<double>(panelCount * PanelWidth, 0.0),
+                     std::vector<double>(panelCount * PanelWidth * weightCount, 0.0)};
+
+        // Padding nodes get zero weights and bias; their outputs are never read.
+        for (std::size_t i{}; i < nodeCount; ++i)
+        {
+            const auto panel{i / PanelWidth};
+            const auto lane{i % PanelWidth};
+            packed.bias[i] = layer->bias()[i];
+
+            for (std::size_t j{}; j < weightCount; ++j)
+            {
+                packed.weights[(panel * weightCount + j) * PanelWidth + lane] = 
+                    layer->weights()[i][j];
+            }
+        }
+        compiled.push_back(std::move(packed));
+    }
+    return Plan{std::move(compiled)};
+}
+} // namespace ml::inference
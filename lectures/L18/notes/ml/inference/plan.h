@@ -0,0 +1,168 @@
+/**
+ * @brief Frozen inference plan for trained dense layers.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "ml/dense_layer/dense_layer.h"
+#include "ml/types.h"
+
+namespace ml::inference
+{
+/** The number of doubles per SIMD register, detected at compile time. */
+#if defined(__AVX512F__)
+constexpr std::size_t SimdWidth{8U};
+#elif defined(__AVX__)
+constexpr std::size_t SimdWidth{4U};
+#elif defined(__SSE2__) || defined(__ARM_NEON)
+constexpr std::size_t SimdWidth{2U};
+#else
+constexpr std::size_t SimdWidth{1U};
+#endif
+
+/** The number of nodes computed together (two registers to hide the latency of the additions). */
+constexpr std::size_t PanelWidth{2U * SimdWidth};
+
+/**
+ * @brief Immutable inference plan compiled from trained dense layers.
+ * 
+ *        The plan holds no training state (errors, gradients) and uses no virtual calls.
+ *        The weights are packed in panels of PanelWidth nodes, so that the weights of all nodes
+ *        in a panel connected to the same input are stored next to each other. The activation
+ *        function is applied directly when each panel is finished.
+ * 
+ *        The plan is read-only after creation and may be shared between threads, as long as
+ *        each thread uses its own scratch buffer.
+ */
+class Plan final
+{
+public:
+    /**
+     * @brief Get the number of input values of the plan.
+     * 
+     * @return The number of input values.
+     */
+    std::size_t inputCount() const noexcept;
+
+    /**
+     * @brief Get the number of output values of the plan.
+     * 
+     * @return The number of output values.
+     */
+    std::size_t outputCount() const noexcept;
+
+    /**
+     * @brief Get the number of layers in the plan.
+     * 
+     * @return The number of layers.
+     */
+    std::size_t layerCount() const noexcept;
+
+    /**
+     * @brief Get the number of doubles required in the scratch buffer.
+     * 
+     * @return The required scratch size.
+     */
+    std::size_t scratchSize() const noexcept;
+
+    /**
+     * @brief Get the number of doubles required in the scratch buffer for batch prediction.
+     * 
+     * @param[in] batchSize The number of samples in the batch.
+     * 
+     * @return The required scratch size.
+     */
+    std::size_t scratchSize(std::size_t batchSize) const noexcept;
+
+    /**
+     * @brief Perform prediction with the given input.
+     * 
+     * @param[in] input Pointer to inputCount() input values.
+     * @param[out] output Pointer to room for outputCount() output values.
+     * @param[in] scratch Pointer to a scratch buffer holding at least scratchSize() values.
+     */
+    void predict(const double* input, double* output, double* scratch) const noexcept;
+
+    /**
+     * @brief Perform prediction with a batch of inputs.
+     * 
+     *        Each weight panel is streamed from memory once for the whole batch instead of once
+     *        per sample, and two samples are computed per pass over the panel. The results are
+     *        identical to predicting the samples one at a time.
+     * 
+     * @param[in] inputs Pointers to the inputs, each holding inputCount() values.
+     * @param[out] outputs Pointers to room for outputCount() output values per sample.
+     * @param[in] batchSize The number of samples in the batch.
+     * @param[in] scratch Pointer to a scratch buffer holding at least scratchSize(batchSize)
+     *                    values.
+     */
+    void predict(const double* const* inputs, double* const* outputs, std::size_t batchSize,
+                 double* scratch) const noexcept;
+
+    /**
+     * @brief Perform prediction with the given input.
+     * 
+     * @param[in] input Input values with which to predict.
+     * @param[out] output Vector to store the predicted output values in.
+     * @param[in] scratch Scratch buffer, resized if necessary.
+     * 
+     * @return True if prediction was performed, or false on error.
+     */
+    bool predict(const std::vector<double>& input, std::vector<double>& output,
+                 std::vector<double>& scratch) const;
+
+    /**
+     * @brief Compile an inference plan from the given layers.
+     * 
+     * @param[in] layers The layers to compile, in feedforward order. Each layer's weight count
+     *                   must match the node count of the previous layer.
+     * 
+     * @return The compiled inference plan.
+     */
+    static Plan freeze(const std::vector<const ml::dense_layer::DenseLayer*>& layers);
+
+    Plan()                       = delete;  // No default constructor.
+    Plan(const Plan&)            = default; // Copy constructor.
+    Plan(Plan&&)                 = default; // Move constructor.
+    Plan& operator=(const Plan&) = delete;  // No copy assignment.
+    Plan& operator=(Plan&&)      = delete;  // No move assignment.
+    ~Plan() noexcept             = default; // Destructor.
+
+private:
+    /**
+     * @brief Structure holding a compiled layer.
+     */
+    struct Layer
+    {
+        /** The number of nodes in the layer. */
+        std::size_t nodeCount;
+
+        /** The number of weights per node in the layer. */
+        std::size_t weightCount;
+
+        /** The number of panels in the layer. */
+        std::size_t panelCount;
+
+        /** The activation function of the layer. */
+        ml::ActFunc actFunc;
+
+        /** Bias values, padded to a multiple of PanelWidth. */
+        std::vector<double> bias;
+
+        /** Packed weights: [panel][weight][node in panel]. */
+        std::vector<double> weights;
+    };
+
+    explicit Plan(std::vector<Layer> layers);
+
+    static std::size_t scratchSizeOf(const std::vector<Layer>& layers) noexcept;
+
+    /** The compiled layers. */
+    const std::vector<Layer> myLayers;
+
+    /** The number of doubles required in the scratch buffer. */
+    const std::size_t myScratchSize;
+};
+} // namespace ml::inference
@@ -0,0 +1,57 @@
+/**
+ * @brief Neural network interface.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace ml::neural_network
+{
+/**
+ * @brief Neural network interface.
+ */
+class Interface
+{
+public:
+    /**
+     * @brief Delete the neural network.
+     * 
+     * @note This destructor is defined to link to the destructor of the subclass.
+     */
+    virtual ~Interface() noexcept = default;
+
+    /**
+     * @brief Get the number of inputs of the neural network.
+     * 
+     * @return The number of inputs of the neural network.
+     */
+    virtual std::size_t inputCount() const noexcept = 0;
+
+    /**
+     * @brief Get the number of outputs of the neural network.
+     * 
+     * @return The number of outputs of the neural network.
+     */
+    virtual std::size_t outputCount() const noexcept = 0;
+
+    /**
+     * @brief Perform prediction with the given input.
+     * 
+     * @param[in] input Input values with which to perform prediction.
+     * 
+     * @return Vector holding the predicted output values, or an empty vector on error.
+     */
+    virtual const std::vector<double>& predict(const std::vector<double>& input) noexcept = 0;
+
+    /**
+     * @brief Train the neural network with the stored training data.
+     * 
+     * @param[in] epochCount The number of epochs to train.
+     * @param[in] learningRate Learning rate to use for training.
+     * 
+     * @return True if training was performed, or false on error.
+     */
+    virtual bool train(const std::size_t epochCount, const double learningRate) noexcept = 0;
+};
+} // namespace ml::neural_network
@@ -0,0 +1,75 @@
+/**
+ * @brief Neural network with a single hidden layer implementation details.
+ */
+#include <stdexcept>
+#include <vector>
+
+#include "ml/neural_network/single_layer.h"
+
+namespace ml::neural_network
+{
+// -----------------------------------------------------------------------------
+SingleLayer::SingleLayer(dense_layer::Interface& hiddenLayer, dense_layer::Interface& outputLayer,
+                         const std::vector<std::vector<double>>& trainInput,
+                         const std::vector<std::vector<double>>& trainOutput)
+    : myHiddenLayer{hiddenLayer}
+    , myOutputLayer{outputLayer}
+    , myTrainInput{trainInput}
+    , myTrainOutput{trainOutput}
+    , myEmpty{}
+{
+    // Make sure the layers fit together and every training input has a reference.
+    if (hiddenLayer.nodeCount() != outputLayer.weightCount())
+    {
+        throw std::invalid_argument("Invalid neural network parameters: layer mismatch!");
+    }
+    if (trainInput.size() != trainOutput.size())
+    {
+        throw std::invalid_argument("Invalid neural network parameters: training data mismatch!");
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t SingleLayer::inputCount() const noexcept { return myHiddenLayer.weightCount(); }
+
+// -----------------------------------------------------------------------------
+std::size_t SingleLayer::outputCount() const noexcept { return myOutputLayer.nodeCount(); }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& SingleLayer::predict(const std::vector<double>& input) noexcept
+{
+    // Feed the input through both layers, return an empty vector on dimension mismatch.
+    if (!myHiddenLayer.feedforward(input) || !myOutputLayer.feedforward(myHiddenLayer.output()))
+    {
+        return myEmpty;
+    }
+    return myOutputLayer.output();
+}
+
+// -----------------------------------------------------------------------------
+bool SingleLayer::train(const std::size_t epochCount, const double learningRate) noexcept
+{
+    // Terminate the function if the parameters or the training data are unusable.
+    if ((0U == epochCount) || (0.0 >= learningRate) || myTrainInput.empty()) { return false; }
+
+    for (std::size_t epoch{}; epoch < epochCount; ++epoch)
+    {
+        for (std::size_t i{}; i < myTrainInput.size(); ++i)
+        {
+            const auto& input{myTrainInput[i]};
+
+            // Feedforward, compute the errors backwards, then adjust the parameters.
+            if (!myHiddenLayer.feedforward(input) ||
+                !myOutputLayer.feedforward(myHiddenLayer.output()) ||
+                !myOutputLayer.backpropagate(myTrainOutput[i]) ||
+                !myHiddenLayer.backpropagate(myOutputLayer) ||
+                !myHiddenLayer.optimize(input, learningRate) ||
+                !myOutputLayer.optimize(myHiddenLayer.output(), learningRate))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+} // namespace ml::neural_network
@@ -0,0 +1,96 @@
+/**
+ * @brief Neural network with a single hidden layer.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "ml/dense_layer/interface.h"
+#include "ml/neural_network/interface.h"
+
+namespace ml::neural_network
+{
+/**
+ * @brief Neural network with a single hidden layer.
+ * 
+ *        The layers are owned by the caller. Training is performed sample by sample in the order
+ *        of the training data, so that two networks with identical parameters stay identical
+ *        when trained with the same data.
+ */
+class SingleLayer final : public Interface
+{
+public:
+    /**
+     * @brief Create a new neural network.
+     * 
+     * @param[in] hiddenLayer The hidden layer of the network. Must outlive the network.
+     * @param[in] outputLayer The output layer of the network. Must outlive the network.
+     * @param[in] trainInput Training input data.
+     * @param[in] trainOutput Training output data.
+     */
+    explicit SingleLayer(dense_layer::Interface& hiddenLayer, dense_layer::Interface& outputLayer,
+                         const std::vector<std::vector<double>>& trainInput,
+                         const std::vector<std::vector<double>>& trainOutput);
+
+    /**
+     * @brief Delete the neural network.
+     */
+    ~SingleLayer() noexcept override = default;
+
+    /**
+     * @brief Get the number of inputs of the neural network.
+     * 
+     * @return The number of inputs of the neural network.
+     */
+    std::size_t inputCount() const noexcept override;
+
+    /**
+     * @brief Get the number of outputs of the neural network.
+     * 
+     * @return The number of outputs of the neural network.
+     */
+    std::size_t outputCount() const noexcept override;
+
+    /**
+     * @brief Perform prediction with the given input.
+     * 
+     * @param[in] input Input values with which to perform prediction.
+     * 
+     * @return Vector holding the predicted output values, or an empty vector on error.
+     */
+    const std::vector<double>& predict(const std::vector<double>& input) noexcept override;
+
+    /**
+     * @brief Train the neural network with the stored training data.
+     * 
+     * @param[in] epochCount The number of epochs to train.
+     * @param[in] learningRate Learning rate to use for training.
+     * 
+     * @return True if training was performed, or false on error.
+     */
+    bool train(const std::size_t epochCount, const double learningRate) noexcept override;
+
+    SingleLayer()                              = delete; // No default constructor.
+    SingleLayer(const SingleLayer&)            = delete; // No copy constructor.
+    SingleLayer(SingleLayer&&)                 = delete; // No move constructor.
+    SingleLayer& operator=(const SingleLayer&) = delete; // No copy assignment.
+    SingleLayer& operator=(SingleLayer&&)      = delete; // No move assignment.
+
+private:
+    /** The hidden layer of the network. */
+    dense_layer::Interface& myHiddenLayer;
+
+    /** The output layer of the network. */
+    dense_layer::Interface& myOutputLayer;
+
+    /** Training input data. */
+    const std::vector<std::vector<double>> myTrainInput;
+
+    /** Training output data. */
+    const std::vector<std::vector<double>> myTrainOutput;
+
+    /** Empty vector returned on prediction error. */
+    const std::vector<double> myEmpty;
+};
+} // namespace ml::neural_network
@@ -0,0 +1,25 @@
+/**
+ * @brief Inference client implementation details.
+ */
+#include <unistd.h>
+
+#include "ml/serve/client.h"
+#include "ml/serve/socket.h"
+
+namespace ml::serve
+{
+// -----------------------------------------------------------------------------
+Client::Client(const Address& address)
+    : mySocket{connectTo(address)}
+{}
+
+// -----------------------------------------------------------------------------
+Client::~Client() noexcept { ::close(mySocket); }
+
+// -----------------------------------------------------------------------------
+bool Client::predict(const std::vector<double>& input, std::vector<double>& output) noexcept
+{
+    // An empty response indicates an invalid request.
+    return writeMessage(mySocket, input) && readMessage(mySocket, output) && !output.empty();
+}
+} // namespace ml::serve
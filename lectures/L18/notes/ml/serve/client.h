@@ -0,0 +1,50 @@
+/**
+ * @brief Client for the local inference server.
+ */
+#pragma once
+
+#include <vector>
+
+#include "ml/serve/server.h"
+
+namespace ml::serve
+{
+/**
+ * @brief Client connected to a local inference server.
+ */
+class Client final
+{
+public:
+    /**
+     * @brief Create a new client connected to the given address.
+     * 
+     * @param[in] address The address of the server.
+     */
+    explicit Client(const Address& address);
+
+    /**
+     * @brief Close the connection and delete the client.
+     */
+    ~Client() noexcept;
+
+    /**
+     * @brief Perform prediction on the server.
+     * 
+     * @param[in] input Input values with which to predict.
+     * @param[out] output Vector to store the predicted output values in.
+     * 
+     * @return True if prediction was performed, or false on error.
+     */
+    bool predict(const std::vector<double>& input, std::vector<double>& output) noexcept;
+
+    Client()                         = delete; // No default constructor.
+    Client(const Client&)            = delete; // No copy constructor.
+    Client(Client&&)                 = delete; // No move constructor.
+    Client& operator=(const Client&) = delete; // No copy assignment.
+    Client& operator=(Client&&)      = delete; // No move assignment.
+
+private:
+    /** The connection socket. */
+    int mySocket;
+};
+} // namespace ml::serve
@@ -0,0 +1,268 @@
+/**
+ * @brief Inference server implementation details.
+ */
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "ml/serve/server.h"
+#include "ml/serve/socket.h"
+
+namespace ml::serve
+{
+namespace
+{
+/** Interval at which the accepting thread checks whether the server is stopping. */
+constexpr int PollTimeoutMs{100};
+
+// -----------------------------------------------------------------------------
+const Config& checkConfig(const Config& config)
+{
+    if ((0U == config.maxBatchSize) || (0U == config.threadCount))
+    {
+        throw std::invalid_argument(
+            "Invalid server parameters: batch size and thread count must exceed 0!");
+    }
+    return config;
+}
+
+// -----------------------------------------------------------------------------
+double percentile(std::vector<double>& values, const double fraction) noexcept
+{
+    if (values.empty()) { return 0.0; }
+
+    // Use the nearest-rank method.
+    const auto rank{static_cast<std::size_t>(std::ceil(fraction * values.size()))};
+    const auto index{0U < rank ? rank - 1U : 0U};
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+Server::Server(const ml::inference::Plan& plan, const Config& config)
+    : myPlan{plan}
+    , myConfig{checkConfig(config)}
+    , mySocket{listenOn(config.address)}
+    , myPool{config.threadCount}
+    , myQueue{}
+    , myQueueMutex{}
+    , myQueueCondition{}
+    , myStopping{false}
+    , myConnections{}
+    , myConnectionMutex{}
+    , myLatencies{}
+    , myBatchCount{}
+    , myStart{std::chrono::steady_clock::now()}
+    , myStatisticsMutex{}
+    , myBatchThread{&Server::batch, this}
+    , myAcceptThread{&Server::accept, this}
+{}
+
+// -----------------------------------------------------------------------------
+Server::~Server() noexcept { stop(); }
+
+// -----------------------------------------------------------------------------
+void Server::stop() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{myQueueMutex};
+        if (myStopping) { return; }
+        myStopping = true;
+    }
+    myQueueCondition.notify_all();
+
+    // Stop accepting connections.
+    myAcceptThread.join();
+    ::close(mySocket);
+    if (!myConfig.address.socketPath.empty()) { ::unlink(myConfig.address.socketPath.c_str()); }
+
+    // Disconnect the clients, requests already queued are completed before the threads finish.
+    std::lock_guard<std::mutex> lock{myConnectionMutex};
+    for (auto& connection : myConnections) { ::shutdown(connection.socket, SHUT_RDWR); }
+    for (auto& connection : myConnections)
+    {
+        connection.thread.join();
+        ::close(connection.socket);
+    }
+    myConnections.clear();
+
+    // Run the remaining batches.
+    myBatchThread.join();
+}
+
+// -----------------------------------------------------------------------------
+Statistics Server::statistics() const
+{
+    std::unique_lock<std::mutex> lock{myStatisticsMutex};
+    auto latencies{myLatencies};
+    const auto batchCount{myBatchCount};
+    const std::chrono::duration<double> duration{std::chrono::steady_clock::now() - myStart};
+    lock.unlock();
+
+    const auto requestCount{latencies.size()};
+    return Statistics{requestCount,
+                      batchCount,
+                      0U < batchCount ? static_cast<double>(requestCount) / batchCount : 0.0,
+                      percentile(latencies, 0.5),
+                      percentile(latencies, 0.99),
+                      requestCount / duration.count()};
+}
+
+// -----------------------------------------------------------------------------
+void Server::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock{myStatisticsMutex};
+    myLatencies.clear();
+    myBatchCount = 0U;
+    myStart      = std::chrono::steady_clock::now();
+}
+
+// -----------------------------------------------------------------------------
+void Server::accept() noexcept
+{
+    pollfd listener{mySocket, POLLIN, 0};
+
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> lock{myQueueMutex};
+            if (myStopping) { return; }
+        }
+        // Wait for a connection, but check regularly whether the server is stopping.
+        if (0 >= ::poll(&listener, 1U, PollTimeoutMs)) { continue; }
+        const int socket{acceptOn(mySocket, myConfig.address)};
+        if (0 > socket) { continue; }
+
+        std::lock_guard<std::mutex> lock{myConnectionMutex};
+
+        // Remove connections closed by their clients.
+        for (auto it{myConnections.begin()}; it != myConnections.end();)
+        {
+            if (!it->finished) { ++it; continue; }
+            it->thread.join();
+            ::close(it->socket);
+            it = myConnections.erase(it);
+        }
+
+        // Serve the new connection in a dedicated thread.
+        auto& connection{myConnections.emplace_back()};
+        connection.socket = socket;
+        try { connection.thread = std::thread{&Server::serve, this, std::ref(connection)}; }
+        catch (const std::system_error&)
+        {
+            ::close(socket);
+            myConnections.pop_back();
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void Server::serve(Connection& connection) noexcept
+{
+    std::vector<double> input{};
+
+    while (readMessage(connection.socket, input))
+    {
+        // Respond with an empty message if the number of inputs is invalid.
+        if (input.size() != myPlan.inputCount())
+        {
+            if (!writeMessage(connection.socket, {})) { break; }
+            continue;
+        }
+
+        // Queue the request and wait for it to be batched and predicted.
+        std::future<std::vector<double>> response{};
+        {
+            std::lock_guard<std::mutex> lock{myQueueMutex};
+            if (myStopping) { break; }
+            myQueue.push_back(Request{std::move(input), std::chrono::steady_clock::now(), {}});
+            response = myQueue.back().response.get_future();
+        }
+        myQueueCondition.notify_all();
+
+        if (!writeMessage(connection.socket, response.get())) { break; }
+        input = {};
+    }
+    connection.finished = true;
+}
+
+// -----------------------------------------------------------------------------
+void Server::batch() noexcept
+{
+    std::unique_lock<std::mutex> lock{myQueueMutex};
+
+    while (true)
+    {
+        // Wait for the first request of the next batch.
+        myQueueCondition.wait(lock, [this]() { return myStopping || !myQueue.empty(); });
+        if (myQueue.empty()) { return; }
+
+        // Wait for further requests until the batch is full or the latency budget has elapsed.
+        const auto deadline{myQueue.front().received + myConfig.latencyBudget};
+        myQueueCondition.wait_until(lock, deadline, [this]() {
+            return myStopping || (myConfig.maxBatchSize <= myQueue.size());
+        });
+
+        // Move the batch out of the queue and run it on the worker pool.
+        const auto count{std::min(myConfig.maxBatchSize, myQueue.size())};
+        auto requests{std::make_shared<std::vector<Request>>(
+            std::make_move_iterator(myQueue.begin()),
+            std::make_move_iterator(myQueue.begin() + count))};
+        myQueue.erase(myQueue.begin(), myQueue.begin() + count);
+        lock.unlock();
+
+        myPool.submit([this, requests]() { run(*requests); });
+        lock.lock();
+    }
+}
+
+// -----------------------------------------------------------------------------
+void Server::run(std::vector<Request>& requests) noexcept
+{
+    // Each worker thread uses its own scratch buffer, which is reused between batches.
+    thread_local std::vector<double> scratch{};
+    std::vector<std::vector<double>> outputs(requests.size());
+    std::vector<const double*> inputPointers(requests.size());
+    std::vector<double*> outputPointers(requests.size());
+
+    // Predict the whole batch at once, so each weight panel is streamed once per batch.
+    for (std::size_t i{}; i < requests.size(); ++i)
+    {
+        outputs[i].resize(myPlan.outputCount());
+        inputPointers[i]  = requests[i].input.data();
+        outputPointers[i] = outputs[i].data();
+    }
+    if (scratch.size() < myPlan.scratchSize(requests.size()))
+    {
+        scratch.resize(myPlan.scratchSize(requests.size()));
+    }
+    myPlan.predict(inputPointers.data(), outputPointers.data(), requests.size(), scratch.data());
+
+    // Update the statistics before responding, so that they are complete once the clients
+    // have received their responses.
+    const auto now{std::chrono::steady_clock::now()};
+    {
+        std::lock_guard<std::mutex> lock{myStatisticsMutex};
+        for (const auto& request : requests)
+        {
+            const std::chrono::duration<double, std::micro> latency{now - request.received};
+            myLatencies.push_back(latency.count());
+        }
+        ++myBatchCount;
+    }
+
+    for (std::size_t i{}; i < requests.size(); ++i)
+    {
+        requests[i].response.set_value(std::move(outputs[i]));
+    }
+}
+} // namespace ml::serve
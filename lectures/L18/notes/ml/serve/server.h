@@ -0,0 +1,216 @@
+/**
+ * @brief Local inference server with dynamic batching.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ml/inference/plan.h"
+#include "ml/utils/thread_pool.h"
+
+namespace ml::serve
+{
+/**
+ * @brief Structure holding the address of an inference server.
+ * 
+ *        A Unix domain socket is used if a socket path is given, otherwise a TCP socket bound to
+ *        the loopback interface is used.
+ */
+struct Address
+{
+    /** Path of the Unix domain socket (empty = use loopback TCP). */
+    std::string socketPath;
+
+    /** TCP port on the loopback interface (used if no socket path is given). */
+    std::uint16_t port;
+};
+
+/**
+ * @brief Structure holding the server configuration.
+ */
+struct Config
+{
+    /** The address to listen on. */
+    Address address;
+
+    /** The maximum number of requests per batch. */
+    std::size_t maxBatchSize;
+
+    /** The maximum time the first request of a batch waits for further requests. */
+    std::chrono::microseconds latencyBudget;
+
+    /** The number of worker threads running batches. */
+    std::size_t threadCount;
+};
+
+/**
+ * @brief Structure holding server statistics.
+ */
+struct Statistics
+{
+    /** The number of requests served. */
+    std::size_t requestCount;
+
+    /** The number of batches run. */
+    std::size_t batchCount;
+
+    /** The average number of requests per batch. */
+    double meanBatchSize;
+
+    /** Median latency in microseconds, from request received to response ready. */
+    double p50Latency;
+
+    /** 99th percentile latency in microseconds. */
+    double p99Latency;
+
+    /** The number of requests served per second since the server was started. */
+    double throughput;
+};
+
+/**
+ * @brief Local inference server.
+ * 
+ *        Each client connection is served by a dedicated thread, which reads requests and waits
+ *        for the corresponding responses. Received requests are queued and collected into batches
+ *        by a batching thread: a batch is dispatched to the worker pool once it holds the maximum
+ *        number of requests or the latency budget of its first request has elapsed.
+ * 
+ *        Wire format (host byte order): a request consists of the number of input values as a
+ *        32-bit unsigned integer followed by the input values as doubles. The response has the
+ *        same layout with the output values. A response holding zero values indicates an
+ *        invalid request.
+ */
+class Server final
+{
+public:
+    /**
+     * @brief Create a new server and start listening.
+     * 
+     * @param[in] plan The inference plan to serve. Must outlive the server.
+     * @param[in] config The server configuration.
+     */
+    explicit Server(const ml::inference::Plan& plan, const Config& config);
+
+    /**
+     * @brief Stop and delete the server.
+     */
+    ~Server() noexcept;
+
+    /**
+     * @brief Stop the server. Pending requests are completed first.
+     */
+    void stop() noexcept;
+
+    /**
+     * @brief Get the server statistics.
+     * 
+     * @return The statistics of the requests served so far.
+     */
+    Statistics statistics() const;
+
+    /**
+     * @brief Reset the server statistics.
+     */
+    void resetStatistics();
+
+    Server()                         = delete; // No default constructor.
+    Server(const Server&)            = delete; // No copy constructor.
+    Server(Server&&)                 = delete; // No move constructor.
+    Server& operator=(const Server&) = delete; // No copy assignment.
+    Server& operator=(Server&&)      = delete; // No move assignment.
+
+private:
+    /**
+     * @brief Structure holding a queued request.
+     */
+    struct Request
+    {
+        /** The input values. */
+        std::vector<double> input;
+
+        /** The time the request was received. */
+        std::chrono::steady_clock::time_point received;
+
+        /** Promise holding the output values once predicted. */
+        std::promise<std::vector<double>> response;
+    };
+
+    /**
+     * @brief Structure holding a client connection.
+     */
+    struct Connection
+    {
+        /** The connection socket. */
+        int socket;
+
+        /** Thread serving the connection. */
+        std::thread thread;
+
+        /** Indicate whether the connection has been closed by the client. */
+        std::atomic<bool> finished{false};
+    };
+
+    void accept() noexcept;
+    void serve(Connection& connection) noexcept;
+    void batch() noexcept;
+    void run(std::vector<Request>& requests) noexcept;
+
+    /** The inference plan to serve. */
+    const ml::inference::Plan& myPlan;
+
+    /** The server configuration. */
+    const Config myConfig;
+
+    /** The listening socket. */
+    int mySocket;
+
+    /** Worker pool running the batches. */
+    ml::utils::ThreadPool myPool;
+
+    /** Requests waiting to be batched. */
+    std::vector<Request> myQueue;
+
+    /** Mutex protecting the request queue and the stop flag. */
+    std::mutex myQueueMutex;
+
+    /** Condition variable signaled when a request is queued or the server is stopped. */
+    std::condition_variable myQueueCondition;
+
+    /** Indicate whether the server is stopping. */
+    bool myStopping;
+
+    /** Open client connections. */
+    std::list<Connection> myConnections;
+
+    /** Mutex protecting the open client connections. */
+    std::mutex myConnectionMutex;
+
+    /** Latency of each served request in microseconds. */
+    std::vector<double> myLatencies;
+
+    /** The number of batches run. */
+    std::size_t myBatchCount;
+
+    /** The time the statistics were last reset. */
+    std::chrono::steady_clock::time_point myStart;
+
+    /** Mutex protecting the statistics. */
+    mutable std::mutex myStatisticsMutex;
+
+    /** Thread collecting requests into batches. */
+    std::thread myBatchThread;
+
+    /** Thread accepting client connections. */
+    std::thread myAcceptThread;
+};
+} // namespace ml::serve
@@ -0,0 +1,186 @@
+/**
+ * @brief Socket utilities implementation details.
+ */
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "ml/serve/socket.h"
+
+namespace ml::serve
+{
+namespace
+{
+/** The maximum number of values accepted in a single message. */
+constexpr std::uint32_t MaxValueCount{1U << 20U};
+
+/** The maximum number of pending connections. */
+constexpr int Backlog{64};
+
+// -----------------------------------------------------------------------------
+int createSocket(const Address& address, sockaddr_storage& storage, socklen_t& size)
+{
+    std::memset(&storage, 0, sizeof(storage));
+
+    if (!address.socketPath.empty())
+    {
+        auto& unixAddress{reinterpret_cast<sockaddr_un&>(storage)};
+        if (address.socketPath.size() >= sizeof(unixAddress.sun_path))
+        {
+            throw std::runtime_error("Socket path too long: " + address.socketPath + "!");
+        }
+        unixAddress.sun_family = AF_UNIX;
+        std::memcpy(unixAddress.sun_path, address.socketPath.c_str(), address.socketPath.size());
+        size = sizeof(sockaddr_un);
+    }
+    else
+    {
+        // Only the loopback interface is used, the server is not meant to be exposed.
+        auto& inetAddress{reinterpret_cast<sockaddr_in&>(storage)};
+        inetAddress.sin_family      = AF_INET;
+        inetAddress.sin_port        = htons(address.port);
+        inetAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        size = sizeof(sockaddr_in);
+    }
+
+    const int fd{::socket(storage.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+    if (0 > fd)
+    {
+        throw std::runtime_error(std::string{"Failed to create socket: "} + std::strerror(errno));
+    }
+    return fd;
+}
+
+// -----------------------------------------------------------------------------
+void disableDelay(const int fd, const Address& address) noexcept
+{
+    // Send small messages immediately, latency matters more than packet count.
+    if (address.socketPath.empty())
+    {
+        const int enable{1};
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool readAll(const int fd, void* data, std::size_t size) noexcept
+{
+    auto bytes{static_cast<char*>(data)};
+
+    // Read until all bytes are received, retry if interrupted.
+    while (0U < size)
+    {
+        const auto count{::recv(fd, bytes, size, 0)};
+        if (0 > count && EINTR == errno) { continue; }
+        if (0 >= count) { return false; }
+        bytes += count;
+        size  -= static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool writeAll(const int fd, const void* data, std::size_t size) noexcept
+{
+    auto bytes{static_cast<const char*>(data)};
+
+    // Write until all bytes are sent, never raise SIGPIPE if the peer has disconnected.
+    while (0U < size)
+    {
+        const auto count{::send(fd, bytes, size, MSG_NOSIGNAL)};
+        if (0 > count && EINTR == errno) { continue; }
+        if (0 >= count) { return false; }
+        bytes += count;
+        size  -= static_cast<std::size_t>(count);
+    }
+    return true;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+int listenOn(const Address& address)
+{
+    sockaddr_storage storage{};
+    socklen_t size{};
+    const int fd{createSocket(address, storage, size)};
+
+    // Replace a stale Unix domain socket file, allow quick reuse of TCP ports.
+    if (!address.socketPath.empty()) { ::unlink(address.socketPath.c_str()); }
+    else
+    {
+        const int enable{1};
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    }
+
+    if ((0 != ::bind(fd, reinterpret_cast<const sockaddr*>(&storage), size)) ||
+        (0 != ::listen(fd, Backlog)))
+    {
+        const std::string error{std::strerror(errno)};
+        ::close(fd);
+        throw std::runtime_error("Failed to listen: " + error + "!");
+    }
+    return fd;
+}
+
+// -----------------------------------------------------------------------------
+int connectTo(const Address& address)
+{
+    sockaddr_storage storage{};
+    socklen_t size{};
+    const int fd{createSocket(address, storage, size)};
+
+    if (0 != ::connect(fd, reinterpret_cast<const sockaddr*>(&storage), size))
+    {
+        const std::string error{std::strerror(errno)};
+        ::close(fd);
+        throw std::runtime_error("Failed to connect: " + error + "!");
+    }
+    disableDelay(fd, address);
+    return fd;
+}
+
+// -----------------------------------------------------------------------------
+int acceptOn(const int socket, const Address& address) noexcept
+{
+    const int fd{::accept4(socket, nullptr, nullptr, SOCK_CLOEXEC)};
+    if (0 <= fd) { disableDelay(fd, address); }
+    return fd;
+}
+
+// -----------------------------------------------------------------------------
+bool readMessage(const int socket, std::vector<double>& values) noexcept
+{
+    std::uint32_t count{};
+    if (!readAll(socket, &count, sizeof(count)) || (MaxValueCount < count)) { return false; }
+    try { values.resize(count); }
+    catch (const std::bad_alloc&) { return false; }
+    return readAll(socket, values.data(), count * sizeof(double));
+}
+
+// -----------------------------------------------------------------------------
+bool writeMessage(const int socket, const std::vector<double>& values) noexcept
+{
+    // Send the count and the values in one call to avoid an extra round trip.
+    const auto count{static_cast<std::uint32_t>(values.size())};
+    char buffer[sizeof(count) + 64U * sizeof(double)];
+
+    if (sizeof(buffer) >= sizeof(count) + values.size() * sizeof(double))
+    {
+        std::memcpy(buffer, &count, sizeof(count));
+        std::memcpy(buffer + sizeof(count), values.data(), values.size() * sizeof(double));
+        return writeAll(socket, buffer, sizeof(count) + values.size() * sizeof(double));
+    }
+    return writeAll(socket, &count, sizeof(count)) &&
+           writeAll(socket, values.data(), values.size() * sizeof(double));
+}
+} // namespace ml::serve
@@ -0,0 +1,65 @@
+/**
+ * @brief Socket utilities used by the inference server and client.
+ */
+#pragma once
+
+#include <vector>
+
+#include "ml/serve/server.h"
+
+namespace ml::serve
+{
+/**
+ * @brief Create a socket listening on the given address.
+ * 
+ *        An existing Unix domain socket file at the given path is replaced.
+ * 
+ * @param[in] address The address to listen on.
+ * 
+ * @return The listening socket.
+ * 
+ * @throw std::runtime_error If the socket couldn't be created.
+ */
+int listenOn(const Address& address);
+
+/**
+ * @brief Create a socket connected to the given address.
+ * 
+ * @param[in] address The address to connect to.
+ * 
+ * @return The connected socket.
+ * 
+ * @throw std::runtime_error If the connection couldn't be established.
+ */
+int connectTo(const Address& address);
+
+/**
+ * @brief Accept a connection on the given listening socket.
+ * 
+ * @param[in] socket The listening socket.
+ * @param[in] address The address the socket is listening on.
+ * 
+ * @return The connected socket, or -1 on failure.
+ */
+int acceptOn(int socket, const Address& address) noexcept;
+
+/**
+ * @brief Read a message (a count followed by the values) from the given socket.
+ * 
+ * @param[in] socket The socket to read from.
+ * @param[out] values Vector to store the received values in.
+ * 
+ * @return True if a message was read, or false on error or if the connection was closed.
+ */
+bool readMessage(int socket, std::vector<double>& values) noexcept;
+
+/**
+ * @brief Write a message (a count followed by the values) to the given socket.
+ * 
+ * @param[in] socket The socket to write to.
+ * @param[in] values The values to send.
+ * 
+ * @return True if the message was written, or false on error.
+ */
+bool writeMessage(int socket, const std::vector<double>& values) noexcept;
+} // namespace ml::serve
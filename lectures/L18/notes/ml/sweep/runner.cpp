@@ -0,0 +1,250 @@
+/**
+ * @brief Hyperparameter sweep runner implementation details.
+ */
+#include <algorithm>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "ml/dense_layer/dense_layer.h"
+#include "ml/neural_network/single_layer.h"
+#include "ml/sweep/runner.h"
+#include "ml/types.h"
+
+namespace ml::sweep
+{
+namespace
+{
+/**
+ * @brief Structure holding a network being trained during the sweep.
+ */
+struct Trial
+{
+    /**
+     * @brief Create a new trial.
+     * 
+     * @param[in] config The configuration to train.
+     * @param[in] trainInput Training input data.
+     * @param[in] trainOutput Training output data.
+     */
+    explicit Trial(const Config& config, const std::vector<std::vector<double>>& trainInput,
+                   const std::vector<std::vector<double>>& trainOutput)
+        : config{config}
+        , hiddenLayer{config.hiddenCount, trainInput[0U].size(), config.actFunc, config.seed}
+        , outputLayer{trainOutput[0U].size(), config.hiddenCount, config.actFunc, config.seed + 1U}
+        , network{hiddenLayer, outputLayer, trainInput, trainOutput}
+        , epochCount{}
+        , loss{}
+        , rung{}
+        , failed{false}
+    {}
+
+    /** The configuration to train. */
+    const Config config;
+
+    /** The hidden layer of the network. */
+    ml::dense_layer::DenseLayer hiddenLayer;
+
+    /** The output layer of the network. */
+    ml::dense_layer::DenseLayer outputLayer;
+
+    /** The network to train. */
+    ml::neural_network::SingleLayer network;
+
+    /** The number of epochs trained so far. */
+    std::size_t epochCount;
+
+    /** Mean squared error after the latest rung. */
+    double loss;
+
+    /** The latest rung the trial took part in. */
+    std::size_t rung;
+
+    /** Indicate whether training failed. */
+    bool failed;
+};
+
+// -----------------------------------------------------------------------------
+double meanSquaredError(ml::neural_network::Interface& network,
+                        const std::vector<std::vector<double>>& input,
+                        const std::vector<std::vector<double>>& output) noexcept
+{
+    double sum{};
+    std::size_t count{};
+
+    // Accumulate the squared error of every predicted value.
+    for (std::size_t i{}; i < input.size(); ++i)
+    {
+        const auto& prediction{network.predict(input[i])};
+
+        for (std::size_t j{}; j < output[i].size() && j < prediction.size(); ++j)
+        {
+            const auto error{output[i][j] - prediction[j]};
+            sum += error * error;
+            ++count;
+        }
+    }
+    return 0U < count ? sum / count : 0.0;
+}
+
+// -----------------------------------------------------------------------------
+const char* actFuncName(const ml::ActFunc actFunc) noexcept
+{
+    switch (actFunc)
+    {
+        case ml::ActFunc::Relu:
+            return "relu";
+        case ml::ActFunc::Tanh:
+            return "tanh";
+        default:
+            return "unknown";
+    }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+Runner::Runner(const std::vector<std::vector<double>>& trainInput,
+               const std::vector<std::vector<double>>& trainOutput, const std::size_t threadCount)
+    : myTrainInput{trainInput}
+    , myTrainOutput{trainOutput}
+    , myThreadPool{threadCount}
+{
+    // Make sure the training data is usable.
+    if (trainInput.empty() || (trainInput.size() != trainOutput.size()) ||
+        trainInput[0U].empty() || trainOutput[0U].empty())
+    {
+        throw std::invalid_argument("Invalid sweep parameters: training data mismatch!");
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::vector<Result> Runner::run(const std::vector<Config>& configs, const std::size_t minEpochCount,
+                                const std::size_t maxEpochCount, const std::size_t reductionFactor)
+{
+    std::vector<Result> results{};
+
+    // Validate the parameters, return no results on failure.
+    if (configs.empty() || (0U == minEpochCount) || (minEpochCount > maxEpochCount) ||
+        (2U > reductionFactor))
+    {
+        std::cout << "Invalid sweep parameters!\n";
+        return results;
+    }
+
+    // Create one trial per configuration; the networks are created in the worker threads.
+    std::vector<std::unique_ptr<Trial>> trials(configs.size());
+    std::vector<Trial*> survivors{};
+    {
+        std::vector<std::future<void>> futures{};
+
+        for (std::size_t i{}; i < configs.size(); ++i)
+        {
+            futures.push_back(myThreadPool.submit([&, i]() {
+                trials[i] = std::make_unique<Trial>(configs[i], myTrainInput, myTrainOutput);
+            }));
+        }
+        for (auto& future : futures) { future.get(); }
+    }
+    for (auto& trial : trials) { survivors.push_back(trial.get()); }
+
+    // Run successive halving until a single configuration remains or the budget is exhausted.
+    std::size_t epochBudget{minEpochCount};
+
+    for (std::size_t rung{}; !survivors.empty(); ++rung)
+    {
+        std::vector<std::future<void>> futures{};
+
+        // Train every survivor up to the current epoch budget and evaluate it concurrently.
+        for (auto* trial : survivors)
+        {
+            futures.push_back(myThreadPool.submit([this, trial, epochBudget, rung]() {
+                const auto remainingEpochs{epochBudget - trial->epochCount};
+                trial->rung = rung;
+
+                if (!trial->network.train(remainingEpochs, trial->config.learningRate))
+                {
+                    trial->failed = true;
+                    return;
+                }
+                trial->epochCount = epochBudget;
+                trial->loss = meanSquaredError(trial->network, myTrainInput, myTrainOutput);
+            }));
+        }
+        for (auto& future : futures) { future.get(); }
+
+        // Rank the survivors, failed trials last.
+        std::stable_sort(survivors.begin(), survivors.end(), [](const Trial* a, const Trial* b) {
+            if (a->failed != b->failed) { return b->failed; }
+            return a->loss < b->loss;
+        });
+
+        // Terminate the sweep once the budget is exhausted or a single configuration remains.
+        if ((maxEpochCount == epochBudget) || (1U == survivors.size())) { break; }
+
+        // Keep the best configurations, increase their epoch budget.
+        const auto keepCount{std::max<std::size_t>(1U, survivors.size() / reductionFactor)};
+        survivors.resize(keepCount);
+        epochBudget = std::min(maxEpochCount, epochBudget * reductionFactor);
+    }
+
+    // Collect the results, sorted from best to worst.
+    for (const auto& trial : trials)
+    {
+        results.push_back(Result{trial->config, trial->epochCount, trial->loss, trial->rung,
+                                 trial->failed});
+    }
+    std::stable_sort(results.begin(), results.end(), [](const Result& a, const Result& b) {
+        if (a.failed != b.failed) { return b.failed; }
+        if (a.rung != b.rung) { return a.rung > b.rung; }
+        return a.loss < b.loss;
+    });
+    return results;
+}
+
+// -----------------------------------------------------------------------------
+std::vector<Config> Runner::grid(const std::vector<std::size_t>& hiddenCounts,
+                                 const std::vector<double>& learningRates,
+                                 const std::vector<ml::ActFunc>& actFuncs, const unsigned baseSeed)
+{
+    std::vector<Config> configs{};
+    unsigned seed{baseSeed};
+
+    // Create every combination, each layer of a network uses its own seed (seed, seed + 1).
+    for (const auto& hiddenCount : hiddenCounts)
+    {
+        for (const auto& learningRate : learningRates)
+        {
+            for (const auto& actFunc : actFuncs)
+            {
+                configs.push_back(Config{hiddenCount, learningRate, actFunc, seed});
+                seed += 2U;
+            }
+        }
+    }
+    return configs;
+}
+
+// -----------------------------------------------------------------------------
+void Runner::printResults(const std::vector<Result>& results, std::ostream& ostream)
+{
+    ostream << "--------------------------------------------------------------------------------\n";
+    ostream << std::left << std::setw(8) << "hidden" << std::setw(10) << "rate" << std::setw(8)
+            << "act" << std::setw(8) << "seed" << std::setw(10) << "epochs" << std::setw(8)
+            << "rung" << "loss\n";
+
+    // Print one row per configuration.
+    for (const auto& result : results)
+    {
+        ostream << std::setw(8) << result.config.hiddenCount << std::setw(10)
+                << result.config.learningRate << std::setw(8) << actFuncName(result.config.actFunc)
+                << std::setw(8) << result.config.seed << std::setw(10) << result.epochCount
+                << std::setw(8) << result.rung;
+        if (result.failed) { ostream << "failed\n"; }
+        else { ostream << result.loss << "\n"; }
+    }
+    ostream << "--------------------------------------------------------------------------------\n\n";
+}
+} // namespace ml::sweep
@@ -0,0 +1,136 @@
+/**
+ * @brief Hyperparameter sweep runner for single-layer neural networks.
+ */
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include "ml/types.h"
+#include "ml/utils/thread_pool.h"
+
+namespace ml::sweep
+{
+/**
+ * @brief Structure holding a network configuration to evaluate.
+ */
+struct Config
+{
+    /** The number of nodes in the hidden layer. */
+    std::size_t hiddenCount;
+
+    /** The learning rate to train with. */
+    double learningRate;
+
+    /** The activation function used in the hidden and output layers. */
+    ml::ActFunc actFunc;
+
+    /** Seed used to generate the starting values of the network. */
+    unsigned seed;
+};
+
+/**
+ * @brief Structure holding the result of an evaluated configuration.
+ */
+struct Result
+{
+    /** The evaluated configuration. */
+    Config config;
+
+    /** The number of epochs the configuration was trained. */
+    std::size_t epochCount;
+
+    /** Mean squared error after training. */
+    double loss;
+
+    /** The rung (successive halving round) at which the configuration was stopped. */
+    std::size_t rung;
+
+    /** Indicate whether training failed. */
+    bool failed;
+};
+
+/**
+ * @brief Hyperparameter sweep runner.
+ * 
+ *        Configurations are trained concurrently on a thread pool. Successive halving is used
+ *        to stop losing configurations early: after each rung only the best 1 / reductionFactor
+ *        configurations are kept, and the survivors' epoch budget is multiplied by reductionFactor.
+ */
+class Runner final
+{
+public:
+    /**
+     * @brief Create a new sweep runner.
+     * 
+     * @param[in] trainInput Training input data, which is copied. Must be non-empty.
+     * @param[in] trainOutput Training output data, which is copied. Must be the same size as
+     *                        the input.
+     * @param[in] threadCount The number of worker threads (default = hardware concurrency).
+     */
+    explicit Runner(const std::vector<std::vector<double>>& trainInput,
+                    const std::vector<std::vector<double>>& trainOutput,
+                    const std::size_t threadCount = std::thread::hardware_concurrency());
+
+    /**
+     * @brief Delete the sweep runner.
+     */
+    ~Runner() noexcept = default;
+
+    /**
+     * @brief Run the sweep with the given configurations.
+     * 
+     * @param[in] configs The configurations to evaluate.
+     * @param[in] minEpochCount Epoch budget of the first rung. Must exceed 0.
+     * @param[in] maxEpochCount Maximum epoch budget of any configuration.
+     * @param[in] reductionFactor Fraction of configurations eliminated per rung (default = 2).
+     *                            Must exceed 1.
+     * 
+     * @return Vector holding the results, sorted from best to worst.
+     */
+    std::vector<Result> run(const std::vector<Config>& configs, const std::size_t minEpochCount,
+                            const std::size_t maxEpochCount, const std::size_t reductionFactor = 2U);
+
+    /**
+     * @brief Create configurations for every combination of the given parameters.
+     * 
+     *        Each configuration is assigned a unique seed derived from the given base seed.
+     * 
+     * @param[in] hiddenCounts Hidden node counts to evaluate.
+     * @param[in] learningRates Learning rates to evaluate.
+     * @param[in] actFuncs Activation functions to evaluate.
+     * @param[in] baseSeed Base seed (default = 0).
+     * 
+     * @return Vector holding the configurations.
+     */
+    static std::vector<Config> grid(const std::vector<std::size_t>& hiddenCounts,
+                                    const std::vector<double>& learningRates,
+                                    const std::vector<ml::ActFunc>& actFuncs,
+                                    const unsigned baseSeed = 0U);
+
+    /**
+     * @brief Print the given results as a table.
+     * 
+     * @param[in] results The results to print.
+     * @param[in] ostream Output stream to use (default = terminal print).
+     */
+    static void printResults(const std::vector<Result>& results, std::ostream& ostream = std::cout);
+
+    Runner()                         = delete; // No default constructor.
+    Runner(const Runner&)            = delete; // No copy constructor.
+    Runner(Runner&&)                 = delete; // No move constructor.
+    Runner& operator=(const Runner&) = delete; // No copy assignment.
+    Runner& operator=(Runner&&)      = delete; // No move assignment.
+
+private:
+    /** Training input data. */
+    const std::vector<std::vector<double>> myTrainInput;
+
+    /** Training output data. */
+    const std::vector<std::vector<double>> myTrainOutput;
+
+    /** Thread pool used to train the configurations. */
+    ml::utils::ThreadPool myThreadPool;
+};
+} // namespace ml::sweep
@@ -0,0 +1,406 @@
+/**
+ * @brief Multithreaded trainer implementation details.
+ */
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "ml/act_func.h"
+#include "ml/train/parallel_trainer.h"
+
+namespace ml::train
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+inline double load(const std::atomic<double>& value) noexcept
+{
+    // Relaxed ordering is sufficient; stale values are tolerated by the algorithm.
+    return value.load(std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
+inline void add(std::atomic<double>& value, const double delta) noexcept
+{
+    // Plain load + store instead of compare-and-swap: concurrent updates may be lost (Hogwild).
+    value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+ParallelTrainer::ParallelTrainer(const std::vector<ml::dense_layer::DenseLayer*>& layers,
+                                 const std::vector<std::vector<double>>& trainInput,
+                                 const std::vector<std::vector<double>>& trainOutput,
+                                 const std::size_t threadCount, const unsigned seed)
+    : myLayers{layers}
+    , myTrainInput{trainInput}
+    , myTrainOutput{trainOutput}
+    , myParameters{}
+    , myWorkers{}
+    , myThreadPool{threadCount}
+    , mySeed{seed}
+{
+    // Make sure the layers are valid and properly connected.
+    if (layers.empty() || trainInput.empty() || (trainInput.size() != trainOutput.size()))
+    {
+        throw std::invalid_argument("Invalid parallel trainer parameters: no layers or data!");
+    }
+    for (std::size_t i{}; i < layers.size(); ++i)
+    {
+        if ((nullptr == layers[i]) ||
+            ((0U < i) && (layers[i]->weightCount() != layers[i - 1U]->nodeCount())))
+        {
+            throw std::invalid_argument("Invalid parallel trainer parameters: layer mismatch!");
+        }
+    }
+    // Make sure the training data matches the first and the last layer.
+    for (std::size_t i{}; i < trainInput.size(); ++i)
+    {
+        if ((trainInput[i].size() != layers.front()->weightCount()) ||
+            (trainOutput[i].size() != layers.back()->nodeCount()))
+        {
+            throw std::invalid_argument("Invalid parallel trainer parameters: data mismatch!");
+        }
+    }
+
+    // Create the shared parameter store.
+    myParameters.reserve(layers.size());
+    for (const auto* layer : layers)
+    {
+        myParameters.push_back(Parameters{
+            std::vector<std::atomic<double>>(layer->nodeCount()),
+            std::vector<std::atomic<double>>(layer->nodeCount() * layer->weightCount()),
+            layer->weightCount(), layer->actFunc()});
+    }
+
+    // Create the private buffers of each worker.
+    myWorkers.resize(myThreadPool.threadCount());
+    for (auto& worker : myWorkers)
+    {
+        for (const auto* layer : layers)
+        {
+            worker.output.emplace_back(layer->nodeCount(), 0.0);
+            worker.error.emplace_back(layer->nodeCount(), 0.0);
+            worker.biasGradients.emplace_back(layer->nodeCount(), 0.0);
+            worker.weightGradients.emplace_back(layer->nodeCount() * layer->weightCount(), 0.0);
+        }
+    }
+    loadParameters();
+}
+
+// -----------------------------------------------------------------------------
+std::size_t ParallelTrainer::threadCount() const noexcept { return myWorkers.size(); }
+
+// -----------------------------------------------------------------------------
+bool ParallelTrainer::train(const std::size_t epochCount, const double learningRate,
+                            const Mode mode, const std::size_t batchSize)
+{
+    // Validate the learning rate and the batch size.
+    if (0.0 >= learningRate)
+    {
+        std::cout << "Invalid learning rate " << learningRate << "!\n";
+        return false;
+    }
+    if (0U == batchSize)
+    {
+        std::cout << "Invalid batch size " << batchSize << "!\n";
+        return false;
+    }
+
+    // Start from the current layer parameters, copy the result back when finished.
+    loadParameters();
+
+    if (Mode::Hogwild == mode) { trainHogwild(epochCount, learningRate); }
+    else { trainSynchronous(epochCount, learningRate, batchSize); }
+
+    storeParameters();
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+double ParallelTrainer::loss()
+{
+    double sum{};
+    std::size_t count{};
+    auto& worker{myWorkers.front()};
+
+    // Accumulate the squared error of every predicted value.
+    loadParameters();
+    for (std::size_t i{}; i < myTrainInput.size(); ++i)
+    {
+        feedforward(worker, myTrainInput[i]);
+
+        for (std::size_t j{}; j < myTrainOutput[i].size(); ++j)
+        {
+            const auto error{myTrainOutput[i][j] - worker.output.back()[j]};
+            sum += error * error;
+            ++count;
+        }
+    }
+    return 0U < count ? sum / count : 0.0;
+}
+
+// -----------------------------------------------------------------------------
+void ParallelTrainer::feedforward(Worker& worker, const std::vector<double>& input) const noexcept
+{
+    for (std::size_t l{}; l < myParameters.size(); ++l)
+    {
+        const auto& params{myParameters[l]};
+        const auto& layerInput{0U == l ? input : worker.output[l - 1U]};
+        auto& output{worker.output[l]};
+
+        // Compute the output of each node with the shared parameters.
+        for (std::size_t i{}; i < output.size(); ++i)
+        {
+            const auto* weights{&params.weights[i * params.weightCount]};
+            auto sum{load(params.bias[i])};
+
+            for (std::size_t j{}; j < params.weightCount; ++j)
+            {
+                sum += layerInput[j] * load(weights[j]);
+            }
+            output[i] = ml::actFuncOutput(params.actFunc, sum);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void ParallelTrainer::backpropagate(Worker& worker, 
+                                    const std::vector<double>& reference) const noexcept
+{
+    // Compute the errors of the output layer.
+    const auto last{myParameters.size() - 1U};
+
+    for (std::size_t i{}; i < reference.size(); ++i)
+    {
+        const auto output{worker.output[last][i]};
+        worker.error[last][i] = 
+            (reference[i] - output) * ml::actFuncDelta(myParameters[last].actFunc, output);
+    }
+
+    // Propagate the errors backwards through the hidden layers.
+    for (std::size_t l{last}; 0U < l; --l)
+    {
+        const auto& next{myParameters[l]};
+        const auto& nextError{worker.error[l]};
+        auto& error{worker.error[l - 1U]};
+
+        for (std::size_t i{}; i < error.size(); ++i)
+        {
+            double weightedErrorSum{};
+
+            for (std::size_t k{}; k < nextError.size(); ++k)
+            {
+                weightedErrorSum += nextError[k] * load(next.weights[k * next.weightCount + i]);
+            }
+            const auto output{worker.output[l - 1U][i]};
+            error[i] = weightedErrorSum * ml::actFuncDelta(myParameters[l - 1U].actFunc, output);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void ParallelTrainer::optimize(const Worker& worker, const std::vector<double>& input,
+                               const double learningRate) noexcept
+{
+    for (std::size_t l{}; l < myParameters.size(); ++l)
+    {
+        auto& params{myParameters[l]};
+        const auto& layerInput{0U == l ? input : worker.output[l - 1U]};
+        const auto& error{worker.error[l]};
+
+        for (std::size_t i{}; i < error.size(); ++i)
+        {
+            // Skip nodes without error, since they wouldn't change anything.
+            const auto scaledError{error[i] * learningRate};
+            if (0.0 == scaledError) { continue; }
+
+            add(params.bias[i], scaledError);
+            auto* weights{&params.weights[i * params.weightCount]};
+
+            // Only update weights connected to non-zero inputs, which keeps sparse updates sparse.
+            for (std::size_t j{}; j < params.weightCount; ++j)
+            {
+                if (0.0 != layerInput[j]) { add(weights[j], scaledError * layerInput[j]); }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void ParallelTrainer::accumulate(Worker& worker, const std::vector<double>& input) const noexcept
+{
+    for (std::size_t l{}; l < myParameters.size(); ++l)
+    {
+        const auto weightCount{myParameters[l].weightCount};
+        const auto& layerInput{0U == l ? input : worker.output[l - 1U]};
+        const auto& error{worker.error[l]};
+
+        // Add the gradients of this sample to the private buffers.
+        for (std::size_t i{}; i < error.size(); ++i)
+        {
+            if (0.0 == error[i]) { continue; }
+            worker.biasGradients[l][i] += error[i];
+            auto* weightGradients{&worker.weightGradients[l][i * weightCount]};
+
+            for (std::size_t j{}; j < weightCount; ++j)
+            {
+                weightGradients[j] += error[i] * layerInput[j];
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void ParallelTrainer::trainHogwild(const std::size_t epochCount, const double learningRate)
+{
+    std::vector<std::future<void>> futures{};
+
+    // Run each worker on its own shard of the training data for all epochs, no synchronization.
+    for (std::size_t t{}; t < myWorkers.size(); ++t)
+    {
+        futures.push_back(myThreadPool.submit([this, t, epochCount, learningRate]() {
+            auto& worker{myWorkers[t]};
+            std::mt19937 generator{mySeed + static_cast<unsigned>(t)};
+            std::vector<std::size_t> shard{};
+
+            for (std::size_t i{t}; i < myTrainInput.size(); i += myWorkers.size())
+            {
+                shard.push_back(i);
+            }
+            for (std::size_t epoch{}; epoch < epochCount; ++epoch)
+            {
+                // Shuffle the shard every epoch, then train sample by sample.
+                std::shuffle(shard.begin(), shard.end(), generator);
+
+                for (const auto& i : shard)
+                {
+                    feedforward(worker, myTrainInput[i]);
+                    backpropagate(worker, myTrainOutput[i]);
+                    optimize(worker, myTrainInput[i], learningRate);
+                }
+            }
+        }));
+    }
+    for (auto& future : futures) { future.get(); }
+}
+
+// -----------------------------------------------------------------------------
+void ParallelTrainer::trainSynchronous(const std::size_t epochCount, const double learningRate,
+                                       const std::size_t batchSize)
+{
+    std::mt19937 generator{mySeed};
+    std::vector<std::size_t> order(myTrainInput.size());
+    std::iota(order.begin(), order.end(), 0U);
+
+    for (std::size_t epoch{}; epoch < epochCount; ++epoch)
+    {
+        std::shuffle(order.begin(), order.end(), generator);
+
+        for (std::size_t begin{}; begin < order.size(); begin += batchSize)
+        {
+            const auto end{std::min(order.size(), begin + batchSize)};
+            const auto chunkSize{(end - begin + myWorkers.size() - 1U) / myWorkers.size()};
+            std::vector<std::future<void>> futures{};
+
+            // Let each worker compute the gradients of its part of the mini-batch.
+            for (std::size_t t{}; t < myWorkers.size(); ++t)
+            {
+                const auto first{std::min(end, begin + t * chunkSize)};
+                const auto last{std::min(end, first + chunkSize)};
+
+                futures.push_back(myThreadPool.submit([this, t, first, last, &order]() {
+                    auto& worker{myWorkers[t]};
+                    for (auto& gradients : worker.biasGradients) 
+                    { 
+                        std::fill(gradients.begin(), gradients.end(), 0.0); 
+                    }
+                    for (auto& gradients : worker.weightGradients) 
+                    { 
+                        std::fill(gradients.begin(), gradients.end(), 0.0); 
+                    }
+                    for (auto i{first}; i < last; ++i)
+                    {
+                        feedforward(worker, myTrainInput[order[i]]);
+                        backpropagate(worker, myTrainOutput[order[i]]);
+                        accumulate(worker, myTrainInput[order[i]]);
+                    }
+                }));
+            }
+            for (auto& future : futures) { future.get(); }
+
+            // Reduce the gradients of all workers, apply the mean gradient of the mini-batch.
+            const auto scale{learningRate / (end - begin)};
+
+            for (std::size_t l{}; l < myParameters.size(); ++l)
+            {
+                auto& params{myParameters[l]};
+
+                for (std::size_t i{}; i < params.bias.size(); ++i)
+                {
+                    double sum{};
+                    for (const auto& worker : myWorkers) { sum += worker.biasGradients[l][i]; }
+                    add(params.bias[i], sum * scale);
+                }
+                for (std::size_t k{}; k < params.weights.size(); ++k)
+                {
+                    double sum{};
+                    for (const auto& worker : myWorkers) { sum += worker.weightGradients[l][k]; }
+                    add(params.weights[k], sum * scale);
+                }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void ParallelTrainer::loadParameters() noexcept
+{
+    // Copy the bias and weight values of each layer.
+    for (std::size_t l{}; l < myLayers.size(); ++l)
+    {
+        const auto* layer{myLayers[l]};
+        auto& params{myParameters[l]};
+
+        for (std::size_t i{}; i < layer->nodeCount(); ++i)
+        {
+            params.bias[i].store(layer->bias()[i], std::memory_order_relaxed);
+
+            for (std::size_t j{}; j < layer->weightCount(); ++j)
+            {
+                params.weights[i * params.weightCount + j].store(layer->weights()[i][j],
+                                                                 std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void ParallelTrainer::storeParameters() const
+{
+    // Copy the shared parameters back to each layer.
+    for (std::size_t l{}; l < myLayers.size(); ++l)
+    {
+        const auto& params{myParameters[l]};
+        std::vector<double> bias(params.bias.size());
+        std::vector<std::vector<double>> weights(params.bias.size(), 
+                                                 std::vector<double>(params.weightCount));
+
+        for (std::size_t i{}; i < bias.size(); ++i)
+        {
+            bias[i] = load(params.bias[i]);
+
+            for (std::size_t j{}; j < params.weightCount; ++j)
+            {
+                weights[i][j] = load(params.weights[i * params.weightCount + j]);
+            }
+        }
+        myLayers[l]->setParameters(bias, weights);
+    }
+}
+} // namespace ml::train
@@ -0,0 +1,190 @@
+/**
+ * @brief Multithreaded trainer for networks consisting of dense layers.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "ml/dense_layer/dense_layer.h"
+#include "ml/utils/thread_pool.h"
+
+namespace ml::train
+{
+/**
+ * @brief Enumeration of parallel training modes.
+ */
+enum class Mode
+{
+    Synchronous, ///< Workers compute gradients of a mini-batch, which are reduced and applied.
+    Hogwild,     ///< Workers apply their updates directly to the shared parameters without locks.
+};
+
+/**
+ * @brief Multithreaded trainer for a stack of dense layers.
+ * 
+ *        The layer parameters are copied into a shared parameter store during training and
+ *        written back to the layers once training is finished. In Hogwild mode, each worker
+ *        reads and updates the shared parameters via relaxed atomic loads and stores. Concurrent
+ *        updates of the same parameter may overwrite each other, which is accepted, since updates
+ *        rarely collide with sparse inputs (weights connected to zero inputs are never updated).
+ */
+class ParallelTrainer final
+{
+public:
+    /**
+     * @brief Create a new parallel trainer.
+     * 
+     * @param[in] layers The layers to train, in feedforward order.
+     * @param[in] trainInput Training input data.
+     * @param[in] trainOutput Training output data.
+     * @param[in] threadCount The number of worker threads (default = hardware concurrency).
+     * @param[in] seed Seed used to shuffle the training data (default = 0).
+     */
+    explicit ParallelTrainer(const std::vector<ml::dense_layer::DenseLayer*>& layers,
+                             const std::vector<std::vector<double>>& trainInput,
+                             const std::vector<std::vector<double>>& trainOutput,
+                             const std::size_t threadCount = std::thread::hardware_concurrency(),
+                             const unsigned seed = 0U);
+
+    /**
+     * @brief Delete the parallel trainer.
+     */
+    ~ParallelTrainer() noexcept = default;
+
+    /**
+     * @brief Get the number of worker threads.
+     * 
+     * @return The number of worker threads.
+     */
+    std::size_t threadCount() const noexcept;
+
+    /**
+     * @brief Train the layers with the training data.
+     * 
+     * @param[in] epochCount The number of epochs to train.
+     * @param[in] learningRate The learning rate to use. Must exceed 0.
+     * @param[in] mode The training mode to use.
+     * @param[in] batchSize Mini-batch size used in synchronous mode (default = 32).
+     * 
+     * @return True if training was performed, or false on error.
+     */
+    bool train(const std::size_t epochCount, const double learningRate, const Mode mode,
+               const std::size_t batchSize = 32U);
+
+    /**
+     * @brief Compute the mean squared error of the layers on the training data.
+     * 
+     * @return The mean squared error.
+     */
+    double loss();
+
+    ParallelTrainer()                                  = delete; // No default constructor.
+    ParallelTrainer(const ParallelTrainer&)            = delete; // No copy constructor.
+    ParallelTrainer(ParallelTrainer&&)                 = delete; // No move constructor.
+    ParallelTrainer& operator=(const ParallelTrainer&) = delete; // No copy assignment.
+    ParallelTrainer& operator=(ParallelTrainer&&)      = delete; // No move assignment.
+
+private:
+    /**
+     * @brief Structure holding the shared parameters of a layer.
+     */
+    struct Parameters
+    {
+        /** Bias values. */
+        std::vector<std::atomic<double>> bias;
+
+        /** Weights: [i * weightCount + j] => i = node index, j = weight index. */
+        std::vector<std::atomic<double>> weights;
+
+        /** The number of weights per node. */
+        std::size_t weightCount;
+
+        /** The activation function of the layer. */
+        ml::ActFunc actFunc;
+    };
+
+    /**
+     * @brief Structure holding the private state of a worker.
+     */
+    struct Worker
+    {
+        /** Node outputs of each layer. */
+        std::vector<std::vector<double>> output;
+
+        /** Node errors of each layer. */
+        std::vector<std::vector<double>> error;
+
+        /** Accumulated bias gradients of each layer (synchronous mode only). */
+        std::vector<std::vector<double>> biasGradients;
+
+        /** Accumulated weight gradients of each layer (synchronous mode only). */
+        std::vector<std::vector<double>> weightGradients;
+    };
+
+    /**
+     * @brief Perform feedforward with the shared parameters, store the result in the worker.
+     */
+    void feedforward(Worker& worker, const std::vector<double>& input) const noexcept;
+
+    /**
+     * @brief Compute the node errors of the worker with the shared parameters.
+     */
+    void backpropagate(Worker& worker, const std::vector<double>& reference) const noexcept;
+
+    /**
+     * @brief Apply the updates of the worker directly to the shared parameters (Hogwild mode).
+     */
+    void optimize(const Worker& worker, const std::vector<double>& input,
+                  const double learningRate) noexcept;
+
+    /**
+     * @brief Add the gradients of the worker to its private buffers (synchronous mode).
+     */
+    void accumulate(Worker& worker, const std::vector<double>& input) const noexcept;
+
+    /**
+     * @brief Train in Hogwild mode; each worker trains on its own shard of the training data.
+     */
+    void trainHogwild(const std::size_t epochCount, const double learningRate);
+
+    /**
+     * @brief Train in synchronous mode; the gradients are reduced after every mini-batch.
+     */
+    void trainSynchronous(const std::size_t epochCount, const double learningRate,
+                          const std::size_t batchSize);
+
+    /**
+     * @brief Copy the layer parameters to the shared parameter store.
+     */
+    void loadParameters() noexcept;
+
+    /**
+     * @brief Copy the shared parameters back to the layers.
+     */
+    void storeParameters() const;
+
+    /** The layers to train. */
+    const std::vector<ml::dense_layer::DenseLayer*> myLayers;
+
+    /** Training input data. */
+    const std::vector<std::vector<double>>& myTrainInput;
+
+    /** Training output data. */
+    const std::vector<std::vector<double>>& myTrainOutput;
+
+    /** Shared parameters of each layer. */
+    std::vector<Parameters> myParameters;
+
+    /** Private state of each worker. */
+    std::vector<Worker> myWorkers;
+
+    /** Thread pool executing the workers. */
+    ml::utils::ThreadPool myThreadPool;
+
+    /** Seed used to shuffle the training data. */
+    unsigned mySeed;
+};
+} // namespace ml::train
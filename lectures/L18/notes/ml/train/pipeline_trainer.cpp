@@ -0,0 +1,508 @@
+/**
+ * @brief Pipeline-parallel trainer implementation details.
+ */
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "ml/act_func.h"
+#include "ml/train/pipeline_trainer.h"
+
+namespace ml::train
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+template <typename T>
+void push(ml::utils::SpscQueue<T>& queue, const T& value) noexcept
+{
+    // The queue holds a full mini-batch of messages, so it is only full if a stage lags behind.
+    while (!queue.push(value)) { std::this_thread::yield(); }
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+T pop(ml::utils::SpscQueue<T>& queue) noexcept
+{
+    T value{};
+    while (!queue.pop(value)) { std::this_thread::yield(); }
+    return value;
+}
+
+// -----------------------------------------------------------------------------
+std::vector<std::size_t> partition(const std::vector<ml::dense_layer::DenseLayer*>& layers,
+                                   const std::size_t stageCount)
+{
+    // Count the parameters of each layer and of the whole network.
+    std::vector<double> parameterCounts{};
+    for (const auto* layer : layers)
+    {
+        parameterCounts.push_back(static_cast<double>(layer->nodeCount() *
+                                                      (layer->weightCount() + 1U)));
+    }
+    const auto total{std::accumulate(parameterCounts.begin(), parameterCounts.end(), 0.0)};
+
+    // Start a new stage once the current stages hold their share of the parameters, or when
+    // every remaining layer is needed to form a stage of its own.
+    std::vector<std::size_t> firstLayers{0U};
+    double sum{};
+
+    for (std::size_t l{}; l < layers.size(); ++l)
+    {
+        const auto remainingStages{stageCount - firstLayers.size()};
+        if ((0U < l) && (0U < remainingStages) &&
+            ((total * firstLayers.size() / stageCount <= sum) ||
+             (layers.size() - l == remainingStages)))
+        {
+            firstLayers.push_back(l);
+        }
+        sum += parameterCounts[l];
+    }
+    return firstLayers;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+PipelineTrainer::PipelineTrainer(const std::vector<ml::dense_layer::DenseLayer*>& layers,
+                                 const std::vector<std::vector<double>>& trainInput,
+                                 const std::vector<std::vector<double>>& trainOutput,
+                                 const std::size_t stageCount, const unsigned seed)
+    : myLayers{layers}
+    , myTrainInput{trainInput}
+    , myTrainOutput{trainOutput}
+    , myStages{}
+    , myForwardQueues{}
+    , myBackwardQueues{}
+    , myTrainTime{}
+    , mySeed{seed}
+{
+    // Make sure the layers are valid and properly connected.
+    if (layers.empty() || trainInput.empty() || (trainInput.size() != trainOutput.size()))
+    {
+        throw std::invalid_argument("Invalid pipeline trainer parameters: no layers or data!");
+    }
+    for (std::size_t i{}; i < layers.size(); ++i)
+    {
+        if ((nullptr == layers[i]) ||
+            ((0U < i) && (layers[i]->weightCount() != layers[i - 1U]->nodeCount())))
+        {
+            throw std::invalid_argument("Invalid pipeline trainer parameters: layer mismatch!");
+        }
+    }
+    // Make sure the training data matches the first and the last layer.
+    for (std::size_t i{}; i < trainInput.size(); ++i)
+    {
+        if ((trainInput[i].size() != layers.front()->weightCount()) ||
+            (trainOutput[i].size() != layers.back()->nodeCount()))
+        {
+            throw std::invalid_argument("Invalid pipeline trainer parameters: data mismatch!");
+        }
+    }
+
+    // Divide the layers into stages, use at least one stage and at most one stage per layer.
+    const auto firstLayers{
+        partition(layers, std::clamp<std::size_t>(stageCount, 1U, layers.size()))};
+
+    for (std::size_t s{}; s < firstLayers.size(); ++s)
+    {
+        const auto end{s + 1U < firstLayers.size() ? firstLayers[s + 1U] : layers.size()};
+        Stage stage{{}, firstLayers[s], {}, {}, 0.0};
+
+        for (auto l{firstLayers[s]}; l < end; ++l)
+        {
+            const auto* layer{layers[l]};
+            const auto parameterCount{layer->nodeCount() * layer->weightCount()};
+            stage.layers.push_back(Layer{layer->nodeCount(), layer->weightCount(),
+                                         layer->actFunc(), std::vector<double>(layer->nodeCount()),
+                                         std::vector<double>(parameterCount),
+                                         std::vector<double>(layer->nodeCount(), 0.0),
+                                         std::vector<double>(parameterCount, 0.0), {}, {}});
+        }
+        myStages.push_back(std::move(stage));
+    }
+    loadParameters();
+}
+
+// -----------------------------------------------------------------------------
+std::size_t PipelineTrainer::stageCount() const noexcept { return myStages.size(); }
+
+// -----------------------------------------------------------------------------
+std::vector<std::size_t> PipelineTrainer::stageLayers() const
+{
+    std::vector<std::size_t> firstLayers{};
+    for (const auto& stage : myStages) { firstLayers.push_back(stage.firstLayer); }
+    return firstLayers;
+}
+
+// -----------------------------------------------------------------------------
+bool PipelineTrainer::train(const std::size_t epochCount, const double learningRate,
+                            const std::size_t batchSize, const std::size_t microBatchCount)
+{
+    // Validate the learning rate, the batch size and the micro-batch count.
+    if (0.0 >= learningRate)
+    {
+        std::cout << "Invalid learning rate " << learningRate << "!\n";
+        return false;
+    }
+    if ((0U == batchSize) || (0U == microBatchCount))
+    {
+        std::cout << "Invalid batch size " << batchSize << " or micro-batch count "
+                  << microBatchCount << "!\n";
+        return false;
+    }
+
+    // Allocate the buffers of each micro-batch up front, so no allocation occurs while training.
+    const auto microBatchSize{(batchSize + microBatchCount - 1U) / microBatchCount};
+    const auto inputCount{myLayers.front()->weightCount()};
+
+    for (std::size_t s{}; s < myStages.size(); ++s)
+    {
+        auto& stage{myStages[s]};
+        stage.busyTime = 0.0;
+        stage.input.assign(0U == s ? microBatchCount : 0U,
+                           std::vector<double>(microBatchSize * inputCount));
+        stage.inputError.assign(
+            0U == s ? 0U : microBatchCount,
+            std::vector<double>(microBatchSize * stage.layers.front().weightCount));
+
+        for (auto& layer : stage.layers)
+        {
+            layer.output.assign(microBatchCount,
+                                std::vector<double>(microBatchSize * layer.nodeCount));
+            layer.error.assign(microBatchSize * layer.nodeCount, 0.0);
+        }
+    }
+    myForwardQueues.clear();
+    myBackwardQueues.clear();
+
+    for (std::size_t s{}; s + 1U < myStages.size(); ++s)
+    {
+        myForwardQueues.push_back(std::make_unique<Queue>(microBatchCount));
+        myBackwardQueues.push_back(std::make_unique<Queue>(microBatchCount));
+    }
+
+    // Start from the current layer parameters, run each stage in its own thread.
+    loadParameters();
+    const auto start{std::chrono::steady_clock::now()};
+    std::vector<std::thread> threads{};
+
+    for (std::size_t s{}; s < myStages.size(); ++s)
+    {
+        threads.emplace_back(&PipelineTrainer::runStage, this, s, epochCount, learningRate,
+                             batchSize, microBatchCount);
+    }
+    for (auto& thread : threads) { thread.join(); }
+
+    const std::chrono::duration<double> duration{std::chrono::steady_clock::now() - start};
+    myTrainTime = duration.count();
+    storeParameters();
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+double PipelineTrainer::loss()
+{
+    double sum{};
+    std::size_t count{};
+    std::vector<double> input{};
+
+    // Feed each sample through all stages sequentially, using the first micro-batch buffers.
+    loadParameters();
+    for (auto& stage : myStages)
+    {
+        for (auto& layer : stage.layers)
+        {
+            if (layer.output.empty())
+            {
+                layer.output.assign(1U, std::vector<double>(layer.nodeCount));
+            }
+        }
+    }
+    for (std::size_t i{}; i < myTrainInput.size(); ++i)
+    {
+        const double* layerInput{myTrainInput[i].data()};
+
+        for (auto& stage : myStages)
+        {
+            for (auto& layer : stage.layers)
+            {
+                feedforward(layer, layerInput, 0U, 1U);
+                layerInput = layer.output[0U].data();
+            }
+        }
+        for (std::size_t j{}; j < myTrainOutput[i].size(); ++j)
+        {
+            const auto error{myTrainOutput[i][j] - layerInput[j]};
+            sum += error * error;
+            ++count;
+        }
+    }
+    return 0U < count ? sum / count : 0.0;
+}
+
+// -----------------------------------------------------------------------------
+double PipelineTrainer::bubbleOverhead() const noexcept
+{
+    if (0.0 >= myTrainTime) { return 0.0; }
+    double busyTime{};
+    for (const auto& stage : myStages) { busyTime += stage.busyTime; }
+    return std::max(0.0, 1.0 - busyTime / (myTrainTime * myStages.size()));
+}
+
+// -----------------------------------------------------------------------------
+double PipelineTrainer::idealBubbleOverhead(const std::size_t stageCount,
+                                            const std::size_t microBatchCount) noexcept
+{
+    const auto slotCount{microBatchCount + stageCount - 1U};
+    return 0U < slotCount ? static_cast<double>(stageCount - 1U) / slotCount : 0.0;
+}
+
+// -----------------------------------------------------------------------------
+void PipelineTrainer::runStage(const std::size_t index, const std::size_t epochCount,
+                               const double learningRate, const std::size_t batchSize,
+                               const std::size_t microBatchCount)
+{
+    using Clock = std::chrono::steady_clock;
+
+    auto& stage{myStages[index]};
+    const bool isFirst{0U == index};
+    const bool isLast{myStages.size() - 1U == index};
+    auto& lastLayer{stage.layers.back()};
+    std::vector<const double*> inputs(microBatchCount, nullptr);
+
+    // Every stage shuffles with the same seed, so all stages agree on the sample order.
+    std::mt19937 generator{mySeed};
+    std::vector<std::size_t> order(myTrainInput.size());
+    std::iota(order.begin(), order.end(), 0U);
+
+    // Add the time elapsed since the given start to the busy time of the stage.
+    const auto addBusyTime{[&stage](const Clock::time_point start) {
+        const std::chrono::duration<double> duration{Clock::now() - start};
+        stage.busyTime += duration.count();
+    }};
+
+    for (std::size_t epoch{}; epoch < epochCount; ++epoch)
+    {
+        std::shuffle(order.begin(), order.end(), generator);
+
+        for (std::size_t begin{}; begin < order.size(); begin += batchSize)
+        {
+            const auto batchLength{std::min(order.size(), begin + batchSize) - begin};
+            const auto count{std::min(microBatchCount, batchLength)};
+
+            // Get the index of the first sample of the given micro-batch.
+            const auto firstSample{[&](const std::size_t m) {
+                return begin + m * batchLength / count;
+            }};
+
+            // Forward pass: feed each micro-batch through the stage and pass it on.
+            for (std::size_t m{}; m < count; ++m)
+            {
+                const auto sampleCount{firstSample(m + 1U) - firstSample(m)};
+
+                if (isFirst)
+                {
+                    for (std::size_t s{}; s < sampleCount; ++s)
+                    {
+                        const auto& sample{myTrainInput[order[firstSample(m) + s]]};
+                        std::copy(sample.begin(), sample.end(),
+                                  stage.input[m].begin() + s * sample.size());
+                    }
+                    inputs[m] = stage.input[m].data();
+                }
+                else { inputs[m] = pop(*myForwardQueues[index - 1U]).data; }
+
+                const auto start{Clock::now()};
+                const double* layerInput{inputs[m]};
+
+                for (auto& layer : stage.layers)
+                {
+                    feedforward(layer, layerInput, m, sampleCount);
+                    layerInput = layer.output[m].data();
+                }
+                addBusyTime(start);
+                if (!isLast) { push(*myForwardQueues[index], Message{m, layerInput}); }
+            }
+
+            // Backward pass: propagate the errors of each micro-batch in reverse order.
+            for (std::size_t m{count}; 0U < m--;)
+            {
+                const auto sampleCount{firstSample(m + 1U) - firstSample(m)};
+                const double* outputError{isLast ? nullptr : pop(*myBackwardQueues[index]).data};
+                const auto start{Clock::now()};
+                const auto& output{lastLayer.output[m]};
+
+                // Compute the errors of the last layer of the stage.
+                for (std::size_t s{}; s < sampleCount; ++s)
+                {
+                    const auto* reference{isLast ? myTrainOutput[order[firstSample(m) + s]].data()
+                                                 : nullptr};
+
+                    for (std::size_t i{}; i < lastLayer.nodeCount; ++i)
+                    {
+                        const auto k{s * lastLayer.nodeCount + i};
+                        const auto error{isLast ? reference[i] - output[k] : outputError[k]};
+                        lastLayer.error[k] = error * ml::actFuncDelta(lastLayer.actFunc, output[k]);
+                    }
+                }
+                auto* inputError{isFirst ? nullptr : stage.inputError[m].data()};
+                backpropagate(stage, inputs[m], m, sampleCount, inputError);
+                addBusyTime(start);
+
+                // The input of this micro-batch is no longer used, so the sender may reuse it.
+                if (!isFirst) { push(*myBackwardQueues[index - 1U], Message{m, inputError}); }
+            }
+
+            // Apply the mean gradient of the mini-batch, then clear the accumulated gradients.
+            const auto start{Clock::now()};
+            const auto scale{learningRate / batchLength};
+
+            for (auto& layer : stage.layers)
+            {
+                for (std::size_t i{}; i < layer.bias.size(); ++i)
+                {
+                    layer.bias[i] += layer.biasGradients[i] * scale;
+                    layer.biasGradients[i] = 0.0;
+                }
+                for (std::size_t k{}; k < layer.weights.size(); ++k)
+                {
+                    layer.weights[k] += layer.weightGradients[k] * scale;
+                    layer.weightGradients[k] = 0.0;
+                }
+            }
+            addBusyTime(start);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void PipelineTrainer::feedforward(Layer& layer, const double* input, const std::size_t microBatch,
+                                  const std::size_t sampleCount) const noexcept
+{
+    auto* output{layer.output[microBatch].data()};
+
+    // Compute the output of each node for each sample of the micro-batch.
+    for (std::size_t s{}; s < sampleCount; ++s)
+    {
+        const auto* sampleInput{input + s * layer.weightCount};
+
+        for (std::size_t i{}; i < layer.nodeCount; ++i)
+        {
+            const auto* weights{&layer.weights[i * layer.weightCount]};
+            auto sum{layer.bias[i]};
+
+            for (std::size_t j{}; j < layer.weightCount; ++j)
+            {
+                sum += sampleInput[j] * weights[j];
+            }
+            output[s * layer.nodeCount + i] = ml::actFuncOutput(layer.actFunc, sum);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void PipelineTrainer::backpropagate(Stage& stage, const double* input,
+                                    const std::size_t microBatch, const std::size_t sampleCount,
+                                    double* inputError) const noexcept
+{
+    for (std::size_t l{stage.layers.size()}; 0U < l--;)
+    {
+        auto& layer{stage.layers[l]};
+        const auto* layerInput{0U < l ? stage.layers[l - 1U].output[microBatch].data() : input};
+
+        // Errors with respect to the layer input: the previous layer or the stage input.
+        double* previousError{0U < l ? stage.layers[l - 1U].error.data() : inputError};
+
+        for (std::size_t s{}; s < sampleCount; ++s)
+        {
+            const auto* error{&layer.error[s * layer.nodeCount]};
+            const auto* sampleInput{layerInput + s * layer.weightCount};
+            auto* sampleError{nullptr != previousError ? previousError + s * layer.weightCount
+                                                       : nullptr};
+
+            if (nullptr != sampleError)
+            {
+                std::fill(sampleError, sampleError + layer.weightCount, 0.0);
+            }
+
+            // Accumulate the gradients and the weighted errors of the layer input.
+            for (std::size_t i{}; i < layer.nodeCount; ++i)
+            {
+                if (0.0 == error[i]) { continue; }
+                const auto* weights{&layer.weights[i * layer.weightCount]};
+                auto* weightGradients{&layer.weightGradients[i * layer.weightCount]};
+                layer.biasGradients[i] += error[i];
+
+                for (std::size_t j{}; j < layer.weightCount; ++j)
+                {
+                    weightGradients[j] += error[i] * sampleInput[j];
+                }
+                if (nullptr == sampleError) { continue; }
+
+                for (std::size_t j{}; j < layer.weightCount; ++j)
+                {
+                    sampleError[j] += error[i] * weights[j];
+                }
+            }
+
+            // Scale by the activation derivative within the stage (the receiving stage does it
+            // for errors passed between stages).
+            if (0U < l)
+            {
+                const auto& previous{stage.layers[l - 1U]};
+                for (std::size_t j{}; j < layer.weightCount; ++j)
+                {
+                    sampleError[j] *= ml::actFuncDelta(previous.actFunc, sampleInput[j]);
+                }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void PipelineTrainer::loadParameters() noexcept
+{
+    // Copy the bias and weight values of each layer to its stage.
+    for (auto& stage : myStages)
+    {
+        for (std::size_t l{}; l < stage.layers.size(); ++l)
+        {
+            const auto* source{myLayers[stage.firstLayer + l]};
+            auto& layer{stage.layers[l]};
+
+            for (std::size_t i{}; i < layer.nodeCount; ++i)
+            {
+                layer.bias[i] = source->bias()[i];
+                std::copy(source->weights()[i].begin(), source->weights()[i].end(),
+                          layer.weights.begin() + i * layer.weightCount);
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void PipelineTrainer::storeParameters() const
+{
+    // Copy the stage parameters back to each layer.
+    for (const auto& stage : myStages)
+    {
+        for (std::size_t l{}; l < stage.layers.size(); ++l)
+        {
+            const auto& layer{stage.layers[l]};
+            std::vector<std::vector<double>> weights(layer.nodeCount);
+
+            for (std::size_t i{}; i < layer.nodeCount; ++i)
+            {
+                weights[i].assign(layer.weights.begin() + i * layer.weightCount,
+                                  layer.weights.begin() + (i + 1U) * layer.weightCount);
+            }
+            myLayers[stage.firstLayer + l]->setParameters(layer.bias, weights);
+        }
+    }
+}
+} // namespace ml::train
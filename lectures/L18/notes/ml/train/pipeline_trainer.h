@@ -0,0 +1,221 @@
+/**
+ * @brief Pipeline-parallel trainer for deep stacks of dense layers.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "ml/dense_layer/dense_layer.h"
+#include "ml/utils/spsc_queue.h"
+
+namespace ml::train
+{
+/**
+ * @brief Pipeline-parallel trainer for a stack of dense layers.
+ * 
+ *        The layers are divided into stages of consecutive layers with roughly equal parameter
+ *        counts, and each stage is trained by its own thread. The parameters of a layer are only
+ *        held by its stage, so the weights are never replicated between threads.
+ * 
+ *        Each mini-batch is split into micro-batches, which are streamed through the stages
+ *        with a GPipe schedule: all micro-batches are first fed forward, then propagated
+ *        backwards in reverse order. Activations and errors are handed between neighboring
+ *        stages through lock-free single-producer single-consumer queues. The gradients are
+ *        accumulated over the micro-batches and applied at the end of each mini-batch, so the
+ *        result equals synchronous mini-batch gradient descent.
+ * 
+ *        Stages are idle while the pipeline fills and drains (the bubble); the idle fraction
+ *        is ideally (S - 1) / (M + S - 1) for S stages and M micro-batches.
+ */
+class PipelineTrainer final
+{
+public:
+    /**
+     * @brief Create a new pipeline trainer.
+     * 
+     * @param[in] layers The layers to train, in feedforward order.
+     * @param[in] trainInput Training input data.
+     * @param[in] trainOutput Training output data.
+     * @param[in] stageCount The number of stages (default = hardware concurrency). Limited to
+     *                       the number of layers.
+     * @param[in] seed Seed used to shuffle the training data (default = 0).
+     */
+    explicit PipelineTrainer(const std::vector<ml::dense_layer::DenseLayer*>& layers,
+                             const std::vector<std::vector<double>>& trainInput,
+                             const std::vector<std::vector<double>>& trainOutput,
+                             const std::size_t stageCount = std::thread::hardware_concurrency(),
+                             const unsigned seed = 0U);
+
+    /**
+     * @brief Delete the pipeline trainer.
+     */
+    ~PipelineTrainer() noexcept = default;
+
+    /**
+     * @brief Get the number of pipeline stages.
+     * 
+     * @return The number of pipeline stages.
+     */
+    std::size_t stageCount() const noexcept;
+
+    /**
+     * @brief Get the layers assigned to each stage.
+     * 
+     * @return The index of the first layer of each stage.
+     */
+    std::vector<std::size_t> stageLayers() const;
+
+    /**
+     * @brief Train the layers with the training data.
+     * 
+     * @param[in] epochCount The number of epochs to train.
+     * @param[in] learningRate The learning rate to use. Must exceed 0.
+     * @param[in] batchSize Mini-batch size (default = 32).
+     * @param[in] microBatchCount The number of micro-batches per mini-batch (default = 4).
+     * 
+     * @return True if training was performed, or false on error.
+     */
+    bool train(const std::size_t epochCount, const double learningRate,
+               const std::size_t batchSize = 32U, const std::size_t microBatchCount = 4U);
+
+    /**
+     * @brief Compute the mean squared error of the layers on the training data.
+     * 
+     * @return The mean squared error.
+     */
+    double loss();
+
+    /**
+     * @brief Get the measured bubble overhead of the latest training.
+     * 
+     * @return The fraction of the stage time spent waiting for other stages.
+     */
+    double bubbleOverhead() const noexcept;
+
+    /**
+     * @brief Get the ideal bubble overhead of a GPipe schedule.
+     * 
+     * @param[in] stageCount The number of stages.
+     * @param[in] microBatchCount The number of micro-batches per mini-batch.
+     * 
+     * @return The ideal fraction of the stage time spent idle, (S - 1) / (M + S - 1).
+     */
+    static double idealBubbleOverhead(const std::size_t stageCount,
+                                      const std::size_t microBatchCount) noexcept;
+
+    PipelineTrainer()                                  = delete; // No default constructor.
+    PipelineTrainer(const PipelineTrainer&)            = delete; // No copy constructor.
+    PipelineTrainer(PipelineTrainer&&)                 = delete; // No move constructor.
+    PipelineTrainer& operator=(const PipelineTrainer&) = delete; // No copy assignment.
+    PipelineTrainer& operator=(PipelineTrainer&&)      = delete; // No move assignment.
+
+private:
+    /**
+     * @brief Structure holding the parameters and buffers of a layer within its stage.
+     */
+    struct Layer
+    {
+        /** The number of nodes in the layer. */
+        std::size_t nodeCount;
+
+        /** The number of weights per node. */
+        std::size_t weightCount;
+
+        /** The activation function of the layer. */
+        ml::ActFunc actFunc;
+
+        /** Bias values. */
+        std::vector<double> bias;
+
+        /** Weights: [i * weightCount + j] => i = node index, j = weight index. */
+        std::vector<double> weights;
+
+        /** Accumulated bias gradients of the current mini-batch. */
+        std::vector<double> biasGradients;
+
+        /** Accumulated weight gradients of the current mini-batch. */
+        std::vector<double> weightGradients;
+
+        /** Node outputs of each micro-batch: [m][s * nodeCount + i] => s = sample index. */
+        std::vector<std::vector<double>> output;
+
+        /** Node errors of the micro-batch being propagated backwards. */
+        std::vector<double> error;
+    };
+
+    /**
+     * @brief Structure holding a pipeline stage.
+     */
+    struct Stage
+    {
+        /** The layers of the stage. */
+        std::vector<Layer> layers;
+
+        /** Index of the first layer of the stage in the network. */
+        std::size_t firstLayer;
+
+        /** Input values of each micro-batch (first stage only). */
+        std::vector<std::vector<double>> input;
+
+        /** Errors with respect to the stage input of each micro-batch (all but the first stage). */
+        std::vector<std::vector<double>> inputError;
+
+        /** Time spent computing during the latest training, in seconds. */
+        double busyTime;
+    };
+
+    /**
+     * @brief Structure holding a message passed between stages.
+     * 
+     *        The data is owned by the sending stage and remains valid until the end of the
+     *        mini-batch, so only a pointer is passed.
+     */
+    struct Message
+    {
+        /** Index of the micro-batch within the mini-batch. */
+        std::size_t microBatch;
+
+        /** Activations (forward) or errors (backward) of each sample in the micro-batch. */
+        const double* data;
+    };
+
+    /** Queue passing messages between two neighboring stages. */
+    using Queue = ml::utils::SpscQueue<Message>;
+
+    void runStage(const std::size_t index, const std::size_t epochCount, const double learningRate,
+                  const std::size_t batchSize, const std::size_t microBatchCount);
+    void feedforward(Layer& layer, const double* input, const std::size_t microBatch,
+                     const std::size_t sampleCount) const noexcept;
+    void backpropagate(Stage& stage, const double* input, const std::size_t microBatch,
+                       const std::size_t sampleCount, double* inputError) const noexcept;
+    void loadParameters() noexcept;
+    void storeParameters() const;
+
+    /** The layers to train. */
+    const std::vector<ml::dense_layer::DenseLayer*> myLayers;
+
+    /** Training input data. */
+    const std::vector<std::vector<double>>& myTrainInput;
+
+    /** Training output data. */
+    const std::vector<std::vector<double>>& myTrainOutput;
+
+    /** The pipeline stages. */
+    std::vector<Stage> myStages;
+
+    /** Forward queues: queue i passes activations from stage i to stage i + 1. */
+    std::vector<std::unique_ptr<Queue>> myForwardQueues;
+
+    /** Backward queues: queue i passes errors from stage i + 1 to stage i. */
+    std::vector<std::unique_ptr<Queue>> myBackwardQueues;
+
+    /** Wall time of the latest training, in seconds. */
+    double myTrainTime;
+
+    /** Seed used to shuffle the training data. */
+    unsigned mySeed;
+};
+} // namespace ml::train
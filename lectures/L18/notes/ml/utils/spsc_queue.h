@@ -0,0 +1,111 @@
+/**
+ * @brief Lock-free single-producer single-consumer queue.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace ml::utils
+{
+/**
+ * @brief Bounded lock-free queue for one producer thread and one consumer thread.
+ * 
+ *        The queue is a ring buffer; the producer only writes the tail index and the consumer
+ *        only writes the head index, so no locks or read-modify-write operations are needed.
+ *        The indices are stored on separate cache lines to avoid false sharing.
+ * 
+ * @tparam T The value type. Must be trivially copyable.
+ */
+template <typename T>
+class SpscQueue final
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SPSC queue values must be trivially copyable!");
+
+public:
+    /**
+     * @brief Create a new queue.
+     * 
+     * @param[in] capacity The minimum number of values the queue can hold. Rounded up to the
+     *                     nearest power of two.
+     */
+    explicit SpscQueue(const std::size_t capacity)
+        : myBuffer(roundUp(capacity))
+        , myMask{myBuffer.size() - 1U}
+        , myHead{0U}
+        , myTail{0U}
+    {}
+
+    /**
+     * @brief Delete the queue.
+     */
+    ~SpscQueue() noexcept = default;
+
+    /**
+     * @brief Push a value to the queue. May only be called by the producer thread.
+     * 
+     * @param[in] value The value to push.
+     * 
+     * @return True if the value was pushed, or false if the queue is full.
+     */
+    bool push(const T& value) noexcept
+    {
+        const auto tail{myTail.load(std::memory_order_relaxed)};
+        if (tail - myHead.load(std::memory_order_acquire) == myBuffer.size()) { return false; }
+
+        // Write the value before publishing the new tail to the consumer.
+        myBuffer[tail & myMask] = value;
+        myTail.store(tail + 1U, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop a value from the queue. May only be called by the consumer thread.
+     * 
+     * @param[out] value Reference to store the popped value in.
+     * 
+     * @return True if a value was popped, or false if the queue is empty.
+     */
+    bool pop(T& value) noexcept
+    {
+        const auto head{myHead.load(std::memory_order_relaxed)};
+        if (head == myTail.load(std::memory_order_acquire)) { return false; }
+
+        // Read the value before releasing its slot to the producer.
+        value = myBuffer[head & myMask];
+        myHead.store(head + 1U, std::memory_order_release);
+        return true;
+    }
+
+    SpscQueue()                            = delete; // No default constructor.
+    SpscQueue(const SpscQueue&)            = delete; // No copy constructor.
+    SpscQueue(SpscQueue&&)                 = delete; // No move constructor.
+    SpscQueue& operator=(const SpscQueue&) = delete; // No copy assignment.
+    SpscQueue& operator=(SpscQueue&&)      = delete; // No move assignment.
+
+private:
+    /** Assumed cache line size in bytes. */
+    static constexpr std::size_t CacheLineSize{64U};
+
+    static std::size_t roundUp(const std::size_t capacity) noexcept
+    {
+        std::size_t size{1U};
+        while (size < capacity) { size *= 2U; }
+        return size;
+    }
+
+    /** Ring buffer holding the values. */
+    std::vector<T> myBuffer;
+
+    /** Mask used to wrap the indices into the ring buffer. */
+    const std::size_t myMask;
+
+    /** Index of the next value to pop (written by the consumer only). */
+    alignas(CacheLineSize) std::atomic<std::size_t> myHead;
+
+    /** Index of the next value to push (written by the producer only). */
+    alignas(CacheLineSize) std::atomic<std::size_t> myTail;
+};
+} // namespace ml::utils
@@ -0,0 +1,85 @@
+/**
+ * @brief Thread pool implementation details.
+ */
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "ml/utils/thread_pool.h"
+
+namespace ml::utils
+{
+// -----------------------------------------------------------------------------
+ThreadPool::ThreadPool(const std::size_t threadCount)
+    : myWorkers{}
+    , myTasks{}
+    , myMutex{}
+    , myCondition{}
+    , myStopped{false}
+{
+    // Create the worker threads, use at least one thread.
+    const std::size_t workerCount{0U < threadCount ? threadCount : 1U};
+    myWorkers.reserve(workerCount);
+
+    for (std::size_t i{}; i < workerCount; ++i)
+    {
+        myWorkers.emplace_back(&ThreadPool::run, this);
+    }
+}
+
+// -----------------------------------------------------------------------------
+ThreadPool::~ThreadPool() noexcept
+{
+    // Signal the workers to stop once the task queue is empty.
+    {
+        std::lock_guard<std::mutex> lock{myMutex};
+        myStopped = true;
+    }
+    myCondition.notify_all();
+
+    // Wait for the workers to finish.
+    for (auto& worker : myWorkers) { worker.join(); }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t ThreadPool::threadCount() const noexcept { return myWorkers.size(); }
+
+// -----------------------------------------------------------------------------
+std::future<void> ThreadPool::submit(std::function<void()> task)
+{
+    // Wrap the task so that the caller can wait for it to finish.
+    std::packaged_task<void()> packagedTask{std::move(task)};
+    auto future{packagedTask.get_future()};
+
+    // Add the task to the queue, then wake up one worker.
+    {
+        std::lock_guard<std::mutex> lock{myMutex};
+        myTasks.push(std::move(packagedTask));
+    }
+    myCondition.notify_one();
+    return future;
+}
+
+// -----------------------------------------------------------------------------
+void ThreadPool::run() noexcept
+{
+    while (true)
+    {
+        std::packaged_task<void()> task{};
+
+        // Wait for a task, terminate the worker once stopped and no tasks remain.
+        {
+            std::unique_lock<std::mutex> lock{myMutex};
+            myCondition.wait(lock, [this]() { return myStopped || !myTasks.empty(); });
+            if (myTasks.empty()) { return; }
+
+            task = std::move(myTasks.front());
+            myTasks.pop();
+        }
+        // Execute the task; exceptions are stored in the associated future.
+        task();
+    }
+}
+} // namespace ml::utils
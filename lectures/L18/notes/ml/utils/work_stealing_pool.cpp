@@ -0,0 +1,192 @@
+/**
+ * @brief Work-stealing thread pool implementation details.
+ */
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "ml/utils/work_stealing_pool.h"
+
+namespace ml::utils
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+void pinThread(std::thread& thread, const std::size_t cpu) noexcept
+{
+#ifdef __linux__
+    // Restrict the thread to the given CPU; pinning is an optimization, so errors are ignored.
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet);
+#else
+    (void) thread;
+    (void) cpu;
+#endif
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+WorkStealingPool::WorkStealingPool(const std::size_t threadCount, const bool pinThreads)
+    : myWorkers{}
+    , myPendingCount{0U}
+    , myStopping{false}
+    , myMutex{}
+    , myWorkCondition{}
+    , myDoneCondition{}
+    , myRunMutex{}
+{
+    // Create at least one worker, create all queues before any worker starts stealing.
+    const auto workerCount{std::max<std::size_t>(threadCount, 1U)};
+    for (std::size_t i{}; i < workerCount; ++i) { myWorkers.push_back(std::make_unique<Worker>()); }
+
+    const auto cpuCount{std::max(std::thread::hardware_concurrency(), 1U)};
+
+    for (std::size_t i{}; i < workerCount; ++i)
+    {
+        myWorkers[i]->thread = std::thread{&WorkStealingPool::work, this, i};
+        if (pinThreads) { pinThread(myWorkers[i]->thread, i % cpuCount); }
+    }
+}
+
+// -----------------------------------------------------------------------------
+WorkStealingPool::~WorkStealingPool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{myMutex};
+        myStopping = true;
+    }
+    myWorkCondition.notify_all();
+    for (auto& worker : myWorkers) { worker->thread.join(); }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t WorkStealingPool::threadCount() const noexcept { return myWorkers.size(); }
+
+// -----------------------------------------------------------------------------
+void WorkStealingPool::reserve(const std::size_t taskCount)
+{
+    // Task i is queued on worker i % threadCount, so each queue holds at most this many tasks.
+    const auto slotCount{(taskCount + myWorkers.size() - 1U) / myWorkers.size()};
+
+    for (auto& worker : myWorkers)
+    {
+        std::lock_guard<std::mutex> lock{worker->mutex};
+        worker->tasks.reserve(slotCount);
+    }
+}
+
+// -----------------------------------------------------------------------------
+void WorkStealingPool::submit(const std::size_t taskCount, const Task& task)
+{
+    if (0U == taskCount) { return; }
+
+    // Only one run at a time, since the tasks refer to the caller's function.
+    std::lock_guard<std::mutex> runLock{myRunMutex};
+
+    // Allocate missing queue slots before any task is queued.
+    reserve(taskCount);
+    {
+        std::lock_guard<std::mutex> lock{myMutex};
+        myPendingCount = taskCount;
+    }
+    // Queue task i on worker i % threadCount, so each index always starts on the same worker.
+    for (std::size_t i{}; i < taskCount; ++i)
+    {
+        auto& worker{*myWorkers[i % myWorkers.size()]};
+        std::lock_guard<std::mutex> lock{worker.mutex};
+        worker.tasks.push_back(Task{task.invoker, task.function, i, task.stealable});
+    }
+    // Wake the workers, then wait until every task has been completed.
+    std::unique_lock<std::mutex> lock{myMutex};
+    myWorkCondition.notify_all();
+    myDoneCondition.wait(lock, [this]() { return 0U == myPendingCount; });
+}
+
+// -----------------------------------------------------------------------------
+bool WorkStealingPool::takeTask(const std::size_t index, Task& task) noexcept
+{
+    // Take the most recently queued task of the own queue first.
+    {
+        auto& worker{*myWorkers[index]};
+        std::lock_guard<std::mutex> lock{worker.mutex};
+        if (worker.first < worker.tasks.size())
+        {
+            task = worker.tasks.back();
+            worker.tasks.pop_back();
+
+            // Reuse the storage from the start once the queue is empty.
+            if (worker.first == worker.tasks.size())
+            {
+                worker.tasks.clear();
+                worker.first = 0U;
+            }
+            return true;
+        }
+    }
+    // Steal the oldest stealable task from another worker.
+    for (std::size_t offset{1U}; offset < myWorkers.size(); ++offset)
+    {
+        auto& victim{*myWorkers[(index + offset) % myWorkers.size()]};
+        std::lock_guard<std::mutex> lock{victim.mutex};
+        if ((victim.first < victim.tasks.size()) && victim.tasks[victim.first].stealable)
+        {
+            task = victim.tasks[victim.first++];
+
+            if (victim.first == victim.tasks.size())
+            {
+                victim.tasks.clear();
+                victim.first = 0U;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+bool WorkStealingPool::hasTask(const std::size_t index) noexcept
+{
+    // Check the own queue and the stealable tasks of the other workers.
+    for (std::size_t offset{}; offset < myWorkers.size(); ++offset)
+    {
+        auto& worker{*myWorkers[(index + offset) % myWorkers.size()]};
+        std::lock_guard<std::mutex> lock{worker.mutex};
+        if ((worker.first < worker.tasks.size()) &&
+            ((0U == offset) || worker.tasks[worker.first].stealable))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+void WorkStealingPool::work(const std::size_t index) noexcept
+{
+    while (true)
+    {
+        Task task{};
+
+        if (takeTask(index, task))
+        {
+            task.invoker(task.function, task.index);
+
+            std::lock_guard<std::mutex> lock{myMutex};
+            if (0U == --myPendingCount) { myDoneCondition.notify_all(); }
+            continue;
+        }
+
+        // Sleep until new tasks are queued; non-stealable tasks of other workers are ignored.
+        std::unique_lock<std::mutex> lock{myMutex};
+        if (myStopping) { return; }
+        myWorkCondition.wait(lock, [this, index]() {
+            return myStopping || hasTask(index);
+        });
+    }
+}
+} // namespace ml::utils
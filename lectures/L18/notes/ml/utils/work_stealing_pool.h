@@ -0,0 +1,172 @@
+/**
+ * @brief Work-stealing thread pool implementation.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ml::utils
+{
+/**
+ * @brief Work-stealing thread pool.
+ * 
+ *        Each worker has its own task queue. Task i of a parallel run is queued on worker
+ *        i % threadCount, so the same task index always starts on the same worker, which keeps
+ *        data first touched by that worker in memory local to it (NUMA first-touch placement).
+ *        A worker that runs out of tasks steals from the other queues, so uneven workloads
+ *        are still balanced.
+ * 
+ *        Optionally, worker i is pinned to CPU i % hardware concurrency (Linux only), so that
+ *        workers never migrate away from the memory they have touched.
+ * 
+ *        The queues keep their storage between runs, so runs that fit in the reserved slots
+ *        (see reserve) don't allocate any memory.
+ */
+class WorkStealingPool final
+{
+public:
+    /**
+     * @brief Create a new work-stealing pool.
+     * 
+     * @param[in] threadCount The number of worker threads (default = hardware concurrency).
+     *                        At least one worker thread is always created.
+     * @param[in] pinThreads Indicate whether to pin each worker to a CPU (default = true).
+     */
+    explicit WorkStealingPool(const std::size_t threadCount = std::thread::hardware_concurrency(),
+                              const bool pinThreads = true);
+
+    /**
+     * @brief Delete the pool. The worker threads are joined.
+     */
+    ~WorkStealingPool() noexcept;
+
+    /**
+     * @brief Get the number of worker threads in the pool.
+     * 
+     * @return The number of worker threads in the pool.
+     */
+    std::size_t threadCount() const noexcept;
+
+    /**
+     * @brief Reserve queue slots for runs of up to the given number of tasks.
+     * 
+     *        Runs of at most taskCount tasks then never allocate memory, so they can be used in
+     *        noexcept code.
+     * 
+     * @param[in] taskCount The number of tasks to reserve slots for.
+     */
+    void reserve(const std::size_t taskCount);
+
+    /**
+     * @brief Run the given task for each index in [0, taskCount) and wait for completion.
+     * 
+     *        Task i is queued on worker i % threadCount, but may be stolen by an idle worker.
+     *        Queue slots are allocated only if taskCount exceeds the reserved number of tasks.
+     * 
+     * @tparam Function The task type, callable with a task index.
+     * 
+     * @param[in] taskCount The number of tasks to run.
+     * @param[in] task The task to run, called with the task index.
+     */
+    template <typename Function>
+    void run(const std::size_t taskCount, const Function& task)
+    {
+        submit(taskCount, Task{&invoke<Function>, &task, 0U, true});
+    }
+
+    /**
+     * @brief Run the given task once on each worker and wait for completion.
+     * 
+     *        These tasks are never stolen, which makes it possible to allocate and initialize
+     *        data on the worker that will use it.
+     * 
+     * @tparam Function The task type, callable with a worker index.
+     * 
+     * @param[in] task The task to run, called with the worker index.
+     */
+    template <typename Function>
+    void runOnEach(const Function& task)
+    {
+        submit(myWorkers.size(), Task{&invoke<Function>, &task, 0U, false});
+    }
+
+    WorkStealingPool(const WorkStealingPool&)            = delete; // No copy constructor.
+    WorkStealingPool(WorkStealingPool&&)                 = delete; // No move constructor.
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete; // No copy assignment.
+    WorkStealingPool& operator=(WorkStealingPool&&)      = delete; // No move assignment.
+
+private:
+    /**
+     * @brief Structure holding a queued task.
+     */
+    struct Task
+    {
+        /** Function calling the task function with the given index. */
+        void (*invoker)(const void*, std::size_t);
+
+        /** The task function, owned by the caller of the run. */
+        const void* function;
+
+        /** The index to pass to the function. */
+        std::size_t index;
+
+        /** Indicate whether other workers may steal the task. */
+        bool stealable;
+    };
+
+    /**
+     * @brief Structure holding a worker and its task queue.
+     */
+    struct Worker
+    {
+        /** Queued tasks in [first, size); the owner pops from the back, thieves steal the first. */
+        std::vector<Task> tasks;
+
+        /** Index of the first queued task. */
+        std::size_t first;
+
+        /** Mutex protecting the task queue. */
+        std::mutex mutex;
+
+        /** The worker thread. */
+        std::thread thread;
+    };
+
+    template <typename Function>
+    static void invoke(const void* function, const std::size_t index)
+    {
+        (*static_cast<const Function*>(function))(index);
+    }
+
+    void work(const std::size_t index) noexcept;
+    bool takeTask(const std::size_t index, Task& task) noexcept;
+    bool hasTask(const std::size_t index) noexcept;
+    void submit(const std::size_t taskCount, const Task& task);
+
+    /** The workers of the pool. */
+    std::vector<std::unique_ptr<Worker>> myWorkers;
+
+    /** The number of submitted tasks not yet completed. */
+    std::size_t myPendingCount;
+
+    /** Indicate whether the pool is stopping. */
+    bool myStopping;
+
+    /** Mutex protecting the pending count and the stop flag. */
+    std::mutex myMutex;
+
+    /** Condition variable signaled when tasks are queued or the pool is stopping. */
+    std::condition_variable myWorkCondition;
+
+    /** Condition variable signaled when all submitted tasks are completed. */
+    std::condition_variable myDoneCondition;
+
+    /** Mutex serializing parallel runs. */
+    std::mutex myRunMutex;
+};
+} // namespace ml::utils
@@ -0,0 +1,160 @@
+/**
+ * @brief Benchmark of pipeline-parallel training of a deep stack of dense layers.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "ml/dense_layer/dense_layer.h"
+#include "ml/train/parallel_trainer.h"
+#include "ml/train/pipeline_trainer.h"
+
+namespace
+{
+/** The number of layers in the network. */
+constexpr std::size_t LayerCount{8U};
+
+/** The number of nodes per layer (except the output layer). */
+constexpr std::size_t NodeCount{256U};
+
+/**
+ * @brief Create random training data, where the output is the sine of the input mean.
+ *
+ * @param[out] input Vector to store the input data in.
+ * @param[out] output Vector to store the output data in.
+ * @param[in] sampleCount The number of samples to create.
+ */
+void createData(std::vector<std::vector<double>>& input, std::vector<std::vector<double>>& output,
+                const std::size_t sampleCount)
+{
+    std::mt19937 generator{1U};
+    std::uniform_real_distribution<double> distribution{-1.0, 1.0};
+    input.assign(sampleCount, std::vector<double>(NodeCount));
+    output.assign(sampleCount, std::vector<double>(1U));
+
+    for (std::size_t i{}; i < sampleCount; ++i)
+    {
+        double sum{};
+        for (auto& value : input[i]) { sum += value = distribution(generator); }
+        output[i][0U] = std::sin(sum / NodeCount * 4.0);
+    }
+}
+
+/**
+ * @brief Create a freshly initialized deep network, identical on every call.
+ *
+ * @return The layers of the network.
+ */
+std::vector<std::unique_ptr<ml::dense_layer::DenseLayer>> createNetwork()
+{
+    std::vector<std::unique_ptr<ml::dense_layer::DenseLayer>> layers{};
+    std::mt19937 generator{1U};
+
+    for (std::size_t l{}; l < LayerCount; ++l)
+    {
+        const auto nodeCount{LayerCount - 1U == l ? 1U : NodeCount};
+        layers.push_back(std::make_unique<ml::dense_layer::DenseLayer>(nodeCount, NodeCount,
+                                                                       ml::ActFunc::Tanh));
+
+        // Scale the initial weights with the number of inputs, so that the activations of the
+        // deep network don't saturate.
+        const auto limit{1.0 / std::sqrt(static_cast<double>(NodeCount))};
+        std::uniform_real_distribution<double> distribution{-limit, limit};
+        std::vector<double> bias(nodeCount, 0.0);
+        std::vector<std::vector<double>> weights(nodeCount, std::vector<double>(NodeCount));
+
+        for (auto& nodeWeights : weights)
+        {
+            for (auto& weight : nodeWeights) { weight = distribution(generator); }
+        }
+        layers.back()->setParameters(bias, weights);
+    }
+    return layers;
+}
+
+/**
+ * @brief Get raw pointers to the given layers.
+ *
+ * @param[in] layers The layers.
+ *
+ * @return Pointers to the layers.
+ */
+std::vector<ml::dense_layer::DenseLayer*> pointers(
+    const std::vector<std::unique_ptr<ml::dense_layer::DenseLayer>>& layers)
+{
+    std::vector<ml::dense_layer::DenseLayer*> result{};
+    for (const auto& layer : layers) { result.push_back(layer.get()); }
+    return result;
+}
+} // namespace
+
+/**
+ * @brief Verify pipeline training against synchronous training, then compare the throughput and
+ *        bubble overhead for various stage and micro-batch counts.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int main()
+{
+    constexpr std::size_t epochCount{2U}, batchSize{32U};
+    constexpr double learningRate{0.05};
+    std::vector<std::vector<double>> input{}, output{};
+    createData(input, output, 512U);
+
+    // Pipeline training performs synchronous mini-batch gradient descent, so it shall match
+    // the synchronous trainer (up to rounding, since the gradients are summed in another order).
+    {
+        auto reference{createNetwork()}, pipelined{createNetwork()};
+        ml::train::ParallelTrainer referenceTrainer{pointers(reference), input, output, 1U};
+        ml::train::PipelineTrainer pipelineTrainer{pointers(pipelined), input, output, 4U};
+        referenceTrainer.train(epochCount, learningRate, ml::train::Mode::Synchronous, batchSize);
+        pipelineTrainer.train(epochCount, learningRate, batchSize, 4U);
+
+        double maxDifference{};
+        for (std::size_t l{}; l < LayerCount; ++l)
+        {
+            for (std::size_t i{}; i < reference[l]->nodeCount(); ++i)
+            {
+                for (std::size_t j{}; j < reference[l]->weightCount(); ++j)
+                {
+                    maxDifference = std::max(maxDifference, std::abs(
+                        reference[l]->weights()[i][j] - pipelined[l]->weights()[i][j]));
+                }
+            }
+        }
+        std::cout << "Max weight difference versus synchronous training: " << maxDifference
+                  << "\n\n";
+        if (1e-9 < maxDifference) { return -1; }
+    }
+
+    std::cout << std::left << std::setw(8) << "stages" << std::setw(14) << "micro-batches"
+              << std::setw(14) << "samples/s" << std::setw(10) << "bubble" << std::setw(10)
+              << "ideal" << "loss\n";
+
+    for (const std::size_t stageCount : {1U, 2U, 4U})
+    {
+        for (const std::size_t microBatchCount : {1U, 2U, 4U, 8U})
+        {
+            auto layers{createNetwork()};
+            ml::train::PipelineTrainer trainer{pointers(layers), input, output, stageCount};
+
+            const auto start{std::chrono::steady_clock::now()};
+            trainer.train(epochCount, learningRate, batchSize, microBatchCount);
+            const std::chrono::duration<double> duration{std::chrono::steady_clock::now() - start};
+
+            std::cout << std::left << std::setw(8) << trainer.stageCount() << std::setw(14)
+                      << microBatchCount << std::setw(14) << std::fixed << std::setprecision(0)
+                      << epochCount * input.size() / duration.count() << std::setw(10)
+                      << std::setprecision(3) << trainer.bubbleOverhead() << std::setw(10)
+                      << ml::train::PipelineTrainer::idealBubbleOverhead(trainer.stageCount(),
+                                                                         microBatchCount)
+                      << std::setprecision(4) << trainer.loss() << "\n";
+        }
+    }
+    return 0;
+}
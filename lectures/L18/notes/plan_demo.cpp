@@ -0,0 +1,106 @@
+/**
+ * @brief Comparison of a frozen inference plan with the dense layers it was compiled from.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ml/dense_layer/dense_layer.h"
+#include "ml/inference/plan.h"
+
+/**
+ * @brief Freeze a network of dense layers into an inference plan, then compare the outputs and
+ *        the prediction time of the layers, the plan and the plan in batches for a set of random
+ *        inputs.
+ * 
+ * @return 0 if the outputs match, -1 otherwise.
+ */
+int main()
+{
+    // Implement the network and check parameters as compile-time constants.
+    constexpr std::size_t inputCount{64U}, sampleCount{1000U}, batchSize{32U};
+    constexpr double tolerance{1e-12};
+
+    // The node counts are not multiples of the panel width, so the padding is covered too.
+    ml::dense_layer::DenseLayer hiddenLayer1{301U, inputCount, ml::ActFunc::Relu, 1U};
+    ml::dense_layer::DenseLayer hiddenLayer2{203U, 301U, ml::ActFunc::Tanh, 2U};
+    ml::dense_layer::DenseLayer outputLayer{10U, 203U, ml::ActFunc::Tanh, 3U};
+    const std::vector<ml::dense_layer::DenseLayer*> layers{&hiddenLayer1, &hiddenLayer2,
+                                                           &outputLayer};
+    const auto plan{ml::inference::Plan::freeze({&hiddenLayer1, &hiddenLayer2, &outputLayer})};
+
+    std::mt19937 generator{4U};
+    std::uniform_real_distribution<double> distribution{-0.05, 0.05};
+    std::vector<std::vector<double>> inputs(sampleCount, std::vector<double>(inputCount));
+    for (auto& input : inputs)
+    {
+        for (auto& value : input) { value = distribution(generator); }
+    }
+
+    std::vector<std::vector<double>> expected(sampleCount), actual(sampleCount);
+    std::vector<double> scratch{};
+
+    // Predict with the layers, then with the plan.
+    const auto layerStart{std::chrono::steady_clock::now()};
+    for (std::size_t i{}; i < sampleCount; ++i)
+    {
+        const auto* input{&inputs[i]};
+        for (auto* layer : layers)
+        {
+            if (!layer->feedforward(*input)) { return -1; }
+            input = &layer->output();
+        }
+        expected[i] = *input;
+    }
+    const auto planStart{std::chrono::steady_clock::now()};
+    for (std::size_t i{}; i < sampleCount; ++i)
+    {
+        if (!plan.predict(inputs[i], actual[i], scratch)) { return -1; }
+    }
+    const auto planEnd{std::chrono::steady_clock::now()};
+
+    // Predict with the plan in batches, each weight panel is then streamed once per batch.
+    std::vector<std::vector<double>> batched(sampleCount, std::vector<double>(plan.outputCount()));
+    std::vector<const double*> inputPointers(sampleCount);
+    std::vector<double*> outputPointers(sampleCount);
+    scratch.resize(plan.scratchSize(batchSize));
+    for (std::size_t i{}; i < sampleCount; ++i)
+    {
+        inputPointers[i]  = inputs[i].data();
+        outputPointers[i] = batched[i].data();
+    }
+
+    const auto batchStart{std::chrono::steady_clock::now()};
+    for (std::size_t i{}; i < sampleCount; i += batchSize)
+    {
+        plan.predict(&inputPointers[i], &outputPointers[i], std::min(batchSize, sampleCount - i),
+                     scratch.data());
+    }
+    const auto batchEnd{std::chrono::steady_clock::now()};
+
+    double maxError{}, maxBatchError{};
+    for (std::size_t i{}; i < sampleCount; ++i)
+    {
+        for (std::size_t j{}; j < expected[i].size(); ++j)
+        {
+            maxError      = std::max(maxError, std::abs(expected[i][j] - actual[i][j]));
+            maxBatchError = std::max(maxBatchError, std::abs(expected[i][j] - batched[i][j]));
+        }
+    }
+
+    const std::chrono::duration<double, std::micro> layerTime{planStart - layerStart};
+    const std::chrono::duration<double, std::micro> planTime{planEnd - planStart};
+    const std::chrono::duration<double, std::micro> batchTime{batchEnd - batchStart};
+    const bool match{(tolerance > maxError) && (tolerance > maxBatchError)};
+
+    std::cout << sampleCount << " predictions (" << inputCount << " => 301 => 203 => 10): "
+              << "max difference " << maxError << ", batched " << maxBatchError << " ("
+              << (match ? "match" : "MISMATCH") << ")\n";
+    std::cout << "Mean time per prediction: dense layers " << layerTime.count() / sampleCount
+              << " us, plan " << planTime.count() / sampleCount << " us, plan in batches of "
+              << batchSize << " " << batchTime.count() / sampleCount << " us\n";
+    return match ? 0 : -1;
+}
@@ -0,0 +1,129 @@
+/**
+ * @brief Load generator for the local inference server.
+ */
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ml/checkpoint/checkpoint.h"
+#include "ml/dense_layer/dense_layer.h"
+#include "ml/inference/plan.h"
+#include "ml/serve/client.h"
+#include "ml/serve/server.h"
+
+namespace
+{
+/**
+ * @brief Send requests from several concurrent clients and print the resulting statistics.
+ *
+ *        Each response is compared with a local prediction of the plan.
+ *
+ * @param[in] plan The inference plan to serve.
+ * @param[in] address The address to serve on.
+ * @param[in] latencyBudget The latency budget used for batching.
+ * @param[in] clientCount The number of concurrent clients.
+ * @param[in] requestCount The number of requests sent per client.
+ *
+ * @return True if every response matched the local prediction, false otherwise.
+ */
+bool generateLoad(const ml::inference::Plan& plan, const ml::serve::Address& address,
+                  const std::chrono::microseconds latencyBudget, const std::size_t clientCount,
+                  const std::size_t requestCount)
+{
+    constexpr std::size_t maxBatchSize{32U};
+    ml::serve::Server server{plan, {address, maxBatchSize, latencyBudget, 2U}};
+    std::vector<std::thread> clients{};
+    // One byte per client (not std::vector<bool>, whose packed bits cannot be written
+    // concurrently).
+    std::vector<char> results(clientCount, true);
+
+    // Each client sends its requests one at a time over its own connection.
+    for (std::size_t i{}; i < clientCount; ++i)
+    {
+        clients.emplace_back([&, i]() {
+            ml::serve::Client client{address};
+            std::mt19937 generator{static_cast<unsigned>(i)};
+            std::uniform_real_distribution<double> distribution{-1.0, 1.0};
+            std::vector<double> input(plan.inputCount()), output{}, expected{}, scratch{};
+
+            for (std::size_t j{}; j < requestCount; ++j)
+            {
+                for (auto& value : input) { value = distribution(generator); }
+                if (!client.predict(input, output) || !plan.predict(input, expected, scratch) ||
+                    (output != expected))
+                {
+                    results[i] = false;
+                }
+            }
+        });
+    }
+    for (auto& client : clients) { client.join(); }
+
+    const auto statistics{server.statistics()};
+    const bool passed{std::all_of(results.begin(), results.end(), [](char r) { return r; })};
+    std::cout << std::left << std::setw(12) << latencyBudget.count() << std::setw(10)
+              << clientCount << std::setw(12) << std::fixed << std::setprecision(0)
+              << statistics.throughput << std::setw(12) << std::setprecision(2)
+              << statistics.meanBatchSize << std::setw(12) << std::setprecision(1)
+              << statistics.p50Latency << std::setw(12) << statistics.p99Latency
+              << (passed ? "ok" : "FAILED") << "\n";
+    return passed;
+}
+} // namespace
+
+/**
+ * @brief Save a network, load it and serve it under load with various latency budgets.
+ *
+ *        Usage: serve_demo [socket path | TCP port] (default = Unix domain socket ml_serve.sock).
+ *
+ * @param[in] argc The number of command line arguments.
+ * @param[in] argv The command line arguments.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int main(int argc, char** argv)
+{
+    constexpr std::size_t inputCount{64U}, hiddenCount{128U}, outputCount{8U};
+    constexpr std::size_t requestCount{2000U};
+    constexpr const char* directory{"serve_model"};
+
+    // Use a Unix domain socket by default, or loopback TCP if a port number is given.
+    ml::serve::Address address{argc > 1 ? argv[1] : "ml_serve.sock", 0U};
+    if ((1 < argc) && (std::string{argv[1]}.find_first_not_of("0123456789") == std::string::npos))
+    {
+        address = {"", static_cast<std::uint16_t>(std::stoul(argv[1]))};
+    }
+
+    // Save a network, then load it into new layers as a separate server process would.
+    {
+        const ml::dense_layer::DenseLayer hidden{hiddenCount, inputCount, ml::ActFunc::Tanh, 1U};
+        const ml::dense_layer::DenseLayer output{outputCount, hiddenCount, ml::ActFunc::Tanh, 2U};
+        ml::checkpoint::Writer writer{directory, {&hidden, &output}};
+        if (!writer.save({0U, 0.0, ""}) || !writer.wait()) { return -1; }
+    }
+    ml::dense_layer::DenseLayer hidden{hiddenCount, inputCount};
+    ml::dense_layer::DenseLayer output{outputCount, hiddenCount};
+    ml::checkpoint::State state{};
+    if (!ml::checkpoint::restore(directory, {&hidden, &output}, state)) { return -1; }
+    const auto plan{ml::inference::Plan::freeze({&hidden, &output})};
+
+    std::cout << std::left << std::setw(12) << "budget(us)" << std::setw(10) << "clients"
+              << std::setw(12) << "requests/s" << std::setw(12) << "batch size" << std::setw(12)
+              << "p50(us)" << std::setw(12) << "p99(us)" << "status\n";
+
+    bool passed{true};
+    for (const auto budget : {0, 100, 1000})
+    {
+        for (const std::size_t clientCount : {1U, 8U, 32U})
+        {
+            passed &= generateLoad(plan, address, std::chrono::microseconds{budget}, clientCount,
+                                   requestCount);
+        }
+    }
+    return passed ? 0 : -1;
+}
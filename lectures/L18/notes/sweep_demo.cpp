@@ -0,0 +1,40 @@
+/**
+ * @brief Hyperparameter sweep with single-layer neural networks.
+ */
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "ml/sweep/runner.h"
+#include "ml/types.h"
+
+/**
+ * @brief Evaluate a range of network configurations trained to predict a two-bit XOR pattern.
+ * 
+ * @return 0 on success, or -1 on failure.
+ */
+int main()
+{
+    // Implement the epoch budgets as compile-time constants.
+    constexpr std::size_t minEpochCount{100U};
+    constexpr std::size_t maxEpochCount{3200U};
+
+    // Create training data vectors.
+    const std::vector<std::vector<double>> trainInput{{0,0}, {0,1}, {1,0}, {1,1}};
+    const std::vector<std::vector<double>> trainOutput{{0}, {1}, {1}, {0}};
+
+    // Create every combination of the parameters to evaluate, use the same base seed every run.
+    const auto configs{ml::sweep::Runner::grid({2U, 3U, 4U, 6U, 8U}, {0.01, 0.05, 0.1, 0.2},
+                                               {ml::ActFunc::Relu, ml::ActFunc::Tanh}, 42U)};
+
+    // Train the configurations concurrently, terminate the program on failure.
+    ml::sweep::Runner runner{trainInput, trainOutput};
+    const auto results{runner.run(configs, minEpochCount, maxEpochCount)};
+    if (results.empty()) { return -1; }
+
+    // Print the results in the terminal and write them to a file.
+    ml::sweep::Runner::printResults(results);
+    std::ofstream file{"sweep_results.txt"};
+    ml::sweep::Runner::printResults(results, file);
+    return 0;
+}
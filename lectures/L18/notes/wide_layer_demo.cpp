@@ -0,0 +1,97 @@
+/**
+ * @brief Benchmark of a very wide dense layer with the nodes split across worker threads.
+ */
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "ml/dense_layer/dense_layer.h"
+#include "ml/dense_layer/parallel_dense_layer.h"
+#include "ml/utils/work_stealing_pool.h"
+
+namespace
+{
+/**
+ * @brief Measure the median time of the given function.
+ *
+ * @param[in] function The function to measure.
+ * @param[in] runCount The number of runs.
+ *
+ * @return The median time in microseconds.
+ */
+template <typename Function>
+double medianTime(Function&& function, const std::size_t runCount)
+{
+    std::vector<double> times{};
+
+    for (std::size_t i{}; i < runCount; ++i)
+    {
+        const auto start{std::chrono::steady_clock::now()};
+        function();
+        const std::chrono::duration<double, std::micro> duration{
+            std::chrono::steady_clock::now() - start};
+        times.push_back(duration.count());
+    }
+    std::nth_element(times.begin(), times.begin() + times.size() / 2U, times.end());
+    return times[times.size() / 2U];
+}
+} // namespace
+
+/**
+ * @brief Compare the per-sample latency of a wide dense layer with an increasing number of threads.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int main()
+{
+    // Implement the layer and benchmark parameters as compile-time constants.
+    constexpr std::size_t nodeCount{16384U}, weightCount{512U}, runCount{20U};
+    constexpr double learningRate{1e-6};
+    constexpr unsigned seed{1U};
+
+    std::mt19937 generator{2U};
+    std::uniform_real_distribution<double> distribution{-1.0, 1.0};
+    std::vector<double> input(weightCount), reference(nodeCount);
+    for (auto& value : input) { value = distribution(generator); }
+    for (auto& value : reference) { value = distribution(generator); }
+
+    // The sequential layer serves as the reference for both the results and the latency.
+    ml::dense_layer::DenseLayer sequential{nodeCount, weightCount, ml::ActFunc::Relu, seed};
+    const auto sequentialTime{medianTime([&]() { sequential.feedforward(input); }, runCount)};
+
+    std::cout << std::left << std::setw(10) << "threads" << std::setw(18) << "feedforward(us)"
+              << std::setw(16) << "train step(us)" << std::setw(10) << "speedup" << "result\n";
+    std::cout << std::setw(10) << "-" << std::setw(18) << std::fixed << std::setprecision(0)
+              << sequentialTime << std::setw(16) << "-" << std::setw(10) << "1.00" << "-\n";
+
+    // Double the number of threads up to the hardware concurrency (at least 4 threads).
+    const std::size_t maxThreadCount{std::max(4U, std::thread::hardware_concurrency())};
+    bool identical{true};
+
+    for (std::size_t threadCount{1U}; threadCount <= maxThreadCount; threadCount *= 2U)
+    {
+        ml::utils::WorkStealingPool pool{threadCount};
+        ml::dense_layer::ParallelDenseLayer layer{nodeCount, weightCount, pool,
+                                                  ml::ActFunc::Relu, seed};
+
+        const auto feedforwardTime{medianTime([&]() { layer.feedforward(input); }, runCount)};
+        const bool result{layer.output() == sequential.output()};
+        identical = identical && result;
+
+        const auto trainTime{medianTime([&]() {
+            layer.feedforward(input);
+            layer.backpropagate(reference);
+            layer.optimize(input, learningRate);
+        }, runCount)};
+
+        std::cout << std::setw(10) << threadCount << std::setw(18) << std::setprecision(0)
+                  << feedforwardTime << std::setw(16) << trainTime << std::setw(10)
+                  << std::setprecision(2) << sequentialTime / feedforwardTime
+                  << (result ? "identical" : "DIFFERS") << "\n";
+    }
+    return identical ? 0 : -1;
+}
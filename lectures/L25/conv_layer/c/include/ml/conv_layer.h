@@ -50,6 +50,24 @@ const matrix_t* conv_layer_output(const conv_layer_t* self);
  */
 const matrix_t* conv_layer_input_gradients(const conv_layer_t* self);
 
+/**
+ * @brief Get convolutional layer kernel.
+ * 
+ * @param[in] self Pointer to the convolutional layer.
+ * 
+ * @return Pointer to matrix holding the convolutional layer kernel.
+ */
+const matrix_t* conv_layer_kernel(const conv_layer_t* self);
+
+/**
+ * @brief Get convolutional layer bias.
+ * 
+ * @param[in] self Pointer to the convolutional layer.
+ * 
+ * @return The bias value of the convolutional layer, or 0.0 if the layer is invalid.
+ */
+double conv_layer_bias(const conv_layer_t* self);
+
 /**
  * @brief Run feedforward operation.
  *
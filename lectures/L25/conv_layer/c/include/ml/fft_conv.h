@@ -0,0 +1,75 @@
+/**
+ * @brief Two-dimensional correlation via the fast Fourier transform.
+ */
+#ifndef ML_FFT_CONV_H_
+#define ML_FFT_CONV_H_
+
+#include <stddef.h>
+
+/** FFT convolution structure. */
+typedef struct fft_conv fft_conv_t;
+
+/**
+ * @brief Create a new FFT convolution.
+ *
+ *        The input is split into tiles, each of which is transformed with a radix-2 real FFT,
+ *        multiplied with the kernel spectrum and transformed back. The results of neighboring
+ *        tiles overlap by kernel_size - 1 rows and columns and are added together (overlap-add).
+ *        The tile size is selected to minimize the estimated cost.
+ *
+ * @param[in] input_size Input size (assumed square).
+ * @param[in] kernel_size Kernel size (assumed square).
+ *
+ * @return Pointer to the new FFT convolution, or nullptr in failure.
+ */
+fft_conv_t* fft_conv_new(size_t input_size, size_t kernel_size);
+
+/**
+ * @brief Delete given FFT convolution.
+ *
+ *        Release allocated resources and set the corresponding pointer to null.
+ *
+ * @param[in] self Double pointer to the FFT convolution.
+ */
+void fft_conv_del(fft_conv_t** self);
+
+/**
+ * @brief Replace the kernel and compute its spectrum.
+ *
+ *        The spectrum is kept until the kernel is replaced again.
+ *
+ * @param[in] self Pointer to the FFT convolution.
+ * @param[in] kernel The kernel, kernel_size x kernel_size values stored row-major.
+ * @param[in] kernel_stride The distance between the starts of two kernel rows in elements.
+ */
+void fft_conv_set_kernel(fft_conv_t* self, const double* kernel, size_t kernel_stride);
+
+/**
+ * @brief Correlate the input with the kernel.
+ *
+ *        The output has the same size as the input, as if the input was zero-padded with
+ *        kernel_size / 2 zeros on each edge.
+ *
+ * @param[in] self Pointer to the FFT convolution.
+ * @param[in] input The input, input_size x input_size values stored row-major.
+ * @param[in] input_stride The distance between the starts of two input rows in elements.
+ * @param[out] output The output, input_size x input_size values stored row-major.
+ * @param[in] output_stride The distance between the starts of two output rows in elements.
+ */
+void fft_conv_correlate(fft_conv_t* self, const double* input, size_t input_stride,
+                        double* output, size_t output_stride);
+
+/**
+ * @brief Estimate the number of floating-point operations of a correlation via the FFT.
+ *
+ *        A complex FFT of size N is counted as 5 * N * log2(N) operations, so a real
+ *        two-dimensional transform of size N costs about 5 * N^2 * log2(N) operations.
+ *
+ * @param[in] input_size Input size (assumed square).
+ * @param[in] kernel_size Kernel size (assumed square).
+ *
+ * @return The estimated number of floating-point operations.
+ */
+double fft_conv_cost(size_t input_size, size_t kernel_size);
+
+#endif /** ML_FFT_CONV_H_ */
@@ -1,6 +1,7 @@
 /**
  * @brief Simple convolutional layer demo.
  */
+#include <math.h>
 #include <stdio.h>
 
 #include "ml/conv_layer.h"
@@ -12,8 +13,117 @@
 /** Convolutional layer kernel size. */
 #define KERNEL_SIZE 2U
 
+/** Input size of the FFT check, large enough for the layer to select the FFT. */
+#define FFT_INPUT_SIZE 256U
+
+/** Kernel size of the FFT check. */
+#define FFT_KERNEL_SIZE 11U
+
+/** Largest accepted difference between the FFT and the direct reference. */
+#define FFT_TOLERANCE 1e-9
+
+/**
+ * @brief Fill a matrix with deterministic values in the range [-1, 1].
+ * 
+ * @param[in] self Pointer to the matrix to fill.
+ * @param[in] seed Seed making the values differ between matrices.
+ */
+static void fill_values(matrix_t* self, const double seed)
+{
+    for (size_t i = 0U; i < matrix_rows(self); ++i)
+    {
+        double* row = matrix_row(self, i);
+        for (size_t j = 0U; j < matrix_cols(self); ++j)
+        {
+            row[j] = sin(seed + 0.37 * i + 0.11 * j);
+        }
+    }
+}
+
+/**
+ * @brief Compare the output of a convolutional layer with direct convolution of the given input.
+ * 
+ * @param[in] conv_layer Pointer to the convolutional layer.
+ * @param[in] input Pointer to the input the layer output was computed from.
+ * 
+ * @return The largest difference between the layer output and the direct reference.
+ */
+static double max_difference(const conv_layer_t* conv_layer, const matrix_t* input)
+{
+    const matrix_t* kernel = conv_layer_kernel(conv_layer);
+    const matrix_t* output = conv_layer_output(conv_layer);
+    const size_t size      = matrix_rows(input);
+    const size_t offset    = matrix_rows(kernel) / 2U;
+    double max_diff        = 0.0;
+
+    for (size_t i = 0U; i < size; ++i)
+    {
+        for (size_t j = 0U; j < size; ++j)
+        {
+            double sum = conv_layer_bias(conv_layer);
+
+            // Add input * kernel values, skip the kernel values covering the zero padding.
+            for (size_t ki = 0U; ki < matrix_rows(kernel); ++ki)
+            {
+                for (size_t kj = 0U; kj < matrix_cols(kernel); ++kj)
+                {
+                    const size_t row = i + ki, col = j + kj;
+                    if ((row < offset) || (col < offset) || (row - offset >= size) ||
+                        (col - offset >= size)) { continue; }
+                    sum += matrix_row_const(kernel, ki)[kj] *
+                           matrix_row_const(input, row - offset)[col - offset];
+                }
+            }
+            const double expected = 0.0 < sum ? sum : 0.0;
+            const double diff     = fabs(matrix_row_const(output, i)[j] - expected);
+            if (diff > max_diff) { max_diff = diff; }
+        }
+    }
+    return max_diff;
+}
+
+/**
+ * @brief Check that a layer using the FFT matches direct convolution, both with its initial
+ *        kernel and after the kernel has been updated during training.
+ * 
+ * @return True if the outputs matched, false otherwise.
+ */
+static bool check_fft(void)
+{
+    matrix_t* input            = matrix_new(FFT_INPUT_SIZE, FFT_INPUT_SIZE);
+    matrix_t* output_gradients = matrix_new(FFT_INPUT_SIZE, FFT_INPUT_SIZE);
+    conv_layer_t* conv_layer   = conv_layer_new(FFT_INPUT_SIZE, FFT_KERNEL_SIZE);
+    bool passed                = false;
+
+    if ((NULL != input) && (NULL != output_gradients) && (NULL != conv_layer))
+    {
+        fill_values(input, 0.0);
+        fill_values(output_gradients, 1.0);
+
+        // Compare before and after training, the latter requires a new kernel spectrum.
+        const bool initial = conv_layer_feedforward(conv_layer, input) &&
+                             (FFT_TOLERANCE > max_difference(conv_layer, input));
+        const bool trained = conv_layer_backpropagate(conv_layer, output_gradients) &&
+                             conv_layer_optimize(conv_layer, 0.01) &&
+                             conv_layer_feedforward(conv_layer, input) &&
+                             (FFT_TOLERANCE > max_difference(conv_layer, input));
+        passed = initial && trained;
+    }
+    printf("FFT convolution (%ux%u input, %ux%u kernel) matches direct convolution: %s\n\n",
+           FFT_INPUT_SIZE, FFT_INPUT_SIZE, FFT_KERNEL_SIZE, FFT_KERNEL_SIZE,
+           passed ? "OK" : "FAILED");
+
+    matrix_del(&input);
+    matrix_del(&output_gradients);
+    conv_layer_del(&conv_layer);
+    return passed;
+}
+
 int main(void)
 {
+    // Check the FFT path first, terminate the program with error code -1 on mismatch.
+    if (!check_fft()) { return -1; }
+
     // Example 4x4 input matrix (could represent an image or feature map).
     const double input_data[CONV_SIZE][CONV_SIZE] = {
         {1, 1, 1, 1},
@@ -21,7 +131,7 @@ int main(void)
         {1, 0, 0, 1},
         {1, 1, 1, 1},
     };
-    matrix_t* input = matrix_copy(input_data, sizeof(input_data));
+    matrix_t* input = matrix_copy(input_data, CONV_SIZE, CONV_SIZE);
 
     // Example output gradients (target output for demonstration).
     const double gradients[CONV_SIZE][CONV_SIZE] = {
@@ -30,7 +140,7 @@ int main(void)
         {1, 1, 1, 1},
         {1, 1, 1, 1},
     };
-    matrix_t* output_gradients = matrix_copy(gradients, sizeof(gradients));
+    matrix_t* output_gradients = matrix_copy(gradients, CONV_SIZE, CONV_SIZE);
 
     // Create a convolutional layer: 4x4 input, 2x2 kernel, return -1 on failure.
     conv_layer_t* conv_layer = conv_layer_new(CONV_SIZE, KERNEL_SIZE);
@@ -0,0 +1,475 @@
+/**
+ * @brief FFT convolution implementation details.
+ *
+ *        The two-dimensional transform of real data is computed with radix-2 complex FFTs.
+ *        Two real rows are transformed at a time as the real and imaginary part of a single
+ *        complex row, then the columns are transformed row by row, so that the inner loops run
+ *        over contiguous memory. Since the input is real, the spectrum is conjugate symmetric,
+ *        so only n x (n / 2 + 1) values are stored.
+ */
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ml/fft_conv.h"
+
+/**
+ * @brief Complex number structure.
+ */
+typedef struct complex
+{
+    /** Real part. */
+    double re;
+
+    /** Imaginary part. */
+    double im;
+} complex_t;
+
+/**
+ * @brief FFT convolution structure.
+ */
+typedef struct fft_conv
+{
+    /** Twiddle factors exp(-2 * pi * i * k / n) for k in [0, n / 2). */
+    complex_t* twiddles;
+
+    /** Bit-reversed index of each index. */
+    size_t* bit_reversed;
+
+    /** Complex row used during the row transforms. */
+    complex_t* row;
+
+    /** Spectrum of the flipped kernel. */
+    complex_t* kernel_spectrum;
+
+    /** Spectrum of the current tile. */
+    complex_t* spectrum;
+
+    /** Correlation of the current tile. */
+    double* tile;
+
+    /** Transform size (n). */
+    size_t transform_size;
+
+    /** Input size. */
+    size_t input_size;
+
+    /** Kernel size. */
+    size_t kernel_size;
+} fft_conv_t;
+
+// -----------------------------------------------------------------------------
+static inline complex_t complex_mul(const complex_t a, const complex_t b)
+{
+    const complex_t product = {a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re};
+    return product;
+}
+
+// -----------------------------------------------------------------------------
+static inline complex_t complex_conj(const complex_t a)
+{
+    const complex_t conjugate = {a.re, -a.im};
+    return conjugate;
+}
+
+// -----------------------------------------------------------------------------
+static size_t log2_size(size_t value)
+{
+    size_t result = 0U;
+
+    while (1U < value)
+    {
+        value >>= 1U;
+        ++result;
+    }
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+static size_t tile_count(const size_t input_size, const size_t kernel_size,
+                         const size_t transform_size)
+{
+    // Get the number of tiles needed to cover the input, tiles per row squared.
+    const size_t tile_size     = transform_size - kernel_size + 1U;
+    const size_t tiles_per_row = (input_size + tile_size - 1U) / tile_size;
+    return tiles_per_row * tiles_per_row;
+}
+
+// -----------------------------------------------------------------------------
+static double tile_cost(const size_t transform_size)
+{
+    // Forward and inverse transform, product with the kernel spectrum and accumulation.
+    const double area = (double)(transform_size * transform_size);
+    return 10.0 * area * log2_size(transform_size) + 4.0 * area;
+}
+
+// -----------------------------------------------------------------------------
+static size_t select_transform_size(const size_t input_size, const size_t kernel_size)
+{
+    // Try powers of two from twice the kernel size up to a single tile covering the input.
+    size_t largest = 2U;
+    size_t result  = 0U;
+    double cost    = 0.0;
+
+    while (largest < input_size + kernel_size - 1U) { largest <<= 1U; }
+
+    for (size_t n = largest; (n >= 2U * kernel_size) || (n == largest); n >>= 1U)
+    {
+        const double n_cost = tile_count(input_size, kernel_size, n) * tile_cost(n);
+
+        if ((0U == result) || (n_cost < cost))
+        {
+            result = n;
+            cost   = n_cost;
+        }
+    }
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+static size_t fft_conv_spectrum_width(const fft_conv_t* self)
+{
+    return self->transform_size / 2U + 1U;
+}
+
+// -----------------------------------------------------------------------------
+static void fft_conv_transform_row(fft_conv_t* self, complex_t* row, const bool inverse)
+{
+    const size_t n = self->transform_size;
+
+    // Reorder the values, then combine transforms of increasing length (radix-2 butterflies).
+    for (size_t i = 0U; i < n; ++i)
+    {
+        const size_t k = self->bit_reversed[i];
+
+        if (i < k)
+        {
+            const complex_t temp = row[i];
+            row[i]               = row[k];
+            row[k]               = temp;
+        }
+    }
+    for (size_t length = 2U; length <= n; length <<= 1U)
+    {
+        const size_t half = length / 2U;
+        const size_t step = n / length;
+
+        for (size_t start = 0U; start < n; start += length)
+        {
+            for (size_t k = 0U; k < half; ++k)
+            {
+                const complex_t twiddle = inverse ? complex_conj(self->twiddles[k * step])
+                                                  : self->twiddles[k * step];
+                const complex_t product = complex_mul(row[start + k + half], twiddle);
+                complex_t* first        = &row[start + k];
+                complex_t* second       = &row[start + k + half];
+
+                second->re = first->re - product.re;
+                second->im = first->im - product.im;
+                first->re  += product.re;
+                first->im  += product.im;
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+static void fft_conv_transform_columns(fft_conv_t* self, complex_t* spectrum, const bool inverse)
+{
+    const size_t n     = self->transform_size;
+    const size_t width = fft_conv_spectrum_width(self);
+
+    // Same as the row transform, but each butterfly combines two whole rows.
+    for (size_t i = 0U; i < n; ++i)
+    {
+        const size_t k = self->bit_reversed[i];
+
+        if (i < k)
+        {
+            // Use the complex row as temporary storage during the swap.
+            memcpy(self->row, spectrum + i * width, sizeof(complex_t) * width);
+            memcpy(spectrum + i * width, spectrum + k * width, sizeof(complex_t) * width);
+            memcpy(spectrum + k * width, self->row, sizeof(complex_t) * width);
+        }
+    }
+    for (size_t length = 2U; length <= n; length <<= 1U)
+    {
+        const size_t half = length / 2U;
+        const size_t step = n / length;
+
+        for (size_t start = 0U; start < n; start += length)
+        {
+            for (size_t k = 0U; k < half; ++k)
+            {
+                const complex_t twiddle = inverse ? complex_conj(self->twiddles[k * step])
+                                                  : self->twiddles[k * step];
+                complex_t* first        = spectrum + (start + k) * width;
+                complex_t* second       = first + half * width;
+
+                for (size_t j = 0U; j < width; ++j)
+                {
+                    const complex_t product = complex_mul(second[j], twiddle);
+
+                    second[j].re = first[j].re - product.re;
+                    second[j].im = first[j].im - product.im;
+                    first[j].re  += product.re;
+                    first[j].im  += product.im;
+                }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+static void fft_conv_forward(fft_conv_t* self, const double* data, const size_t row_count,
+                             const size_t col_count, const size_t stride, complex_t* spectrum)
+{
+    const size_t n     = self->transform_size;
+    const size_t width = fft_conv_spectrum_width(self);
+    complex_t* row     = self->row;
+
+    // Transform two rows at a time: z = x[r] + i * x[r + 1].
+    for (size_t r = 0U; r < n; r += 2U)
+    {
+        complex_t* first  = spectrum + r * width;
+        complex_t* second = first + width;
+
+        // The rows of the zero padding have an all-zero spectrum.
+        if (r >= row_count)
+        {
+            memset(first, 0, sizeof(complex_t) * 2U * width);
+            continue;
+        }
+
+        const double* x0 = data + r * stride;
+        const double* x1 = r + 1U < row_count ? x0 + stride : NULL;
+
+        for (size_t j = 0U; j < col_count; ++j)
+        {
+            row[j].re = x0[j];
+            row[j].im = NULL != x1 ? x1[j] : 0.0;
+        }
+        memset(row + col_count, 0, sizeof(complex_t) * (n - col_count));
+        fft_conv_transform_row(self, row, false);
+
+        // Separate the spectra: X[r][k] = (Z[k] + Z*[n - k]) / 2,
+        //                       X[r + 1][k] = (Z[k] - Z*[n - k]) / 2i.
+        for (size_t k = 0U; k < width; ++k)
+        {
+            const complex_t z        = row[k];
+            const complex_t mirrored = complex_conj(row[(n - k) & (n - 1U)]);
+
+            first[k].re  = 0.5 * (z.re + mirrored.re);
+            first[k].im  = 0.5 * (z.im + mirrored.im);
+            second[k].re = 0.5 * (z.im - mirrored.im);
+            second[k].im = -0.5 * (z.re - mirrored.re);
+        }
+    }
+    fft_conv_transform_columns(self, spectrum, false);
+}
+
+// -----------------------------------------------------------------------------
+static void fft_conv_inverse(fft_conv_t* self, complex_t* spectrum, const size_t row_count,
+                             double* data)
+{
+    const size_t n     = self->transform_size;
+    const size_t width = fft_conv_spectrum_width(self);
+    const double scale = 1.0 / (n * n);
+    complex_t* row     = self->row;
+
+    fft_conv_transform_columns(self, spectrum, true);
+
+    // Transform two rows at a time: Z = X[r] + i * X[r + 1], whose inverse is x[r] + i * x[r + 1].
+    for (size_t r = 0U; r < row_count; r += 2U)
+    {
+        const complex_t* first  = spectrum + r * width;
+        const complex_t* second = first + width;
+
+        for (size_t k = 0U; k < width; ++k)
+        {
+            row[k].re = first[k].re - second[k].im;
+            row[k].im = first[k].im + second[k].re;
+        }
+
+        // Restore the other half from the conjugate symmetry: X[r][k] = X*[r][n - k].
+        for (size_t k = width; k < n; ++k)
+        {
+            const size_t m = n - k;
+            row[k].re      = first[m].re + second[m].im;
+            row[k].im      = second[m].re - first[m].im;
+        }
+        fft_conv_transform_row(self, row, true);
+
+        double* x0 = data + r * n;
+        for (size_t j = 0U; j < n; ++j) { x0[j] = row[j].re * scale; }
+
+        if (r + 1U < row_count)
+        {
+            for (size_t j = 0U; j < n; ++j) { x0[n + j] = row[j].im * scale; }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+fft_conv_t* fft_conv_new(const size_t input_size, const size_t kernel_size)
+{
+    // Check the input parameters, return null if invalid.
+    if ((0U == kernel_size) || (0U == input_size)) { return NULL; }
+
+    // Create new FFT convolution, return null on failure.
+    fft_conv_t* self = (fft_conv_t*)(malloc(sizeof(fft_conv_t)));
+    if (NULL == self) { return NULL; }
+
+    // Select the transform size with the lowest estimated cost.
+    const size_t n     = select_transform_size(input_size, kernel_size);
+    const size_t width = n / 2U + 1U;
+
+    // Initialize the member variables.
+    self->twiddles        = (complex_t*)(malloc(sizeof(complex_t) * n / 2U));
+    self->bit_reversed    = (size_t*)(malloc(sizeof(size_t) * n));
+    self->row             = (complex_t*)(malloc(sizeof(complex_t) * n));
+    self->kernel_spectrum = (complex_t*)(calloc(n * width, sizeof(complex_t)));
+    self->spectrum        = (complex_t*)(malloc(sizeof(complex_t) * n * width));
+    self->tile            = (double*)(calloc(n * n, sizeof(double)));
+    self->transform_size  = n;
+    self->input_size      = input_size;
+    self->kernel_size     = kernel_size;
+
+    // Check whether the member variables were initialize correctly, return null on failure.
+    if ((NULL == self->twiddles) || (NULL == self->bit_reversed) || (NULL == self->row) ||
+        (NULL == self->kernel_spectrum) || (NULL == self->spectrum) || (NULL == self->tile))
+    {
+        fft_conv_del(&self);
+        return NULL;
+    }
+
+    // Precompute the twiddle factors and the bit-reversed indices.
+    const double pi   = acos(-1.0);
+    const size_t bits = log2_size(n);
+
+    for (size_t k = 0U; k < n / 2U; ++k)
+    {
+        self->twiddles[k].re = cos(-2.0 * pi * k / n);
+        self->twiddles[k].im = sin(-2.0 * pi * k / n);
+    }
+    for (size_t i = 0U; i < n; ++i)
+    {
+        self->bit_reversed[i] = 0U;
+
+        for (size_t bit = 0U; bit < bits; ++bit)
+        {
+            self->bit_reversed[i] |= ((i >> bit) & 1U) << (bits - 1U - bit);
+        }
+    }
+    // Return the new FFT convolution.
+    return self;
+}
+
+// -----------------------------------------------------------------------------
+void fft_conv_del(fft_conv_t** self)
+{
+    // Check if the FFT convolution is valid, terminate the function if not.
+    if ((NULL == self) || (NULL == *self)) { return; }
+
+    // Free allocated resources and set the associated pointer to null.
+    fft_conv_t* impl = *self;
+    free(impl->twiddles);
+    free(impl->bit_reversed);
+    free(impl->row);
+    free(impl->kernel_spectrum);
+    free(impl->spectrum);
+    free(impl->tile);
+    free(impl);
+    *self = NULL;
+}
+
+// -----------------------------------------------------------------------------
+void fft_conv_set_kernel(fft_conv_t* self, const double* kernel, const size_t kernel_stride)
+{
+    // Check the input parameters, terminate the function if invalid.
+    if ((NULL == self) || (NULL == kernel)) { return; }
+    const size_t size = self->kernel_size;
+
+    // Correlation is convolution with the flipped kernel, so transform the flipped kernel.
+    for (size_t ki = 0U; ki < size; ++ki)
+    {
+        for (size_t kj = 0U; kj < size; ++kj)
+        {
+            const double* kernel_row   = kernel + (size - 1U - ki) * kernel_stride;
+            self->tile[ki * size + kj] = kernel_row[size - 1U - kj];
+        }
+    }
+    fft_conv_forward(self, self->tile, size, size, size, self->kernel_spectrum);
+}
+
+// -----------------------------------------------------------------------------
+void fft_conv_correlate(fft_conv_t* self, const double* input, const size_t input_stride,
+                        double* output, const size_t output_stride)
+{
+    // Check the input parameters, terminate the function if invalid.
+    if ((NULL == self) || (NULL == input) || (NULL == output)) { return; }
+
+    const size_t n              = self->transform_size;
+    const size_t size           = self->input_size;
+    const size_t kernel_size    = self->kernel_size;
+    const size_t tile_size      = n - kernel_size + 1U;
+    const size_t spectrum_count = n * fft_conv_spectrum_width(self);
+
+    // The full convolution of a tile starting at (r0, c0) is kernel_size - 1 larger than the
+    // tile; its value [a][b] belongs to output [r0 + a - offset][c0 + b - offset].
+    const size_t offset = kernel_size - 1U - kernel_size / 2U;
+    for (size_t i = 0U; i < size; ++i)
+    {
+        memset(output + i * output_stride, 0, sizeof(double) * size);
+    }
+
+    for (size_t r0 = 0U; r0 < size; r0 += tile_size)
+    {
+        for (size_t c0 = 0U; c0 < size; c0 += tile_size)
+        {
+            const size_t tile_rows = tile_size < size - r0 ? tile_size : size - r0;
+            const size_t tile_cols = tile_size < size - c0 ? tile_size : size - c0;
+            const size_t row_count = tile_rows + kernel_size - 1U;
+            const size_t col_count = tile_cols + kernel_size - 1U;
+
+            // Transform the tile, multiply with the kernel spectrum and transform back.
+            fft_conv_forward(self, input + r0 * input_stride + c0, tile_rows, tile_cols,
+                             input_stride, self->spectrum);
+
+            for (size_t k = 0U; k < spectrum_count; ++k)
+            {
+                self->spectrum[k] = complex_mul(self->spectrum[k], self->kernel_spectrum[k]);
+            }
+            fft_conv_inverse(self, self->spectrum, row_count, self->tile);
+
+            // Add the result to the output, skip the values outside of the output.
+            const size_t first_col = offset > c0 ? offset - c0 : 0U;
+            const size_t last_col  = col_count < size + offset - c0 ? col_count
+                                                                   : size + offset - c0;
+
+            for (size_t a = 0U; a < row_count; ++a)
+            {
+                if ((r0 + a < offset) || (r0 + a - offset >= size)) { continue; }
+
+                double* row          = output + (r0 + a - offset) * output_stride;
+                const double* result = self->tile + a * n;
+
+                for (size_t b = first_col; b < last_col; ++b)
+                {
+                    row[c0 + b - offset] += result[b];
+                }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+double fft_conv_cost(const size_t input_size, const size_t kernel_size)
+{
+    // Check the input parameters, return zero if invalid.
+    if ((0U == kernel_size) || (0U == input_size)) { return 0.0; }
+
+    const size_t n = select_transform_size(input_size, kernel_size);
+    return tile_count(input_size, kernel_size, n) * tile_cost(n);
+}
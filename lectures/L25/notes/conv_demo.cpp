@@ -1,356 +1,1099 @@
 /**
  * @brief Simple convolutional layer demo.
  */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <ctime>
+#include <initializer_list>
 #include <iomanip>
 #include <iostream>
 #include <stdexcept>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "ml/conv1d_stack.h"
+#include "ml/conv2d_layer.h"
+#include "ml/conv_layer.h"
+#include "ml/conv_pool_layer.h"
+#include "ml/depthwise_conv_layer.h"
+#include "ml/fft.h"
+#include "ml/pointwise_conv_layer.h"
+#include "ml/tensor.h"
+#include "ml/tiled_conv.h"
+#include "ml/utils/cache_info.h"
+#include "ml/utils/thread_pool.h"
+#include "ml/winograd.h"
+
 namespace
 {
-/** One-dimensional matrix. */
-using Matrix1d = std::vector<double>;
+/**
+ * @brief Generate a random starting value between 0.0 and 1.0.
+ *
+ * @return Random floating-point value in the range [0.0, 1.0].
+ */
+double randomStartVal() noexcept { return static_cast<double>(std::rand()) / RAND_MAX; }
 
-/** Two-dimensional matrix. */
-using Matrix2d = std::vector<Matrix1d>;
+/**
+ * @brief ReLU activation function (output).
+ *
+ * @param[in] input Input value.
+ * @return Output after ReLU activation.
+ */
+constexpr double reluOutput(const double input) noexcept { return 0.0 < input ? input : 0.0; }
 
 /**
- * @brief Initialize given matrix with zeros.
- * 
- * @param[in] matrix The matrix to initialize.
+ * @brief ReLU activation function (derivative).
+ *
+ * @param[in] input Input value.
+ * @return Derivative of ReLU at input.
  */
-void initMatrix(Matrix2d& matrix) noexcept
-{
-    // Fill the matrix with zeros.
-    for (auto& row : matrix)
-    {
-        for (auto& num : row) { num = 0.0; }
-    }
-}
+constexpr double reluDelta(const double input) noexcept { return 0.0 < input ? 1.0 : 0.0; }
 
 /**
- * @brief Initialize matrix with zeros.
+ * @brief Get the name of the given convolution algorithm.
+ * 
+ * @param[in] algorithm The algorithm.
  * 
- * @param[in] matrix The matrix to initialize.
- * @param[in] size The desired size of the matrix.
+ * @return The name of the algorithm.
  */
-void initMatrix(Matrix2d& matrix, const std::size_t size)
+const char* algorithmName(const ml::ConvAlgorithm algorithm) noexcept
 {
-    // Resize the matrix if necessary, then fill the matrix with zeros.
-    matrix.resize(size, Matrix1d(size));
-    initMatrix(matrix);
+    switch (algorithm)
+    {
+        case ml::ConvAlgorithm::Direct:
+            return "direct";
+        case ml::ConvAlgorithm::Gemm:
+            return "GEMM";
+        case ml::ConvAlgorithm::Winograd2x2:
+            return "Winograd F(2x2, 3x3)";
+        case ml::ConvAlgorithm::Winograd4x4:
+            return "Winograd F(4x4, 3x3)";
+        case ml::ConvAlgorithm::Fft:
+            return "FFT";
+        default:
+            return "auto";
+    }
 }
 
 /**
- * @brief Check whether given matrix is square.
+ * @brief Create a single-channel image holding the given values.
  * 
- * @param[in] matrix The matrix to check.
+ * @param[in] height The height of the image.
+ * @param[in] width The width of the image.
+ * @param[in] values The values of the image, stored row by row.
  * 
- * @return True if the matrix is square, false otherwise.
+ * @return Tensor holding the image.
  */
-bool isMatrixSquare(const Matrix2d& matrix) noexcept
+ml::Tensor createImage(const std::size_t height, const std::size_t width,
+                       const std::initializer_list<double> values)
 {
-    // Check the matrix row by row.
-    for (const auto& row: matrix)
-    {
-        // Return false if the matrix isn't square.
-        if (row.size() != matrix.size()) { return false; }
-    }
-    // Return true to indicate that the matrix is square.
-    return true;
+    ml::Tensor image{1U, 1U, height, width};
+    std::copy_n(values.begin(), std::min(values.size(), image.size()), image.data());
+    return image;
 }
 
 /**
- * @brief Print the contents of given matrix.
+ * @brief Print the contents of given tensor, one matrix per image and channel.
  * 
- * @param[in] matrix The matrix to print.
+ * @param[in] tensor The tensor to print.
  * @param[in] precision Decimal precision (default = 1).
  * @param[in] ostream Output stream (default = terminal print).
  */
-void printMatrix(const Matrix2d& matrix, const std::size_t precision = 1U,
+void printTensor(const ml::Tensor& tensor, const std::size_t precision = 1U,
                  std::ostream& ostream = std::cout) noexcept
 {
     // Set the decimal precision.
     ostream << std::fixed << std::setprecision(precision);
 
-    // Print the matrix contents row by row.
-    for (const auto& row : matrix)
+    // Print each feature map row by row.
+    for (std::size_t n{}; n < tensor.batchCount(); ++n)
     {
-        const auto* lastNum{row.empty() ? nullptr : &row[row.size() - 1U]};
-        ostream << "\t";
+        for (std::size_t c{}; c < tensor.channelCount(); ++c)
+        {
+            for (std::size_t i{}; i < tensor.height(); ++i)
+            {
+                ostream << "\t";
 
-        // Separate each number in the row with a comma.
-        for (const auto& num : row)
+                // Separate each number in the row with a comma.
+                for (std::size_t j{}; j < tensor.width(); ++j)
+                {
+                    ostream << tensor(n, c, i, j);
+                    if (j + 1U < tensor.width()) { ostream << ", "; }
+                }
+                ostream << "\n";
+            }
+            ostream << "\n";
+        }
+    }
+}
+
+/**
+ * @brief Fill the given tensor with random values in the range [-offset, 1.0 - offset].
+ * 
+ * @param[out] tensor The tensor to fill.
+ * @param[in] offset Offset subtracted from each value (default = 0).
+ */
+void randomize(ml::Tensor& tensor, const double offset = 0.0) noexcept
+{
+    for (std::size_t k{}; k < tensor.size(); ++k) { tensor.data()[k] = randomStartVal() - offset; }
+}
+
+/**
+ * @brief Get the largest absolute difference between two tensors of the same shape.
+ * 
+ *        The layouts of the tensors may differ.
+ * 
+ * @param[in] first The first tensor.
+ * @param[in] second The second tensor.
+ * 
+ * @return The largest absolute difference.
+ */
+double maxDifference(const ml::Tensor& first, const ml::Tensor& second) noexcept
+{
+    double result{};
+
+    for (std::size_t n{}; n < first.batchCount(); ++n)
+    {
+        for (std::size_t c{}; c < first.channelCount(); ++c)
         {
-            ostream << num;
-            if (&num < lastNum) { ostream << ", "; }
+            for (std::size_t i{}; i < first.height(); ++i)
+            {
+                for (std::size_t j{}; j < first.width(); ++j)
+                {
+                    result = std::max(result, std::abs(first(n, c, i, j) - second(n, c, i, j)));
+                }
+            }
         }
-        ostream << "\n";
     }
-    ostream << "\n";
+    return result;
 }
 
 /**
- * @brief Generate a random starting value between 0.0 and 1.0.
- *
- * @return Random floating-point value in the range [0.0, 1.0].
+ * @brief Measure the median time of feedforward followed by backpropagation.
+ * 
+ * @param[in] convLayer The layer to measure.
+ * @param[in] input The input to use.
+ * @param[in] outputGradients The output gradients to use.
+ * @param[in] runCount The number of runs (default = 5).
+ * 
+ * @return The median time in milliseconds.
  */
-double randomStartVal() noexcept { return static_cast<double>(std::rand()) / RAND_MAX; }
+double measure(ml::ConvLayer& convLayer, const ml::Tensor& input,
+               const ml::Tensor& outputGradients, const std::size_t runCount = 5U)
+{
+    std::vector<double> times{};
+
+    for (std::size_t i{}; i < runCount; ++i)
+    {
+        const auto start{std::chrono::steady_clock::now()};
+        convLayer.feedforward(input);
+        convLayer.backpropagate(outputGradients);
+        const std::chrono::duration<double, std::milli> duration{
+            std::chrono::steady_clock::now() - start};
+        times.push_back(duration.count());
+    }
+    std::nth_element(times.begin(), times.begin() + runCount / 2U, times.end());
+    return times[runCount / 2U];
+}
 
 /**
- * @brief ReLU activation function (output).
- *
- * @param[in] input Input value.
- * @return Output after ReLU activation.
+ * @brief Measure the median time of feedforward.
+ * 
+ * @param[in] convLayer The layer to measure.
+ * @param[in] input The input to use.
+ * @param[in] runCount The number of runs.
+ * 
+ * @return The median time in milliseconds.
  */
-constexpr double reluOutput(const double input) noexcept { return 0.0 < input ? input : 0.0; }
+double measureFeedforward(ml::ConvLayer& convLayer, const ml::Tensor& input,
+                          const std::size_t runCount)
+{
+    std::vector<double> times{};
+
+    for (std::size_t i{}; i < runCount; ++i)
+    {
+        const auto start{std::chrono::steady_clock::now()};
+        convLayer.feedforward(input);
+        const std::chrono::duration<double, std::milli> duration{
+            std::chrono::steady_clock::now() - start};
+        times.push_back(duration.count());
+    }
+    std::nth_element(times.begin(), times.begin() + runCount / 2U, times.end());
+    return times[runCount / 2U];
+}
 
 /**
- * @brief ReLU activation function (derivative).
- *
- * @param[in] input Input value.
- * @return Derivative of ReLU at input.
+ * @brief Compare the direct and the GEMM algorithm with the given input and kernel size.
+ * 
+ * @param[in] inputSize The input size.
+ * @param[in] kernelSize The kernel size.
+ * 
+ * @return True if the outputs and gradients match, false otherwise.
  */
-constexpr double reluDelta(const double input) noexcept { return 0.0 < input ? 1.0 : 0.0; }
+bool compareAlgorithms(const std::size_t inputSize, const std::size_t kernelSize)
+{
+    constexpr double tolerance{1e-9};
+    ml::Tensor input{1U, 1U, inputSize, inputSize}, outputGradients{input};
+    randomize(input);
+    randomize(outputGradients, 0.5);
 
-namespace ml
+    // Use the same parameters in both layers.
+    ml::ConvLayer direct{inputSize, kernelSize, ml::ConvAlgorithm::Direct};
+    ml::ConvLayer lowered{inputSize, kernelSize, ml::ConvAlgorithm::Gemm};
+    lowered.kernel = direct.kernel;
+    lowered.bias   = direct.bias;
+
+    const auto selection{ml::selectAlgorithm(inputSize, kernelSize)};
+    const auto directTime{measure(direct, input, outputGradients)};
+    const auto gemmTime{measure(lowered, input, outputGradients)};
+    const auto difference{std::max({maxDifference(direct.output, lowered.output),
+                                    maxDifference(direct.inputGradients, lowered.inputGradients),
+                                    maxDifference(direct.kernelGradients,
+                                                  lowered.kernelGradients)})};
+
+    std::cout << std::fixed << std::setprecision(2) << "\t" << inputSize << "x" << inputSize
+              << " input, " << kernelSize << "x" << kernelSize << " kernel: direct " << directTime
+              << " ms, im2col + GEMM " << gemmTime << " ms (speedup " << directTime / gemmTime
+              << "x, max difference " << std::scientific << std::setprecision(1) << difference
+              << (tolerance > difference ? " OK" : " FAILED") << ", auto selects "
+              << algorithmName(selection) << ")\n";
+    return tolerance > difference;
+}
+
+/**
+ * @brief Test the Winograd algorithms against the direct algorithm with a 3x3 kernel.
+ * 
+ *        The outputs are compared before and after optimization, which verifies that the
+ *        transformed kernel is recomputed once the kernel has been changed.
+ * 
+ * @param[in] inputSize The input size (sizes that aren't multiples of the tile size test the
+ *                      partial tiles at the edges).
+ * 
+ * @return True if the outputs match, false otherwise.
+ */
+bool testWinograd(const std::size_t inputSize)
 {
+    constexpr std::size_t kernelSize{ml::winograd::KernelSize}, runCount{5U};
+    constexpr double tolerance{1e-9};
+    ml::Tensor input{1U, 1U, inputSize, inputSize}, outputGradients{input};
+    randomize(input);
+    randomize(outputGradients, 0.5);
+
+    // Measure feedforward only (backpropagation is the same for all algorithms).
+    ml::ConvLayer direct{inputSize, kernelSize, ml::ConvAlgorithm::Direct};
+    const auto directTime{measureFeedforward(direct, input, runCount)};
+    bool result{true};
+
+    std::cout << std::fixed << std::setprecision(3) << "\t" << inputSize << "x" << inputSize
+              << " input: direct " << directTime << " ms";
+
+    for (const auto algorithm : {ml::ConvAlgorithm::Winograd2x2, ml::ConvAlgorithm::Winograd4x4})
+    {
+        ml::ConvLayer winograd{inputSize, kernelSize, algorithm};
+        ml::ConvLayer reference{inputSize, kernelSize, ml::ConvAlgorithm::Direct};
+        winograd.kernel = reference.kernel;
+        winograd.bias   = reference.bias;
+
+        // Compare the outputs, then train both layers one step and compare again.
+        winograd.feedforward(input);
+        reference.feedforward(input);
+        auto difference{maxDifference(winograd.output, reference.output)};
+
+        winograd.backpropagate(outputGradients);
+        reference.backpropagate(outputGradients);
+        winograd.optimize(0.01);
+        reference.optimize(0.01);
+        winograd.feedforward(input);
+        reference.feedforward(input);
+        difference = std::max(difference, maxDifference(winograd.output, reference.output));
+
+        // Multiplications per output: 9 (direct) versus (m + 2)^2 / m^2 (F(m x m, 3x3)).
+        const auto outputTile{ml::ConvAlgorithm::Winograd2x2 == algorithm ? 2.0 : 4.0};
+        const auto reduction{9.0 * outputTile * outputTile /
+                             ((outputTile + 2.0) * (outputTile + 2.0))};
+        const auto time{measureFeedforward(winograd, input, runCount)};
+        result = result && (tolerance > difference);
+
+        std::cout << std::fixed << std::setprecision(3) << ", " << algorithmName(algorithm) << " "
+                  << time << " ms (" << std::setprecision(2) << reduction
+                  << "x fewer multiplications, speedup " << directTime / time
+                  << "x, max difference "
+                  << std::scientific << std::setprecision(1) << difference
+                  << (tolerance > difference ? " OK" : " FAILED") << ")";
+    }
+    std::cout << "\n";
+    return result;
+}
+
 /**
- * @brief Convolutional layer structure.
+ * @brief Compare the FFT algorithm with the direct algorithm (feedforward).
+ * 
+ * @param[in] inputSize The input size.
+ * @param[in] kernelSize The kernel size.
+ * 
+ * @return True if the outputs match, false otherwise.
  */
-struct ConvLayer final
+bool compareFft(const std::size_t inputSize, const std::size_t kernelSize)
 {
-    /**
-     * @brief Constructor.
-     * 
-     * @param[in] inputSize Input size. Must be greater than 0.
-     * @param[in] kernelSize Kernel size. Must be greater than 0 and smaller than the input size.
-     */
-    explicit ConvLayer(const std::size_t inputSize, const std::size_t kernelSize)
-        : inputPadded{}
-        , inputGradientsPadded{}
-        , inputGradients{}
-        , kernel{}
-        , kernelGradients{}
-        , output{}
-        , bias{randomStartVal()}
-        , biasGradient{}
+    constexpr std::size_t runCount{3U};
+    constexpr double tolerance{1e-9};
+    ml::Tensor input{1U, 1U, inputSize, inputSize};
+    randomize(input);
+
+    // Use the same parameters in both layers, measure after the kernel spectrum is computed.
+    ml::ConvLayer direct{inputSize, kernelSize, ml::ConvAlgorithm::Direct};
+    ml::ConvLayer fft{inputSize, kernelSize, ml::ConvAlgorithm::Fft};
+    fft.kernel = direct.kernel;
+    fft.bias   = direct.bias;
+    fft.feedforward(input);
+
+    const auto directTime{measureFeedforward(direct, input, runCount)};
+    const auto fftTime{measureFeedforward(fft, input, runCount)};
+    const auto difference{maxDifference(direct.output, fft.output)};
+    const auto directCost{2.0 * inputSize * inputSize * kernelSize * kernelSize};
+    const auto fftCost{ml::fft::Convolution::cost(inputSize, kernelSize)};
+    const ml::fft::Convolution convolution{inputSize, kernelSize};
+
+    std::cout << std::fixed << std::setprecision(2) << "\t" << inputSize << "x" << inputSize
+              << " input, " << kernelSize << "x" << kernelSize << " kernel: direct " << directTime
+              << " ms, FFT " << fftTime << " ms (" << convolution.transformSize() << "x"
+              << convolution.transformSize() << " transforms, estimated cost ratio "
+              << directCost / fftCost << ", speedup " << directTime / fftTime
+              << "x, max difference " << std::scientific << std::setprecision(1) << difference
+              << (tolerance > difference ? " OK" : " FAILED") << ", auto selects "
+              << algorithmName(ml::selectAlgorithm(inputSize, kernelSize)) << ")\n";
+    return tolerance > difference;
+}
+
+/**
+ * @brief Get the median time of five runs of the given function.
+ * 
+ * @param[in] function The function to run.
+ * 
+ * @return The median time in milliseconds.
+ */
+template <typename Function>
+double medianTime(Function&& function)
+{
+    std::vector<double> times{};
+
+    for (std::size_t run{}; run < 5U; ++run)
     {
-        // Check the input arguments, throw if invalid.
-        if ((0U == inputSize) || (0U == kernelSize) || (inputSize < kernelSize))
+        const auto start{std::chrono::steady_clock::now()};
+        function();
+        const std::chrono::duration<double, std::milli> duration{
+            std::chrono::steady_clock::now() - start};
+        times.push_back(duration.count());
+    }
+    std::nth_element(times.begin(), times.begin() + 2U, times.end());
+    return times[2U];
+}
+
+/**
+ * @brief Compare batched convolution on a thread pool with one image at a time.
+ * 
+ *        Both layers use the direct algorithm and the same parameters, so the outputs and the
+ *        input gradients must match, and the kernel and bias gradients of the batch must match
+ *        the sums over the images.
+ * 
+ * @param[in] imageCount The number of images per batch.
+ * @param[in] inputSize The input size.
+ * @param[in] kernelSize The kernel size.
+ * @param[in] pool The thread pool to use.
+ * 
+ * @return True if the results match, false otherwise.
+ */
+bool compareBatch(const std::size_t imageCount, const std::size_t inputSize,
+                  const std::size_t kernelSize, ml::utils::ThreadPool& pool)
+{
+    constexpr double tolerance{1e-9};
+    ml::Tensor inputs{imageCount, 1U, inputSize, inputSize}, outputGradients{inputs};
+    randomize(inputs);
+    randomize(outputGradients, 0.5);
+
+    // Split the batch into single images for the layer processing one image at a time.
+    std::vector<ml::Tensor> images{}, imageGradients{};
+
+    for (std::size_t n{}; n < imageCount; ++n)
+    {
+        images.emplace_back(1U, 1U, inputSize, inputSize);
+        imageGradients.emplace_back(1U, 1U, inputSize, inputSize);
+        std::copy_n(inputs.image(n), inputs.imageSize(), images.back().data());
+        std::copy_n(outputGradients.image(n), inputs.imageSize(), imageGradients.back().data());
+    }
+
+    // Use the same parameters in both layers.
+    ml::ConvLayer single{inputSize, kernelSize, ml::ConvAlgorithm::Direct};
+    ml::ConvLayer batched{inputSize, kernelSize, ml::ConvAlgorithm::Direct};
+    batched.kernel = single.kernel;
+    batched.bias   = single.bias;
+
+    // Process one image at a time, sum the kernel and bias gradients.
+    ml::Tensor kernelGradients{single.kernelGradients};
+    double biasGradient{}, difference{};
+
+    const auto singleTime{medianTime([&]() {
+        kernelGradients.fill();
+        biasGradient = 0.0;
+
+        for (std::size_t n{}; n < imageCount; ++n)
         {
-            throw std::invalid_argument(
-                "Cannot create convolutional layer: invalid input arguments!");
+            single.feedforward(images[n]);
+            single.backpropagate(imageGradients[n]);
+
+            for (std::size_t k{}; k < kernelGradients.size(); ++k)
+            {
+                kernelGradients.data()[k] += single.kernelGradients.data()[k];
+            }
+            biasGradient += single.biasGradient;
         }
-    
-        // Calculate pad offset (how many zeros need to be added to each edge?).
-        const std::size_t padOffset{kernelSize / 2U};
-
-        // Calculate padded size (we need to add zeros both to the left and to the right).
-        const std::size_t paddedSize{inputSize + 2U * padOffset};
-
-        // Initialize matrices with zeros.
-        initMatrix(inputPadded, paddedSize);
-        initMatrix(inputGradientsPadded, paddedSize);
-        initMatrix(inputGradients, inputSize);
-        initMatrix(kernel, kernelSize);
-        initMatrix(kernelGradients, kernelSize);
-        initMatrix(output, inputSize);
-
-        // Fill the kernel with randomized values in the range [0.0, 1.0].
-        for (std::size_t ki{}; ki < kernel.size(); ++ki)
+    })};
+
+    // Process the whole batch on the thread pool (the buffers are allocated on the first run).
+    const auto batchTime{medianTime([&]() {
+        batched.feedforwardBatch(inputs, pool);
+        batched.backpropagateBatch(outputGradients, pool);
+    })};
+
+    // Compare the results of the last image and the gradients summed over the batch.
+    const auto lastImageDifference{[imageCount](const ml::Tensor& image, const ml::Tensor& batch) {
+        const auto* last{batch.image(imageCount - 1U)};
+        double result{};
+
+        for (std::size_t k{}; k < image.size(); ++k)
         {
-            for (std::size_t kj{}; kj < kernel.size(); ++kj)
+            result = std::max(result, std::abs(image.data()[k] - last[k]));
+        }
+        return result;
+    }};
+    difference = std::max({lastImageDifference(single.output, batched.batchOutputs),
+                           lastImageDifference(single.inputGradients,
+                                               batched.batchInputGradients),
+                           maxDifference(kernelGradients, batched.kernelGradients),
+                           std::abs(biasGradient - batched.biasGradient)});
+
+    std::cout << std::fixed << std::setprecision(2) << "\t" << imageCount << " images "
+              << inputSize << "x" << inputSize << ", " << kernelSize << "x" << kernelSize
+              << " kernel: one at a time " << singleTime << " ms, batch " << batchTime
+              << " ms on " << pool.threadCount() << " threads (speedup " << singleTime / batchTime
+              << "x, max difference "
+              << std::scientific << std::setprecision(1) << difference
+              << (tolerance > difference ? " OK" : " FAILED") << ")\n";
+    return tolerance > difference;
+}
+
+/**
+ * @brief Check that batched backpropagation is rejected before any batch has been fed forward.
+ * 
+ * @param[in] inputSize The input size.
+ * @param[in] pool The thread pool to use.
+ * 
+ * @return True if the backpropagation was rejected, false otherwise.
+ */
+bool checkBatchOrder(const std::size_t inputSize, ml::utils::ThreadPool& pool)
+{
+    ml::ConvLayer layer{inputSize, 3U, ml::ConvAlgorithm::Direct};
+    ml::Tensor outputGradients{1U, 1U, inputSize, inputSize};
+    randomize(outputGradients, 0.5);
+    const auto rejected{!layer.backpropagateBatch(outputGradients, pool)};
+
+    std::cout << "\tBackpropagation of a single image before feedforward: "
+              << (rejected ? "rejected OK" : "accepted FAILED") << "\n";
+    return rejected;
+}
+
+/**
+ * @brief Compute the output and the gradients of a multi-channel convolution with plain loops.
+ * 
+ *        Used as reference for the im2col implementation of the multi-channel layer.
+ * 
+ * @param[in] layer The layer holding the kernel and the bias values.
+ * @param[in] input The input tensor.
+ * @param[in] outputGradients The output gradients.
+ * @param[out] output The output of the convolution.
+ * @param[out] inputGradients The input gradients.
+ * @param[out] kernelGradients The kernel gradients.
+ */
+void convolveReference(const ml::Conv2dLayer& layer, const ml::Tensor& input,
+                       const ml::Tensor& outputGradients, ml::Tensor& output,
+                       ml::Tensor& inputGradients, ml::Tensor& kernelGradients) noexcept
+{
+    const auto& kernel{layer.kernel()};
+    const auto size{static_cast<int>(layer.kernelSize())}, pad{size / 2};
+    const auto height{static_cast<int>(input.height())}, width{static_cast<int>(input.width())};
+    inputGradients.fill();
+    kernelGradients.fill();
+
+    for (std::size_t n{}; n < input.batchCount(); ++n)
+    {
+        for (std::size_t f{}; f < layer.filterCount(); ++f)
+        {
+            for (int i{}; i < height; ++i)
             {
-                kernel[ki][kj] = randomStartVal();
+                for (int j{}; j < width; ++j)
+                {
+                    // Visit each kernel position that hits the input (the pad holds zeros).
+                    const auto visit{[&](auto&& function) {
+                        for (std::size_t c{}; c < layer.inputChannelCount(); ++c)
+                        {
+                            for (int ki{}; ki < size; ++ki)
+                            {
+                                const auto row{i + ki - pad};
+                                if ((0 > row) || (row >= height)) { continue; }
+
+                                for (int kj{}; kj < size; ++kj)
+                                {
+                                    const auto col{j + kj - pad};
+                                    if ((0 > col) || (col >= width)) { continue; }
+                                    function(c, row, col, ki, kj);
+                                }
+                            }
+                        }
+                    }};
+
+                    auto sum{layer.bias()[f]};
+                    visit([&](auto c, auto row, auto col, auto ki, auto kj) {
+                        sum += input(n, c, row, col) * kernel(f, c, ki, kj);
+                    });
+                    output(n, f, i, j) = reluOutput(sum);
+
+                    const auto delta{outputGradients(n, f, i, j) * reluDelta(output(n, f, i, j))};
+                    visit([&](auto c, auto row, auto col, auto ki, auto kj) {
+                        kernelGradients(f, c, ki, kj) += input(n, c, row, col) * delta;
+                        inputGradients(n, c, row, col) += kernel(f, c, ki, kj) * delta;
+                    });
+                }
             }
         }
     }
-    
-    /**
-     * @brief Perform feedforward operation.
-     * 
-     * @param[in] input Matrix holding input data.
-     * 
-     * @return True on success, false on failure.
-     */
-    bool feedforward(const Matrix2d& input) noexcept
+}
+
+/**
+ * @brief Compare the multi-channel layer in both layouts with the reference implementation.
+ * 
+ *        The time is compared with the single-channel layer, which would have to be run once
+ *        per input channel and filter (and would still have to add the results together).
+ * 
+ * @param[in] batchCount The number of images per batch.
+ * @param[in] channelCount The number of input channels.
+ * @param[in] filterCount The number of filters.
+ * @param[in] inputSize The input size.
+ * @param[in] kernelSize The kernel size.
+ * 
+ * @return True if both layouts match the reference implementation, false otherwise.
+ */
+bool compareLayouts(const std::size_t batchCount, const std::size_t channelCount,
+                    const std::size_t filterCount, const std::size_t inputSize,
+                    const std::size_t kernelSize)
+{
+    constexpr double tolerance{1e-9};
+    ml::Tensor input{batchCount, channelCount, inputSize, inputSize};
+    ml::Tensor outputGradients{batchCount, filterCount, inputSize, inputSize};
+    randomize(input);
+    randomize(outputGradients, 0.5);
+
+    // Use the same parameters in both layouts.
+    ml::Conv2dLayer nchw{channelCount, filterCount, inputSize, inputSize, kernelSize, batchCount,
+                         ml::Layout::Nchw, 1U};
+    ml::Conv2dLayer nhwc{channelCount, filterCount, inputSize, inputSize, kernelSize, batchCount,
+                         ml::Layout::Nhwc};
+    nhwc.setParameters(nchw.kernel(), nchw.bias());
+
+    // Compute the reference values.
+    ml::Tensor output{nchw.output()}, inputGradients{input}, kernelGradients{nchw.kernel()};
+    convolveReference(nchw, input, outputGradients, output, inputGradients, kernelGradients);
+
+    std::cout << std::fixed << std::setprecision(2) << "\t" << batchCount << " x " << channelCount
+              << " x " << inputSize << "x" << inputSize << " input, " << filterCount << " filters "
+              << kernelSize << "x" << kernelSize << ":";
+    bool result{true};
+
+    for (auto* layer : {&nchw, &nhwc})
     {
-        // Check the input matrix, return false on dimension mismatch.
-        if ((input.size() != output.size()) || !isMatrixSquare(input)) { return false; }
+        std::vector<double> times{};
 
-        // Pad the input with zeros.
-        padInput(input);
+        for (std::size_t run{}; run < 5U; ++run)
+        {
+            const auto start{std::chrono::steady_clock::now()};
+            layer->feedforward(input);
+            layer->backpropagate(outputGradients);
+            const std::chrono::duration<double, std::milli> duration{
+                std::chrono::steady_clock::now() - start};
+            times.push_back(duration.count());
+        }
+        std::nth_element(times.begin(), times.begin() + 2U, times.end());
+        const auto difference{std::max({maxDifference(layer->output(), output),
+                                        maxDifference(layer->inputGradients(), inputGradients),
+                                        maxDifference(layer->kernelGradients(), kernelGradients)})};
+        result = result && (tolerance > difference);
+        std::cout << (ml::Layout::Nchw == layer->layout() ? " NCHW " : ", NHWC ") << times[2U]
+                  << " ms (max difference " << std::scientific << std::setprecision(1)
+                  << difference << (tolerance > difference ? " OK" : " FAILED") << std::fixed
+                  << std::setprecision(2) << ")";
+    }
 
-        // Run feedforward; accumulate bias and contributions from the input and the kernel.
-        for (std::size_t i{}; i < output.size(); ++i)
+    // Estimate the time of the single-channel layer from one pass.
+    ml::Tensor image{1U, 1U, inputSize, inputSize}, gradients{image};
+    ml::ConvLayer single{inputSize, kernelSize, ml::ConvAlgorithm::Direct};
+    const auto singleTime{measure(single, image, gradients)};
+    std::cout << ", single-channel layer " << singleTime * batchCount * channelCount * filterCount
+              << " ms\n";
+    return result;
+}
+
+/**
+ * @brief Compare a depthwise-separable convolution with a full convolution of the same shape.
+ * 
+ *        The separable convolution is a depthwise layer followed by a pointwise layer. Both are
+ *        checked against the multi-channel layer: a pointwise layer is a multi-channel layer with
+ *        a 1x1 kernel, and a depthwise layer is a multi-channel layer with one filter per channel
+ *        whose kernel is zero outside of its own channel.
+ * 
+ * @param[in] batchCount The number of images per batch.
+ * @param[in] channelCount The number of input channels.
+ * @param[in] filterCount The number of filters.
+ * @param[in] inputSize The input size.
+ * @param[in] kernelSize The kernel size.
+ * 
+ * @return True if the depthwise and pointwise layers match the multi-channel layer.
+ */
+bool compareSeparable(const std::size_t batchCount, const std::size_t channelCount,
+                      const std::size_t filterCount, const std::size_t inputSize,
+                      const std::size_t kernelSize)
+{
+    constexpr double tolerance{1e-9};
+    ml::Tensor input{batchCount, channelCount, inputSize, inputSize};
+    ml::Tensor depthwiseGradients{batchCount, channelCount, inputSize, inputSize};
+    ml::Tensor outputGradients{batchCount, filterCount, inputSize, inputSize};
+    randomize(input);
+    randomize(depthwiseGradients, 0.5);
+    randomize(outputGradients, 0.5);
+
+    // Count the multiplications and additions of the feedforward, backpropagation costs twice
+    // as much (kernel gradients and input gradients).
+    const auto pixels{static_cast<double>(batchCount * inputSize * inputSize)};
+    const auto area{kernelSize * kernelSize};
+    const auto fullFlops{2.0 * pixels * channelCount * filterCount * area};
+    const auto separableFlops{2.0 * pixels * channelCount * (area + filterCount)};
+
+    ml::Conv2dLayer full{channelCount, filterCount, inputSize, inputSize, kernelSize, batchCount};
+    const auto fullTime{medianTime([&]() {
+        full.feedforward(input);
+        full.backpropagate(outputGradients);
+    })};
+
+    std::cout << std::fixed << std::setprecision(2) << "\t" << batchCount << " x " << channelCount
+              << " x " << inputSize << "x" << inputSize << " input, " << filterCount << " filters "
+              << kernelSize << "x" << kernelSize << ": " << fullFlops * 1e-6 << " MFLOP full, "
+              << separableFlops * 1e-6 << " MFLOP separable (" << fullFlops / separableFlops
+              << "x fewer)\n\t\tfull " << fullTime << " ms";
+    bool passed{true};
+
+    for (const auto layout : {ml::Layout::Nchw, ml::Layout::Nhwc})
+    {
+        ml::DepthwiseConvLayer depthwise{channelCount, inputSize, inputSize, kernelSize,
+                                         batchCount,   layout,    1U};
+        ml::PointwiseConvLayer pointwise{channelCount, filterCount, inputSize, inputSize,
+                                         batchCount,   layout,      2U};
+
+        // Compare the depthwise layer with a multi-channel layer holding its kernels on the
+        // diagonal (filter c only sees channel c).
+        ml::Tensor diagonal{channelCount, channelCount, kernelSize, kernelSize};
+        ml::Tensor kernelGradients{depthwise.kernel()};
+        for (std::size_t c{}; c < channelCount; ++c)
         {
-            for (std::size_t j{}; j < output.size(); ++j)
+            for (std::size_t ki{}; ki < kernelSize; ++ki)
             {
-                // Start by adding the bias value.
-                auto sum{bias};
-
-                // Iterate through the kernel and add the input * kernel values.
-                for (std::size_t ki{}; ki < kernel.size(); ++ki)
+                for (std::size_t kj{}; kj < kernelSize; ++kj)
                 {
-                    for (std::size_t kj{}; kj < kernel.size(); ++kj)
-                    {
-                        sum += inputPadded[i + ki][j + kj] * kernel[ki][kj];
-                    }
+                    diagonal(c, c, ki, kj) = depthwise.kernel()(0U, c, ki, kj);
                 }
+            }
+        }
+        ml::Conv2dLayer depthwiseReference{channelCount, channelCount, inputSize,
+                                           inputSize,    kernelSize,   batchCount};
+        depthwiseReference.setParameters(diagonal, depthwise.bias());
+        depthwiseReference.feedforward(input);
+        depthwiseReference.backpropagate(depthwiseGradients);
+        depthwise.feedforward(input);
+        depthwise.backpropagate(depthwiseGradients);
 
-                // Pass the sum through the ReLU activation function, store as output.
-                output[i][j] = reluOutput(sum);
+        for (std::size_t c{}; c < channelCount; ++c)
+        {
+            for (std::size_t ki{}; ki < kernelSize; ++ki)
+            {
+                for (std::size_t kj{}; kj < kernelSize; ++kj)
+                {
+                    kernelGradients(0U, c, ki, kj) =
+                        depthwiseReference.kernelGradients()(c, c, ki, kj);
+                }
             }
         }
-        return true;
+
+        // Compare the pointwise layer with a multi-channel layer with a 1x1 kernel.
+        ml::Conv2dLayer pointwiseReference{channelCount, filterCount, inputSize,
+                                           inputSize,    1U,          batchCount};
+        pointwiseReference.setParameters(pointwise.kernel(), pointwise.bias());
+        pointwiseReference.feedforward(input);
+        pointwiseReference.backpropagate(outputGradients);
+        pointwise.feedforward(input);
+        pointwise.backpropagate(outputGradients);
+
+        const auto difference{std::max(
+            {maxDifference(depthwise.output(), depthwiseReference.output()),
+             maxDifference(depthwise.inputGradients(), depthwiseReference.inputGradients()),
+             maxDifference(depthwise.kernelGradients(), kernelGradients),
+             maxDifference(pointwise.output(), pointwiseReference.output()),
+             maxDifference(pointwise.inputGradients(), pointwiseReference.inputGradients()),
+             maxDifference(pointwise.kernelGradients(), pointwiseReference.kernelGradients())})};
+        passed = (tolerance > difference) && passed;
+
+        // Time the separable convolution, the pointwise layer takes the depthwise output.
+        const auto depthwiseTime{medianTime([&]() {
+            depthwise.feedforward(input);
+            depthwise.backpropagate(depthwiseGradients);
+        })};
+        const auto pointwiseTime{medianTime([&]() {
+            pointwise.feedforward(depthwise.output());
+            pointwise.backpropagate(outputGradients);
+        })};
+        const auto separableTime{depthwiseTime + pointwiseTime};
+
+        std::cout << (ml::Layout::Nchw == layout ? ", NCHW separable " : ", NHWC separable ")
+                  << separableTime << " ms (depthwise " << depthwiseTime << " ms, pointwise "
+                  << pointwiseTime << " ms, speedup " << fullTime / separableTime
+                  << "x, max difference " << std::scientific << std::setprecision(1)
+                  << difference << (tolerance > difference ? " OK" : " FAILED") << std::fixed
+                  << std::setprecision(2) << ")";
     }
+    std::cout << "\n";
+    return passed;
+}
 
-    /**
-     * @brief Perform backpropagation.
-     * 
-     * @param[in] outputGradients Matrix holding gradients from the next layer.
-     * 
-     * @return True on success, false on failure.
-     */
-    bool backpropagate(const Matrix2d& outputGradients) noexcept
+/**
+ * @brief Max pool the given feature maps the same way as the max pooling layer of L26.
+ * 
+ *        The input is copied for the backpropagation and the first max value of each window
+ *        is selected.
+ * 
+ * @param[in] input The feature maps to pool.
+ * @param[in] poolSize The pool size.
+ * @param[out] inputCopy Copy of the feature maps, used by the backpropagation.
+ * @param[out] output The pooled feature maps.
+ */
+void maxPoolReference(const ml::Tensor& input, const std::size_t poolSize, ml::Tensor& inputCopy,
+                      ml::Tensor& output) noexcept
+{
+    for (std::size_t n{}; n < output.batchCount(); ++n)
     {
-        // Check the output gradients matrix, return false on dimension mismatch.
-        if ((outputGradients.size() != output.size()) || !isMatrixSquare(outputGradients))
+        for (std::size_t c{}; c < output.channelCount(); ++c)
         {
-            return false;
+            for (std::size_t i{}; i < output.height(); ++i)
+            {
+                for (std::size_t j{}; j < output.width(); ++j)
+                {
+                    auto maxValue{input(n, c, i * poolSize, j * poolSize)};
+
+                    for (std::size_t pi{}; pi < poolSize; ++pi)
+                    {
+                        for (std::size_t pj{}; pj < poolSize; ++pj)
+                        {
+                            maxValue = std::max(maxValue,
+                                                input(n, c, i * poolSize + pi, j * poolSize + pj));
+                        }
+                    }
+                    output(n, c, i, j) = maxValue;
+                }
+            }
         }
+    }
+    inputCopy.copyFrom(input);
+}
 
-        // Reinitialize the gradients with zeros (to remove old values).
-        // Else values from the previous backpropagation would still remain.
-        initMatrix(inputGradientsPadded);
-        initMatrix(inputGradients);
-        initMatrix(kernelGradients);
-        biasGradient = 0.0;
+/**
+ * @brief Feed the gradients of pooled feature maps back to the first max value of each window.
+ * 
+ *        Each window is searched again for its max value, the same way as the max pooling layer
+ *        of L26.
+ * 
+ * @param[in] input The copy of the pooled feature maps.
+ * @param[in] output The pooled feature maps.
+ * @param[in] outputGradients The gradients of the pooled feature maps.
+ * @param[out] inputGradients The gradients of the feature maps.
+ */
+void maxPoolReferenceGradients(const ml::Tensor& input, const ml::Tensor& output,
+                               const ml::Tensor& outputGradients,
+                               ml::Tensor& inputGradients) noexcept
+{
+    const auto poolSize{input.height() / output.height()};
+    inputGradients.fill();
 
-        // Iterate through the output gradients.
-        for (std::size_t i{}; i < output.size(); ++i)
+    for (std::size_t n{}; n < output.batchCount(); ++n)
+    {
+        for (std::size_t c{}; c < output.channelCount(); ++c)
         {
-            for (std::size_t j{}; j < output.size(); ++j)
+            for (std::size_t i{}; i < output.height(); ++i)
             {
-                // Calculate output derivate.
-                const auto delta{outputGradients[i][j] * reluDelta(output[i][j])};
-
-                // Accumulate the bias gradient by adding all output delta values.
-                biasGradient += delta;
-
-                // Iterate through the kernel.
-                for (std::size_t ki{}; ki < kernel.size(); ++ki)
+                for (std::size_t j{}; j < output.width(); ++j)
                 {
-                    for (std::size_t kj{}; kj < kernel.size(); ++kj)
+                    bool found{false};
+
+                    for (std::size_t pi{}; (pi < poolSize) && !found; ++pi)
                     {
-                        kernelGradients[ki][kj] += inputPadded[i + ki][j + kj] * delta;
-                        inputGradientsPadded[i + ki][j + kj] += kernel[ki][kj] * delta;
+                        for (std::size_t pj{}; (pj < poolSize) && !found; ++pj)
+                        {
+                            const auto row{i * poolSize + pi}, col{j * poolSize + pj};
+                            if (input(n, c, row, col) != output(n, c, i, j)) { continue; }
+                            inputGradients(n, c, row, col) = outputGradients(n, c, i, j);
+                            found                          = true;
+                        }
                     }
                 }
             }
         }
-        // Extract input gradients without zeros.
-        extractInputGradients();
-        return true;
     }
+}
 
-    /**
-     * @brief Perform optimization.
-     * 
-     * @param[in] learningRate Learning rate to use. Must be in range (0.0, 1.0].
-     * 
-     * @return True on success, false on failure.
-     */
-    bool optimize(const double learningRate) noexcept
+/**
+ * @brief Compare the fused convolution and max pooling layer with separate layers.
+ * 
+ *        The separate layers are the multi-channel layer followed by max pooling as in L26,
+ *        which writes the full convolution output, reads it back, copies it and searches each
+ *        window again during backpropagation.
+ * 
+ * @param[in] batchCount The number of images per batch.
+ * @param[in] channelCount The number of input channels.
+ * @param[in] filterCount The number of filters.
+ * @param[in] inputSize The input size.
+ * @param[in] kernelSize The kernel size.
+ * @param[in] poolSize The pool size.
+ * 
+ * @return True if the fused layer matches the separate layers.
+ */
+bool compareConvPool(const std::size_t batchCount, const std::size_t channelCount,
+                     const std::size_t filterCount, const std::size_t inputSize,
+                     const std::size_t kernelSize, const std::size_t poolSize)
+{
+    constexpr double tolerance{1e-9};
+    const auto pooledSize{inputSize / poolSize};
+    ml::Tensor input{batchCount, channelCount, inputSize, inputSize};
+    ml::Tensor outputGradients{batchCount, filterCount, pooledSize, pooledSize};
+    randomize(input, 0.5);
+    randomize(outputGradients, 0.5);
+
+    ml::ConvPoolLayer fused{channelCount, filterCount, inputSize, inputSize, kernelSize,
+                            poolSize,     batchCount};
+    ml::Conv2dLayer conv{channelCount, filterCount, inputSize, inputSize, kernelSize, batchCount};
+    conv.setParameters(fused.kernel(), fused.bias());
+
+    ml::Tensor convCopy{conv.output()}, convGradients{conv.output()}, pooled{outputGradients};
+    const auto separateTime{medianTime([&]() {
+        conv.feedforward(input);
+        maxPoolReference(conv.output(), poolSize, convCopy, pooled);
+        maxPoolReferenceGradients(convCopy, pooled, outputGradients, convGradients);
+        conv.backpropagate(convGradients);
+    })};
+    const auto fusedTime{medianTime([&]() {
+        fused.feedforward(input);
+        fused.backpropagate(outputGradients);
+    })};
+
+    const auto tensorDifference{
+        std::max({maxDifference(fused.output(), pooled),
+                  maxDifference(fused.inputGradients(), conv.inputGradients()),
+                  maxDifference(fused.kernelGradients(), conv.kernelGradients())})};
+    auto biasDifference{0.0};
+    for (std::size_t f{}; f < filterCount; ++f)
     {
-        // Check the learning rate, return false if out of range.
-        if ((0.0 >= learningRate) || (1.0 < learningRate)) { return false; }
+        biasDifference = std::max(
+            biasDifference, std::abs(fused.biasGradients()[f] - conv.biasGradients()[f]));
+    }
+    const auto difference{std::max(tensorDifference, biasDifference)};
+
+    // The separate layers write the convolution output, read it back and copy it (one read and
+    // one write); the fused layer only writes the pooled output and one byte per window.
+    const auto convBytes{4.0 * conv.output().size() * sizeof(double)};
+    const auto fusedBytes{fused.output().size() * (sizeof(double) + sizeof(std::uint8_t))};
 
-        // Adjust the bias with the computed bias gradient, multiplied by the learning rate.
-        // We subtract, since the gradients are computed in this manner, as opposed to what
-        // we've used in dense layer.
-        bias -= biasGradient * learningRate;
+    std::cout << std::fixed << std::setprecision(2) << "\t" << batchCount << " x " << channelCount
+              << " x " << inputSize << "x" << inputSize << " input, " << filterCount << " filters "
+              << kernelSize << "x" << kernelSize << ", pool " << poolSize << "x" << poolSize
+              << ": separate " << separateTime << " ms, fused " << fusedTime << " ms (speedup "
+              << separateTime / fusedTime << "x), conv output traffic " << convBytes / 1024.0
+              << " KiB -> " << fusedBytes / 1024.0 << " KiB (" << convBytes / fusedBytes
+              << "x less, max difference " << std::scientific << std::setprecision(1)
+              << difference << (tolerance > difference ? " OK" : " FAILED") << ")\n";
+    return tolerance > difference;
+}
+
+/**
+ * @brief Correlate a single-channel image one output row per kernel weight (reference).
+ * 
+ *        This is the direct algorithm before tiling: each output row is passed once per kernel
+ *        weight, so the output row is loaded and stored kernelSize * kernelSize times.
+ * 
+ * @param[in] input The input image.
+ * @param[in] kernel The kernel.
+ * @param[in] bias The bias value.
+ * @param[out] output The output image, same shape as the input.
+ */
+void correlateReference(const ml::Tensor& input, const ml::Tensor& kernel, const double bias,
+                        ml::Tensor& output) noexcept
+{
+    const auto size{input.width()}, kernelSize{kernel.width()}, pad{kernelSize / 2U};
 
-        // Adjust the kernel weights with the corresponding gradients and the learning rate.
-        for (std::size_t ki{}; ki < kernel.size(); ++ki)
+    for (std::size_t i{}; i < size; ++i)
+    {
+        auto* sums{&output(0U, 0U, i, 0U)};
+        std::fill_n(sums, size, bias);
+
+        for (std::size_t ki{}; ki < kernelSize; ++ki)
         {
-            for (std::size_t kj{}; kj < kernel.size(); ++kj)
+            if ((i + ki < pad) || (i + ki - pad >= size)) { continue; }
+            const auto* inputRow{&input(0U, 0U, i + ki - pad, 0U)};
+
+            for (std::size_t kj{}; kj < kernelSize; ++kj)
             {
-                kernel[ki][kj] -= kernelGradients[ki][kj] * learningRate;
+                const auto first{std::min(size, pad > kj ? pad - kj : 0U)};
+                const auto last{std::max(first, std::min(size, size + pad - kj))};
+                const auto weight{kernel(0U, 0U, ki, kj)};
+                for (auto j{first}; j < last; ++j) { sums[j] += weight * inputRow[j + kj - pad]; }
             }
         }
-        return true;
+        for (std::size_t j{}; j < size; ++j) { sums[j] = 0.0 < sums[j] ? sums[j] : 0.0; }
     }
+}
 
-    /** Input matrix (padded with zeros). */
-    Matrix2d inputPadded;
+/**
+ * @brief Compare the cache-tiled direct convolution with the untiled reference.
+ * 
+ *        The achieved bandwidth (input read once, output written once) is compared with the
+ *        bandwidth of a plain copy of the input, which is the most a streaming kernel can reach.
+ * 
+ * @param[in] inputSize The input size.
+ * @param[in] kernelSize The kernel size.
+ * 
+ * @return True if the tiled convolution matches the reference.
+ */
+bool compareTiled(const std::size_t inputSize, const std::size_t kernelSize)
+{
+    constexpr double tolerance{1e-9};
+    ml::Tensor input{1U, 1U, inputSize, inputSize}, output{input}, reference{input}, copy{input};
+    ml::Tensor kernel{1U, 1U, kernelSize, kernelSize};
+    randomize(input, 0.5);
+    randomize(kernel, 0.5);
 
-    /** Input gradient matrix (padded with zeros). */
-    Matrix2d inputGradientsPadded;
+    constexpr double bias{0.1};
+    const auto tileSize{ml::tiled::selectTileSize(inputSize, kernelSize)};
 
-    /** Input gradient matrix (without padding). */
-    Matrix2d inputGradients;
+    const auto copyTime{medianTime([&]() { copy.copyFrom(input); })};
+    const auto referenceTime{
+        medianTime([&]() { correlateReference(input, kernel, bias, reference); })};
+    const auto tiledTime{medianTime([&]() {
+        ml::tiled::correlateRelu(input.data(), inputSize, inputSize, kernel.data(), kernelSize,
+                                 bias, output.data(), 0U, inputSize, tileSize);
+    })};
+    const auto difference{maxDifference(output, reference)};
 
-    /** Kernel matrix (holding weights). */
-    Matrix2d kernel;
+    // Each time is in milliseconds, so bytes / time * 1e-6 is in GB/s.
+    const auto bytes{2.0 * input.size() * sizeof(double)};
+    const auto multiplyAdds{static_cast<double>(input.size() * kernelSize * kernelSize)};
 
-    /** Kernel gradient matrix. */
-    Matrix2d kernelGradients;
+    std::cout << std::fixed << std::setprecision(2) << "\t" << inputSize << "x" << inputSize
+              << " input, kernel " << kernelSize << "x" << kernelSize << ", tile "
+              << tileSize.rows << "x" << tileSize.cols << ": untiled " << referenceTime
+              << " ms, tiled " << tiledTime << " ms (speedup " << referenceTime / tiledTime
+              << "x, " << multiplyAdds / tiledTime * 1e-6 << " GMAC/s, "
+              << bytes / tiledTime * 1e-6 << " GB/s of " << bytes / copyTime * 1e-6
+              << " GB/s copy, max difference "
+              << std::scientific << std::setprecision(1) << difference
+              << (tolerance > difference ? " OK" : " FAILED") << ")\n";
+    return tolerance > difference;
+}
 
-    /** Output matrix. */
-    Matrix2d output;
+/**
+ * @brief Compare streaming a signal through a stack of causal dilated 1D convolutions with
+ *        recomputing the receptive field for each new sample.
+ * 
+ *        The signal simulates 10-bit ADC readings of a noisy sine wave, scaled to [0, 1]. The
+ *        streamed outputs are checked against running the whole sequence through the stack.
+ * 
+ * @param[in] filterCount The number of filters per layer.
+ * @param[in] kernelSize The kernel size.
+ * @param[in] layerCount The number of layers.
+ * @param[in] sampleCount The number of samples to stream.
+ * 
+ * @return True if the streamed outputs match the sequence outputs.
+ */
+bool compareStreaming(const std::size_t filterCount, const std::size_t kernelSize,
+                      const std::size_t layerCount, const std::size_t sampleCount)
+{
+    constexpr double tolerance{1e-9};
+    constexpr double adcMaxValue{1023.0};
+    ml::Conv1dStack stack{1U, filterCount, kernelSize, layerCount};
+    const auto field{stack.receptiveField()};
 
-    /** Bias value. */
-    double bias;
+    ml::Tensor signal{1U, 1U, 1U, sampleCount}, output{1U, filterCount, 1U, sampleCount};
+    for (std::size_t t{}; t < sampleCount; ++t)
+    {
+        const auto value{0.5 + 0.4 * std::sin(0.05 * t) + 0.05 * (randomStartVal() - 0.5)};
+        signal(0U, 0U, 0U, t) = std::round(value * adcMaxValue) / adcMaxValue;
+    }
+    stack.feedforward(signal, output);
 
-    /** Bias gradient. */
-    double biasGradient;
+    // Stream the samples one at a time, then once more to compare each output with the
+    // sequence output.
+    const auto start{std::chrono::steady_clock::now()};
+    for (std::size_t t{}; t < sampleCount; ++t) { stack.step(signal(0U, 0U, 0U, t)); }
+    const std::chrono::duration<double, std::micro> streamTime{std::chrono::steady_clock::now() -
+                                                               start};
+    double difference{};
+    stack.reset();
 
-private:
-    /**
-     * @brief Pad input with zeros.
-     * 
-     * @param[in] input Input data.
-     */
-    void padInput(const Matrix2d& input) noexcept
+    for (std::size_t t{}; t < sampleCount; ++t)
     {
-        // Compute the pad offset (the number of zeros in each direction).
-        const std::size_t padOffset{kernel.size() / 2U};
-
-        // Ensure that the padded input matrix is filled with zeros only.
-        initMatrix(inputPadded);
+        stack.step(signal(0U, 0U, 0U, t));
 
-        // Copy the input values to the corresponding padded matrix.
-        for (std::size_t i{}; i < output.size(); ++i)
+        for (std::size_t f{}; f < filterCount; ++f)
         {
-            for (std::size_t j{}; j < output.size(); ++j)
-            {
-                inputPadded[i + padOffset][j + padOffset] = input[i][j];
-            }
+            difference = std::max(difference, std::abs(stack.output()[f] - output(0U, f, 0U, t)));
         }
     }
 
-    /**
-     * @brief Extract input gradients.
-     */
-    void extractInputGradients() noexcept
-    {
-        // Compute the pad offset (the number of zeros in each direction).
-        const std::size_t padOffset{kernel.size() / 2U};
+    // Recompute the receptive field for each new sample (as a sliding window model would).
+    ml::Tensor window{1U, 1U, 1U, field}, windowOutput{1U, filterCount, 1U, field};
+    const auto windowCount{std::min<std::size_t>(sampleCount, 256U)};
+    const auto windowStart{std::chrono::steady_clock::now()};
 
-        for (std::size_t i{}; i < output.size(); ++i)
+    for (std::size_t t{}; t < windowCount; ++t)
+    {
+        for (std::size_t k{}; k < field; ++k)
         {
-            for (std::size_t j{}; j < output.size(); ++j)
-            {
-                inputGradients[i][j] = inputGradientsPadded[i + padOffset][j + padOffset];
-            }
+            window(0U, 0U, 0U, k) = t + k + 1U >= field ? signal(0U, 0U, 0U, t + k + 1U - field)
+                                                        : 0.0;
         }
+        stack.feedforward(window, windowOutput);
     }
-};
-} // namespace ml
+    const std::chrono::duration<double, std::micro> windowTime{std::chrono::steady_clock::now() -
+                                                               windowStart};
+
+    const auto streamSampleTime{streamTime.count() / sampleCount};
+    const auto windowSampleTime{windowTime.count() / windowCount};
+    const auto multiplyAdds{kernelSize * filterCount * (1U + (layerCount - 1U) * filterCount)};
+
+    std::cout << std::fixed << std::setprecision(2) << "\t" << layerCount << " layers, "
+              << filterCount << " filters, kernel " << kernelSize << " (receptive field " << field
+              << " samples): streaming " << streamSampleTime << " us/sample (" << multiplyAdds
+              << " MAC), recomputing the window " << windowSampleTime << " us/sample ("
+              << multiplyAdds * field << " MAC, speedup " << windowSampleTime / streamSampleTime
+              << "x), max difference " << std::scientific << std::setprecision(1) << difference
+              << (tolerance > difference ? " OK" : " FAILED") << "\n";
+    return tolerance > difference;
+}
 } // namespace
 
 /**
@@ -361,16 +1104,16 @@ private:
 int main()
 {
     // Example 4x4 input matrix (could represent an image or feature map).
-    const Matrix2d input{{1, 1, 1, 1},
-                         {1, 0, 0, 1},
-                         {1, 0, 0, 1},
-                         {1, 1, 1, 1}};
+    const auto input{createImage(4U, 4U, {1, 1, 1, 1,
+                                          1, 0, 0, 1,
+                                          1, 0, 0, 1,
+                                          1, 1, 1, 1})};
 
     // Example output gradients (target output for demonstration).
-    const Matrix2d outputGradients{{1, 1, 1, 1},
-                                   {1, 1, 1, 1},
-                                   {1, 1, 1, 1},
-                                   {1, 1, 1, 1}};
+    const auto outputGradients{createImage(4U, 4U, {1, 1, 1, 1,
+                                                    1, 1, 1, 1,
+                                                    1, 1, 1, 1,
+                                                    1, 1, 1, 1})};
 
     // Initialize the random generator with the current time as seed.
     std::srand(std::time(nullptr));
@@ -382,20 +1125,103 @@ int main()
     
     // Show the input matrix.
     std::cout << "Convolution input data (2D):\n";
-    printMatrix(input);
+    printTensor(input);
 
     // Perform feedforward (convolution).
     convLayer.feedforward(input);
     std::cout << "Convolution output (2D):\n";
-    printMatrix(convLayer.output);
+    printTensor(convLayer.output);
 
     // Show the output gradients.
     std::cout << "Convolution output gradients (2D):\n";
-    printMatrix(outputGradients);
+    printTensor(outputGradients);
 
     // Perform backpropagation.
     convLayer.backpropagate(outputGradients);
     std::cout << "Input gradients after backpropagation (2D):\n";
-    printMatrix(convLayer.inputGradients);
-    return 0;
+    printTensor(convLayer.inputGradients);
+
+    // Compare the algorithms on larger inputs (feedforward + backpropagation).
+    std::cout << "Direct convolution versus im2col + GEMM:\n";
+    bool gemmPassed{true};
+    for (const std::size_t kernelSize : {3U, 5U, 7U})
+    {
+        gemmPassed = compareAlgorithms(224U, kernelSize) && gemmPassed;
+    }
+
+    // Test the Winograd algorithms against the direct algorithm (feedforward).
+    std::cout << "\nWinograd versus direct convolution (3x3 kernel):\n";
+    bool winogradPassed{true};
+    for (const std::size_t inputSize : {4U, 15U, 224U})
+    {
+        winogradPassed = testWinograd(inputSize) && winogradPassed;
+    }
+
+    // Compare the FFT algorithm with the direct algorithm on large kernels (feedforward).
+    std::cout << "\nFFT versus direct convolution:\n";
+    bool fftPassed{true};
+    for (const auto& [inputSize, kernelSize] : {std::make_pair(224U, 7U), std::make_pair(512U, 11U),
+                                                std::make_pair(512U, 15U),
+                                                std::make_pair(1024U, 15U)})
+    {
+        fftPassed = compareFft(inputSize, kernelSize) && fftPassed;
+    }
+
+    // Run batches on a thread pool with one worker per core (feedforward + backpropagation).
+    ml::utils::ThreadPool pool{std::thread::hardware_concurrency()};
+    std::cout << "\nBatched convolution:\n";
+    bool batchPassed{true};
+    for (const std::size_t kernelSize : {3U, 5U})
+    {
+        batchPassed = compareBatch(32U, 112U, kernelSize, pool) && batchPassed;
+    }
+
+    // Run the same batch on 32 workers, which splits each image into four tiles of rows (on
+    // fewer cores, this measures the overhead of the tiles and the extra tasks).
+    ml::utils::ThreadPool widePool{32U};
+    batchPassed = compareBatch(32U, 112U, 3U, widePool) && batchPassed;
+    batchPassed = checkBatchOrder(112U, pool) && batchPassed;
+
+    // Run multi-channel layers in both layouts (feedforward + backpropagation).
+    std::cout << "\nMulti-channel convolution:\n";
+    bool layoutsPassed{true};
+    layoutsPassed = compareLayouts(1U, 3U, 16U, 112U, 3U) && layoutsPassed;
+    layoutsPassed = compareLayouts(4U, 16U, 32U, 28U, 3U) && layoutsPassed;
+
+    // Compare depthwise-separable convolution with full convolution (feedforward +
+    // backpropagation).
+    std::cout << "\nDepthwise-separable versus full convolution:\n";
+    bool separablePassed{true};
+    separablePassed = compareSeparable(1U, 32U, 64U, 56U, 3U) && separablePassed;
+    separablePassed = compareSeparable(1U, 128U, 128U, 28U, 3U) && separablePassed;
+    separablePassed = compareSeparable(1U, 64U, 64U, 28U, 5U) && separablePassed;
+
+    // Compare fused convolution, ReLU and max pooling with separate layers (feedforward +
+    // backpropagation).
+    std::cout << "\nFused convolution and max pooling versus separate layers:\n";
+    bool fusedPassed{true};
+    fusedPassed = compareConvPool(1U, 3U, 16U, 112U, 3U, 2U) && fusedPassed;
+    fusedPassed = compareConvPool(4U, 16U, 32U, 28U, 3U, 2U) && fusedPassed;
+    fusedPassed = compareConvPool(1U, 8U, 16U, 96U, 5U, 4U) && fusedPassed;
+
+    // Compare the cache-tiled direct convolution with the untiled one on large images
+    // (feedforward).
+    const auto& caches{ml::utils::cacheSizes()};
+    std::cout << "\nCache-tiled direct convolution (L1 " << caches.l1Data / 1024U << " KiB, L2 "
+              << caches.l2 / 1024U << " KiB):\n";
+    bool tiledPassed{true};
+    for (const std::size_t kernelSize : {3U, 5U, 7U})
+    {
+        tiledPassed = compareTiled(2048U, kernelSize) && tiledPassed;
+    }
+
+    // Stream a simulated sensor signal through stacks of causal dilated 1D convolutions.
+    std::cout << "\nStreaming causal dilated 1D convolution (4096 samples):\n";
+    bool streamingPassed{true};
+    streamingPassed = compareStreaming(8U, 2U, 8U, 4096U) && streamingPassed;
+    streamingPassed = compareStreaming(16U, 3U, 6U, 4096U) && streamingPassed;
+
+    const auto passed{gemmPassed && winogradPassed && fftPassed && batchPassed && layoutsPassed
+                      && separablePassed && fusedPassed && tiledPassed && streamingPassed};
+    return passed ? 0 : -1;
 }
@@ -0,0 +1,165 @@
+/**
+ * @brief Causal one-dimensional convolutional layer implementation details.
+ */
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "ml/conv1d_layer.h"
+
+namespace ml
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+constexpr double reluOutput(const double input) noexcept { return 0.0 < input ? input : 0.0; }
+
+// -----------------------------------------------------------------------------
+std::size_t checkDilation(const std::size_t dilation)
+{
+    // Check the dilation, throw if invalid (the other dimensions are checked by the kernel).
+    if (0U == dilation)
+    {
+        throw std::invalid_argument("Cannot create conv1d layer: invalid dilation!");
+    }
+    return dilation;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+Conv1dLayer::Conv1dLayer(const std::size_t inputChannelCount, const std::size_t filterCount,
+                         const std::size_t kernelSize, const std::size_t dilation,
+                         const unsigned seed)
+    : myKernel{filterCount, inputChannelCount, 1U, kernelSize}
+    , myBias(filterCount)
+    , myHistory(((kernelSize - 1U) * dilation + 1U) * inputChannelCount)
+    , myOutput(filterCount)
+    , myDilation{checkDilation(dilation)}
+    , myPosition{}
+{
+    // Initialize the kernel with values scaled to the number of inputs per filter.
+    const auto limit{std::sqrt(6.0 / myKernel.imageSize())};
+    std::mt19937 generator{seed};
+    std::uniform_real_distribution<double> distribution{-limit, limit};
+    for (std::size_t k{}; k < myKernel.size(); ++k)
+    {
+        myKernel.data()[k] = distribution(generator);
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Conv1dLayer::inputChannelCount() const noexcept { return myKernel.channelCount(); }
+
+// -----------------------------------------------------------------------------
+std::size_t Conv1dLayer::filterCount() const noexcept { return myKernel.batchCount(); }
+
+// -----------------------------------------------------------------------------
+std::size_t Conv1dLayer::kernelSize() const noexcept { return myKernel.width(); }
+
+// -----------------------------------------------------------------------------
+std::size_t Conv1dLayer::dilation() const noexcept { return myDilation; }
+
+// -----------------------------------------------------------------------------
+std::size_t Conv1dLayer::receptiveField() const noexcept
+{
+    return (kernelSize() - 1U) * myDilation + 1U;
+}
+
+// -----------------------------------------------------------------------------
+const Tensor& Conv1dLayer::kernel() const noexcept { return myKernel; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& Conv1dLayer::bias() const noexcept { return myBias; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& Conv1dLayer::output() const noexcept { return myOutput; }
+
+// -----------------------------------------------------------------------------
+bool Conv1dLayer::setParameters(const Tensor& kernel, const std::vector<double>& bias) noexcept
+{
+    // Check the dimensions, return false on mismatch.
+    if (!kernel.hasShape(myKernel) || (bias.size() != myBias.size())) { return false; }
+
+    myKernel.copyFrom(kernel);
+    myBias = bias;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Conv1dLayer::feedforward(const Tensor& input, Tensor& output) const noexcept
+{
+    // Check the dimensions, return false on mismatch.
+    const auto length{input.width()};
+    if ((1U != input.batchCount()) || (inputChannelCount() != input.channelCount()) ||
+        (1U != input.height()) || (1U != output.batchCount()) ||
+        (filterCount() != output.channelCount()) || (1U != output.height()) ||
+        (length != output.width()))
+    {
+        return false;
+    }
+
+    for (std::size_t f{}; f < filterCount(); ++f)
+    {
+        for (std::size_t t{}; t < length; ++t)
+        {
+            auto sum{myBias[f]};
+
+            // Kernel position k hits the sample (kernelSize - 1 - k) * dilation steps back, skip
+            // the positions before the start of the sequence.
+            for (std::size_t k{}; k < kernelSize(); ++k)
+            {
+                const auto age{(kernelSize() - 1U - k) * myDilation};
+                if (age > t) { continue; }
+
+                for (std::size_t c{}; c < inputChannelCount(); ++c)
+                {
+                    sum += myKernel(f, c, 0U, k) * input(0U, c, 0U, t - age);
+                }
+            }
+            output(0U, f, 0U, t) = reluOutput(sum);
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Conv1dLayer::step(const std::vector<double>& sample) noexcept
+{
+    // Check the sample, return false on dimension mismatch.
+    const auto channels{inputChannelCount()};
+    if (channels != sample.size()) { return false; }
+
+    // Overwrite the oldest sample of the ring buffer with the new sample.
+    const auto field{receptiveField()}, size{kernelSize()}, stride{myKernel.channelStride()};
+    myPosition = (myPosition + 1U) % field;
+    std::copy(sample.begin(), sample.end(), myHistory.begin() + myPosition * channels);
+    std::copy(myBias.begin(), myBias.end(), myOutput.begin());
+
+    // Add the contribution of each kernel position, the samples before the first one are zero.
+    for (std::size_t k{}; k < size; ++k)
+    {
+        const auto age{(size - 1U - k) * myDilation};
+        const auto slot{myPosition >= age ? myPosition - age : myPosition + field - age};
+        const auto* values{&myHistory[slot * channels]};
+
+        for (std::size_t f{}; f < filterCount(); ++f)
+        {
+            const auto* weights{&myKernel(f, 0U, 0U, k)};
+            auto sum{myOutput[f]};
+            for (std::size_t c{}; c < channels; ++c) { sum += weights[c * stride] * values[c]; }
+            myOutput[f] = sum;
+        }
+    }
+    for (auto& value : myOutput) { value = reluOutput(value); }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void Conv1dLayer::reset() noexcept
+{
+    std::fill(myHistory.begin(), myHistory.end(), 0.0);
+    std::fill(myOutput.begin(), myOutput.end(), 0.0);
+    myPosition = 0U;
+}
+} // namespace ml
@@ -0,0 +1,176 @@
+/**
+ * @brief Causal one-dimensional convolutional layer with streaming support.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "ml/tensor.h"
+
+namespace ml
+{
+/**
+ * @brief Causal one-dimensional convolutional layer with ReLU activation, for time series.
+ * 
+ *        Each filter covers all input channels and generates one output channel. The output at
+ *        time t only depends on the inputs at times t, t - dilation, ..., t - (kernelSize - 1) *
+ *        dilation (the inputs before the start of the sequence are zero), so the layer never
+ *        looks ahead and can run on a continuous signal, e.g. samples read from an ADC.
+ * 
+ *        The layer can be run in two modes:
+ *          - Sequence mode: a whole sequence is convolved at once.
+ *          - Streaming mode: one sample is fed at a time. The layer keeps the latest
+ *            receptiveField() samples in a ring buffer, so each new sample only costs
+ *            kernelSize x inputChannelCount x filterCount multiplications, instead of
+ *            recomputing the whole window. The streaming output matches the sequence output at
+ *            the same time step.
+ * 
+ *        The sequences are stored in tensors holding one image of one row, i.e. channelCount x
+ *        1 x sequenceLength values. The kernel is stored in a tensor of shape filterCount x
+ *        inputChannelCount x 1 x kernelSize, where kernel position kernelSize - 1 is applied to
+ *        the latest sample.
+ * 
+ *        All buffers are allocated when the layer is created, none during streaming.
+ */
+class Conv1dLayer final
+{
+public:
+    /**
+     * @brief Create a new causal one-dimensional convolutional layer.
+     * 
+     * @param[in] inputChannelCount The number of input channels. Must exceed 0.
+     * @param[in] filterCount The number of filters (output channels). Must exceed 0.
+     * @param[in] kernelSize The kernel size. Must exceed 0.
+     * @param[in] dilation The distance between the samples hit by the kernel (default = 1).
+     *                     Must exceed 0.
+     * @param[in] seed Seed used to generate the starting kernel values (default = 0).
+     */
+    explicit Conv1dLayer(std::size_t inputChannelCount, std::size_t filterCount,
+                         std::size_t kernelSize, std::size_t dilation = 1U, unsigned seed = 0U);
+
+    /**
+     * @brief Delete the layer.
+     */
+    ~Conv1dLayer() noexcept = default;
+
+    /**
+     * @brief Get the number of input channels.
+     * 
+     * @return The number of input channels.
+     */
+    std::size_t inputChannelCount() const noexcept;
+
+    /**
+     * @brief Get the number of filters (output channels).
+     * 
+     * @return The number of filters.
+     */
+    std::size_t filterCount() const noexcept;
+
+    /**
+     * @brief Get the kernel size.
+     * 
+     * @return The kernel size.
+     */
+    std::size_t kernelSize() const noexcept;
+
+    /**
+     * @brief Get the dilation.
+     * 
+     * @return The distance between the samples hit by the kernel.
+     */
+    std::size_t dilation() const noexcept;
+
+    /**
+     * @brief Get the receptive field, i.e. the number of samples each output depends on.
+     * 
+     * @return The receptive field, (kernelSize - 1) * dilation + 1.
+     */
+    std::size_t receptiveField() const noexcept;
+
+    /**
+     * @brief Get the kernel.
+     * 
+     * @return Tensor holding filterCount x inputChannelCount x 1 x kernelSize weights.
+     */
+    const Tensor& kernel() const noexcept;
+
+    /**
+     * @brief Get the bias values, one per filter.
+     * 
+     * @return Vector holding the bias values.
+     */
+    const std::vector<double>& bias() const noexcept;
+
+    /**
+     * @brief Get the output of the latest streamed sample.
+     * 
+     * @return Vector holding one output value per filter.
+     */
+    const std::vector<double>& output() const noexcept;
+
+    /**
+     * @brief Replace the kernel and bias values.
+     * 
+     * @param[in] kernel The new kernel, any layout.
+     * @param[in] bias The new bias values, one per filter.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool setParameters(const Tensor& kernel, const std::vector<double>& bias) noexcept;
+
+    /**
+     * @brief Convolve a whole sequence (sequence mode).
+     * 
+     *        The streaming state is not affected.
+     * 
+     * @param[in] input Tensor holding inputChannelCount x 1 x sequenceLength values, any layout.
+     * @param[out] output Tensor holding filterCount x 1 x sequenceLength values, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool feedforward(const Tensor& input, Tensor& output) const noexcept;
+
+    /**
+     * @brief Feed the next sample of the signal (streaming mode).
+     * 
+     *        The output for the sample is available via output().
+     * 
+     * @param[in] sample Vector holding one value per input channel.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool step(const std::vector<double>& sample) noexcept;
+
+    /**
+     * @brief Reset the streaming state, as if no samples had been fed.
+     */
+    void reset() noexcept;
+
+    Conv1dLayer()                              = delete; // No default constructor.
+    Conv1dLayer(const Conv1dLayer&)            = delete; // No copy constructor.
+    Conv1dLayer(Conv1dLayer&&)                 = delete; // No move constructor.
+    Conv1dLayer& operator=(const Conv1dLayer&) = delete; // No copy assignment.
+    Conv1dLayer& operator=(Conv1dLayer&&)      = delete; // No move assignment.
+
+private:
+    /** Kernel: filterCount x inputChannelCount x 1 x kernelSize. */
+    Tensor myKernel;
+
+    /** Bias values, one per filter. */
+    std::vector<double> myBias;
+
+    /** Ring buffer holding the latest receptiveField() samples, one after another. */
+    std::vector<double> myHistory;
+
+    /** Output of the latest streamed sample, one value per filter. */
+    std::vector<double> myOutput;
+
+    /** The dilation. */
+    std::size_t myDilation;
+
+    /** Position of the latest sample in the ring buffer. */
+    std::size_t myPosition;
+};
+} // namespace ml
@@ -0,0 +1,109 @@
+/**
+ * @brief Stack of causal dilated one-dimensional convolutional layers implementation details.
+ */
+#include <stdexcept>
+
+#include "ml/conv1d_stack.h"
+
+namespace ml
+{
+namespace
+{
+/** The largest number of layers (the dilation of the last layer is 2^15). */
+constexpr std::size_t MaxLayerCount{16U};
+} // namespace
+
+// -----------------------------------------------------------------------------
+Conv1dStack::Conv1dStack(const std::size_t inputChannelCount, const std::size_t filterCount,
+                         const std::size_t kernelSize, const std::size_t layerCount,
+                         const unsigned seed)
+    : myLayers{}
+    , mySample(1U)
+{
+    // Check the number of layers, throw if invalid (the other dimensions are checked by the
+    // layers).
+    if ((0U == layerCount) || (MaxLayerCount < layerCount))
+    {
+        throw std::invalid_argument("Cannot create conv1d stack: invalid layer count!");
+    }
+
+    // The first layer reads the input channels, each following layer the filters of the layer
+    // before it.
+    for (std::size_t l{}; l < layerCount; ++l)
+    {
+        myLayers.push_back(std::make_unique<Conv1dLayer>(
+            0U == l ? inputChannelCount : filterCount, filterCount, kernelSize,
+            std::size_t{1U} << l, seed + static_cast<unsigned>(l)));
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Conv1dStack::layerCount() const noexcept { return myLayers.size(); }
+
+// -----------------------------------------------------------------------------
+Conv1dLayer& Conv1dStack::layer(const std::size_t index) noexcept { return *myLayers[index]; }
+
+// -----------------------------------------------------------------------------
+const Conv1dLayer& Conv1dStack::layer(const std::size_t index) const noexcept
+{
+    return *myLayers[index];
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Conv1dStack::receptiveField() const noexcept
+{
+    // Each layer extends the receptive field by its own, minus the shared latest sample.
+    std::size_t result{1U};
+    for (const auto& layer : myLayers) { result += layer->receptiveField() - 1U; }
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& Conv1dStack::output() const noexcept
+{
+    return myLayers.back()->output();
+}
+
+// -----------------------------------------------------------------------------
+bool Conv1dStack::feedforward(const Tensor& input, Tensor& output) const
+{
+    // Run the layers one after another, the hidden layers alternate between two temporary
+    // outputs.
+    const auto length{input.width()}, filterCount{myLayers.back()->filterCount()};
+    Tensor hidden[2U]{Tensor{1U, filterCount, 1U, length}, Tensor{1U, filterCount, 1U, length}};
+    const auto* current{&input};
+
+    for (std::size_t l{}; l + 1U < myLayers.size(); ++l)
+    {
+        if (!myLayers[l]->feedforward(*current, hidden[l % 2U])) { return false; }
+        current = &hidden[l % 2U];
+    }
+    return myLayers.back()->feedforward(*current, output);
+}
+
+// -----------------------------------------------------------------------------
+bool Conv1dStack::step(const std::vector<double>& sample) noexcept
+{
+    // Pass the sample through the layers, each layer reads the output of the layer before it.
+    if (!myLayers.front()->step(sample)) { return false; }
+
+    for (std::size_t l{1U}; l < myLayers.size(); ++l)
+    {
+        myLayers[l]->step(myLayers[l - 1U]->output());
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Conv1dStack::step(const double sample) noexcept
+{
+    mySample[0U] = sample;
+    return step(mySample);
+}
+
+// -----------------------------------------------------------------------------
+void Conv1dStack::reset() noexcept
+{
+    for (auto& layer : myLayers) { layer->reset(); }
+}
+} // namespace ml
@@ -0,0 +1,137 @@
+/**
+ * @brief Stack of causal dilated one-dimensional convolutional layers.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "ml/conv1d_layer.h"
+#include "ml/tensor.h"
+
+namespace ml
+{
+/**
+ * @brief Stack of causal one-dimensional convolutional layers with doubling dilations.
+ * 
+ *        Layer l has the dilation 2^l, so the receptive field grows exponentially with the
+ *        number of layers (as in WaveNet and temporal convolutional networks), while the cost
+ *        per sample only grows linearly: (kernelSize - 1) * (2^layerCount - 1) + 1 samples are
+ *        covered at the cost of layerCount layers of kernelSize taps each.
+ * 
+ *        In streaming mode, each layer keeps its own ring buffer, so a new sample is passed
+ *        through the layers one after another without recomputing any earlier outputs. For
+ *        instance, to run the stack on an ADC channel, each conversion is scaled to [0, 1] and
+ *        fed as it arrives:
+ * 
+ *            stack.step(adc.read(pin) / static_cast<double>(adc.maxValue()));
+ */
+class Conv1dStack final
+{
+public:
+    /**
+     * @brief Create a new stack of causal dilated convolutional layers.
+     * 
+     * @param[in] inputChannelCount The number of input channels. Must exceed 0.
+     * @param[in] filterCount The number of filters of each layer. Must exceed 0.
+     * @param[in] kernelSize The kernel size of each layer. Must exceed 0.
+     * @param[in] layerCount The number of layers. Must be in range [1, 16].
+     * @param[in] seed Seed used to generate the starting kernel values (default = 0).
+     */
+    explicit Conv1dStack(std::size_t inputChannelCount, std::size_t filterCount,
+                         std::size_t kernelSize, std::size_t layerCount, unsigned seed = 0U);
+
+    /**
+     * @brief Delete the stack.
+     */
+    ~Conv1dStack() noexcept = default;
+
+    /**
+     * @brief Get the number of layers.
+     * 
+     * @return The number of layers.
+     */
+    std::size_t layerCount() const noexcept;
+
+    /**
+     * @brief Get the layer at the given index.
+     * 
+     * @param[in] index The layer index. Must be less than the number of layers.
+     * 
+     * @return Reference to the layer.
+     */
+    Conv1dLayer& layer(std::size_t index) noexcept;
+
+    /**
+     * @brief Get the layer at the given index.
+     * 
+     * @param[in] index The layer index. Must be less than the number of layers.
+     * 
+     * @return Reference to the layer.
+     */
+    const Conv1dLayer& layer(std::size_t index) const noexcept;
+
+    /**
+     * @brief Get the receptive field, i.e. the number of samples each output depends on.
+     * 
+     * @return The receptive field of the stack.
+     */
+    std::size_t receptiveField() const noexcept;
+
+    /**
+     * @brief Get the output of the latest streamed sample.
+     * 
+     * @return Vector holding one output value per filter of the last layer.
+     */
+    const std::vector<double>& output() const noexcept;
+
+    /**
+     * @brief Run a whole sequence through the stack (sequence mode).
+     * 
+     *        The streaming state is not affected.
+     * 
+     * @param[in] input Tensor holding inputChannelCount x 1 x sequenceLength values, any layout.
+     * @param[out] output Tensor holding filterCount x 1 x sequenceLength values, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool feedforward(const Tensor& input, Tensor& output) const;
+
+    /**
+     * @brief Feed the next sample of the signal (streaming mode).
+     * 
+     * @param[in] sample Vector holding one value per input channel.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool step(const std::vector<double>& sample) noexcept;
+
+    /**
+     * @brief Feed the next sample of a single-channel signal (streaming mode).
+     * 
+     * @param[in] sample The value of the sample.
+     * 
+     * @return True on success, false if the stack has more than one input channel.
+     */
+    bool step(double sample) noexcept;
+
+    /**
+     * @brief Reset the streaming state of all layers, as if no samples had been fed.
+     */
+    void reset() noexcept;
+
+    Conv1dStack()                              = delete; // No default constructor.
+    Conv1dStack(const Conv1dStack&)            = delete; // No copy constructor.
+    Conv1dStack(Conv1dStack&&)                 = delete; // No move constructor.
+    Conv1dStack& operator=(const Conv1dStack&) = delete; // No copy assignment.
+    Conv1dStack& operator=(Conv1dStack&&)      = delete; // No move assignment.
+
+private:
+    /** The layers, the dilation doubles from one layer to the next. */
+    std::vector<std::unique_ptr<Conv1dLayer>> myLayers;
+
+    /** Buffer holding a single-channel sample. */
+    std::vector<double> mySample;
+};
+} // namespace ml
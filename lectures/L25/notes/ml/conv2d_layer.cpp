@@ -0,0 +1,389 @@
+/**
+ * @brief Multi-channel convolutional layer implementation details.
+ */
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "ml/conv2d_layer.h"
+#include "ml/gemm.h"
+
+namespace ml
+{
+namespace
+{
+/** The size of the patch matrix of a tile (kept in L2 cache between lowering and use). */
+constexpr std::size_t TileBytes{128U * 1024U};
+
+// -----------------------------------------------------------------------------
+constexpr double reluOutput(const double input) noexcept { return 0.0 < input ? input : 0.0; }
+
+// -----------------------------------------------------------------------------
+constexpr double reluDelta(const double output) noexcept { return 0.0 < output ? 1.0 : 0.0; }
+
+// -----------------------------------------------------------------------------
+void validColumns(const std::size_t width, const std::size_t pad, const std::size_t kj,
+                  std::size_t& first, std::size_t& last) noexcept
+{
+    // Get the output columns [first, last) for which kernel column kj hits the input.
+    first = std::min(width, pad > kj ? pad - kj : 0U);
+    last  = std::max(first, std::min(width, width + pad - kj));
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+Conv2dLayer::Conv2dLayer(const std::size_t inputChannelCount, const std::size_t filterCount,
+                         const std::size_t inputHeight, const std::size_t inputWidth,
+                         const std::size_t kernelSize, const std::size_t batchCount,
+                         const Layout layout, const unsigned seed)
+    : myInput{batchCount, inputChannelCount, inputHeight, inputWidth, layout}
+    , myInputGradients{batchCount, inputChannelCount, inputHeight, inputWidth, layout}
+    , myKernel{filterCount, inputChannelCount, kernelSize, kernelSize, layout}
+    , myKernelGradients{filterCount, inputChannelCount, kernelSize, kernelSize, layout}
+    , myOutput{batchCount, filterCount, inputHeight, inputWidth, layout}
+    , myDelta{batchCount, filterCount, inputHeight, inputWidth, layout}
+    , myBias(filterCount)
+    , myBiasGradients(filterCount)
+    , myColumns{}
+    , myColumnGradients{}
+{
+    // Check the kernel size, throw if invalid (the other dimensions are checked by the tensors).
+    if ((kernelSize > inputHeight) || (kernelSize > inputWidth))
+    {
+        throw std::invalid_argument("Cannot create convolutional layer: invalid kernel size!");
+    }
+
+    // Allocate the patch matrix of one tile and its gradients.
+    myColumns.resize(myKernel.imageSize() * inputWidth * tileRowCount());
+    myColumnGradients.resize(myColumns.size());
+
+    // Initialize the kernel with values scaled to the number of inputs per filter, which keeps
+    // the output magnitude independent of the number of input channels.
+    const auto limit{std::sqrt(6.0 / myKernel.imageSize())};
+    std::mt19937 generator{seed};
+    std::uniform_real_distribution<double> distribution{-limit, limit};
+    for (std::size_t k{}; k < myKernel.size(); ++k)
+    {
+        myKernel.data()[k] = distribution(generator);
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Conv2dLayer::inputChannelCount() const noexcept { return myInput.channelCount(); }
+
+// -----------------------------------------------------------------------------
+std::size_t Conv2dLayer::filterCount() const noexcept { return myOutput.channelCount(); }
+
+// -----------------------------------------------------------------------------
+std::size_t Conv2dLayer::kernelSize() const noexcept { return myKernel.height(); }
+
+// -----------------------------------------------------------------------------
+Layout Conv2dLayer::layout() const noexcept { return myOutput.layout(); }
+
+// -----------------------------------------------------------------------------
+const Tensor& Conv2dLayer::output() const noexcept { return myOutput; }
+
+// -----------------------------------------------------------------------------
+const Tensor& Conv2dLayer::inputGradients() const noexcept { return myInputGradients; }
+
+// -----------------------------------------------------------------------------
+const Tensor& Conv2dLayer::kernel() const noexcept { return myKernel; }
+
+// -----------------------------------------------------------------------------
+const Tensor& Conv2dLayer::kernelGradients() const noexcept { return myKernelGradients; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& Conv2dLayer::bias() const noexcept { return myBias; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& Conv2dLayer::biasGradients() const noexcept { return myBiasGradients; }
+
+// -----------------------------------------------------------------------------
+bool Conv2dLayer::setParameters(const Tensor& kernel, const std::vector<double>& bias) noexcept
+{
+    // Check the dimensions, return false on mismatch.
+    if (!kernel.hasShape(myKernel) || (bias.size() != myBias.size())) { return false; }
+
+    myKernel.copyFrom(kernel);
+    myBias = bias;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Conv2dLayer::feedforward(const Tensor& input) noexcept
+{
+    // Store the input (rearranged to the layout of the layer), return false on mismatch.
+    if (!myInput.copyFrom(input)) { return false; }
+
+    const auto height{myOutput.height()}, width{myOutput.width()};
+    const auto filters{filterCount()};
+    const auto depth{myKernel.imageSize()};
+    const auto tileRows{tileRowCount()};
+
+    for (std::size_t n{}; n < myOutput.batchCount(); ++n)
+    {
+        auto* output{myOutput.image(n)};
+
+        // Lower each tile of the image, then multiply the kernel with the patch matrix.
+        for (std::size_t row{}; row < height; row += tileRows)
+        {
+            const auto rowCount{std::min(tileRows, height - row)};
+            const auto tileArea{rowCount * width};
+            lowerInput(n, row, rowCount);
+
+            if (Layout::Nchw == layout())
+            {
+                // output[filter][position] = kernel[filter][depth] * columns[depth][position].
+                gemm(Transpose::No, Transpose::No, filters, tileArea, depth, myKernel.data(),
+                     depth, myColumns.data(), tileArea, output + row * width, height * width);
+            }
+            else
+            {
+                // output[position][filter] = columns[position][depth] * kernel^T[depth][filter].
+                gemm(Transpose::No, Transpose::Yes, tileArea, filters, depth, myColumns.data(),
+                     depth, myKernel.data(), depth, output + row * width * filters, filters);
+            }
+        }
+    }
+
+    // Add the bias of each filter and pass each sum through the ReLU activation function.
+    for (std::size_t n{}; n < myOutput.batchCount(); ++n)
+    {
+        for (std::size_t f{}; f < filters; ++f)
+        {
+            for (std::size_t i{}; i < height; ++i)
+            {
+                for (std::size_t j{}; j < width; ++j)
+                {
+                    auto& value{myOutput(n, f, i, j)};
+                    value = reluOutput(value + myBias[f]);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Conv2dLayer::backpropagate(const Tensor& outputGradients) noexcept
+{
+    // Copy the output gradients (rearranged to the layout of the layer), false on mismatch.
+    if (!myDelta.copyFrom(outputGradients)) { return false; }
+
+    const auto height{myOutput.height()}, width{myOutput.width()};
+    const auto filters{filterCount()};
+    const auto depth{myKernel.imageSize()};
+    const auto tileRows{tileRowCount()};
+
+    // Reset the gradients, since the contributions of all tiles and images are accumulated.
+    myInputGradients.fill();
+    myKernelGradients.fill();
+    std::fill(myBiasGradients.begin(), myBiasGradients.end(), 0.0);
+
+    // Compute the output deltas and the bias gradients.
+    for (std::size_t n{}; n < myDelta.batchCount(); ++n)
+    {
+        for (std::size_t f{}; f < filters; ++f)
+        {
+            for (std::size_t i{}; i < height; ++i)
+            {
+                for (std::size_t j{}; j < width; ++j)
+                {
+                    auto& delta{myDelta(n, f, i, j)};
+                    delta *= reluDelta(myOutput(n, f, i, j));
+                    myBiasGradients[f] += delta;
+                }
+            }
+        }
+    }
+
+    for (std::size_t n{}; n < myDelta.batchCount(); ++n)
+    {
+        const auto* delta{myDelta.image(n)};
+
+        for (std::size_t row{}; row < height; row += tileRows)
+        {
+            const auto rowCount{std::min(tileRows, height - row)};
+            const auto tileArea{rowCount * width};
+
+            // Rebuild the patch matrix, accumulate the kernel gradients, compute the gradients
+            // of the patch matrix and scatter them to the input gradients.
+            lowerInput(n, row, rowCount);
+
+            if (Layout::Nchw == layout())
+            {
+                const auto* tileDelta{delta + row * width};
+                gemm(Transpose::No, Transpose::Yes, filters, depth, tileArea, tileDelta,
+                     height * width, myColumns.data(), tileArea, myKernelGradients.data(), depth,
+                     true);
+                gemm(Transpose::Yes, Transpose::No, depth, tileArea, filters, myKernel.data(),
+                     depth, tileDelta, height * width, myColumnGradients.data(), tileArea);
+            }
+            else
+            {
+                const auto* tileDelta{delta + row * width * filters};
+                gemm(Transpose::Yes, Transpose::No, filters, depth, tileArea, tileDelta, filters,
+                     myColumns.data(), depth, myKernelGradients.data(), depth, true);
+                gemm(Transpose::No, Transpose::No, tileArea, depth, filters, tileDelta, filters,
+                     myKernel.data(), depth, myColumnGradients.data(), depth);
+            }
+            scatterColumnGradients(n, row, rowCount);
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Conv2dLayer::optimize(const double learningRate) noexcept
+{
+    // Check the learning rate, return false if out of range.
+    if ((0.0 >= learningRate) || (1.0 < learningRate)) { return false; }
+
+    // Adjust the parameters in the opposite direction of the gradients.
+    for (std::size_t f{}; f < myBias.size(); ++f)
+    {
+        myBias[f] -= myBiasGradients[f] * learningRate;
+    }
+
+    auto* kernel{myKernel.data()};
+    const auto* kernelGradients{myKernelGradients.data()};
+
+    for (std::size_t k{}; k < myKernel.size(); ++k)
+    {
+        kernel[k] -= kernelGradients[k] * learningRate;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Conv2dLayer::tileRowCount() const noexcept
+{
+    const auto rowBytes{myKernel.imageSize() * myOutput.width() * sizeof(double)};
+    return std::clamp<std::size_t>(TileBytes / rowBytes, 1U, myOutput.height());
+}
+
+// -----------------------------------------------------------------------------
+void Conv2dLayer::lowerInput(const std::size_t image, const std::size_t firstRow,
+                             const std::size_t rowCount) noexcept
+{
+    const auto height{myInput.height()}, width{myInput.width()};
+    const auto channels{myInput.channelCount()};
+    const auto size{kernelSize()}, pad{kernelSize() / 2U};
+    auto* column{myColumns.data()};
+
+    if (Layout::Nchw == layout())
+    {
+        // Row (c, ki, kj) holds input[c][i + ki - pad][j + kj - pad] for each output position
+        // (i, j) of the tile, i.e. parts of input rows with zeros where the kernel hits the pad.
+        for (std::size_t c{}; c < channels; ++c)
+        {
+            for (std::size_t ki{}; ki < size; ++ki)
+            {
+                for (std::size_t kj{}; kj < size; ++kj)
+                {
+                    std::size_t first{}, last{};
+                    validColumns(width, pad, kj, first, last);
+
+                    for (auto i{firstRow}; i < firstRow + rowCount; ++i, column += width)
+                    {
+                        if ((i + ki < pad) || (i + ki - pad >= height))
+                        {
+                            std::fill_n(column, width, 0.0);
+                            continue;
+                        }
+                        const auto* input{&myInput(image, c, i + ki - pad, 0U)};
+                        std::fill(column, column + first, 0.0);
+                        std::copy(input + first + kj - pad, input + last + kj - pad,
+                                  column + first);
+                        std::fill(column + last, column + width, 0.0);
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        // Row (i, j) holds the channels of input[i + ki - pad][j + kj - pad] for each kernel
+        // position (ki, kj), i.e. contiguous pixels with zeros where the kernel hits the pad.
+        for (auto i{firstRow}; i < firstRow + rowCount; ++i)
+        {
+            for (std::size_t j{}; j < width; ++j)
+            {
+                for (std::size_t ki{}; ki < size; ++ki)
+                {
+                    for (std::size_t kj{}; kj < size; ++kj, column += channels)
+                    {
+                        if ((i + ki < pad) || (i + ki - pad >= height) || (j + kj < pad) ||
+                            (j + kj - pad >= width))
+                        {
+                            std::fill_n(column, channels, 0.0);
+                            continue;
+                        }
+                        std::copy_n(&myInput(image, 0U, i + ki - pad, j + kj - pad), channels,
+                                    column);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void Conv2dLayer::scatterColumnGradients(const std::size_t image, const std::size_t firstRow,
+                                         const std::size_t rowCount) noexcept
+{
+    const auto height{myInput.height()}, width{myInput.width()};
+    const auto channels{myInput.channelCount()};
+    const auto size{kernelSize()}, pad{kernelSize() / 2U};
+    const auto* column{myColumnGradients.data()};
+
+    // Walk the patch matrix in the order it was built, skip the positions in the pad.
+    if (Layout::Nchw == layout())
+    {
+        for (std::size_t c{}; c < channels; ++c)
+        {
+            for (std::size_t ki{}; ki < size; ++ki)
+            {
+                for (std::size_t kj{}; kj < size; ++kj)
+                {
+                    std::size_t first{}, last{};
+                    validColumns(width, pad, kj, first, last);
+
+                    for (auto i{firstRow}; i < firstRow + rowCount; ++i, column += width)
+                    {
+                        if ((i + ki < pad) || (i + ki - pad >= height)) { continue; }
+                        auto* gradients{&myInputGradients(image, c, i + ki - pad, 0U)};
+                        for (auto j{first}; j < last; ++j)
+                        {
+                            gradients[j + kj - pad] += column[j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        for (auto i{firstRow}; i < firstRow + rowCount; ++i)
+        {
+            for (std::size_t j{}; j < width; ++j)
+            {
+                for (std::size_t ki{}; ki < size; ++ki)
+                {
+                    for (std::size_t kj{}; kj < size; ++kj, column += channels)
+                    {
+                        if ((i + ki < pad) || (i + ki - pad >= height) || (j + kj < pad) ||
+                            (j + kj - pad >= width))
+                        {
+                            continue;
+                        }
+                        auto* gradients{&myInputGradients(image, 0U, i + ki - pad, j + kj - pad)};
+                        for (std::size_t c{}; c < channels; ++c) { gradients[c] += column[c]; }
+                    }
+                }
+            }
+        }
+    }
+}
+} // namespace ml
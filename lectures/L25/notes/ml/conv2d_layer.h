@@ -0,0 +1,220 @@
+/**
+ * @brief Multi-channel convolutional layer.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "ml/tensor.h"
+
+namespace ml
+{
+/**
+ * @brief Convolutional layer with multiple input channels and multiple filters.
+ * 
+ *        Each filter spans all input channels and produces one output channel (feature map).
+ *        The input is zero-padded implicitly, so each output channel has the same size as the
+ *        input channels, and the output is passed through the ReLU activation function.
+ * 
+ *        The computation is performed via im2col and matrix multiplication. The kernel is stored
+ *        as a tensor of filterCount images in the layout of the layer, so each filter is a
+ *        contiguous row whose values are ordered like the rows of the patch matrix. All buffers
+ *        are allocated on construction, so no memory is allocated during training.
+ */
+class Conv2dLayer final
+{
+public:
+    /**
+     * @brief Create a new convolutional layer.
+     * 
+     * @param[in] inputChannelCount The number of input channels. Must exceed 0.
+     * @param[in] filterCount The number of filters (output channels). Must exceed 0.
+     * @param[in] inputHeight The height of the input. Must exceed 0.
+     * @param[in] inputWidth The width of the input. Must exceed 0.
+     * @param[in] kernelSize The kernel size. Must exceed 0 and not exceed the input size.
+     * @param[in] batchCount The number of images per batch (default = 1).
+     * @param[in] layout The tensor layout of the layer (default = NCHW).
+     * @param[in] seed Seed used to generate the starting kernel values (default = 0).
+     */
+    explicit Conv2dLayer(std::size_t inputChannelCount, std::size_t filterCount,
+                         std::size_t inputHeight, std::size_t inputWidth, std::size_t kernelSize,
+                         std::size_t batchCount = 1U, Layout layout = Layout::Nchw,
+                         unsigned seed = 0U);
+
+    /**
+     * @brief Delete the convolutional layer.
+     */
+    ~Conv2dLayer() noexcept = default;
+
+    /**
+     * @brief Get the number of input channels.
+     * 
+     * @return The number of input channels.
+     */
+    std::size_t inputChannelCount() const noexcept;
+
+    /**
+     * @brief Get the number of filters (output channels).
+     * 
+     * @return The number of filters.
+     */
+    std::size_t filterCount() const noexcept;
+
+    /**
+     * @brief Get the kernel size.
+     * 
+     * @return The kernel size.
+     */
+    std::size_t kernelSize() const noexcept;
+
+    /**
+     * @brief Get the tensor layout of the layer.
+     * 
+     * @return The tensor layout of the layer.
+     */
+    Layout layout() const noexcept;
+
+    /**
+     * @brief Get the output of the latest feedforward.
+     * 
+     * @return Tensor holding batchCount x filterCount output feature maps.
+     */
+    const Tensor& output() const noexcept;
+
+    /**
+     * @brief Get the input gradients of the latest backpropagation.
+     * 
+     * @return Tensor holding the input gradients, same shape as the input.
+     */
+    const Tensor& inputGradients() const noexcept;
+
+    /**
+     * @brief Get the kernel.
+     * 
+     * @return Tensor holding filterCount x inputChannelCount x kernelSize x kernelSize weights.
+     */
+    const Tensor& kernel() const noexcept;
+
+    /**
+     * @brief Get the kernel gradients of the latest backpropagation.
+     * 
+     * @return Tensor holding the kernel gradients, same shape as the kernel.
+     */
+    const Tensor& kernelGradients() const noexcept;
+
+    /**
+     * @brief Get the bias values, one per filter.
+     * 
+     * @return Vector holding the bias values.
+     */
+    const std::vector<double>& bias() const noexcept;
+
+    /**
+     * @brief Get the bias gradients of the latest backpropagation, one per filter.
+     * 
+     * @return Vector holding the bias gradients.
+     */
+    const std::vector<double>& biasGradients() const noexcept;
+
+    /**
+     * @brief Replace the kernel and bias values.
+     * 
+     * @param[in] kernel The new kernel, any layout.
+     * @param[in] bias The new bias values, one per filter.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool setParameters(const Tensor& kernel, const std::vector<double>& bias) noexcept;
+
+    /**
+     * @brief Perform feedforward operation.
+     * 
+     * @param[in] input Tensor holding batchCount x inputChannelCount input images, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool feedforward(const Tensor& input) noexcept;
+
+    /**
+     * @brief Perform backpropagation.
+     * 
+     * @param[in] outputGradients Tensor holding gradients from the next layer, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool backpropagate(const Tensor& outputGradients) noexcept;
+
+    /**
+     * @brief Perform optimization.
+     * 
+     * @param[in] learningRate Learning rate to use. Must be in range (0.0, 1.0].
+     * 
+     * @return True on success, false on failure.
+     */
+    bool optimize(double learningRate) noexcept;
+
+    Conv2dLayer()                              = delete; // No default constructor.
+    Conv2dLayer(const Conv2dLayer&)            = delete; // No copy constructor.
+    Conv2dLayer(Conv2dLayer&&)                 = delete; // No move constructor.
+    Conv2dLayer& operator=(const Conv2dLayer&) = delete; // No copy assignment.
+    Conv2dLayer& operator=(Conv2dLayer&&)      = delete; // No move assignment.
+
+private:
+    /**
+     * @brief Get the number of output rows lowered at a time.
+     * 
+     * @return The number of output rows per tile.
+     */
+    std::size_t tileRowCount() const noexcept;
+
+    /**
+     * @brief Lower part of an input image to the patch matrix (im2col).
+     * 
+     * @param[in] image The image index.
+     * @param[in] firstRow The first output row of the tile.
+     * @param[in] rowCount The number of output rows in the tile.
+     */
+    void lowerInput(std::size_t image, std::size_t firstRow, std::size_t rowCount) noexcept;
+
+    /**
+     * @brief Add the gradients of the patch matrix to the input gradients (col2im).
+     * 
+     * @param[in] image The image index.
+     * @param[in] firstRow The first output row of the tile.
+     * @param[in] rowCount The number of output rows in the tile.
+     */
+    void scatterColumnGradients(std::size_t image, std::size_t firstRow,
+                                std::size_t rowCount) noexcept;
+
+    /** Copy of the input of the latest feedforward. */
+    Tensor myInput;
+
+    /** Input gradients. */
+    Tensor myInputGradients;
+
+    /** Kernel: filterCount x inputChannelCount x kernelSize x kernelSize. */
+    Tensor myKernel;
+
+    /** Kernel gradients. */
+    Tensor myKernelGradients;
+
+    /** Output feature maps. */
+    Tensor myOutput;
+
+    /** Output deltas (output gradients masked by the ReLU derivative). */
+    Tensor myDelta;
+
+    /** Bias values, one per filter. */
+    std::vector<double> myBias;
+
+    /** Bias gradients, one per filter. */
+    std::vector<double> myBiasGradients;
+
+    /** Patch matrix of a tile of the input. */
+    std::vector<double> myColumns;
+
+    /** Gradients of the patch matrix. */
+    std::vector<double> myColumnGradients;
+};
+} // namespace ml
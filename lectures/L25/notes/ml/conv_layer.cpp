@@ -0,0 +1,772 @@
+/**
+ * @brief Single-channel convolutional layer implementation details.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <map>
+#include <stdexcept>
+
+#include "ml/conv_layer.h"
+#include "ml/gemm.h"
+
+namespace ml
+{
+namespace
+{
+/** Estimated cost ratio (direct / FFT) above which the FFT is selected without timing. */
+constexpr double FftCostMargin{3.0};
+
+// -----------------------------------------------------------------------------
+double randomStartVal() noexcept { return static_cast<double>(std::rand()) / RAND_MAX; }
+
+// -----------------------------------------------------------------------------
+constexpr double reluOutput(const double input) noexcept { return 0.0 < input ? input : 0.0; }
+} // namespace
+
+// -----------------------------------------------------------------------------
+ConvLayer::ConvLayer(const std::size_t inputSize, const std::size_t kernelSize,
+                     const ConvAlgorithm algorithm)
+    : input{1U, 1U, inputSize, inputSize}
+    , inputGradients{input}
+    , kernel{1U, 1U, kernelSize, kernelSize}
+    , kernelGradients{kernel}
+    , output{input}
+    , bias{randomStartVal()}
+    , biasGradient{}
+    , algorithm{resolveAlgorithm(algorithm, inputSize, kernelSize)}
+    , batchInputs{input}
+    , batchOutputs{input}
+    , batchInputGradients{input}
+    , inputColumns{}
+    , columnGradients{}
+    , transformedKernel{}
+    , transformedKernelValid{false}
+    , fftConvolution{}
+    , activeOutputs(inputSize * ((inputSize + 63U) / 64U))
+    , deltas{input}
+    , columnSums(kernelSize * kernelSize * inputSize)
+    , batchActiveOutputs{}
+    , batchDeltas{input}
+    , partialKernelGradients{}
+    , partialBiasGradients{}
+    , partialColumnSums{}
+    , directTileSize{tiled::selectTileSize(inputSize, kernelSize)}
+{
+    // Check the input arguments, throw if invalid.
+    if ((0U == inputSize) || (0U == kernelSize) || (inputSize < kernelSize))
+    {
+        throw std::invalid_argument(
+            "Cannot create convolutional layer: invalid input arguments!");
+    }
+
+    // The tensors are filled with zeros. The input is padded implicitly, by skipping the
+    // kernel positions outside of the input, so no padded copies are needed. Each tensor
+    // holds its values row by row in one block, so the kernel, the input and the output are
+    // handed to the GEMM and FFT routines without flattening them first.
+
+    // Allocate the buffers of the GEMM path: the patch matrix holds one column per output
+    // position of a tile and one row per kernel position.
+    if (ConvAlgorithm::Gemm == this->algorithm)
+    {
+        inputColumns.resize(kernelSize * kernelSize * inputSize * tileRowCount());
+        columnGradients.resize(inputColumns.size());
+    }
+
+    // Create the FFT convolution.
+    if (ConvAlgorithm::Fft == this->algorithm)
+    {
+        fftConvolution = std::make_unique<fft::Convolution>(inputSize, kernelSize);
+    }
+
+    // Allocate the transformed kernel of the Winograd path.
+    if (isWinograd(this->algorithm))
+    {
+        const auto tileSize{winograd::inputTileSize(variant())};
+        transformedKernel.resize(tileSize * tileSize);
+    }
+
+    // Fill the kernel with randomized values in the range [0.0, 1.0].
+    for (std::size_t k{}; k < kernel.size(); ++k) { kernel.data()[k] = randomStartVal(); }
+}
+
+// -----------------------------------------------------------------------------
+bool ConvLayer::feedforward(const Tensor& input) noexcept
+{
+    // Store the input for backpropagation, return false on dimension mismatch.
+    if (!this->input.copyFrom(input)) { return false; }
+
+    if (ConvAlgorithm::Direct != algorithm)
+    {
+        if (ConvAlgorithm::Gemm == algorithm) { feedforwardGemm(); }
+        else if (isWinograd(algorithm)) { feedforwardWinograd(); }
+        else { feedforwardFft(); }
+
+        // Store which output nodes are active for backpropagation.
+        storeActiveRows(output.data(), activeOutputs, 0U, inputSize());
+        return true;
+    }
+
+    // Run feedforward for all output rows.
+    feedforwardRows(this->input.data(), output.data(), activeOutputs, 0U, inputSize());
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ConvLayer::backpropagate(const Tensor& outputGradients) noexcept
+{
+    // Check the output gradients, return false on dimension mismatch.
+    if (!outputGradients.hasShape(output)) { return false; }
+
+    // Reinitialize the gradients with zeros (to remove old values).
+    // Else values from the previous backpropagation would still remain.
+    kernelGradients.fill();
+    biasGradient = 0.0;
+
+    // Compute the output deltas with the activation mask stored during feedforward (with a
+    // single channel, both layouts store the values in the same order).
+    computeDeltaRows(outputGradients.data(), activeOutputs, deltas.data(), 0U, inputSize(),
+                     biasGradient);
+
+    if (ConvAlgorithm::Gemm == algorithm)
+    {
+        inputGradients.fill();
+        backpropagateGemm();
+        return true;
+    }
+
+    // Correlate the input with the deltas (kernel gradients), then convolve the deltas with
+    // the flipped kernel (input gradients).
+    accumulateKernelGradientRows(input.data(), deltas.data(), 0U, inputSize(), columnSums,
+                                 kernelGradients.data());
+    gatherInputGradientRows(deltas.data(), inputGradients.data(), 0U, inputSize());
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ConvLayer::optimize(const double learningRate) noexcept
+{
+    // Check the learning rate, return false if out of range.
+    if ((0.0 >= learningRate) || (1.0 < learningRate)) { return false; }
+
+    // Adjust the bias with the computed bias gradient, multiplied by the learning rate.
+    // We subtract, since the gradients are computed in this manner, as opposed to what
+    // we've used in dense layer.
+    bias -= biasGradient * learningRate;
+
+    // Adjust the kernel weights with the corresponding gradients and the learning rate.
+    for (std::size_t k{}; k < kernel.size(); ++k)
+    {
+        kernel.data()[k] -= kernelGradients.data()[k] * learningRate;
+    }
+
+    // The transformed kernel (or kernel spectrum) is stale now, it's recomputed during the next
+    // feedforward.
+    kernelChanged();
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ConvLayer::feedforwardBatch(const Tensor& inputs, utils::ThreadPool& pool)
+{
+    // Check the input images, return false on dimension mismatch.
+    if (!isBatchValid(inputs)) { return false; }
+
+    // Allocate the outputs if the batch size changed.
+    resizeBatch(inputs.batchCount());
+
+    // Compute the output rows of each tile, store its input rows for backpropagation while
+    // they're in cache (with a single channel, both layouts store the values in the same order).
+    runBatch(pool, inputs.batchCount(), [this, &inputs](const std::size_t,
+                                                        const std::size_t image,
+                                                        const std::size_t firstRow,
+                                                        const std::size_t lastRow)
+    {
+        const auto* values{inputs.image(image)};
+        feedforwardRows(values, batchOutputs.image(image), batchActiveOutputs[image], firstRow,
+                        lastRow);
+        std::copy(values + firstRow * inputSize(), values + lastRow * inputSize(),
+                  batchInputs.image(image) + firstRow * inputSize());
+    });
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ConvLayer::backpropagateBatch(const Tensor& outputGradients, utils::ThreadPool& pool)
+{
+    // Check the output gradients, return false on dimension or batch size mismatch, or if no
+    // batch has been fed forward yet (then there are no stored inputs or active outputs).
+    if (!isBatchValid(outputGradients) || !outputGradients.hasShape(batchOutputs) ||
+        (batchActiveOutputs.size() != outputGradients.batchCount()))
+    {
+        return false;
+    }
+
+    // Reset the gradients and the scratch buffers of each worker.
+    partialKernelGradients.assign(pool.threadCount(), std::vector<double>(kernel.size()));
+    partialBiasGradients.assign(pool.threadCount(), 0.0);
+    partialColumnSums.assign(pool.threadCount(), std::vector<double>(columnSums.size()));
+
+    // Compute the output deltas and accumulate the kernel and bias gradients per worker. The
+    // input gradients require the deltas of the neighboring tiles, so they can only be
+    // gathered in the same pass if each tile holds a whole image.
+    const auto imageCount{outputGradients.batchCount()};
+    const auto wholeImages{inputSize() == batchRowsPerTile(imageCount, pool.threadCount())};
+
+    runBatch(pool, imageCount,
+             [this, &outputGradients, wholeImages](const std::size_t worker,
+                                                   const std::size_t image,
+                                                   const std::size_t firstRow,
+                                                   const std::size_t lastRow)
+    {
+        computeDeltaRows(outputGradients.image(image), batchActiveOutputs[image],
+                         batchDeltas.image(image), firstRow, lastRow,
+                         partialBiasGradients[worker]);
+        accumulateKernelGradientRows(batchInputs.image(image), batchDeltas.image(image),
+                                     firstRow, lastRow, partialColumnSums[worker],
+                                     partialKernelGradients[worker].data());
+        if (wholeImages)
+        {
+            gatherInputGradientRows(batchDeltas.image(image), batchInputGradients.image(image),
+                                    firstRow, lastRow);
+        }
+    });
+
+    // Else gather the input gradients in a second pass, once all deltas are computed.
+    if (!wholeImages)
+    {
+        runBatch(pool, imageCount,
+                 [this](const std::size_t, const std::size_t image, const std::size_t firstRow,
+                        const std::size_t lastRow)
+        {
+            gatherInputGradientRows(batchDeltas.image(image), batchInputGradients.image(image),
+                                    firstRow, lastRow);
+        });
+    }
+
+    // Reduce the gradients of the workers.
+    kernelGradients.fill();
+    biasGradient = 0.0;
+
+    for (std::size_t worker{}; worker < pool.threadCount(); ++worker)
+    {
+        for (std::size_t k{}; k < kernel.size(); ++k)
+        {
+            kernelGradients.data()[k] += partialKernelGradients[worker][k];
+        }
+        biasGradient += partialBiasGradients[worker];
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void ConvLayer::kernelChanged() noexcept { transformedKernelValid = false; }
+
+// -----------------------------------------------------------------------------
+std::size_t ConvLayer::inputSize() const noexcept { return output.width(); }
+
+// -----------------------------------------------------------------------------
+std::size_t ConvLayer::kernelSize() const noexcept { return kernel.width(); }
+
+// -----------------------------------------------------------------------------
+std::size_t ConvLayer::padOffset() const noexcept { return kernelSize() / 2U; }
+
+// -----------------------------------------------------------------------------
+std::pair<std::size_t, std::size_t> ConvLayer::kernelRange(
+    const std::size_t position) const noexcept
+{
+    const auto pad{padOffset()};
+    const auto first{pad > position ? pad - position : 0U};
+    return {first, std::min(kernelSize(), inputSize() + pad - position)};
+}
+
+// -----------------------------------------------------------------------------
+std::pair<std::size_t, std::size_t> ConvLayer::outputRange(
+    const std::size_t kernelIndex) const noexcept
+{
+    const auto pad{padOffset()};
+    const auto first{pad > kernelIndex ? pad - kernelIndex : 0U};
+    return {first, std::min(inputSize(), inputSize() + pad - kernelIndex)};
+}
+
+// -----------------------------------------------------------------------------
+std::pair<std::size_t, std::size_t> ConvLayer::inputRange(
+    const std::size_t kernelIndex) const noexcept
+{
+    const auto pad{padOffset()};
+    const auto first{kernelIndex > pad ? kernelIndex - pad : 0U};
+    return {first, std::min(inputSize(), inputSize() + kernelIndex - pad)};
+}
+
+// -----------------------------------------------------------------------------
+void ConvLayer::feedforwardRows(const double* image, double* result, Bitmask& active,
+                                const std::size_t firstRow,
+                                const std::size_t lastRow) const noexcept
+{
+    const auto size{inputSize()};
+
+    for (auto band{firstRow}; band < lastRow; band += directTileSize.rows)
+    {
+        const auto bandEnd{std::min(lastRow, band + directTileSize.rows)};
+        tiled::correlateRelu(image, size, size, kernel.data(), kernelSize(), bias, result,
+                             band, bandEnd, directTileSize);
+        storeActiveRows(result, active, band, bandEnd);
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t ConvLayer::maskWordsPerRow() const noexcept { return (inputSize() + 63U) / 64U; }
+
+// -----------------------------------------------------------------------------
+void ConvLayer::storeActiveRows(const double* result, Bitmask& active, const std::size_t firstRow,
+                                const std::size_t lastRow) const noexcept
+{
+    const auto wordCount{maskWordsPerRow()}, size{inputSize()};
+
+    for (auto i{firstRow}; i < lastRow; ++i)
+    {
+        auto* words{&active[i * wordCount]};
+        std::fill_n(words, wordCount, 0U);
+
+        const auto* row{result + i * size};
+
+        for (std::size_t j{}; j < size; ++j)
+        {
+            words[j / 64U] |= static_cast<std::uint64_t>(0.0 < row[j]) << (j % 64U);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void ConvLayer::computeDeltaRows(const double* outputGradients, const Bitmask& active,
+                                 double* deltaRows, const std::size_t firstRow,
+                                 const std::size_t lastRow, double& biasGradientSum) const noexcept
+{
+    const auto wordCount{maskWordsPerRow()}, size{inputSize()};
+
+    for (auto i{firstRow}; i < lastRow; ++i)
+    {
+        const auto* words{&active[i * wordCount]};
+        const auto* gradients{outputGradients + i * size};
+        auto* deltaRow{deltaRows + i * size};
+
+        // Handle 64 values per word, inactive and fully active words need no bit tests.
+        for (std::size_t word{}; word < wordCount; ++word)
+        {
+            const auto first{word * 64U}, last{std::min(first + 64U, inputSize())};
+            const auto bits{words[word]};
+            const auto count{last - first};
+            const auto allActive{64U == count ? ~std::uint64_t{}
+                                              : (std::uint64_t{1U} << count) - 1U};
+
+            if (0U == bits) { std::fill(deltaRow + first, deltaRow + last, 0.0); }
+            else if (allActive == bits)
+            {
+                std::copy(gradients + first, gradients + last, deltaRow + first);
+            }
+            else
+            {
+                for (auto j{first}; j < last; ++j)
+                {
+                    deltaRow[j] = 0U != ((bits >> (j - first)) & 1U) ? gradients[j] : 0.0;
+                }
+            }
+        }
+
+        // Accumulate the bias gradient by adding the output deltas.
+        for (std::size_t j{}; j < inputSize(); ++j) { biasGradientSum += deltaRow[j]; }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void ConvLayer::accumulateKernelGradientRows(const double* image, const double* deltaRows,
+                                             const std::size_t firstRow, const std::size_t lastRow,
+                                             std::vector<double>& sums,
+                                             double* gradients) const noexcept
+{
+    const auto pad{padOffset()}, size{inputSize()};
+    std::fill(sums.begin(), sums.end(), 0.0);
+
+    for (auto i{firstRow}; i < lastRow; ++i)
+    {
+        // Only the kernel rows overlapping the input contribute.
+        const auto [firstKernelRow, lastKernelRow]{kernelRange(i)};
+        const auto* deltaRow{deltaRows + i * size};
+
+        for (auto ki{firstKernelRow}; ki < lastKernelRow; ++ki)
+        {
+            const auto* inputRow{image + (i + ki - pad) * size};
+
+            for (std::size_t kj{}; kj < kernelSize(); ++kj)
+            {
+                const auto [first, last]{outputRange(kj)};
+                auto* columnSums{&sums[(ki * kernelSize() + kj) * size]};
+
+                for (auto j{first}; j < last; ++j)
+                {
+                    columnSums[j] += inputRow[j + kj - pad] * deltaRow[j];
+                }
+            }
+        }
+    }
+
+    // Add the column sums of each kernel position together.
+    for (std::size_t ki{}; ki < kernelSize(); ++ki)
+    {
+        for (std::size_t kj{}; kj < kernelSize(); ++kj)
+        {
+            const auto* columnSums{&sums[(ki * kernelSize() + kj) * size]};
+            auto& gradient{gradients[ki * kernelSize() + kj]};
+            for (std::size_t j{}; j < size; ++j) { gradient += columnSums[j]; }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void ConvLayer::gatherInputGradientRows(const double* deltaRows, double* gradients,
+                                        const std::size_t firstRow,
+                                        const std::size_t lastRow) const noexcept
+{
+    const auto pad{padOffset()}, size{inputSize()};
+
+    for (auto r{firstRow}; r < lastRow; ++r)
+    {
+        auto* gradientRow{gradients + r * size};
+        std::fill_n(gradientRow, size, 0.0);
+
+        for (std::size_t ki{}; ki < kernelSize(); ++ki)
+        {
+            // Skip the kernel rows for which the output row is outside of the output.
+            if ((r + pad < ki) || (r + pad - ki >= inputSize())) { continue; }
+            const auto* deltaRow{deltaRows + (r + pad - ki) * size};
+
+            for (std::size_t kj{}; kj < kernelSize(); ++kj)
+            {
+                const auto [first, last]{inputRange(kj)};
+                const auto weight{kernel(0U, 0U, ki, kj)};
+                for (auto c{first}; c < last; ++c)
+                {
+                    gradientRow[c] += weight * deltaRow[c + pad - kj];
+                }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool ConvLayer::isBatchValid(const Tensor& batch) const noexcept
+{
+    return (1U == batch.channelCount()) && (inputSize() == batch.height()) &&
+        (inputSize() == batch.width());
+}
+
+// -----------------------------------------------------------------------------
+void ConvLayer::resizeBatch(const std::size_t imageCount)
+{
+    if (batchActiveOutputs.size() == imageCount) { return; }
+    const Tensor zeros{imageCount, 1U, inputSize(), inputSize()};
+    batchInputs         = zeros;
+    batchOutputs        = zeros;
+    batchInputGradients = zeros;
+    batchDeltas         = zeros;
+    batchActiveOutputs.assign(imageCount, Bitmask(inputSize() * maskWordsPerRow()));
+}
+
+// -----------------------------------------------------------------------------
+template <typename Task>
+void ConvLayer::runBatch(utils::ThreadPool& pool, const std::size_t imageCount, Task&& task) const
+{
+    const auto size{inputSize()}, workerCount{pool.threadCount()};
+    const auto rowsPerTile{batchRowsPerTile(imageCount, workerCount)};
+    const auto tilesPerImage{(size + rowsPerTile - 1U) / rowsPerTile};
+    const auto tileCount{imageCount * tilesPerImage};
+    const auto chunkCount{std::min(workerCount, tileCount)};
+    std::vector<std::future<void>> futures{};
+
+    for (std::size_t chunk{}; chunk < chunkCount; ++chunk)
+    {
+        // Assign the tiles [first, last) to the chunk, tile t covers rows of image t / tiles.
+        const auto first{chunk * tileCount / chunkCount};
+        const auto last{(chunk + 1U) * tileCount / chunkCount};
+
+        futures.push_back(pool.submit([&task, chunk, first, last, tilesPerImage,
+                                       rowsPerTile, size]()
+        {
+            for (auto tile{first}; tile < last; ++tile)
+            {
+                const auto firstRow{(tile % tilesPerImage) * rowsPerTile};
+                task(chunk, tile / tilesPerImage, firstRow,
+                     std::min(firstRow + rowsPerTile, size));
+            }
+        }));
+    }
+    // Wait for all tasks, rethrow exceptions raised by the tasks.
+    for (auto& future : futures) { future.get(); }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t ConvLayer::batchRowsPerTile(const std::size_t imageCount,
+                                        const std::size_t workerCount) const noexcept
+{
+    // Aim for about four tiles per worker, but never split the images more than needed.
+    const auto size{inputSize()};
+    return std::clamp<std::size_t>(
+        (imageCount * size + 4U * workerCount - 1U) / (4U * workerCount), 1U, size);
+}
+
+// -----------------------------------------------------------------------------
+std::size_t ConvLayer::tileRowCount() const noexcept
+{
+    constexpr std::size_t tileBytes{128U * 1024U};
+    const auto rowBytes{kernelSize() * kernelSize() * inputSize() * sizeof(double)};
+    return std::clamp<std::size_t>(tileBytes / rowBytes, 1U, inputSize());
+}
+
+// -----------------------------------------------------------------------------
+void ConvLayer::lowerInput(const std::size_t firstRow, const std::size_t rowCount) noexcept
+{
+    const auto size{inputSize()}, pad{padOffset()};
+    auto* column{inputColumns.data()};
+
+    for (std::size_t ki{}; ki < kernelSize(); ++ki)
+    {
+        for (std::size_t kj{}; kj < kernelSize(); ++kj)
+        {
+            const auto [first, last]{outputRange(kj)};
+
+            for (auto i{firstRow}; i < firstRow + rowCount; ++i, column += size)
+            {
+                if ((i + ki < pad) || (i + ki - pad >= size))
+                {
+                    std::fill_n(column, size, 0.0);
+                    continue;
+                }
+                const auto* inputRow{&input(0U, 0U, i + ki - pad, 0U)};
+                std::fill(column, column + first, 0.0);
+                std::copy(inputRow + first + kj - pad, inputRow + last + kj - pad,
+                          column + first);
+                std::fill(column + last, column + size, 0.0);
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void ConvLayer::feedforwardGemm() noexcept
+{
+    const auto size{inputSize()};
+    const auto kernelArea{kernelSize() * kernelSize()};
+    const auto tileRows{tileRowCount()};
+
+    // Lower each tile of the input, then compute output = kernel * columns.
+    for (std::size_t row{}; row < size; row += tileRows)
+    {
+        const auto rowCount{std::min(tileRows, size - row)};
+        const auto tileArea{rowCount * size};
+        lowerInput(row, rowCount);
+        gemm(Transpose::No, Transpose::No, 1U, tileArea, kernelArea, kernel.data(),
+             kernelArea, inputColumns.data(), tileArea, &output(0U, 0U, row, 0U), tileArea);
+    }
+
+    // Add the bias and pass each sum through the ReLU activation function.
+    for (std::size_t k{}; k < output.size(); ++k)
+    {
+        output.data()[k] = reluOutput(output.data()[k] + bias);
+    }
+}
+
+// -----------------------------------------------------------------------------
+winograd::Variant ConvLayer::variant() const noexcept
+{
+    return ConvAlgorithm::Winograd2x2 == algorithm ? winograd::Variant::F2x2
+                                                   : winograd::Variant::F4x4;
+}
+
+// -----------------------------------------------------------------------------
+void ConvLayer::feedforwardWinograd() noexcept
+{
+    using namespace winograd;
+    constexpr auto maxTileSize{inputTileSize(Variant::F4x4)};
+    const auto size{inputSize()}, pad{padOffset()};
+    const auto tileSize{inputTileSize(variant())};
+    const auto outputTile{outputTileSize(variant())};
+    double tile[maxTileSize * maxTileSize]{}, transformed[maxTileSize * maxTileSize]{};
+    double result[maxTileSize * maxTileSize]{};
+
+    // Transform the kernel unless it's unchanged since the previous call.
+    if (!transformedKernelValid)
+    {
+        transformKernel(variant(), kernel.data(), transformedKernel.data());
+        transformedKernelValid = true;
+    }
+
+    for (std::size_t i{}; i < size; i += outputTile)
+    {
+        for (std::size_t j{}; j < size; j += outputTile)
+        {
+            // Gather the input tile starting at input [i - pad][j - pad]; only the tiles
+            // at the edges cover the padding, where zeros are used.
+            const auto interior{(i >= pad) && (i + tileSize <= size + pad) && (j >= pad) &&
+                                (j + tileSize <= size + pad)};
+
+            for (std::size_t ti{}; ti < tileSize; ++ti)
+            {
+                if (interior)
+                {
+                    std::copy_n(&input(0U, 0U, i + ti - pad, j - pad), tileSize,
+                                &tile[ti * tileSize]);
+                    continue;
+                }
+                for (std::size_t tj{}; tj < tileSize; ++tj)
+                {
+                    const auto inside{(i + ti >= pad) && (i + ti < size + pad) &&
+                                      (j + tj >= pad) && (j + tj < size + pad)};
+                    tile[ti * tileSize + tj] =
+                        inside ? input(0U, 0U, i + ti - pad, j + tj - pad) : 0.0;
+                }
+            }
+
+            // Transform, multiply element-wise and transform back to an output tile.
+            transformInput(variant(), tile, transformed);
+            for (std::size_t k{}; k < tileSize * tileSize; ++k)
+            {
+                transformed[k] *= transformedKernel[k];
+            }
+            transformOutput(variant(), transformed, result);
+
+            // Add the bias and pass each sum through the ReLU activation function.
+            for (std::size_t ti{}; ti < outputTile && i + ti < size; ++ti)
+            {
+                for (std::size_t tj{}; tj < outputTile && j + tj < size; ++tj)
+                {
+                    output(0U, 0U, i + ti, j + tj) =
+                        reluOutput(result[ti * outputTile + tj] + bias);
+                }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void ConvLayer::feedforwardFft() noexcept
+{
+    // Compute the kernel spectrum unless the kernel is unchanged since the previous call.
+    if (!transformedKernelValid)
+    {
+        fftConvolution->setKernel(kernel.data());
+        transformedKernelValid = true;
+    }
+
+    // Correlate the input with the kernel.
+    fftConvolution->correlate(input.data(), output.data());
+
+    // Add the bias and pass each sum through the ReLU activation function.
+    for (std::size_t k{}; k < output.size(); ++k)
+    {
+        output.data()[k] = reluOutput(output.data()[k] + bias);
+    }
+}
+
+// -----------------------------------------------------------------------------
+void ConvLayer::backpropagateGemm() noexcept
+{
+    const auto size{inputSize()}, pad{padOffset()};
+    const auto kernelArea{kernelSize() * kernelSize()};
+    const auto tileRows{tileRowCount()};
+
+    for (std::size_t row{}; row < size; row += tileRows)
+    {
+        const auto rowCount{std::min(tileRows, size - row)};
+        const auto tileArea{rowCount * size};
+        const auto* delta{&deltas(0U, 0U, row, 0U)};
+
+        // Rebuild the patch matrix of the tile, accumulate the kernel gradients of all tiles.
+        lowerInput(row, rowCount);
+        gemm(Transpose::No, Transpose::Yes, 1U, kernelArea, tileArea, delta, tileArea,
+             inputColumns.data(), tileArea, kernelGradients.data(), kernelArea, 0U < row);
+        gemm(Transpose::Yes, Transpose::No, kernelArea, tileArea, 1U, kernel.data(),
+             kernelArea, delta, tileArea, columnGradients.data(), tileArea);
+
+        // Scatter the column gradients to the input gradients (col2im).
+        const auto* column{columnGradients.data()};
+
+        for (std::size_t ki{}; ki < kernelSize(); ++ki)
+        {
+            for (std::size_t kj{}; kj < kernelSize(); ++kj)
+            {
+                const auto [first, last]{outputRange(kj)};
+
+                for (auto i{row}; i < row + rowCount; ++i, column += size)
+                {
+                    if ((i + ki < pad) || (i + ki - pad >= size)) { continue; }
+                    auto* gradients{&inputGradients(0U, 0U, i + ki - pad, 0U)};
+                    for (auto j{first}; j < last; ++j) { gradients[j + kj - pad] += column[j]; }
+                }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+ConvAlgorithm selectAlgorithm(const std::size_t inputSize, const std::size_t kernelSize)
+{
+    // Selections measured so far, one per input and kernel size.
+    static std::map<std::pair<std::size_t, std::size_t>, ConvAlgorithm> selections{};
+    const auto key{std::make_pair(inputSize, kernelSize)};
+    const auto selection{selections.find(key)};
+    if (selections.end() != selection) { return selection->second; }
+
+    // Select the FFT algorithm if it's estimated to require well below the operations of the
+    // direct one; the direct loops are vectorized, so the measured break-even lies at a ratio
+    // between 2 and 3.
+    const auto directCost{2.0 * inputSize * inputSize * kernelSize * kernelSize};
+    const auto fftCost{fft::Convolution::cost(inputSize, kernelSize)};
+    if (FftCostMargin * fftCost < directCost)
+    {
+        selections[key] = ConvAlgorithm::Fft;
+        return ConvAlgorithm::Fft;
+    }
+
+    // Use inputs and gradients of ones, so that every output node is active.
+    Tensor input{1U, 1U, inputSize, inputSize}, outputGradients{input};
+    input.fill(1.0);
+    outputGradients.fill(1.0);
+
+    // Time feedforward and backpropagation after a warm-up run.
+    const auto measure{[&](const ConvAlgorithm algorithm) {
+        ConvLayer convLayer{inputSize, kernelSize, algorithm};
+        convLayer.feedforward(input);
+        convLayer.backpropagate(outputGradients);
+
+        const auto start{std::chrono::steady_clock::now()};
+        convLayer.feedforward(input);
+        convLayer.backpropagate(outputGradients);
+        return std::chrono::steady_clock::now() - start;
+    }};
+    std::vector<ConvAlgorithm> candidates{ConvAlgorithm::Direct, ConvAlgorithm::Gemm};
+    if (winograd::KernelSize == kernelSize)
+    {
+        candidates.push_back(ConvAlgorithm::Winograd2x2);
+        candidates.push_back(ConvAlgorithm::Winograd4x4);
+    }
+    // Time the FFT algorithm as well if it's estimated to be cheaper, but not by the margin.
+    if (fftCost < directCost) { candidates.push_back(ConvAlgorithm::Fft); }
+
+    // Select the candidate with the shortest time.
+    auto result{candidates.front()};
+    auto resultTime{measure(result)};
+
+    for (std::size_t i{1U}; i < candidates.size(); ++i)
+    {
+        const auto time{measure(candidates[i])};
+        if (time < resultTime)
+        {
+            result     = candidates[i];
+            resultTime = time;
+        }
+    }
+    selections[key] = result;
+    return result;
+}
+} // namespace ml
@@ -0,0 +1,505 @@
+/**
+ * @brief Single-channel convolutional layer with selectable convolution algorithms.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "ml/fft.h"
+#include "ml/tensor.h"
+#include "ml/tiled_conv.h"
+#include "ml/utils/thread_pool.h"
+#include "ml/winograd.h"
+
+namespace ml
+{
+/**
+ * @brief Enumeration of convolution algorithms.
+ */
+enum class ConvAlgorithm
+{
+    Auto,        ///< Select the fastest algorithm for the given input and kernel size.
+    Direct,      ///< Loop over the input directly, skipping the zero padding.
+    Gemm,        ///< Lower the input to a patch matrix (im2col) and use matrix multiplication.
+    Winograd2x2, ///< Winograd F(2x2, 3x3) minimal filtering (3x3 kernels only).
+    Winograd4x4, ///< Winograd F(4x4, 3x3) minimal filtering (3x3 kernels only).
+    Fft,         ///< Multiply spectra computed via the fast Fourier transform (overlap-add tiles).
+};
+
+/**
+ * @brief Select the fastest convolution algorithm for the given input and kernel size.
+ * 
+ *        The FFT algorithm is selected if a cost model estimates that it requires less than a
+ *        third of the floating-point operations of the direct algorithm, which is the case for
+ *        large kernels; timing the direct algorithm on such sizes would be expensive. Otherwise,
+ *        which algorithm wins depends on the sizes as well as on the compiler and the machine, so
+ *        the remaining algorithms are timed once per input and kernel size, and the result is
+ *        reused. The Winograd algorithms are only considered for 3x3 kernels, and the FFT
+ *        algorithm only if it's estimated to be cheaper than the direct one. Not thread-safe.
+ * 
+ * @param[in] inputSize The input size.
+ * @param[in] kernelSize The kernel size.
+ * 
+ * @return The selected algorithm.
+ */
+ConvAlgorithm selectAlgorithm(std::size_t inputSize, std::size_t kernelSize);
+
+/**
+ * @brief Check whether the given algorithm is a Winograd algorithm.
+ * 
+ * @param[in] algorithm The algorithm to check.
+ * 
+ * @return True if the algorithm is a Winograd algorithm, false otherwise.
+ */
+constexpr bool isWinograd(const ConvAlgorithm algorithm) noexcept
+{
+    return (ConvAlgorithm::Winograd2x2 == algorithm) || (ConvAlgorithm::Winograd4x4 == algorithm);
+}
+
+/**
+ * @brief Resolve the algorithm to use for the given input and kernel size.
+ * 
+ * @param[in] algorithm The requested algorithm.
+ * @param[in] inputSize The input size.
+ * @param[in] kernelSize The kernel size.
+ * 
+ * @return The requested algorithm, or the fastest supported algorithm if the requested algorithm
+ *         is Auto or a Winograd algorithm with a kernel size other than 3x3.
+ */
+inline ConvAlgorithm resolveAlgorithm(const ConvAlgorithm algorithm, const std::size_t inputSize,
+                                      const std::size_t kernelSize)
+{
+    const auto unsupported{isWinograd(algorithm) && (winograd::KernelSize != kernelSize)};
+    return (ConvAlgorithm::Auto == algorithm) || unsupported
+        ? selectAlgorithm(inputSize, kernelSize) : algorithm;
+}
+
+/**
+ * @brief Convolutional layer structure.
+ */
+struct ConvLayer final
+{
+    /** Bitmask holding one bit per value, stored row by row in whole 64-bit words. */
+    using Bitmask = std::vector<std::uint64_t>;
+
+    /**
+     * @brief Constructor.
+     * 
+     * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] kernelSize Kernel size. Must be greater than 0 and smaller than the input size.
+     * @param[in] algorithm The convolution algorithm to use (default = auto).
+     */
+    explicit ConvLayer(const std::size_t inputSize, const std::size_t kernelSize,
+                       const ConvAlgorithm algorithm = ConvAlgorithm::Auto);
+    
+    /**
+     * @brief Perform feedforward operation.
+     * 
+     * @param[in] input Tensor holding a single input image of one channel, any layout.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool feedforward(const Tensor& input) noexcept;
+
+    /**
+     * @brief Perform backpropagation.
+     * 
+     * @param[in] outputGradients Tensor holding gradients from the next layer, same shape as
+     *                            the output, any layout.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool backpropagate(const Tensor& outputGradients) noexcept;
+
+    /**
+     * @brief Perform optimization.
+     * 
+     * @param[in] learningRate Learning rate to use. Must be in range (0.0, 1.0].
+     * 
+     * @return True on success, false on failure.
+     */
+    bool optimize(const double learningRate) noexcept;
+
+    /**
+     * @brief Perform feedforward operation for a batch of images.
+     * 
+     *        Each image is split into tiles of output rows, which are processed in parallel by
+     *        the given thread pool. The kernel and the bias are shared read-only between the
+     *        threads and each tile writes its own output rows only, after copying its own input
+     *        rows for backpropagation. The direct algorithm is used
+     *        regardless of the selected algorithm, since the other algorithms use scratch buffers
+     *        shared between calls. The outputs are stored in batchOutputs.
+     * 
+     * @param[in] inputs Tensor holding the input images, one channel each, any layout.
+     * @param[in] pool The thread pool to use.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool feedforwardBatch(const Tensor& inputs, utils::ThreadPool& pool);
+
+    /**
+     * @brief Perform backpropagation for a batch of images.
+     * 
+     *        Must be preceded by feedforwardBatch with the same number of images. First, each tile
+     *        computes its output deltas and accumulates the kernel and bias gradients in the
+     *        buffers of its worker, which are then added together (reduced). Second, the input
+     *        gradients are gathered from the deltas of the surrounding rows, so that each tile
+     *        writes its own input gradient rows only. If each tile holds a whole image, both
+     *        steps are done in the same pass while the image is still in cache, else the second
+     *        step waits for the deltas of the neighboring tiles. The gradients are summed over
+     *        the batch and stored in kernelGradients and biasGradient, so that optimize can be
+     *        used as is. The input gradients are stored in batchInputGradients.
+     * 
+     * @param[in] outputGradients Tensor holding gradients from the next layer, one image per
+     *                            input image, any layout.
+     * @param[in] pool The thread pool to use.
+     * 
+     * @return True on success, false on failure (including if no batch of the same size has
+     *         been fed forward).
+     */
+    bool backpropagateBatch(const Tensor& outputGradients, utils::ThreadPool& pool);
+
+    /**
+     * @brief Indicate that the kernel has been changed.
+     * 
+     *        Must be called if the kernel is changed directly after the first feedforward,
+     *        since the Winograd and FFT paths reuse the transformed kernel between calls.
+     */
+    void kernelChanged() noexcept;
+
+    /** Input image (stored during feedforward, used during backpropagation). */
+    Tensor input;
+
+    /** Input gradients, same shape as the input. */
+    Tensor inputGradients;
+
+    /** Kernel (holding weights). Call kernelChanged() after changing it directly. */
+    Tensor kernel;
+
+    /** Kernel gradients, same shape as the kernel. */
+    Tensor kernelGradients;
+
+    /** Output image, same shape as the input. */
+    Tensor output;
+
+    /** Bias value. */
+    double bias;
+
+    /** Bias gradient. */
+    double biasGradient;
+
+    /** The convolution algorithm in use. */
+    const ConvAlgorithm algorithm;
+
+    /** Input images of the latest batch. */
+    Tensor batchInputs;
+
+    /** Output images of the latest batch. */
+    Tensor batchOutputs;
+
+    /** Input gradients of the latest batch. */
+    Tensor batchInputGradients;
+
+private:
+    /**
+     * @brief Get the input size (the height and width of the input and output images).
+     * 
+     * @return The input size.
+     */
+    std::size_t inputSize() const noexcept;
+
+    /**
+     * @brief Get the kernel size (the height and width of the kernel).
+     * 
+     * @return The kernel size.
+     */
+    std::size_t kernelSize() const noexcept;
+
+    /**
+     * @brief Get the pad offset (the number of implicit zeros on each edge of the input).
+     * 
+     * @return The pad offset.
+     */
+    std::size_t padOffset() const noexcept;
+
+    /**
+     * @brief Get the kernel rows (or columns) overlapping the input at an output position.
+     * 
+     *        Kernel index k at output index i covers input index i + k - padOffset(); the kernel
+     *        indices outside of the returned range cover the zero padding and can be skipped.
+     * 
+     * @param[in] position The output row (or column).
+     * 
+     * @return The first and one past the last kernel index overlapping the input.
+     */
+    std::pair<std::size_t, std::size_t> kernelRange(const std::size_t position) const noexcept;
+
+    /**
+     * @brief Get the output rows (or columns) for which a kernel index overlaps the input.
+     * 
+     * @param[in] kernelIndex The kernel row (or column).
+     * 
+     * @return The first and one past the last output index for which the kernel index overlaps
+     *         the input.
+     */
+    std::pair<std::size_t, std::size_t> outputRange(const std::size_t kernelIndex) const noexcept;
+
+    /**
+     * @brief Get the input rows (or columns) for which a kernel index receives output deltas.
+     * 
+     *        Input index i receives the delta of output index i + padOffset() - k via kernel
+     *        index k; this is the inverse of outputRange.
+     * 
+     * @param[in] kernelIndex The kernel row (or column).
+     * 
+     * @return The first and one past the last input index receiving deltas via the kernel index.
+     */
+    std::pair<std::size_t, std::size_t> inputRange(const std::size_t kernelIndex) const noexcept;
+
+    /**
+     * @brief Compute output rows via the direct algorithm.
+     * 
+     *        The rows are computed in bands of cache-sized tiles, and the activation mask of each
+     *        band is stored while its output is still in the L2 cache.
+     * 
+     * @param[in] image The input image, stored row by row.
+     * @param[out] result The output image, of which rows [firstRow, lastRow) are written.
+     * @param[out] active The activation mask of the output image, updated for the same rows.
+     * @param[in] firstRow The first output row to compute.
+     * @param[in] lastRow One past the last output row to compute.
+     */
+    void feedforwardRows(const double* image, double* result, Bitmask& active,
+                         const std::size_t firstRow, const std::size_t lastRow) const noexcept;
+
+    /**
+     * @brief Get the number of bitmask words per row.
+     * 
+     * @return The number of 64-bit words per row of an activation mask.
+     */
+    std::size_t maskWordsPerRow() const noexcept;
+
+    /**
+     * @brief Store which output nodes are active (have a ReLU derivative of 1).
+     * 
+     *        Each row starts at a new word, so tiles of different rows never share a word.
+     * 
+     * @param[in] result The output image, stored row by row.
+     * @param[out] active The activation mask, of which rows [firstRow, lastRow) are written.
+     * @param[in] firstRow The first row to store.
+     * @param[in] lastRow One past the last row to store.
+     */
+    void storeActiveRows(const double* result, Bitmask& active, const std::size_t firstRow,
+                         const std::size_t lastRow) const noexcept;
+
+    /**
+     * @brief Compute output deltas from the output gradients and the activation mask.
+     * 
+     * @param[in] outputGradients The output gradients of the image.
+     * @param[in] active The activation mask stored during feedforward.
+     * @param[out] deltaRows The output deltas, of which rows [firstRow, lastRow) are written.
+     * @param[in] firstRow The first row to compute.
+     * @param[in] lastRow One past the last row to compute.
+     * @param[in,out] biasGradientSum The bias gradient to accumulate.
+     */
+    void computeDeltaRows(const double* outputGradients, const Bitmask& active,
+                          double* deltaRows, const std::size_t firstRow,
+                          const std::size_t lastRow, double& biasGradientSum) const noexcept;
+
+    /**
+     * @brief Accumulate the kernel gradients of output rows: the correlation of the input with
+     *        the output deltas.
+     * 
+     *        The products are summed per kernel position and output column over the rows, which
+     *        the compiler can vectorize, and the column sums are added together at the end. Each
+     *        row is thereby only read once while it's in cache.
+     * 
+     * @param[in] image The input image.
+     * @param[in] deltaRows The output deltas.
+     * @param[in] firstRow The first output row.
+     * @param[in] lastRow One past the last output row.
+     * @param[in] sums Scratch buffer holding one value per kernel position and output column.
+     * @param[in,out] gradients The kernel gradients to accumulate.
+     */
+    void accumulateKernelGradientRows(const double* image, const double* deltaRows,
+                                      const std::size_t firstRow, const std::size_t lastRow,
+                                      std::vector<double>& sums, double* gradients) const noexcept;
+
+    /**
+     * @brief Compute input gradient rows: the full convolution of the output deltas with the
+     *        flipped kernel.
+     * 
+     *        Input gradient [r][c] is the sum of kernel[ki][kj] * delta[r + pad - ki][c + pad - kj]
+     *        over the kernel positions for which the delta exists, so each row is gathered from
+     *        the deltas without writing to other rows.
+     * 
+     * @param[in] deltaRows The output deltas.
+     * @param[out] gradients The input gradients, of which rows [firstRow, lastRow) are written.
+     * @param[in] firstRow The first input row.
+     * @param[in] lastRow One past the last input row.
+     */
+    void gatherInputGradientRows(const double* deltaRows, double* gradients,
+                                 const std::size_t firstRow,
+                                 const std::size_t lastRow) const noexcept;
+
+    /**
+     * @brief Check whether the given batch matches the layer.
+     * 
+     * @param[in] batch The batch to check.
+     * 
+     * @return True if the images of the batch have one channel each and the size of the output,
+     *         false otherwise.
+     */
+    bool isBatchValid(const Tensor& batch) const noexcept;
+
+    /**
+     * @brief Allocate the batch buffers for the given number of images.
+     * 
+     *        No memory is allocated if the number of images is unchanged.
+     * 
+     * @param[in] imageCount The number of images per batch.
+     */
+    void resizeBatch(const std::size_t imageCount);
+
+    /**
+     * @brief Run a task for each tile of output rows of each image of a batch.
+     * 
+     *        The tiles are assigned to at most one chunk per worker thread, each of which is
+     *        submitted as a single task. The tiles are sized so that there are about four
+     *        tiles per worker, which evens out the load. Returns once all tasks are done.
+     * 
+     * @tparam Task Task type, invoked as task(chunk, image, firstRow, lastRow), where chunk is
+     *              less than the number of worker threads.
+     * 
+     * @param[in] pool The thread pool to use.
+     * @param[in] imageCount The number of images in the batch.
+     * @param[in] task The task to run.
+     */
+    template <typename Task>
+    void runBatch(utils::ThreadPool& pool, const std::size_t imageCount, Task&& task) const;
+
+    /**
+     * @brief Get the number of output rows per tile of a batch.
+     * 
+     *        Whole images are used as soon as there are about four images per worker, so that
+     *        each image is only split when needed to keep all workers busy.
+     * 
+     * @param[in] imageCount The number of images in the batch.
+     * @param[in] workerCount The number of worker threads.
+     * 
+     * @return The number of output rows per tile.
+     */
+    std::size_t batchRowsPerTile(const std::size_t imageCount,
+                                 const std::size_t workerCount) const noexcept;
+
+    /**
+     * @brief Get the number of output rows lowered at a time.
+     * 
+     *        The patch matrix of a tile is kept at about 128 kB, so that it stays in L2 cache
+     *        between being built and being multiplied.
+     * 
+     * @return The number of output rows per tile.
+     */
+    std::size_t tileRowCount() const noexcept;
+
+    /**
+     * @brief Lower part of the input to a patch matrix (im2col).
+     * 
+     *        Row ki * kernelSize + kj holds the input value at kernel position [ki][kj] for each
+     *        output position of the tile, so each row consists of contiguous copies of part of
+     *        the input rows. The values covering the padding are written as zeros.
+     * 
+     * @param[in] firstRow The first output row of the tile.
+     * @param[in] rowCount The number of output rows in the tile.
+     */
+    void lowerInput(const std::size_t firstRow, const std::size_t rowCount) noexcept;
+
+    /**
+     * @brief Perform feedforward via im2col and matrix multiplication, one tile at a time.
+     * 
+     *        With a single channel and filter the multiplication is a matrix-vector product, so
+     *        this is slower than the direct algorithm (about 0.3x) and kept for illustration only.
+     */
+    void feedforwardGemm() noexcept;
+
+    /**
+     * @brief Get the Winograd variant of the layer.
+     * 
+     * @return The Winograd variant (Winograd algorithms only).
+     */
+    winograd::Variant variant() const noexcept;
+
+    /**
+     * @brief Perform feedforward via Winograd minimal filtering, one output tile at a time.
+     * 
+     *        Each input tile (overlapping its neighbors by two rows and columns) is transformed,
+     *        multiplied element-wise with the transformed kernel and transformed back to an
+     *        output tile. The transformed kernel is computed on first use only. With a single
+     *        channel and filter the transforms cost more than the saved multiplications, so this
+     *        is slower than the direct algorithm (about 0.2x-0.4x) and kept for illustration only.
+     */
+    void feedforwardWinograd() noexcept;
+
+    /**
+     * @brief Perform feedforward via the FFT.
+     * 
+     *        The kernel spectrum is computed on first use only.
+     */
+    void feedforwardFft() noexcept;
+
+    /**
+     * @brief Perform backpropagation via the transposed matrix multiplications.
+     * 
+     *        With delta as a 1 x (tile size) row, the kernel gradients are delta * columns^T
+     *        and the gradients of the patch matrix are kernel^T * delta, which are then scattered
+     *        back to the input positions (col2im), skipping the positions of the padding.
+     *        The output deltas must have been computed beforehand.
+     */
+    void backpropagateGemm() noexcept;
+
+    /** Patch matrix of the input (GEMM only). */
+    std::vector<double> inputColumns;
+
+    /** Gradients of the patch matrix (GEMM only). */
+    std::vector<double> columnGradients;
+
+    /** Transformed kernel (Winograd only). */
+    std::vector<double> transformedKernel;
+
+    /** Indicate whether the transformed kernel or the kernel spectrum matches the kernel. */
+    bool transformedKernelValid;
+
+    /** Convolution via the FFT, holding the kernel spectrum (FFT only). */
+    std::unique_ptr<fft::Convolution> fftConvolution;
+
+    /** Activation mask of the output, one bit per output node (set if active). */
+    Bitmask activeOutputs;
+
+    /** Output deltas during backpropagation. */
+    Tensor deltas;
+
+    /** Scratch buffer holding one sum per kernel position and output column. */
+    std::vector<double> columnSums;
+
+    /** Activation masks of the latest batch. */
+    std::vector<Bitmask> batchActiveOutputs;
+
+    /** Output deltas of the latest batch. */
+    Tensor batchDeltas;
+
+    /** Kernel gradients accumulated by each worker during batch backpropagation. */
+    std::vector<std::vector<double>> partialKernelGradients;
+
+    /** Bias gradients accumulated by each worker during batch backpropagation. */
+    std::vector<double> partialBiasGradients;
+
+    /** Column sums of each worker during batch backpropagation. */
+    std::vector<std::vector<double>> partialColumnSums;
+
+    /** Tile size of the direct algorithm, selected from the cache sizes. */
+    tiled::TileSize directTileSize;
+};
+} // namespace ml
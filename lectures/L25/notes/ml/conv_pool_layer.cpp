@@ -0,0 +1,315 @@
+/**
+ * @brief Fused convolutional, ReLU and max pooling layer implementation details.
+ */
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "ml/conv_pool_layer.h"
+
+namespace ml
+{
+namespace
+{
+/** The largest pool size whose window positions fit in one byte. */
+constexpr std::size_t MaxPoolSize{16U};
+
+// -----------------------------------------------------------------------------
+constexpr double reluOutput(const double input) noexcept { return 0.0 < input ? input : 0.0; }
+
+// -----------------------------------------------------------------------------
+std::size_t pooledSize(const std::size_t size, const std::size_t poolSize)
+{
+    // Check the pool size, throw if invalid (the other dimensions are checked by the tensors).
+    if ((0U == poolSize) || (MaxPoolSize < poolSize) || (0U != (size % poolSize)))
+    {
+        throw std::invalid_argument("Cannot create conv pool layer: invalid pool size!");
+    }
+    return size / poolSize;
+}
+
+// -----------------------------------------------------------------------------
+void validColumns(const std::size_t width, const std::size_t pad, const std::size_t kj,
+                  std::size_t& first, std::size_t& last) noexcept
+{
+    // Get the output columns [first, last) for which kernel column kj hits the input.
+    first = std::min(width, pad > kj ? pad - kj : 0U);
+    last  = std::max(first, std::min(width, width + pad - kj));
+}
+
+// -----------------------------------------------------------------------------
+void validKernelRange(const std::size_t size, const std::size_t kernelSize, const std::size_t pad,
+                      const std::size_t position, std::size_t& first, std::size_t& last) noexcept
+{
+    // Get the kernel offsets [first, last) for which output position hits the input.
+    first = std::min(kernelSize, pad > position ? pad - position : 0U);
+    last  = std::max(first, std::min(kernelSize, size + pad - position));
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+ConvPoolLayer::ConvPoolLayer(const std::size_t inputChannelCount, const std::size_t filterCount,
+                             const std::size_t inputHeight, const std::size_t inputWidth,
+                             const std::size_t kernelSize, const std::size_t poolSize,
+                             const std::size_t batchCount, const unsigned seed)
+    : myInput{batchCount, inputChannelCount, inputHeight, inputWidth}
+    , myInputGradients{batchCount, inputChannelCount, inputHeight, inputWidth}
+    , myKernel{filterCount, inputChannelCount, kernelSize, kernelSize}
+    , myKernelGradients{filterCount, inputChannelCount, kernelSize, kernelSize}
+    , myOutput{batchCount, filterCount, pooledSize(inputHeight, poolSize),
+               pooledSize(inputWidth, poolSize)}
+    , myOutputGradients{myOutput}
+    , myMaxIndices(myOutput.size())
+    , myBias(filterCount)
+    , myBiasGradients(filterCount)
+    , myStripe(poolSize * inputWidth)
+    , myPoolSize{poolSize}
+{
+    // Check the kernel size, throw if invalid.
+    if ((kernelSize > inputHeight) || (kernelSize > inputWidth))
+    {
+        throw std::invalid_argument("Cannot create conv pool layer: invalid kernel size!");
+    }
+
+    // Initialize the kernel with values scaled to the number of inputs per filter.
+    const auto limit{std::sqrt(6.0 / myKernel.imageSize())};
+    std::mt19937 generator{seed};
+    std::uniform_real_distribution<double> distribution{-limit, limit};
+    for (std::size_t k{}; k < myKernel.size(); ++k)
+    {
+        myKernel.data()[k] = distribution(generator);
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t ConvPoolLayer::inputChannelCount() const noexcept { return myInput.channelCount(); }
+
+// -----------------------------------------------------------------------------
+std::size_t ConvPoolLayer::filterCount() const noexcept { return myOutput.channelCount(); }
+
+// -----------------------------------------------------------------------------
+std::size_t ConvPoolLayer::kernelSize() const noexcept { return myKernel.height(); }
+
+// -----------------------------------------------------------------------------
+std::size_t ConvPoolLayer::poolSize() const noexcept { return myPoolSize; }
+
+// -----------------------------------------------------------------------------
+const Tensor& ConvPoolLayer::output() const noexcept { return myOutput; }
+
+// -----------------------------------------------------------------------------
+const std::vector<std::uint8_t>& ConvPoolLayer::maxIndices() const noexcept
+{
+    return myMaxIndices;
+}
+
+// -----------------------------------------------------------------------------
+const Tensor& ConvPoolLayer::inputGradients() const noexcept { return myInputGradients; }
+
+// -----------------------------------------------------------------------------
+const Tensor& ConvPoolLayer::kernel() const noexcept { return myKernel; }
+
+// -----------------------------------------------------------------------------
+const Tensor& ConvPoolLayer::kernelGradients() const noexcept { return myKernelGradients; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& ConvPoolLayer::bias() const noexcept { return myBias; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& ConvPoolLayer::biasGradients() const noexcept
+{
+    return myBiasGradients;
+}
+
+// -----------------------------------------------------------------------------
+bool ConvPoolLayer::setParameters(const Tensor& kernel, const std::vector<double>& bias) noexcept
+{
+    // Check the dimensions, return false on mismatch.
+    if (!kernel.hasShape(myKernel) || (bias.size() != myBias.size())) { return false; }
+
+    myKernel.copyFrom(kernel);
+    myBias = bias;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ConvPoolLayer::feedforward(const Tensor& input) noexcept
+{
+    // Store the input (rearranged to the layout of the layer), return false on mismatch.
+    if (!myInput.copyFrom(input)) { return false; }
+
+    const auto pooledHeight{myOutput.height()}, pooledWidth{myOutput.width()};
+    const auto pool{myPoolSize};
+
+    for (std::size_t n{}; n < myOutput.batchCount(); ++n)
+    {
+        for (std::size_t f{}; f < filterCount(); ++f)
+        {
+            for (std::size_t i{}; i < pooledHeight; ++i)
+            {
+                auto* output{&myOutput(n, f, i, 0U)};
+                auto* maxIndices{&myMaxIndices[myOutput.index(n, f, i, 0U)]};
+                convolveStripe(n, f, i * pool);
+
+                // Reduce each window of the stripe to its first max value and its position.
+                for (std::size_t j{}; j < pooledWidth; ++j)
+                {
+                    const auto* window{&myStripe[j * pool]};
+                    auto maxValue{window[0U]};
+                    std::size_t maxIndex{};
+
+                    for (std::size_t pi{}; pi < pool; ++pi)
+                    {
+                        const auto* row{window + pi * myInput.width()};
+
+                        for (std::size_t pj{}; pj < pool; ++pj)
+                        {
+                            if (row[pj] > maxValue)
+                            {
+                                maxValue = row[pj];
+                                maxIndex = pi * pool + pj;
+                            }
+                        }
+                    }
+                    output[j]     = maxValue;
+                    maxIndices[j] = static_cast<std::uint8_t>(maxIndex);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ConvPoolLayer::backpropagate(const Tensor& outputGradients) noexcept
+{
+    // Copy the output gradients (rearranged to the layout of the layer), false on mismatch.
+    if (!myOutputGradients.copyFrom(outputGradients)) { return false; }
+
+    const auto height{myInput.height()}, width{myInput.width()}, area{height * width};
+    const auto channels{inputChannelCount()};
+    const auto size{kernelSize()}, pad{kernelSize() / 2U};
+    const auto pool{myPoolSize};
+
+    // Reset the gradients, since the contributions of all windows and images are accumulated.
+    myInputGradients.fill();
+    myKernelGradients.fill();
+    std::fill(myBiasGradients.begin(), myBiasGradients.end(), 0.0);
+
+    // Only the max value of each window has a gradient, which is zero unless the value passed
+    // the ReLU activation function. Visit the kernel positions covering that value.
+    for (std::size_t n{}; n < myOutput.batchCount(); ++n)
+    {
+        for (std::size_t f{}; f < filterCount(); ++f)
+        {
+            for (std::size_t i{}; i < myOutput.height(); ++i)
+            {
+                const auto offset{myOutput.index(n, f, i, 0U)};
+
+                for (std::size_t j{}; j < myOutput.width(); ++j)
+                {
+                    const auto delta{0.0 < myOutput.data()[offset + j]
+                                         ? myOutputGradients.data()[offset + j]
+                                         : 0.0};
+                    if (0.0 == delta) { continue; }
+
+                    const auto row{i * pool + myMaxIndices[offset + j] / pool};
+                    const auto col{j * pool + myMaxIndices[offset + j] % pool};
+                    std::size_t firstRow{}, lastRow{}, firstCol{}, lastCol{};
+                    validKernelRange(height, size, pad, row, firstRow, lastRow);
+                    validKernelRange(width, size, pad, col, firstCol, lastCol);
+                    myBiasGradients[f] += delta;
+
+                    // Step through the kernel and input with the strides of the NCHW layout.
+                    const auto inputOffset{
+                        myInput.index(n, 0U, row + firstRow - pad, col + firstCol - pad)};
+                    const auto kernelOffset{myKernel.index(f, 0U, firstRow, firstCol)};
+
+                    // The channels are innermost, since the kernel rows are too short for a loop.
+                    for (std::size_t ki{}; ki < lastRow - firstRow; ++ki)
+                    {
+                        for (std::size_t kj{}; kj < lastCol - firstCol; ++kj)
+                        {
+                            const auto* input{myInput.data() + inputOffset + ki * width + kj};
+                            auto* inputGradients{myInputGradients.data() + inputOffset
+                                                 + ki * width + kj};
+                            const auto* kernel{myKernel.data() + kernelOffset + ki * size + kj};
+                            auto* kernelGradients{myKernelGradients.data() + kernelOffset
+                                                  + ki * size + kj};
+
+                            for (std::size_t c{}; c < channels; ++c)
+                            {
+                                kernelGradients[c * size * size] += input[c * area] * delta;
+                                inputGradients[c * area] += kernel[c * size * size] * delta;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ConvPoolLayer::optimize(const double learningRate) noexcept
+{
+    // Check the learning rate, return false if out of range.
+    if ((0.0 >= learningRate) || (1.0 < learningRate)) { return false; }
+
+    // Adjust the parameters in the opposite direction of the gradients.
+    for (std::size_t f{}; f < myBias.size(); ++f)
+    {
+        myBias[f] -= myBiasGradients[f] * learningRate;
+    }
+
+    auto* kernel{myKernel.data()};
+    const auto* kernelGradients{myKernelGradients.data()};
+
+    for (std::size_t k{}; k < myKernel.size(); ++k)
+    {
+        kernel[k] -= kernelGradients[k] * learningRate;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void ConvPoolLayer::convolveStripe(const std::size_t image, const std::size_t filter,
+                                   const std::size_t firstRow) noexcept
+{
+    const auto height{myInput.height()}, width{myInput.width()};
+    const auto size{kernelSize()}, pad{kernelSize() / 2U};
+    std::fill(myStripe.begin(), myStripe.end(), myBias[filter]);
+
+    // Add each kernel row that hits the input, one whole stripe row per weight. The valid
+    // columns only depend on the kernel column, so they are shared by all channels.
+    for (std::size_t i{}; i < myPoolSize; ++i)
+    {
+        auto* output{&myStripe[i * width]};
+        const auto row{firstRow + i};
+
+        for (std::size_t ki{}; ki < size; ++ki)
+        {
+            if ((row + ki < pad) || (row + ki - pad >= height)) { continue; }
+
+            for (std::size_t kj{}; kj < size; ++kj)
+            {
+                std::size_t first{}, last{};
+                validColumns(width, pad, kj, first, last);
+
+                for (std::size_t c{}; c < inputChannelCount(); ++c)
+                {
+                    const auto weight{myKernel(filter, c, ki, kj)};
+                    const auto* input{&myInput(image, c, row + ki - pad, 0U)};
+
+                    for (auto j{first}; j < last; ++j)
+                    {
+                        output[j] += weight * input[j + kj - pad];
+                    }
+                }
+            }
+        }
+    }
+    for (auto& value : myStripe) { value = reluOutput(value); }
+}
+} // namespace ml
@@ -0,0 +1,223 @@
+/**
+ * @brief Fused convolutional, ReLU and max pooling layer.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ml/tensor.h"
+
+namespace ml
+{
+/**
+ * @brief Convolutional layer with ReLU activation followed by max pooling, fused into one pass.
+ * 
+ *        The convolution is the same as in Conv2dLayer (multiple input channels and filters,
+ *        implicit zero padding, same size output), but the full-size output is never stored.
+ *        Instead, the convolution is computed one stripe of poolSize rows at a time into a small
+ *        buffer that stays in the L1 cache. Each pooling window of the stripe is then reduced to
+ *        its max value, and only the pooled output and the position of the max value within
+ *        each window (one byte per window) are written to memory.
+ * 
+ *        Only the max value of each window receives a gradient, so the backpropagation only
+ *        visits the recorded positions instead of the full convolution output.
+ * 
+ *        The layer stores its tensors in the NCHW layout; input and gradients in the NHWC
+ *        layout are converted automatically.
+ */
+class ConvPoolLayer final
+{
+public:
+    /**
+     * @brief Create a new fused convolutional and max pooling layer.
+     * 
+     * @param[in] inputChannelCount The number of input channels. Must exceed 0.
+     * @param[in] filterCount The number of filters (output channels). Must exceed 0.
+     * @param[in] inputHeight The height of the input. Must be divisible by the pool size.
+     * @param[in] inputWidth The width of the input. Must be divisible by the pool size.
+     * @param[in] kernelSize The kernel size. Must exceed 0 and not exceed the input size.
+     * @param[in] poolSize The pool size. Must be in range [1, 16].
+     * @param[in] batchCount The number of images per batch (default = 1).
+     * @param[in] seed Seed used to generate the starting kernel values (default = 0).
+     */
+    explicit ConvPoolLayer(std::size_t inputChannelCount, std::size_t filterCount,
+                           std::size_t inputHeight, std::size_t inputWidth,
+                           std::size_t kernelSize, std::size_t poolSize,
+                           std::size_t batchCount = 1U, unsigned seed = 0U);
+
+    /**
+     * @brief Delete the fused layer.
+     */
+    ~ConvPoolLayer() noexcept = default;
+
+    /**
+     * @brief Get the number of input channels.
+     * 
+     * @return The number of input channels.
+     */
+    std::size_t inputChannelCount() const noexcept;
+
+    /**
+     * @brief Get the number of filters (output channels).
+     * 
+     * @return The number of filters.
+     */
+    std::size_t filterCount() const noexcept;
+
+    /**
+     * @brief Get the kernel size.
+     * 
+     * @return The kernel size.
+     */
+    std::size_t kernelSize() const noexcept;
+
+    /**
+     * @brief Get the pool size.
+     * 
+     * @return The pool size.
+     */
+    std::size_t poolSize() const noexcept;
+
+    /**
+     * @brief Get the pooled output of the latest feedforward.
+     * 
+     * @return Tensor holding batchCount x filterCount pooled feature maps.
+     */
+    const Tensor& output() const noexcept;
+
+    /**
+     * @brief Get the position of the max value within each pooling window.
+     * 
+     *        The position of the window at pooled row i and column j is stored at the same
+     *        offset as output value (n, f, i, j), as poolRow * poolSize + poolCol.
+     * 
+     * @return Vector holding one position per pooled output value.
+     */
+    const std::vector<std::uint8_t>& maxIndices() const noexcept;
+
+    /**
+     * @brief Get the input gradients of the latest backpropagation.
+     * 
+     * @return Tensor holding the input gradients, same shape as the input.
+     */
+    const Tensor& inputGradients() const noexcept;
+
+    /**
+     * @brief Get the kernel.
+     * 
+     * @return Tensor holding filterCount x inputChannelCount x kernelSize x kernelSize weights.
+     */
+    const Tensor& kernel() const noexcept;
+
+    /**
+     * @brief Get the kernel gradients of the latest backpropagation.
+     * 
+     * @return Tensor holding the kernel gradients, same shape as the kernel.
+     */
+    const Tensor& kernelGradients() const noexcept;
+
+    /**
+     * @brief Get the bias values, one per filter.
+     * 
+     * @return Vector holding the bias values.
+     */
+    const std::vector<double>& bias() const noexcept;
+
+    /**
+     * @brief Get the bias gradients of the latest backpropagation, one per filter.
+     * 
+     * @return Vector holding the bias gradients.
+     */
+    const std::vector<double>& biasGradients() const noexcept;
+
+    /**
+     * @brief Replace the kernel and bias values.
+     * 
+     * @param[in] kernel The new kernel, any layout.
+     * @param[in] bias The new bias values, one per filter.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool setParameters(const Tensor& kernel, const std::vector<double>& bias) noexcept;
+
+    /**
+     * @brief Perform feedforward operation.
+     * 
+     * @param[in] input Tensor holding batchCount x inputChannelCount input images, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool feedforward(const Tensor& input) noexcept;
+
+    /**
+     * @brief Perform backpropagation.
+     * 
+     * @param[in] outputGradients Tensor holding the gradients of the pooled output, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool backpropagate(const Tensor& outputGradients) noexcept;
+
+    /**
+     * @brief Perform optimization.
+     * 
+     * @param[in] learningRate Learning rate to use. Must be in range (0.0, 1.0].
+     * 
+     * @return True on success, false on failure.
+     */
+    bool optimize(double learningRate) noexcept;
+
+    ConvPoolLayer()                                = delete; // No default constructor.
+    ConvPoolLayer(const ConvPoolLayer&)            = delete; // No copy constructor.
+    ConvPoolLayer(ConvPoolLayer&&)                 = delete; // No move constructor.
+    ConvPoolLayer& operator=(const ConvPoolLayer&) = delete; // No copy assignment.
+    ConvPoolLayer& operator=(ConvPoolLayer&&)      = delete; // No move assignment.
+
+private:
+    /**
+     * @brief Compute one stripe of poolSize convolution rows into the stripe buffer.
+     * 
+     *        The bias is added and the ReLU activation function is applied.
+     * 
+     * @param[in] image The image index.
+     * @param[in] filter The filter index.
+     * @param[in] firstRow The first convolution row of the stripe.
+     */
+    void convolveStripe(std::size_t image, std::size_t filter, std::size_t firstRow) noexcept;
+
+    /** Copy of the input of the latest feedforward. */
+    Tensor myInput;
+
+    /** Input gradients. */
+    Tensor myInputGradients;
+
+    /** Kernel: filterCount x inputChannelCount x kernelSize x kernelSize. */
+    Tensor myKernel;
+
+    /** Kernel gradients. */
+    Tensor myKernelGradients;
+
+    /** Pooled output feature maps. */
+    Tensor myOutput;
+
+    /** Output gradients (rearranged to the layout of the layer). */
+    Tensor myOutputGradients;
+
+    /** Position of the max value within each pooling window. */
+    std::vector<std::uint8_t> myMaxIndices;
+
+    /** Bias values, one per filter. */
+    std::vector<double> myBias;
+
+    /** Bias gradients, one per filter. */
+    std::vector<double> myBiasGradients;
+
+    /** Convolution output of one stripe, poolSize x inputWidth values. */
+    std::vector<double> myStripe;
+
+    /** The pool size. */
+    std::size_t myPoolSize;
+};
+} // namespace ml
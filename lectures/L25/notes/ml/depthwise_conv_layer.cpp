@@ -0,0 +1,324 @@
+/**
+ * @brief Depthwise convolutional layer implementation details.
+ */
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "ml/depthwise_conv_layer.h"
+
+namespace ml
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+constexpr double reluOutput(const double input) noexcept { return 0.0 < input ? input : 0.0; }
+
+// -----------------------------------------------------------------------------
+constexpr double reluDelta(const double output) noexcept { return 0.0 < output ? 1.0 : 0.0; }
+
+// -----------------------------------------------------------------------------
+void validRange(const std::size_t size, const std::size_t pad, const std::size_t k,
+                std::size_t& first, std::size_t& last) noexcept
+{
+    // Get the output indices [first, last) for which kernel index k hits the input.
+    first = std::min(size, pad > k ? pad - k : 0U);
+    last  = std::max(first, std::min(size, size + pad - k));
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+DepthwiseConvLayer::DepthwiseConvLayer(const std::size_t channelCount,
+                                       const std::size_t inputHeight,
+                                       const std::size_t inputWidth, const std::size_t kernelSize,
+                                       const std::size_t batchCount, const Layout layout,
+                                       const unsigned seed)
+    : myInput{batchCount, channelCount, inputHeight, inputWidth, layout}
+    , myInputGradients{batchCount, channelCount, inputHeight, inputWidth, layout}
+    , myKernel{1U, channelCount, kernelSize, kernelSize, layout}
+    , myKernelGradients{1U, channelCount, kernelSize, kernelSize, layout}
+    , myOutput{batchCount, channelCount, inputHeight, inputWidth, layout}
+    , myDelta{batchCount, channelCount, inputHeight, inputWidth, layout}
+    , myBias(channelCount)
+    , myBiasGradients(channelCount)
+{
+    // Check the kernel size, throw if invalid (the other dimensions are checked by the tensors).
+    if ((kernelSize > inputHeight) || (kernelSize > inputWidth))
+    {
+        throw std::invalid_argument("Cannot create depthwise layer: invalid kernel size!");
+    }
+
+    // Initialize the kernel with values scaled to the number of inputs per output value.
+    const auto limit{std::sqrt(6.0 / (kernelSize * kernelSize))};
+    std::mt19937 generator{seed};
+    std::uniform_real_distribution<double> distribution{-limit, limit};
+    for (std::size_t k{}; k < myKernel.size(); ++k)
+    {
+        myKernel.data()[k] = distribution(generator);
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t DepthwiseConvLayer::channelCount() const noexcept { return myOutput.channelCount(); }
+
+// -----------------------------------------------------------------------------
+std::size_t DepthwiseConvLayer::kernelSize() const noexcept { return myKernel.height(); }
+
+// -----------------------------------------------------------------------------
+Layout DepthwiseConvLayer::layout() const noexcept { return myOutput.layout(); }
+
+// -----------------------------------------------------------------------------
+const Tensor& DepthwiseConvLayer::output() const noexcept { return myOutput; }
+
+// -----------------------------------------------------------------------------
+const Tensor& DepthwiseConvLayer::inputGradients() const noexcept { return myInputGradients; }
+
+// -----------------------------------------------------------------------------
+const Tensor& DepthwiseConvLayer::kernel() const noexcept { return myKernel; }
+
+// -----------------------------------------------------------------------------
+const Tensor& DepthwiseConvLayer::kernelGradients() const noexcept { return myKernelGradients; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& DepthwiseConvLayer::bias() const noexcept { return myBias; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& DepthwiseConvLayer::biasGradients() const noexcept
+{
+    return myBiasGradients;
+}
+
+// -----------------------------------------------------------------------------
+bool DepthwiseConvLayer::setParameters(const Tensor& kernel,
+                                       const std::vector<double>& bias) noexcept
+{
+    // Check the dimensions, return false on mismatch.
+    if (!kernel.hasShape(myKernel) || (bias.size() != myBias.size())) { return false; }
+
+    myKernel.copyFrom(kernel);
+    myBias = bias;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool DepthwiseConvLayer::feedforward(const Tensor& input) noexcept
+{
+    // Store the input (rearranged to the layout of the layer), return false on mismatch.
+    if (!myInput.copyFrom(input)) { return false; }
+
+    for (std::size_t n{}; n < myOutput.batchCount(); ++n)
+    {
+        if (Layout::Nchw == layout()) { feedforwardNchw(n); }
+        else { feedforwardNhwc(n); }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool DepthwiseConvLayer::backpropagate(const Tensor& outputGradients) noexcept
+{
+    // Copy the output gradients (rearranged to the layout of the layer), false on mismatch.
+    if (!myDelta.copyFrom(outputGradients)) { return false; }
+
+    const auto height{myOutput.height()}, width{myOutput.width()};
+
+    // Reset the gradients, since the contributions of all images are accumulated.
+    myInputGradients.fill();
+    myKernelGradients.fill();
+    std::fill(myBiasGradients.begin(), myBiasGradients.end(), 0.0);
+
+    // Compute the output deltas and the bias gradients.
+    for (std::size_t n{}; n < myDelta.batchCount(); ++n)
+    {
+        for (std::size_t c{}; c < channelCount(); ++c)
+        {
+            for (std::size_t i{}; i < height; ++i)
+            {
+                for (std::size_t j{}; j < width; ++j)
+                {
+                    auto& delta{myDelta(n, c, i, j)};
+                    delta *= reluDelta(myOutput(n, c, i, j));
+                    myBiasGradients[c] += delta;
+                }
+            }
+        }
+    }
+
+    for (std::size_t n{}; n < myDelta.batchCount(); ++n)
+    {
+        if (Layout::Nchw == layout()) { backpropagateNchw(n); }
+        else { backpropagateNhwc(n); }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool DepthwiseConvLayer::optimize(const double learningRate) noexcept
+{
+    // Check the learning rate, return false if out of range.
+    if ((0.0 >= learningRate) || (1.0 < learningRate)) { return false; }
+
+    // Adjust the parameters in the opposite direction of the gradients.
+    for (std::size_t c{}; c < myBias.size(); ++c)
+    {
+        myBias[c] -= myBiasGradients[c] * learningRate;
+    }
+
+    auto* kernel{myKernel.data()};
+    const auto* kernelGradients{myKernelGradients.data()};
+
+    for (std::size_t k{}; k < myKernel.size(); ++k)
+    {
+        kernel[k] -= kernelGradients[k] * learningRate;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void DepthwiseConvLayer::feedforwardNchw(const std::size_t image) noexcept
+{
+    const auto height{myOutput.height()}, width{myOutput.width()};
+    const auto size{kernelSize()}, pad{kernelSize() / 2U};
+
+    for (std::size_t c{}; c < channelCount(); ++c)
+    {
+        for (std::size_t i{}; i < height; ++i)
+        {
+            auto* output{&myOutput(image, c, i, 0U)};
+            std::fill_n(output, width, myBias[c]);
+
+            // Add each kernel row that hits the input, one whole output row per weight.
+            for (std::size_t ki{}; ki < size; ++ki)
+            {
+                if ((i + ki < pad) || (i + ki - pad >= height)) { continue; }
+                const auto* input{&myInput(image, c, i + ki - pad, 0U)};
+
+                for (std::size_t kj{}; kj < size; ++kj)
+                {
+                    const auto weight{myKernel(0U, c, ki, kj)};
+                    std::size_t first{}, last{};
+                    validRange(width, pad, kj, first, last);
+
+                    for (auto j{first}; j < last; ++j)
+                    {
+                        output[j] += weight * input[j + kj - pad];
+                    }
+                }
+            }
+            for (std::size_t j{}; j < width; ++j) { output[j] = reluOutput(output[j]); }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void DepthwiseConvLayer::feedforwardNhwc(const std::size_t image) noexcept
+{
+    const auto height{myOutput.height()}, width{myOutput.width()};
+    const auto channels{channelCount()};
+    const auto size{kernelSize()}, pad{kernelSize() / 2U};
+
+    for (std::size_t i{}; i < height; ++i)
+    {
+        for (std::size_t j{}; j < width; ++j)
+        {
+            auto* output{&myOutput(image, 0U, i, j)};
+            std::copy(myBias.begin(), myBias.end(), output);
+
+            // Add each kernel position that hits the input, one whole pixel per position.
+            for (std::size_t ki{}; ki < size; ++ki)
+            {
+                if ((i + ki < pad) || (i + ki - pad >= height)) { continue; }
+
+                for (std::size_t kj{}; kj < size; ++kj)
+                {
+                    if ((j + kj < pad) || (j + kj - pad >= width)) { continue; }
+                    const auto* input{&myInput(image, 0U, i + ki - pad, j + kj - pad)};
+                    const auto* weights{&myKernel(0U, 0U, ki, kj)};
+
+                    for (std::size_t c{}; c < channels; ++c) { output[c] += weights[c] * input[c]; }
+                }
+            }
+            for (std::size_t c{}; c < channels; ++c) { output[c] = reluOutput(output[c]); }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void DepthwiseConvLayer::backpropagateNchw(const std::size_t image) noexcept
+{
+    const auto height{myOutput.height()}, width{myOutput.width()};
+    const auto size{kernelSize()}, pad{kernelSize() / 2U};
+
+    // Walk the deltas in the same order as the feedforward; each weight gets the dot product of
+    // a delta row and an input row, and spreads the delta row to an input gradient row.
+    for (std::size_t c{}; c < channelCount(); ++c)
+    {
+        for (std::size_t i{}; i < height; ++i)
+        {
+            const auto* delta{&myDelta(image, c, i, 0U)};
+
+            for (std::size_t ki{}; ki < size; ++ki)
+            {
+                if ((i + ki < pad) || (i + ki - pad >= height)) { continue; }
+                const auto* input{&myInput(image, c, i + ki - pad, 0U)};
+                auto* inputGradients{&myInputGradients(image, c, i + ki - pad, 0U)};
+
+                for (std::size_t kj{}; kj < size; ++kj)
+                {
+                    const auto weight{myKernel(0U, c, ki, kj)};
+                    std::size_t first{}, last{};
+                    double sum{};
+                    validRange(width, pad, kj, first, last);
+
+                    for (auto j{first}; j < last; ++j)
+                    {
+                        sum                          += input[j + kj - pad] * delta[j];
+                        inputGradients[j + kj - pad] += weight * delta[j];
+                    }
+                    myKernelGradients(0U, c, ki, kj) += sum;
+                }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void DepthwiseConvLayer::backpropagateNhwc(const std::size_t image) noexcept
+{
+    const auto height{myOutput.height()}, width{myOutput.width()};
+    const auto channels{channelCount()};
+    const auto size{kernelSize()}, pad{kernelSize() / 2U};
+
+    for (std::size_t i{}; i < height; ++i)
+    {
+        for (std::size_t j{}; j < width; ++j)
+        {
+            const auto* delta{&myDelta(image, 0U, i, j)};
+
+            // All channels of a pixel share the kernel position, so the inner loops run over
+            // contiguous deltas, inputs, weights and gradients.
+            for (std::size_t ki{}; ki < size; ++ki)
+            {
+                if ((i + ki < pad) || (i + ki - pad >= height)) { continue; }
+
+                for (std::size_t kj{}; kj < size; ++kj)
+                {
+                    if ((j + kj < pad) || (j + kj - pad >= width)) { continue; }
+                    const auto row{i + ki - pad}, col{j + kj - pad};
+                    const auto* input{&myInput(image, 0U, row, col)};
+                    auto* inputGradients{&myInputGradients(image, 0U, row, col)};
+                    const auto* weights{&myKernel(0U, 0U, ki, kj)};
+                    auto* kernelGradients{&myKernelGradients(0U, 0U, ki, kj)};
+
+                    for (std::size_t c{}; c < channels; ++c)
+                    {
+                        kernelGradients[c] += input[c] * delta[c];
+                        inputGradients[c]  += weights[c] * delta[c];
+                    }
+                }
+            }
+        }
+    }
+}
+} // namespace ml
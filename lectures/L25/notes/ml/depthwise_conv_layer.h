@@ -0,0 +1,212 @@
+/**
+ * @brief Depthwise convolutional layer.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "ml/tensor.h"
+
+namespace ml
+{
+/**
+ * @brief Convolutional layer with one kernel per channel (depthwise convolution).
+ * 
+ *        Each channel is convolved with its own kernel only, so the output has as many channels
+ *        as the input. The input is zero-padded implicitly, so each output channel has the same
+ *        size as the input channels, and the output is passed through the ReLU activation
+ *        function.
+ * 
+ *        Each output value only needs kernelSize^2 multiplications, so the layer is limited by
+ *        memory bandwidth rather than arithmetic. The computation is therefore performed directly
+ *        in a single pass over the input, without lowering it to a patch matrix (which would
+ *        multiply the memory traffic by kernelSize^2). In the NCHW layout the inner loop runs
+ *        along the rows of each channel, in the NHWC layout along the channels of each pixel.
+ *        The kernel is stored as a tensor of a single image in the layout of the layer, so in the
+ *        NHWC layout the weights of each kernel position are contiguous across the channels.
+ */
+class DepthwiseConvLayer final
+{
+public:
+    /**
+     * @brief Create a new depthwise convolutional layer.
+     * 
+     * @param[in] channelCount The number of input and output channels. Must exceed 0.
+     * @param[in] inputHeight The height of the input. Must exceed 0.
+     * @param[in] inputWidth The width of the input. Must exceed 0.
+     * @param[in] kernelSize The kernel size. Must exceed 0 and not exceed the input size.
+     * @param[in] batchCount The number of images per batch (default = 1).
+     * @param[in] layout The tensor layout of the layer (default = NCHW).
+     * @param[in] seed Seed used to generate the starting kernel values (default = 0).
+     */
+    explicit DepthwiseConvLayer(std::size_t channelCount, std::size_t inputHeight,
+                                std::size_t inputWidth, std::size_t kernelSize,
+                                std::size_t batchCount = 1U, Layout layout = Layout::Nchw,
+                                unsigned seed = 0U);
+
+    /**
+     * @brief Delete the depthwise convolutional layer.
+     */
+    ~DepthwiseConvLayer() noexcept = default;
+
+    /**
+     * @brief Get the number of channels.
+     * 
+     * @return The number of input and output channels.
+     */
+    std::size_t channelCount() const noexcept;
+
+    /**
+     * @brief Get the kernel size.
+     * 
+     * @return The kernel size.
+     */
+    std::size_t kernelSize() const noexcept;
+
+    /**
+     * @brief Get the tensor layout of the layer.
+     * 
+     * @return The tensor layout of the layer.
+     */
+    Layout layout() const noexcept;
+
+    /**
+     * @brief Get the output of the latest feedforward.
+     * 
+     * @return Tensor holding batchCount x channelCount output feature maps.
+     */
+    const Tensor& output() const noexcept;
+
+    /**
+     * @brief Get the input gradients of the latest backpropagation.
+     * 
+     * @return Tensor holding the input gradients, same shape as the input.
+     */
+    const Tensor& inputGradients() const noexcept;
+
+    /**
+     * @brief Get the kernel.
+     * 
+     * @return Tensor holding 1 x channelCount x kernelSize x kernelSize weights.
+     */
+    const Tensor& kernel() const noexcept;
+
+    /**
+     * @brief Get the kernel gradients of the latest backpropagation.
+     * 
+     * @return Tensor holding the kernel gradients, same shape as the kernel.
+     */
+    const Tensor& kernelGradients() const noexcept;
+
+    /**
+     * @brief Get the bias values, one per channel.
+     * 
+     * @return Vector holding the bias values.
+     */
+    const std::vector<double>& bias() const noexcept;
+
+    /**
+     * @brief Get the bias gradients of the latest backpropagation, one per channel.
+     * 
+     * @return Vector holding the bias gradients.
+     */
+    const std::vector<double>& biasGradients() const noexcept;
+
+    /**
+     * @brief Replace the kernel and bias values.
+     * 
+     * @param[in] kernel The new kernel, any layout.
+     * @param[in] bias The new bias values, one per channel.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool setParameters(const Tensor& kernel, const std::vector<double>& bias) noexcept;
+
+    /**
+     * @brief Perform feedforward operation.
+     * 
+     * @param[in] input Tensor holding batchCount x channelCount input images, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool feedforward(const Tensor& input) noexcept;
+
+    /**
+     * @brief Perform backpropagation.
+     * 
+     * @param[in] outputGradients Tensor holding gradients from the next layer, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool backpropagate(const Tensor& outputGradients) noexcept;
+
+    /**
+     * @brief Perform optimization.
+     * 
+     * @param[in] learningRate Learning rate to use. Must be in range (0.0, 1.0].
+     * 
+     * @return True on success, false on failure.
+     */
+    bool optimize(double learningRate) noexcept;
+
+    DepthwiseConvLayer()                                     = delete; // No default constructor.
+    DepthwiseConvLayer(const DepthwiseConvLayer&)            = delete; // No copy constructor.
+    DepthwiseConvLayer(DepthwiseConvLayer&&)                 = delete; // No move constructor.
+    DepthwiseConvLayer& operator=(const DepthwiseConvLayer&) = delete; // No copy assignment.
+    DepthwiseConvLayer& operator=(DepthwiseConvLayer&&)      = delete; // No move assignment.
+
+private:
+    /**
+     * @brief Perform feedforward of an image stored in the NCHW layout.
+     * 
+     * @param[in] image The image index.
+     */
+    void feedforwardNchw(std::size_t image) noexcept;
+
+    /**
+     * @brief Perform feedforward of an image stored in the NHWC layout.
+     * 
+     * @param[in] image The image index.
+     */
+    void feedforwardNhwc(std::size_t image) noexcept;
+
+    /**
+     * @brief Accumulate the kernel and input gradients of an image stored in the NCHW layout.
+     * 
+     * @param[in] image The image index.
+     */
+    void backpropagateNchw(std::size_t image) noexcept;
+
+    /**
+     * @brief Accumulate the kernel and input gradients of an image stored in the NHWC layout.
+     * 
+     * @param[in] image The image index.
+     */
+    void backpropagateNhwc(std::size_t image) noexcept;
+
+    /** Copy of the input of the latest feedforward. */
+    Tensor myInput;
+
+    /** Input gradients. */
+    Tensor myInputGradients;
+
+    /** Kernel: 1 x channelCount x kernelSize x kernelSize. */
+    Tensor myKernel;
+
+    /** Kernel gradients. */
+    Tensor myKernelGradients;
+
+    /** Output feature maps. */
+    Tensor myOutput;
+
+    /** Output deltas (output gradients masked by the ReLU derivative). */
+    Tensor myDelta;
+
+    /** Bias values, one per channel. */
+    std::vector<double> myBias;
+
+    /** Bias gradients, one per channel. */
+    std::vector<double> myBiasGradients;
+};
+} // namespace ml
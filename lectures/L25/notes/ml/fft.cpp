@@ -0,0 +1,342 @@
+/**
+ * @brief Convolution via the fast Fourier transform, implementation details.
+ */
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "ml/fft.h"
+
+namespace ml::fft
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+inline Complex multiply(const Complex a, const Complex b) noexcept
+{
+    // Multiply without the checks for infinite and NaN values of the standard operator.
+    return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+}
+
+// -----------------------------------------------------------------------------
+constexpr bool isPowerOfTwo(const std::size_t value) noexcept
+{
+    return (0U != value) && (0U == (value & (value - 1U)));
+}
+
+// -----------------------------------------------------------------------------
+std::size_t log2(std::size_t value) noexcept
+{
+    std::size_t result{};
+    while (1U < value)
+    {
+        value >>= 1U;
+        ++result;
+    }
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t tileCount(const std::size_t inputSize, const std::size_t kernelSize,
+                      const std::size_t transformSize) noexcept
+{
+    // Get the number of tiles needed to cover the input, tiles per row squared.
+    const auto tileSize{transformSize - kernelSize + 1U};
+    const auto tilesPerRow{(inputSize + tileSize - 1U) / tileSize};
+    return tilesPerRow * tilesPerRow;
+}
+
+// -----------------------------------------------------------------------------
+double tileCost(const std::size_t transformSize) noexcept
+{
+    // Forward and inverse transform, product with the kernel spectrum and accumulation.
+    const auto area{static_cast<double>(transformSize * transformSize)};
+    return 10.0 * area * log2(transformSize) + 4.0 * area;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+Transform2d::Transform2d(const std::size_t size)
+    : myTwiddles(size / 2U)
+    , myBitReversed(size)
+    , myRow(size)
+{
+    // Check the size, throw if invalid.
+    if ((2U > size) || !isPowerOfTwo(size))
+    {
+        throw std::invalid_argument("Cannot create FFT: the size must be a power of two!");
+    }
+
+    // Precompute the twiddle factors and the bit-reversed indices.
+    const auto pi{std::acos(-1.0)};
+    const auto bits{log2(size)};
+
+    for (std::size_t k{}; k < myTwiddles.size(); ++k)
+    {
+        myTwiddles[k] = std::polar(1.0, -2.0 * pi * k / size);
+    }
+    for (std::size_t i{}; i < size; ++i)
+    {
+        for (std::size_t bit{}; bit < bits; ++bit)
+        {
+            myBitReversed[i] |= ((i >> bit) & 1U) << (bits - 1U - bit);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Transform2d::size() const noexcept { return myBitReversed.size(); }
+
+// -----------------------------------------------------------------------------
+std::size_t Transform2d::spectrumWidth() const noexcept { return size() / 2U + 1U; }
+
+// -----------------------------------------------------------------------------
+void Transform2d::forward(const double* data, const std::size_t rowCount,
+                          const std::size_t colCount, const std::size_t stride,
+                          Complex* spectrum) noexcept
+{
+    const auto n{size()}, width{spectrumWidth()};
+
+    // Transform two rows at a time: z = x[r] + i * x[r + 1].
+    for (std::size_t r{}; r < n; r += 2U)
+    {
+        auto* first{spectrum + r * width};
+        auto* second{first + width};
+
+        // The rows of the zero padding have an all-zero spectrum.
+        if (r >= rowCount)
+        {
+            std::fill(first, second + width, Complex{});
+            continue;
+        }
+
+        const auto* x0{data + r * stride};
+        const auto* x1{r + 1U < rowCount ? x0 + stride : nullptr};
+        for (std::size_t j{}; j < colCount; ++j) { myRow[j] = {x0[j], x1 ? x1[j] : 0.0}; }
+        std::fill(myRow.begin() + colCount, myRow.end(), Complex{});
+        transformRow(myRow.data(), false);
+
+        // Separate the spectra: X[r][k] = (Z[k] + Z*[n - k]) / 2,
+        //                      X[r + 1][k] = (Z[k] - Z*[n - k]) / 2i.
+        for (std::size_t k{}; k < width; ++k)
+        {
+            const auto z{myRow[k]}, mirrored{std::conj(myRow[(n - k) & (n - 1U)])};
+            const auto difference{z - mirrored};
+            first[k]  = 0.5 * (z + mirrored);
+            second[k] = {0.5 * difference.imag(), -0.5 * difference.real()};
+        }
+    }
+    transformColumns(spectrum, false);
+}
+
+// -----------------------------------------------------------------------------
+void Transform2d::inverse(Complex* spectrum, const std::size_t rowCount, double* data) noexcept
+{
+    const auto n{size()}, width{spectrumWidth()};
+    const auto scale{1.0 / (n * n)};
+    transformColumns(spectrum, true);
+
+    // Transform two rows at a time: Z = X[r] + i * X[r + 1], whose inverse is x[r] + i * x[r + 1].
+    for (std::size_t r{}; r < rowCount; r += 2U)
+    {
+        const auto* first{spectrum + r * width};
+        const auto* second{first + width};
+
+        for (std::size_t k{}; k < width; ++k)
+        {
+            myRow[k] = {first[k].real() - second[k].imag(), first[k].imag() + second[k].real()};
+        }
+
+        // Restore the other half from the conjugate symmetry: X[r][k] = X*[r][n - k].
+        for (auto k{width}; k < n; ++k)
+        {
+            const auto m{n - k};
+            myRow[k] = {first[m].real() + second[m].imag(), second[m].real() - first[m].imag()};
+        }
+        transformRow(myRow.data(), true);
+
+        auto* x0{data + r * n};
+        for (std::size_t j{}; j < n; ++j) { x0[j] = myRow[j].real() * scale; }
+        if (r + 1U < rowCount)
+        {
+            for (std::size_t j{}; j < n; ++j) { x0[n + j] = myRow[j].imag() * scale; }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void Transform2d::transformRow(Complex* row, const bool inverse) const noexcept
+{
+    const auto n{size()};
+
+    // Reorder the values, then combine transforms of increasing length (radix-2 butterflies).
+    for (std::size_t i{}; i < n; ++i)
+    {
+        if (i < myBitReversed[i]) { std::swap(row[i], row[myBitReversed[i]]); }
+    }
+    for (std::size_t length{2U}; length <= n; length <<= 1U)
+    {
+        const auto half{length / 2U}, step{n / length};
+
+        for (std::size_t start{}; start < n; start += length)
+        {
+            for (std::size_t k{}; k < half; ++k)
+            {
+                const auto twiddle{inverse ? std::conj(myTwiddles[k * step])
+                                           : myTwiddles[k * step]};
+                const auto product{multiply(row[start + k + half], twiddle)};
+                row[start + k + half] = row[start + k] - product;
+                row[start + k] += product;
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void Transform2d::transformColumns(Complex* spectrum, const bool inverse) const noexcept
+{
+    const auto n{size()}, width{spectrumWidth()};
+
+    // Same as the row transform, but each butterfly combines two whole rows.
+    for (std::size_t i{}; i < n; ++i)
+    {
+        if (i < myBitReversed[i])
+        {
+            std::swap_ranges(spectrum + i * width, spectrum + (i + 1U) * width,
+                             spectrum + myBitReversed[i] * width);
+        }
+    }
+    for (std::size_t length{2U}; length <= n; length <<= 1U)
+    {
+        const auto half{length / 2U}, step{n / length};
+
+        for (std::size_t start{}; start < n; start += length)
+        {
+            for (std::size_t k{}; k < half; ++k)
+            {
+                const auto twiddle{inverse ? std::conj(myTwiddles[k * step])
+                                           : myTwiddles[k * step]};
+                auto* first{spectrum + (start + k) * width};
+                auto* second{first + half * width};
+
+                for (std::size_t j{}; j < width; ++j)
+                {
+                    const auto product{multiply(second[j], twiddle)};
+                    second[j] = first[j] - product;
+                    first[j] += product;
+                }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+Convolution::Convolution(const std::size_t inputSize, const std::size_t kernelSize)
+    : myTransform{selectTransformSize(inputSize, kernelSize)}
+    , myKernelSpectrum(myTransform.size() * myTransform.spectrumWidth())
+    , mySpectrum(myKernelSpectrum.size())
+    , myTile(myTransform.size() * myTransform.size())
+    , myInputSize{inputSize}
+    , myKernelSize{kernelSize}
+{
+    // Check the sizes, throw if invalid.
+    if ((0U == inputSize) || (0U == kernelSize))
+    {
+        throw std::invalid_argument("Cannot create FFT convolution: invalid sizes!");
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Convolution::transformSize() const noexcept { return myTransform.size(); }
+
+// -----------------------------------------------------------------------------
+std::size_t Convolution::tileSize() const noexcept
+{
+    return myTransform.size() - myKernelSize + 1U;
+}
+
+// -----------------------------------------------------------------------------
+void Convolution::setKernel(const double* kernel) noexcept
+{
+    // Correlation is convolution with the flipped kernel, so transform the flipped kernel.
+    const auto size{myKernelSize};
+
+    for (std::size_t ki{}; ki < size; ++ki)
+    {
+        for (std::size_t kj{}; kj < size; ++kj)
+        {
+            myTile[ki * size + kj] = kernel[(size - 1U - ki) * size + (size - 1U - kj)];
+        }
+    }
+    myTransform.forward(myTile.data(), size, size, size, myKernelSpectrum.data());
+}
+
+// -----------------------------------------------------------------------------
+void Convolution::correlate(const double* input, double* output) noexcept
+{
+    const auto n{myTransform.size()}, size{myInputSize}, tile{tileSize()};
+
+    // The full convolution of a tile starting at (r0, c0) is kernelSize - 1 larger than the
+    // tile; its value [a][b] belongs to output [r0 + a - offset][c0 + b - offset].
+    const auto offset{myKernelSize - 1U - myKernelSize / 2U};
+    std::fill_n(output, size * size, 0.0);
+
+    for (std::size_t r0{}; r0 < size; r0 += tile)
+    {
+        for (std::size_t c0{}; c0 < size; c0 += tile)
+        {
+            const auto rowCount{std::min(tile, size - r0) + myKernelSize - 1U};
+            const auto colCount{std::min(tile, size - c0) + myKernelSize - 1U};
+
+            // Transform the tile, multiply with the kernel spectrum and transform back.
+            myTransform.forward(input + r0 * size + c0, rowCount - myKernelSize + 1U,
+                                colCount - myKernelSize + 1U, size, mySpectrum.data());
+            for (std::size_t k{}; k < mySpectrum.size(); ++k)
+            {
+                mySpectrum[k] = multiply(mySpectrum[k], myKernelSpectrum[k]);
+            }
+            myTransform.inverse(mySpectrum.data(), rowCount, myTile.data());
+
+            // Add the result to the output, skip the values outside of the output.
+            const auto firstCol{offset > c0 ? offset - c0 : 0U};
+            const auto lastCol{std::min(colCount, size + offset - c0)};
+
+            for (std::size_t a{}; a < rowCount; ++a)
+            {
+                if ((r0 + a < offset) || (r0 + a - offset >= size)) { continue; }
+                auto* row{output + (r0 + a - offset) * size};
+                const auto* result{&myTile[a * n]};
+                for (auto b{firstCol}; b < lastCol; ++b) { row[c0 + b - offset] += result[b]; }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Convolution::selectTransformSize(const std::size_t inputSize,
+                                             const std::size_t kernelSize) noexcept
+{
+    // Try powers of two from twice the kernel size up to a single tile covering the input.
+    std::size_t largest{2U}, result{};
+    while (largest < inputSize + kernelSize - 1U) { largest <<= 1U; }
+
+    double resultCost{};
+    for (auto size{largest}; (size >= 2U * kernelSize) || (size == largest); size >>= 1U)
+    {
+        const auto cost{tileCount(inputSize, kernelSize, size) * tileCost(size)};
+        if ((0U == result) || (cost < resultCost))
+        {
+            result     = size;
+            resultCost = cost;
+        }
+    }
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+double Convolution::cost(const std::size_t inputSize, const std::size_t kernelSize) noexcept
+{
+    const auto size{selectTransformSize(inputSize, kernelSize)};
+    return tileCount(inputSize, kernelSize, size) * tileCost(size);
+}
+} // namespace ml::fft
@@ -0,0 +1,200 @@
+/**
+ * @brief Convolution via the fast Fourier transform.
+ */
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace ml::fft
+{
+/** Complex number. */
+using Complex = std::complex<double>;
+
+/**
+ * @brief Two-dimensional fast Fourier transform of real data.
+ * 
+ *        The transform size must be a power of two. Since the input is real, the spectrum is
+ *        conjugate symmetric, so only size x (size / 2 + 1) values are stored. Two real rows are
+ *        transformed at a time as the real and imaginary part of a single complex row, then
+ *        the columns are transformed row by row, so that the inner loops run over contiguous
+ *        memory.
+ */
+class Transform2d final
+{
+public:
+    /**
+     * @brief Create a new transform.
+     * 
+     * @param[in] size The transform size. Must be a power of two, at least 2.
+     */
+    explicit Transform2d(std::size_t size);
+
+    /**
+     * @brief Delete the transform.
+     */
+    ~Transform2d() noexcept = default;
+
+    /**
+     * @brief Get the transform size.
+     * 
+     * @return The transform size.
+     */
+    std::size_t size() const noexcept;
+
+    /**
+     * @brief Get the number of stored values per spectrum row.
+     * 
+     * @return The number of values per spectrum row (size / 2 + 1).
+     */
+    std::size_t spectrumWidth() const noexcept;
+
+    /**
+     * @brief Transform real data to a spectrum.
+     * 
+     *        The data is zero-padded to size x size.
+     * 
+     * @param[in] data The data to transform.
+     * @param[in] rowCount The number of data rows. Must not exceed the transform size.
+     * @param[in] colCount The number of data columns. Must not exceed the transform size.
+     * @param[in] stride The row stride of the data (in elements).
+     * @param[out] spectrum The spectrum, size x spectrumWidth values.
+     */
+    void forward(const double* data, std::size_t rowCount, std::size_t colCount,
+                 std::size_t stride, Complex* spectrum) noexcept;
+
+    /**
+     * @brief Transform a spectrum back to real data.
+     * 
+     * @param[in,out] spectrum The spectrum, overwritten during the transform.
+     * @param[in] rowCount The number of rows to compute. Must not exceed the transform size.
+     * @param[out] data The data, rowCount x size values.
+     */
+    void inverse(Complex* spectrum, std::size_t rowCount, double* data) noexcept;
+
+    Transform2d()                              = delete; // No default constructor.
+    Transform2d(const Transform2d&)            = delete; // No copy constructor.
+    Transform2d(Transform2d&&)                 = delete; // No move constructor.
+    Transform2d& operator=(const Transform2d&) = delete; // No copy assignment.
+    Transform2d& operator=(Transform2d&&)      = delete; // No move assignment.
+
+private:
+    void transformRow(Complex* row, bool inverse) const noexcept;
+    void transformColumns(Complex* spectrum, bool inverse) const noexcept;
+
+    /** Twiddle factors exp(-2 * pi * i * k / size) for k in [0, size / 2). */
+    std::vector<Complex> myTwiddles;
+
+    /** Bit-reversed index of each index. */
+    std::vector<std::size_t> myBitReversed;
+
+    /** Complex row used during the row transforms. */
+    std::vector<Complex> myRow;
+};
+
+/**
+ * @brief Two-dimensional correlation of a square input with a square kernel via the FFT.
+ * 
+ *        The output has the same size as the input, as if the input was zero-padded with
+ *        kernelSize / 2 zeros on each edge. The input is split into tiles, each of which is
+ *        transformed, multiplied with the kernel spectrum and transformed back; the results
+ *        of neighboring tiles overlap by kernelSize - 1 rows and columns and are added together
+ *        (overlap-add). The kernel spectrum is kept until the kernel is replaced.
+ */
+class Convolution final
+{
+public:
+    /**
+     * @brief Create a new FFT convolution.
+     * 
+     * @param[in] inputSize The input size. Must exceed 0.
+     * @param[in] kernelSize The kernel size. Must exceed 0.
+     */
+    explicit Convolution(std::size_t inputSize, std::size_t kernelSize);
+
+    /**
+     * @brief Delete the FFT convolution.
+     */
+    ~Convolution() noexcept = default;
+
+    /**
+     * @brief Get the transform size selected for the tiles.
+     * 
+     * @return The transform size.
+     */
+    std::size_t transformSize() const noexcept;
+
+    /**
+     * @brief Get the tile size (the number of input rows and columns per tile).
+     * 
+     * @return The tile size.
+     */
+    std::size_t tileSize() const noexcept;
+
+    /**
+     * @brief Replace the kernel, compute its spectrum.
+     * 
+     * @param[in] kernel The kernel, kernelSize x kernelSize values stored row-major.
+     */
+    void setKernel(const double* kernel) noexcept;
+
+    /**
+     * @brief Correlate the input with the kernel.
+     * 
+     * @param[in] input The input, inputSize x inputSize values stored row-major.
+     * @param[out] output The output, inputSize x inputSize values stored row-major.
+     */
+    void correlate(const double* input, double* output) noexcept;
+
+    /**
+     * @brief Get the transform size with the lowest estimated cost.
+     * 
+     * @param[in] inputSize The input size.
+     * @param[in] kernelSize The kernel size.
+     * 
+     * @return The transform size.
+     */
+    static std::size_t selectTransformSize(std::size_t inputSize, std::size_t kernelSize) noexcept;
+
+    /**
+     * @brief Estimate the number of floating-point operations of a correlation.
+     * 
+     *        A complex FFT of size N is counted as 5 * N * log2(N) operations, so a real
+     *        two-dimensional transform of size N costs about 5 * N^2 * log2(N) operations.
+     *        Each tile requires a forward and an inverse transform, the product with the kernel
+     *        spectrum and the accumulation of the result.
+     * 
+     * @param[in] inputSize The input size.
+     * @param[in] kernelSize The kernel size.
+     * 
+     * @return The estimated number of floating-point operations.
+     */
+    static double cost(std::size_t inputSize, std::size_t kernelSize) noexcept;
+
+    Convolution()                              = delete; // No default constructor.
+    Convolution(const Convolution&)            = delete; // No copy constructor.
+    Convolution(Convolution&&)                 = delete; // No move constructor.
+    Convolution& operator=(const Convolution&) = delete; // No copy assignment.
+    Convolution& operator=(Convolution&&)      = delete; // No move assignment.
+
+private:
+    /** The real transform used for all tiles. */
+    Transform2d myTransform;
+
+    /** Spectrum of the flipped kernel. */
+    std::vector<Complex> myKernelSpectrum;
+
+    /** Spectrum of the current tile. */
+    std::vector<Complex> mySpectrum;
+
+    /** Correlation of the current tile. */
+    std::vector<double> myTile;
+
+    /** The input size. */
+    std::size_t myInputSize;
+
+    /** The kernel size. */
+    std::size_t myKernelSize;
+};
+} // namespace ml::fft
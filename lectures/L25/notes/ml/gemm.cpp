@@ -0,0 +1,188 @@
+/**
+ * @brief Cache-blocked matrix multiplication implementation details.
+ */
+#include <algorithm>
+#include <vector>
+
+#include "ml/gemm.h"
+
+namespace ml
+{
+namespace
+{
+/** The number of rows computed by the micro-kernel. */
+constexpr std::size_t MR{4U};
+
+/** The number of columns computed by the micro-kernel (a multiple of the SIMD width). */
+constexpr std::size_t NR{8U};
+
+/** The number of rows of A packed at a time (the packed block of A stays in L2 cache). */
+constexpr std::size_t MC{128U};
+
+/** The depth packed at a time (a packed panel of B stays in L1 cache). */
+constexpr std::size_t KC{256U};
+
+/** The number of columns of B packed at a time. */
+constexpr std::size_t NC{512U};
+
+// -----------------------------------------------------------------------------
+inline double element(const double* matrix, const std::size_t stride, const Transpose trans,
+                      const std::size_t row, const std::size_t col) noexcept
+{
+    // Get element [row][col] of op(matrix).
+    return Transpose::No == trans ? matrix[row * stride + col] : matrix[col * stride + row];
+}
+
+// -----------------------------------------------------------------------------
+void packA(const double* a, const std::size_t lda, const Transpose trans, const std::size_t row,
+           const std::size_t col, const std::size_t rowCount, const std::size_t depth,
+           double* packed) noexcept
+{
+    // Store panels of MR rows column by column; the last panel keeps its real height, so no
+    // work is wasted when only a few rows remain (e.g. a single filter).
+    for (std::size_t i{}; i < rowCount; i += MR)
+    {
+        const auto height{std::min(MR, rowCount - i)};
+
+        for (std::size_t p{}; p < depth; ++p)
+        {
+            for (std::size_t r{}; r < height; ++r)
+            {
+                *packed++ = element(a, lda, trans, row + i + r, col + p);
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void packB(const double* b, const std::size_t ldb, const Transpose trans, const std::size_t row,
+           const std::size_t col, const std::size_t depth, const std::size_t colCount,
+           double* packed) noexcept
+{
+    // Store panels of NR columns row by row, pad the last panel with zeros.
+    for (std::size_t j{}; j < colCount; j += NR)
+    {
+        const auto width{std::min(NR, colCount - j)};
+
+        for (std::size_t p{}; p < depth; ++p)
+        {
+            if ((Transpose::No == trans) && (NR == width))
+            {
+                std::copy_n(&b[(row + p) * ldb + col + j], NR, packed);
+                packed += NR;
+                continue;
+            }
+            for (std::size_t c{}; c < NR; ++c)
+            {
+                *packed++ = c < width ? element(b, ldb, trans, row + p, col + j + c) : 0.0;
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+template <std::size_t Rows>
+void microKernel(const std::size_t depth, const double* a, const double* b,
+                 const std::size_t bStride, double* c, const std::size_t ldc,
+                 const std::size_t width, const bool accumulate) noexcept
+{
+    // Keep the Rows x NR block of C in registers while streaming through the panels.
+    double sum[Rows][NR]{};
+
+    for (std::size_t p{}; p < depth; ++p)
+    {
+        for (std::size_t r{}; r < Rows; ++r)
+        {
+            const auto value{a[p * Rows + r]};
+            for (std::size_t j{}; j < NR; ++j) { sum[r][j] += value * b[p * bStride + j]; }
+        }
+    }
+    for (std::size_t r{}; r < Rows; ++r)
+    {
+        for (std::size_t j{}; j < width; ++j)
+        {
+            c[r * ldc + j] = accumulate ? c[r * ldc + j] + sum[r][j] : sum[r][j];
+        }
+    }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+void gemm(const Transpose transA, const Transpose transB, const std::size_t m,
+          const std::size_t n, const std::size_t k, const double* a, const std::size_t lda,
+          const double* b, const std::size_t ldb, double* c, const std::size_t ldc,
+          const bool accumulate)
+{
+    // The product is empty if k is 0; clear C unless accumulating.
+    if (0U == k)
+    {
+        if (!accumulate) { for (std::size_t i{}; i < m; ++i) { std::fill_n(&c[i * ldc], n, 0.0); } }
+        return;
+    }
+
+    // Packing buffers are reused between calls.
+    thread_local std::vector<double> packedA{}, packedB{};
+    packedA.resize(MC * KC);
+    packedB.resize(KC * (NC + NR));
+
+    for (std::size_t jc{}; jc < n; jc += NC)
+    {
+        const auto nc{std::min(NC, n - jc)};
+
+        for (std::size_t pc{}; pc < k; pc += KC)
+        {
+            const auto kc{std::min(KC, k - pc)};
+
+            // Only the first block of the depth may overwrite C.
+            const bool add{accumulate || (0U < pc)};
+
+            // Packing B only pays off if it is reused by several panels of A; otherwise full
+            // panels are read directly from B and only the last partial panel is packed.
+            const bool packAll{(Transpose::Yes == transB) || (MR < m)};
+            if (packAll) { packB(b, ldb, transB, pc, jc, kc, nc, packedB.data()); }
+            else if (0U != nc % NR)
+            {
+                const auto tail{nc - nc % NR};
+                packB(b, ldb, transB, pc, jc + tail, kc, nc % NR, &packedB[tail * kc]);
+            }
+
+            for (std::size_t ic{}; ic < m; ic += MC)
+            {
+                const auto mc{std::min(MC, m - ic)};
+                packA(a, lda, transA, ic, pc, mc, kc, packedA.data());
+
+                // Multiply each panel of A with each panel of B.
+                for (std::size_t jr{}; jr < nc; jr += NR)
+                {
+                    const auto width{std::min(NR, nc - jr)};
+                    const bool packed{packAll || (NR != width)};
+                    const auto* panelB{packed ? &packedB[jr * kc] : &b[pc * ldb + jc + jr]};
+                    const auto stride{packed ? NR : ldb};
+
+                    for (std::size_t ir{}; ir < mc; ir += MR)
+                    {
+                        const auto* panelA{&packedA[ir * kc]};
+                        auto* block{&c[(ic + ir) * ldc + jc + jr]};
+
+                        switch (std::min(MR, mc - ir))
+                        {
+                            case 1U:
+                                microKernel<1U>(kc, panelA, panelB, stride, block, ldc, width, add);
+                                break;
+                            case 2U:
+                                microKernel<2U>(kc, panelA, panelB, stride, block, ldc, width, add);
+                                break;
+                            case 3U:
+                                microKernel<3U>(kc, panelA, panelB, stride, block, ldc, width, add);
+                                break;
+                            default:
+                                microKernel<MR>(kc, panelA, panelB, stride, block, ldc, width, add);
+                                break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+} // namespace ml
@@ -0,0 +1,43 @@
+/**
+ * @brief Cache-blocked matrix multiplication.
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace ml
+{
+/**
+ * @brief Enumeration of matrix operations applied to GEMM operands.
+ */
+enum class Transpose
+{
+    No,  ///< Use the matrix as is.
+    Yes, ///< Use the transpose of the matrix.
+};
+
+/**
+ * @brief Compute C = op(A) * op(B), or C += op(A) * op(B) if accumulate is true.
+ * 
+ *        All matrices are stored row-major. op(A) is m x k, op(B) is k x n and C is m x n.
+ *        The operands are copied block by block into contiguous panels sized to stay in cache
+ *        (packing, which also takes care of any transpose), then multiplied by a register-blocked
+ *        micro-kernel that the compiler can vectorize.
+ * 
+ * @param[in] transA Operation applied to A.
+ * @param[in] transB Operation applied to B.
+ * @param[in] m The number of rows of op(A) and C.
+ * @param[in] n The number of columns of op(B) and C.
+ * @param[in] k The number of columns of op(A) and rows of op(B).
+ * @param[in] a Pointer to matrix A.
+ * @param[in] lda Row stride of A (in elements).
+ * @param[in] b Pointer to matrix B.
+ * @param[in] ldb Row stride of B (in elements).
+ * @param[out] c Pointer to matrix C.
+ * @param[in] ldc Row stride of C (in elements).
+ * @param[in] accumulate True to add the product to C, false to overwrite C (default = false).
+ */
+void gemm(Transpose transA, Transpose transB, std::size_t m, std::size_t n, std::size_t k,
+          const double* a, std::size_t lda, const double* b, std::size_t ldb, double* c,
+          std::size_t ldc, bool accumulate = false);
+} // namespace ml
@@ -0,0 +1,212 @@
+/**
+ * @brief Pointwise (1x1) convolutional layer implementation details.
+ */
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "ml/gemm.h"
+#include "ml/pointwise_conv_layer.h"
+
+namespace ml
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+constexpr double reluOutput(const double input) noexcept { return 0.0 < input ? input : 0.0; }
+
+// -----------------------------------------------------------------------------
+constexpr double reluDelta(const double output) noexcept { return 0.0 < output ? 1.0 : 0.0; }
+} // namespace
+
+// -----------------------------------------------------------------------------
+PointwiseConvLayer::PointwiseConvLayer(const std::size_t inputChannelCount,
+                                       const std::size_t filterCount,
+                                       const std::size_t inputHeight,
+                                       const std::size_t inputWidth, const std::size_t batchCount,
+                                       const Layout layout, const unsigned seed)
+    : myInput{batchCount, inputChannelCount, inputHeight, inputWidth, layout}
+    , myInputGradients{batchCount, inputChannelCount, inputHeight, inputWidth, layout}
+    , myKernel{filterCount, inputChannelCount, 1U, 1U, layout}
+    , myKernelGradients{filterCount, inputChannelCount, 1U, 1U, layout}
+    , myOutput{batchCount, filterCount, inputHeight, inputWidth, layout}
+    , myDelta{batchCount, filterCount, inputHeight, inputWidth, layout}
+    , myBias(filterCount)
+    , myBiasGradients(filterCount)
+{
+    // Initialize the kernel with values scaled to the number of inputs per filter.
+    const auto limit{std::sqrt(6.0 / inputChannelCount)};
+    std::mt19937 generator{seed};
+    std::uniform_real_distribution<double> distribution{-limit, limit};
+    for (std::size_t k{}; k < myKernel.size(); ++k)
+    {
+        myKernel.data()[k] = distribution(generator);
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t PointwiseConvLayer::inputChannelCount() const noexcept
+{
+    return myInput.channelCount();
+}
+
+// -----------------------------------------------------------------------------
+std::size_t PointwiseConvLayer::filterCount() const noexcept { return myOutput.channelCount(); }
+
+// -----------------------------------------------------------------------------
+Layout PointwiseConvLayer::layout() const noexcept { return myOutput.layout(); }
+
+// -----------------------------------------------------------------------------
+const Tensor& PointwiseConvLayer::output() const noexcept { return myOutput; }
+
+// -----------------------------------------------------------------------------
+const Tensor& PointwiseConvLayer::inputGradients() const noexcept { return myInputGradients; }
+
+// -----------------------------------------------------------------------------
+const Tensor& PointwiseConvLayer::kernel() const noexcept { return myKernel; }
+
+// -----------------------------------------------------------------------------
+const Tensor& PointwiseConvLayer::kernelGradients() const noexcept { return myKernelGradients; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& PointwiseConvLayer::bias() const noexcept { return myBias; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& PointwiseConvLayer::biasGradients() const noexcept
+{
+    return myBiasGradients;
+}
+
+// -----------------------------------------------------------------------------
+bool PointwiseConvLayer::setParameters(const Tensor& kernel,
+                                       const std::vector<double>& bias) noexcept
+{
+    // Check the dimensions, return false on mismatch.
+    if (!kernel.hasShape(myKernel) || (bias.size() != myBias.size())) { return false; }
+
+    myKernel.copyFrom(kernel);
+    myBias = bias;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool PointwiseConvLayer::feedforward(const Tensor& input) noexcept
+{
+    // Store the input (rearranged to the layout of the layer), return false on mismatch.
+    if (!myInput.copyFrom(input)) { return false; }
+
+    const auto height{myOutput.height()}, width{myOutput.width()};
+    const auto area{height * width};
+    const auto channels{inputChannelCount()}, filters{filterCount()};
+
+    for (std::size_t n{}; n < myOutput.batchCount(); ++n)
+    {
+        if (Layout::Nchw == layout())
+        {
+            // output[filter][pixel] = kernel[filter][channel] * input[channel][pixel].
+            gemm(Transpose::No, Transpose::No, filters, area, channels, myKernel.data(), channels,
+                 myInput.image(n), area, myOutput.image(n), area);
+        }
+        else
+        {
+            // output[pixel][filter] = input[pixel][channel] * kernel^T[channel][filter].
+            gemm(Transpose::No, Transpose::Yes, area, filters, channels, myInput.image(n),
+                 channels, myKernel.data(), channels, myOutput.image(n), filters);
+        }
+    }
+
+    // Add the bias of each filter and pass each sum through the ReLU activation function.
+    for (std::size_t n{}; n < myOutput.batchCount(); ++n)
+    {
+        for (std::size_t f{}; f < filters; ++f)
+        {
+            for (std::size_t i{}; i < height; ++i)
+            {
+                for (std::size_t j{}; j < width; ++j)
+                {
+                    auto& value{myOutput(n, f, i, j)};
+                    value = reluOutput(value + myBias[f]);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool PointwiseConvLayer::backpropagate(const Tensor& outputGradients) noexcept
+{
+    // Copy the output gradients (rearranged to the layout of the layer), false on mismatch.
+    if (!myDelta.copyFrom(outputGradients)) { return false; }
+
+    const auto height{myOutput.height()}, width{myOutput.width()};
+    const auto area{height * width};
+    const auto channels{inputChannelCount()}, filters{filterCount()};
+
+    // Reset the gradients, since the contributions of all images are accumulated.
+    myKernelGradients.fill();
+    std::fill(myBiasGradients.begin(), myBiasGradients.end(), 0.0);
+
+    // Compute the output deltas and the bias gradients.
+    for (std::size_t n{}; n < myDelta.batchCount(); ++n)
+    {
+        for (std::size_t f{}; f < filters; ++f)
+        {
+            for (std::size_t i{}; i < height; ++i)
+            {
+                for (std::size_t j{}; j < width; ++j)
+                {
+                    auto& delta{myDelta(n, f, i, j)};
+                    delta *= reluDelta(myOutput(n, f, i, j));
+                    myBiasGradients[f] += delta;
+                }
+            }
+        }
+    }
+
+    // Accumulate the kernel gradients and compute the input gradients (each image only gets
+    // contributions from its own deltas, so the input gradients are overwritten).
+    for (std::size_t n{}; n < myDelta.batchCount(); ++n)
+    {
+        const auto* delta{myDelta.image(n)};
+
+        if (Layout::Nchw == layout())
+        {
+            gemm(Transpose::No, Transpose::Yes, filters, channels, area, delta, area,
+                 myInput.image(n), area, myKernelGradients.data(), channels, true);
+            gemm(Transpose::Yes, Transpose::No, channels, area, filters, myKernel.data(),
+                 channels, delta, area, myInputGradients.image(n), area);
+        }
+        else
+        {
+            gemm(Transpose::Yes, Transpose::No, filters, channels, area, delta, filters,
+                 myInput.image(n), channels, myKernelGradients.data(), channels, true);
+            gemm(Transpose::No, Transpose::No, area, channels, filters, delta, filters,
+                 myKernel.data(), channels, myInputGradients.image(n), channels);
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool PointwiseConvLayer::optimize(const double learningRate) noexcept
+{
+    // Check the learning rate, return false if out of range.
+    if ((0.0 >= learningRate) || (1.0 < learningRate)) { return false; }
+
+    // Adjust the parameters in the opposite direction of the gradients.
+    for (std::size_t f{}; f < myBias.size(); ++f)
+    {
+        myBias[f] -= myBiasGradients[f] * learningRate;
+    }
+
+    auto* kernel{myKernel.data()};
+    const auto* kernelGradients{myKernelGradients.data()};
+
+    for (std::size_t k{}; k < myKernel.size(); ++k)
+    {
+        kernel[k] -= kernelGradients[k] * learningRate;
+    }
+    return true;
+}
+} // namespace ml
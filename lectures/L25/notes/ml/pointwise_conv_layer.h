@@ -0,0 +1,181 @@
+/**
+ * @brief Pointwise (1x1) convolutional layer.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "ml/tensor.h"
+
+namespace ml
+{
+/**
+ * @brief Convolutional layer with 1x1 kernels (pointwise convolution).
+ * 
+ *        Each filter combines the input channels of a single pixel into one output channel, so
+ *        the layer mixes channels without looking at neighboring pixels. The output is passed
+ *        through the ReLU activation function.
+ * 
+ *        Every input value is used once per filter, so the layer is limited by arithmetic rather
+ *        than memory bandwidth. Since a 1x1 kernel needs no patches, each input image already is
+ *        the patch matrix (channels x pixels in NCHW, pixels x channels in NHWC), and the output
+ *        and all gradients of an image are computed by a single matrix multiplication each,
+ *        without lowering or copying the input.
+ */
+class PointwiseConvLayer final
+{
+public:
+    /**
+     * @brief Create a new pointwise convolutional layer.
+     * 
+     * @param[in] inputChannelCount The number of input channels. Must exceed 0.
+     * @param[in] filterCount The number of filters (output channels). Must exceed 0.
+     * @param[in] inputHeight The height of the input. Must exceed 0.
+     * @param[in] inputWidth The width of the input. Must exceed 0.
+     * @param[in] batchCount The number of images per batch (default = 1).
+     * @param[in] layout The tensor layout of the layer (default = NCHW).
+     * @param[in] seed Seed used to generate the starting kernel values (default = 0).
+     */
+    explicit PointwiseConvLayer(std::size_t inputChannelCount, std::size_t filterCount,
+                                std::size_t inputHeight, std::size_t inputWidth,
+                                std::size_t batchCount = 1U, Layout layout = Layout::Nchw,
+                                unsigned seed = 0U);
+
+    /**
+     * @brief Delete the pointwise convolutional layer.
+     */
+    ~PointwiseConvLayer() noexcept = default;
+
+    /**
+     * @brief Get the number of input channels.
+     * 
+     * @return The number of input channels.
+     */
+    std::size_t inputChannelCount() const noexcept;
+
+    /**
+     * @brief Get the number of filters (output channels).
+     * 
+     * @return The number of filters.
+     */
+    std::size_t filterCount() const noexcept;
+
+    /**
+     * @brief Get the tensor layout of the layer.
+     * 
+     * @return The tensor layout of the layer.
+     */
+    Layout layout() const noexcept;
+
+    /**
+     * @brief Get the output of the latest feedforward.
+     * 
+     * @return Tensor holding batchCount x filterCount output feature maps.
+     */
+    const Tensor& output() const noexcept;
+
+    /**
+     * @brief Get the input gradients of the latest backpropagation.
+     * 
+     * @return Tensor holding the input gradients, same shape as the input.
+     */
+    const Tensor& inputGradients() const noexcept;
+
+    /**
+     * @brief Get the kernel.
+     * 
+     * @return Tensor holding filterCount x inputChannelCount x 1 x 1 weights.
+     */
+    const Tensor& kernel() const noexcept;
+
+    /**
+     * @brief Get the kernel gradients of the latest backpropagation.
+     * 
+     * @return Tensor holding the kernel gradients, same shape as the kernel.
+     */
+    const Tensor& kernelGradients() const noexcept;
+
+    /**
+     * @brief Get the bias values, one per filter.
+     * 
+     * @return Vector holding the bias values.
+     */
+    const std::vector<double>& bias() const noexcept;
+
+    /**
+     * @brief Get the bias gradients of the latest backpropagation, one per filter.
+     * 
+     * @return Vector holding the bias gradients.
+     */
+    const std::vector<double>& biasGradients() const noexcept;
+
+    /**
+     * @brief Replace the kernel and bias values.
+     * 
+     * @param[in] kernel The new kernel, any layout.
+     * @param[in] bias The new bias values, one per filter.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool setParameters(const Tensor& kernel, const std::vector<double>& bias) noexcept;
+
+    /**
+     * @brief Perform feedforward operation.
+     * 
+     * @param[in] input Tensor holding batchCount x inputChannelCount input images, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool feedforward(const Tensor& input) noexcept;
+
+    /**
+     * @brief Perform backpropagation.
+     * 
+     * @param[in] outputGradients Tensor holding gradients from the next layer, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool backpropagate(const Tensor& outputGradients) noexcept;
+
+    /**
+     * @brief Perform optimization.
+     * 
+     * @param[in] learningRate Learning rate to use. Must be in range (0.0, 1.0].
+     * 
+     * @return True on success, false on failure.
+     */
+    bool optimize(double learningRate) noexcept;
+
+    PointwiseConvLayer()                                     = delete; // No default constructor.
+    PointwiseConvLayer(const PointwiseConvLayer&)            = delete; // No copy constructor.
+    PointwiseConvLayer(PointwiseConvLayer&&)                 = delete; // No move constructor.
+    PointwiseConvLayer& operator=(const PointwiseConvLayer&) = delete; // No copy assignment.
+    PointwiseConvLayer& operator=(PointwiseConvLayer&&)      = delete; // No move assignment.
+
+private:
+    /** Copy of the input of the latest feedforward. */
+    Tensor myInput;
+
+    /** Input gradients. */
+    Tensor myInputGradients;
+
+    /** Kernel: filterCount x inputChannelCount x 1 x 1. */
+    Tensor myKernel;
+
+    /** Kernel gradients. */
+    Tensor myKernelGradients;
+
+    /** Output feature maps. */
+    Tensor myOutput;
+
+    /** Output deltas (output gradients masked by the ReLU derivative). */
+    Tensor myDelta;
+
+    /** Bias values, one per filter. */
+    std::vector<double> myBias;
+
+    /** Bias gradients, one per filter. */
+    std::vector<double> myBiasGradients;
+};
+} // namespace ml
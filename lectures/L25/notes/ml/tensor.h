@@ -0,0 +1,356 @@
+/**
+ * @brief Four-dimensional tensor stored in contiguous memory.
+ */
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace ml
+{
+/**
+ * @brief Allocator aligning each block to the given number of bytes.
+ * 
+ * @tparam T The value type.
+ * @tparam Alignment The alignment in bytes. Must be a power of two.
+ */
+template <typename T, std::size_t Alignment>
+struct AlignedAllocator
+{
+    /** The value type. */
+    using value_type = T;
+
+    /**
+     * @brief Allocator of another value type with the same alignment.
+     * 
+     * @tparam U The other value type.
+     */
+    template <typename U>
+    struct rebind
+    {
+        /** The allocator type. */
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    /**
+     * @brief Create a new allocator.
+     */
+    AlignedAllocator() noexcept = default;
+
+    /**
+     * @brief Create a new allocator from an allocator of another value type.
+     * 
+     * @tparam U The other value type.
+     */
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    /**
+     * @brief Allocate an aligned block.
+     * 
+     * @param[in] count The number of values to allocate.
+     * 
+     * @return Pointer to the first value of the block.
+     */
+    T* allocate(const std::size_t count)
+    {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    /**
+     * @brief Release a block allocated by this allocator.
+     * 
+     * @param[in] block Pointer to the first value of the block.
+     */
+    void deallocate(T* block, std::size_t) noexcept
+    {
+        ::operator delete(block, std::align_val_t{Alignment});
+    }
+
+    /**
+     * @brief Check whether blocks of this allocator can be released by another allocator.
+     * 
+     * @return True, since the allocator holds no state.
+     */
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+    /**
+     * @brief Check whether blocks of this allocator can't be released by another allocator.
+     * 
+     * @return False, since the allocator holds no state.
+     */
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+/**
+ * @brief Enumeration of tensor memory layouts.
+ */
+enum class Layout
+{
+    Nchw, ///< Image, channel, row, column (each channel is a contiguous feature map).
+    Nhwc, ///< Image, row, column, channel (the channels of each pixel are contiguous).
+};
+
+/**
+ * @brief Four-dimensional tensor holding a batch of multi-channel images.
+ * 
+ *        All values are stored in a single contiguous block in the given layout, so a whole
+ *        image (or a whole batch) can be handed to matrix routines without copying. The block
+ *        starts at a cache line boundary. The shape is stored together with the stride of each
+ *        dimension (the distance between neighboring values of the dimension), so values are
+ *        located and shapes are compared in constant time, whatever the layout.
+ */
+class Tensor final
+{
+public:
+    /** The alignment of the values in bytes (the size of a cache line). */
+    static constexpr std::size_t Alignment{64U};
+
+    /**
+     * @brief Create a new tensor filled with zeros.
+     * 
+     * @param[in] batchCount The number of images. Must exceed 0.
+     * @param[in] channelCount The number of channels per image. Must exceed 0.
+     * @param[in] height The height of each image. Must exceed 0.
+     * @param[in] width The width of each image. Must exceed 0.
+     * @param[in] layout The memory layout to use (default = NCHW).
+     */
+    explicit Tensor(std::size_t batchCount, std::size_t channelCount, std::size_t height,
+                    std::size_t width, Layout layout = Layout::Nchw);
+
+    /**
+     * @brief Delete the tensor.
+     */
+    ~Tensor() noexcept = default;
+
+    /**
+     * @brief Get the number of images in the tensor.
+     * 
+     * @return The number of images.
+     */
+    std::size_t batchCount() const noexcept { return myBatchCount; }
+
+    /**
+     * @brief Get the number of channels per image.
+     * 
+     * @return The number of channels per image.
+     */
+    std::size_t channelCount() const noexcept { return myChannelCount; }
+
+    /**
+     * @brief Get the height of each image.
+     * 
+     * @return The height of each image.
+     */
+    std::size_t height() const noexcept { return myHeight; }
+
+    /**
+     * @brief Get the width of each image.
+     * 
+     * @return The width of each image.
+     */
+    std::size_t width() const noexcept { return myWidth; }
+
+    /**
+     * @brief Get the memory layout of the tensor.
+     * 
+     * @return The memory layout of the tensor.
+     */
+    Layout layout() const noexcept { return myLayout; }
+
+    /**
+     * @brief Get the number of values per image.
+     * 
+     * @return The number of values per image.
+     */
+    std::size_t imageSize() const noexcept { return myChannelCount * myHeight * myWidth; }
+
+    /**
+     * @brief Get the total number of values in the tensor.
+     * 
+     * @return The total number of values in the tensor.
+     */
+    std::size_t size() const noexcept { return myData.size(); }
+
+    /**
+     * @brief Get the distance between the first values of neighboring images.
+     * 
+     * @return The image stride.
+     */
+    std::size_t batchStride() const noexcept { return myBatchStride; }
+
+    /**
+     * @brief Get the distance between the values of neighboring channels.
+     * 
+     * @return The channel stride.
+     */
+    std::size_t channelStride() const noexcept { return myChannelStride; }
+
+    /**
+     * @brief Get the distance between the values of neighboring rows.
+     * 
+     * @return The row stride.
+     */
+    std::size_t rowStride() const noexcept { return myRowStride; }
+
+    /**
+     * @brief Get the distance between the values of neighboring columns.
+     * 
+     * @return The column stride.
+     */
+    std::size_t colStride() const noexcept { return myColStride; }
+
+    /**
+     * @brief Get the offset of the given value from the start of the tensor.
+     * 
+     * @param[in] image The image index.
+     * @param[in] channel The channel index.
+     * @param[in] row The row index.
+     * @param[in] col The column index.
+     * 
+     * @return The offset of the value.
+     */
+    std::size_t index(const std::size_t image, const std::size_t channel, const std::size_t row,
+                      const std::size_t col) const noexcept
+    {
+        return image * myBatchStride + channel * myChannelStride + row * myRowStride +
+            col * myColStride;
+    }
+
+    /**
+     * @brief Get the given value.
+     * 
+     * @param[in] image The image index.
+     * @param[in] channel The channel index.
+     * @param[in] row The row index.
+     * @param[in] col The column index.
+     * 
+     * @return Reference to the value.
+     */
+    double& operator()(const std::size_t image, const std::size_t channel, const std::size_t row,
+                       const std::size_t col) noexcept
+    {
+        return myData[index(image, channel, row, col)];
+    }
+
+    /**
+     * @brief Get the given value.
+     * 
+     * @param[in] image The image index.
+     * @param[in] channel The channel index.
+     * @param[in] row The row index.
+     * @param[in] col The column index.
+     * 
+     * @return Reference to the value.
+     */
+    const double& operator()(const std::size_t image, const std::size_t channel,
+                             const std::size_t row, const std::size_t col) const noexcept
+    {
+        return myData[index(image, channel, row, col)];
+    }
+
+    /**
+     * @brief Get a pointer to the first value of the tensor.
+     * 
+     * @return Pointer to the first value.
+     */
+    double* data() noexcept { return myData.data(); }
+
+    /**
+     * @brief Get a pointer to the first value of the tensor.
+     * 
+     * @return Pointer to the first value.
+     */
+    const double* data() const noexcept { return myData.data(); }
+
+    /**
+     * @brief Get a pointer to the first value of the given image.
+     * 
+     * @param[in] image The image index.
+     * 
+     * @return Pointer to the first value of the image.
+     */
+    double* image(const std::size_t image) noexcept { return &myData[image * imageSize()]; }
+
+    /**
+     * @brief Get a pointer to the first value of the given image.
+     * 
+     * @param[in] image The image index.
+     * 
+     * @return Pointer to the first value of the image.
+     */
+    const double* image(const std::size_t image) const noexcept
+    {
+        return &myData[image * imageSize()];
+    }
+
+    /**
+     * @brief Check whether the tensor has the same dimensions as another tensor.
+     * 
+     *        The layouts of the tensors may differ.
+     * 
+     * @param[in] other The other tensor.
+     * 
+     * @return True if the dimensions match, false otherwise.
+     */
+    bool hasShape(const Tensor& other) const noexcept;
+
+    /**
+     * @brief Fill the tensor with the given value.
+     * 
+     * @param[in] value The value to fill the tensor with (default = 0).
+     */
+    void fill(double value = 0.0) noexcept;
+
+    /**
+     * @brief Copy the values of another tensor with the same dimensions.
+     * 
+     *        The values are rearranged if the layouts of the tensors differ.
+     * 
+     * @param[in] source The tensor to copy.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool copyFrom(const Tensor& source) noexcept;
+
+    Tensor()                         = delete;  // No default constructor.
+    Tensor(const Tensor&)            = default; // Copy constructor.
+    Tensor(Tensor&&)                 = default; // Move constructor.
+    Tensor& operator=(const Tensor&) = default; // Copy assignment.
+    Tensor& operator=(Tensor&&)      = default; // Move assignment.
+
+private:
+    /** The values of the tensor. */
+    std::vector<double, AlignedAllocator<double, Alignment>> myData;
+
+    /** The number of images. */
+    std::size_t myBatchCount;
+
+    /** The number of channels per image. */
+    std::size_t myChannelCount;
+
+    /** The height of each image. */
+    std::size_t myHeight;
+
+    /** The width of each image. */
+    std::size_t myWidth;
+
+    /** The memory layout. */
+    Layout myLayout;
+
+    /** The distance between the first values of neighboring images. */
+    std::size_t myBatchStride;
+
+    /** The distance between the values of neighboring channels. */
+    std::size_t myChannelStride;
+
+    /** The distance between the values of neighboring rows. */
+    std::size_t myRowStride;
+
+    /** The distance between the values of neighboring columns. */
+    std::size_t myColStride;
+};
+} // namespace ml
@@ -0,0 +1,179 @@
+/**
+ * @brief Cache-tiled direct convolution implementation details.
+ */
+#include <algorithm>
+
+#include "ml/tiled_conv.h"
+#include "ml/utils/cache_info.h"
+
+namespace ml::tiled
+{
+namespace
+{
+/** The number of kernel columns applied per pass over an output row. */
+constexpr std::size_t TapsPerPass{3U};
+
+/** Tile columns are rounded down to whole cache lines of doubles. */
+constexpr std::size_t ColumnAlignment{8U};
+
+// -----------------------------------------------------------------------------
+void addTap(double* sums, const double* inputRow, const double weight, const std::size_t kj,
+            const std::size_t pad, const std::size_t first, const std::size_t last) noexcept
+{
+    // Output column j is hit by input column j + kj - pad via kernel column kj.
+    if (first >= last) { return; }
+    const auto* input{inputRow + (first + kj - pad)};
+    for (std::size_t j{}; j < last - first; ++j) { sums[first + j] += weight * input[j]; }
+}
+
+/**
+ * @brief Columns of a tile row for which each kernel column hits the input.
+ */
+struct ColumnRange
+{
+    /**
+     * @brief Create the range of columns [firstCol, lastCol) of a tile row.
+     * 
+     * @param[in] width The width of the input.
+     * @param[in] pad The pad offset (kernelSize / 2).
+     * @param[in] firstCol The first output column of the tile.
+     * @param[in] lastCol One past the last output column of the tile.
+     */
+    ColumnRange(const std::size_t width, const std::size_t pad, const std::size_t firstCol,
+                const std::size_t lastCol) noexcept
+        : width{width}, pad{pad}, firstCol{firstCol}, lastCol{lastCol}
+    {}
+
+    /**
+     * @brief Get the first output column for which kernel column kj hits the input.
+     * 
+     * @param[in] kj The kernel column.
+     * 
+     * @return The first output column.
+     */
+    std::size_t first(const std::size_t kj) const noexcept
+    {
+        return std::min(lastCol, std::max(firstCol, pad > kj ? pad - kj : 0U));
+    }
+
+    /**
+     * @brief Get one past the last output column for which kernel column kj hits the input.
+     * 
+     * @param[in] kj The kernel column.
+     * 
+     * @return One past the last output column.
+     */
+    std::size_t last(const std::size_t kj) const noexcept
+    {
+        return std::max(first(kj), std::min(lastCol, width + pad - kj));
+    }
+
+    /** The width of the input. */
+    const std::size_t width;
+
+    /** The pad offset. */
+    const std::size_t pad;
+
+    /** The first output column of the tile. */
+    const std::size_t firstCol;
+
+    /** One past the last output column of the tile. */
+    const std::size_t lastCol;
+};
+
+// -----------------------------------------------------------------------------
+void correlateRow(const double* inputRow, const double* kernelRow, const std::size_t kernelSize,
+                  const ColumnRange& range, double* sums) noexcept
+{
+    const auto pad{range.pad};
+    std::size_t kj{};
+
+    // Apply three kernel columns per pass in the columns where all three hit the input. At the
+    // edges of the input, the columns are applied one at a time.
+    for (; kj + TapsPerPass <= kernelSize; kj += TapsPerPass)
+    {
+        const auto first{range.first(kj)}, last{std::max(first, range.last(kj + 2U))};
+        const auto w0{kernelRow[kj]}, w1{kernelRow[kj + 1U]}, w2{kernelRow[kj + 2U]};
+
+        if (first < last)
+        {
+            const auto* input{inputRow + (first + kj - pad)};
+            auto* out{sums + first};
+
+            for (std::size_t j{}; j < last - first; ++j)
+            {
+                out[j] += w0 * input[j] + w1 * input[j + 1U] + w2 * input[j + 2U];
+            }
+        }
+        for (auto tap{kj}; tap < kj + TapsPerPass; ++tap)
+        {
+            addTap(sums, inputRow, kernelRow[tap], tap, pad, range.first(tap),
+                   std::min(first, range.last(tap)));
+            addTap(sums, inputRow, kernelRow[tap], tap, pad, std::max(last, range.first(tap)),
+                   range.last(tap));
+        }
+    }
+
+    // Apply the remaining kernel columns one at a time.
+    for (; kj < kernelSize; ++kj)
+    {
+        addTap(sums, inputRow, kernelRow[kj], kj, pad, range.first(kj), range.last(kj));
+    }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+TileSize selectTileSize(const std::size_t width, const std::size_t kernelSize)
+{
+    const auto& caches{utils::cacheSizes()};
+    const auto halo{kernelSize - 1U};
+
+    // L1: kernelSize input rows (plus the halo columns) and one output row per tile.
+    const auto l1Values{caches.l1Data / sizeof(double) / (kernelSize + 1U)};
+    const auto cols{l1Values > halo + ColumnAlignment
+                        ? (l1Values - halo) / ColumnAlignment * ColumnAlignment
+                        : ColumnAlignment};
+
+    // L2 (half): the output rows of a tile and their input rows.
+    const auto l2Rows{caches.l2 / 2U / sizeof(double) / std::max<std::size_t>(width, 1U)};
+    const auto rows{l2Rows > halo + 2U ? (l2Rows - halo) / 2U : 1U};
+    return TileSize{rows, std::min(cols, width)};
+}
+
+// -----------------------------------------------------------------------------
+void correlateRelu(const double* input, const std::size_t height, const std::size_t width,
+                   const double* kernel, const std::size_t kernelSize, const double bias,
+                   double* output, const std::size_t firstRow, const std::size_t lastRow,
+                   const TileSize& tileSize) noexcept
+{
+    const auto pad{kernelSize / 2U};
+    const auto tileCols{std::max<std::size_t>(tileSize.cols, 1U)};
+
+    // Compute the tile rows one column strip at a time, so that the input rows of the strip
+    // stay in the L1 cache while they're shared by consecutive output rows.
+    for (std::size_t firstCol{}; firstCol < width; firstCol += tileCols)
+    {
+        const ColumnRange range{width, pad, firstCol, std::min(width, firstCol + tileCols)};
+
+        for (auto i{firstRow}; i < lastRow; ++i)
+        {
+            auto* sums{output + i * width};
+            std::fill(sums + range.firstCol, sums + range.lastCol, bias);
+
+            // Only the kernel rows hitting the input contribute.
+            const auto firstKernelRow{pad > i ? pad - i : 0U};
+            const auto lastKernelRow{std::min(kernelSize, height + pad - i)};
+
+            for (auto ki{firstKernelRow}; ki < lastKernelRow; ++ki)
+            {
+                correlateRow(input + (i + ki - pad) * width, kernel + ki * kernelSize,
+                             kernelSize, range, sums);
+            }
+            for (auto j{range.firstCol}; j < range.lastCol; ++j)
+            {
+                sums[j] = 0.0 < sums[j] ? sums[j] : 0.0;
+            }
+        }
+    }
+}
+} // namespace ml::tiled
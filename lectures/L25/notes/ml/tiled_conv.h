@@ -0,0 +1,58 @@
+/**
+ * @brief Cache-tiled direct convolution.
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace ml::tiled
+{
+/**
+ * @brief Size of the tiles of output values computed in one go.
+ */
+struct TileSize
+{
+    std::size_t rows; ///< The number of output rows per tile (sized to the L2 cache).
+    std::size_t cols; ///< The number of output columns per tile (sized to the L1 cache).
+};
+
+/**
+ * @brief Select the tile size for the given input width and kernel size.
+ * 
+ *        The columns are chosen so that the kernelSize input rows of a tile and the output row
+ *        being computed fit in the L1 cache together, so each input value is loaded from memory
+ *        once, and the input rows shared by neighboring output rows are still in L1. The rows
+ *        are chosen so that the output of a tile, along with its input rows, fits in half of the
+ *        L2 cache, so the output can be post-processed (e.g. to store an activation mask) before
+ *        it's evicted. The cache sizes are detected at runtime.
+ * 
+ * @param[in] width The width of the input.
+ * @param[in] kernelSize The kernel size.
+ * 
+ * @return The tile size.
+ */
+TileSize selectTileSize(std::size_t width, std::size_t kernelSize);
+
+/**
+ * @brief Correlate the given output rows, tile by tile, add the bias and apply ReLU.
+ * 
+ *        The input is zero padded implicitly with kernelSize / 2 zeros on each edge, so the
+ *        output has the same size as the input. Instead of one pass over each output row per
+ *        kernel weight, up to three kernel columns are applied per pass, which reduces the loads
+ *        and stores of the output by up to three times.
+ * 
+ * @param[in] input The input, height x width values stored row-major.
+ * @param[in] height The height of the input.
+ * @param[in] width The width of the input.
+ * @param[in] kernel The kernel, kernelSize x kernelSize values stored row-major.
+ * @param[in] kernelSize The kernel size. Must not exceed the input size.
+ * @param[in] bias The bias value to add to each output value.
+ * @param[out] output The output, of which rows [firstRow, lastRow) are written.
+ * @param[in] firstRow The first output row to compute.
+ * @param[in] lastRow One past the last output row to compute.
+ * @param[in] tileSize The tile size (only the number of columns is used).
+ */
+void correlateRelu(const double* input, std::size_t height, std::size_t width,
+                   const double* kernel, std::size_t kernelSize, double bias, double* output,
+                   std::size_t firstRow, std::size_t lastRow, const TileSize& tileSize) noexcept;
+} // namespace ml::tiled
@@ -0,0 +1,70 @@
+/**
+ * @brief Detection of the data cache sizes implementation details.
+ */
+#include <fstream>
+#include <string>
+
+#include <unistd.h>
+
+#include "ml/utils/cache_info.h"
+
+namespace ml::utils
+{
+namespace
+{
+/** Size assumed for the L1 data cache if it can't be detected. */
+constexpr std::size_t DefaultL1Size{32U * 1024U};
+
+/** Size assumed for the L2 cache if it can't be detected. */
+constexpr std::size_t DefaultL2Size{256U * 1024U};
+
+/** The largest number of cache descriptions listed in sysfs. */
+constexpr std::size_t MaxCacheIndex{8U};
+
+// -----------------------------------------------------------------------------
+std::size_t sysfsSize(const unsigned level)
+{
+    // Find the data or unified cache of the given level among the caches of the first core.
+    for (std::size_t index{}; index < MaxCacheIndex; ++index)
+    {
+        const std::string path{"/sys/devices/system/cpu/cpu0/cache/index" +
+                               std::to_string(index) + "/"};
+        std::ifstream levelFile{path + "level"}, typeFile{path + "type"}, sizeFile{path + "size"};
+        unsigned cacheLevel{};
+        std::string type{};
+        std::size_t size{};
+        std::string unit{};
+
+        if (!(levelFile >> cacheLevel) || !(typeFile >> type)) { break; }
+        if ((level != cacheLevel) || ("Instruction" == type) || !(sizeFile >> size)) { continue; }
+
+        // The size is given with a unit suffix, such as 48K.
+        sizeFile >> unit;
+        return "M" == unit ? size * 1024U * 1024U : ("K" == unit ? size * 1024U : size);
+    }
+    return 0U;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t detectSize(const unsigned level, const std::size_t fallback)
+{
+    std::size_t size{};
+#if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE)
+    // Get the size via sysconf (glibc), which reports 0 or -1 on some systems if it's unknown.
+    const auto reported{::sysconf(1U == level ? _SC_LEVEL1_DCACHE_SIZE : _SC_LEVEL2_CACHE_SIZE)};
+    size = 0 < reported ? static_cast<std::size_t>(reported) : 0U;
+#endif
+    // Fall back on sysfs, then on the typical size.
+    if (0U == size) { size = sysfsSize(level); }
+    return 0U < size ? size : fallback;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+const CacheSizes& cacheSizes()
+{
+    // Detect the sizes once, the initialization of a static local variable is thread-safe.
+    static const CacheSizes sizes{detectSize(1U, DefaultL1Size), detectSize(2U, DefaultL2Size)};
+    return sizes;
+}
+} // namespace ml::utils
@@ -0,0 +1,29 @@
+/**
+ * @brief Detection of the data cache sizes of the processor.
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace ml::utils
+{
+/**
+ * @brief Sizes of the data caches of the processor.
+ */
+struct CacheSizes
+{
+    std::size_t l1Data; ///< Size of the L1 data cache in bytes.
+    std::size_t l2;     ///< Size of the L2 cache in bytes.
+};
+
+/**
+ * @brief Get the data cache sizes of the processor.
+ * 
+ *        The sizes are detected on first use, via sysconf or via sysfs if sysconf doesn't know
+ *        them. Typical sizes (32 kB L1, 256 kB L2) are assumed for the caches that can't be
+ *        detected.
+ * 
+ * @return Reference to the detected cache sizes.
+ */
+const CacheSizes& cacheSizes();
+} // namespace ml::utils
@@ -0,0 +1,80 @@
+/**
+ * @brief Thread pool implementation.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace ml::utils
+{
+/**
+ * @brief Thread pool implementation.
+ * 
+ *        A fixed number of worker threads execute submitted tasks in the order they were added.
+ */
+class ThreadPool final
+{
+public:
+    /**
+     * @brief Create a new thread pool.
+     * 
+     * @param[in] threadCount The number of worker threads (default = hardware concurrency).
+     *                        At least one worker thread is always created.
+     */
+    explicit ThreadPool(const std::size_t threadCount = std::thread::hardware_concurrency());
+
+    /**
+     * @brief Delete the thread pool.
+     * 
+     *        Remaining tasks are executed before the worker threads are joined.
+     */
+    ~ThreadPool() noexcept;
+
+    /**
+     * @brief Get the number of worker threads in the pool.
+     * 
+     * @return The number of worker threads in the pool.
+     */
+    std::size_t threadCount() const noexcept;
+
+    /**
+     * @brief Submit a task to the thread pool.
+     * 
+     * @param[in] task The task to execute.
+     * 
+     * @return Future that becomes ready once the task has been executed.
+     */
+    std::future<void> submit(std::function<void()> task);
+
+    ThreadPool()                             = delete; // No default constructor.
+    ThreadPool(const ThreadPool&)            = delete; // No copy constructor.
+    ThreadPool(ThreadPool&&)                 = delete; // No move constructor.
+    ThreadPool& operator=(const ThreadPool&) = delete; // No copy assignment.
+    ThreadPool& operator=(ThreadPool&&)      = delete; // No move assignment.
+
+private:
+    void run() noexcept;
+
+    /** Worker threads. */
+    std::vector<std::thread> myWorkers;
+
+    /** Tasks waiting to be executed. */
+    std::queue<std::packaged_task<void()>> myTasks;
+
+    /** Mutex protecting the task queue. */
+    std::mutex myMutex;
+
+    /** Condition variable used to wake up the worker threads. */
+    std::condition_variable myCondition;
+
+    /** Indicate whether the pool is shutting down. */
+    bool myStopped;
+};
+} // namespace ml::utils
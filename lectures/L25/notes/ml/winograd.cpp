@@ -0,0 +1,136 @@
+/**
+ * @brief Winograd minimal filtering implementation details.
+ * 
+ *        Each two-dimensional transform X^T * tile * X is computed as the one-dimensional
+ *        transform X^T applied to every column of the tile, followed by every row of the result.
+ *        The one-dimensional transforms are written out by hand, so that no work is spent on the
+ *        zeros and ones of the transform matrices.
+ */
+#include "ml/winograd.h"
+
+namespace ml::winograd
+{
+namespace
+{
+/** The largest input tile size of all variants. */
+constexpr std::size_t MaxTileSize{6U};
+
+// -----------------------------------------------------------------------------
+void kernel2x2(const double* g, const std::size_t in, double* u, const std::size_t out) noexcept
+{
+    // G = [1 0 0; 1/2 1/2 1/2; 1/2 -1/2 1/2; 0 0 1].
+    u[0U]       = g[0U];
+    u[out]      = 0.5 * (g[0U] + g[in] + g[2U * in]);
+    u[2U * out] = 0.5 * (g[0U] - g[in] + g[2U * in]);
+    u[3U * out] = g[2U * in];
+}
+
+// -----------------------------------------------------------------------------
+void kernel4x4(const double* g, const std::size_t in, double* u, const std::size_t out) noexcept
+{
+    // G = [1/4 0 0; -1/6 -1/6 -1/6; -1/6 1/6 -1/6; 1/24 1/12 1/6; 1/24 -1/12 1/6; 0 0 1].
+    const auto g0{g[0U]}, g1{g[in]}, g2{g[2U * in]};
+    u[0U]       = g0 / 4.0;
+    u[out]      = -(g0 + g1 + g2) / 6.0;
+    u[2U * out] = -(g0 - g1 + g2) / 6.0;
+    u[3U * out] = g0 / 24.0 + g1 / 12.0 + g2 / 6.0;
+    u[4U * out] = g0 / 24.0 - g1 / 12.0 + g2 / 6.0;
+    u[5U * out] = g2;
+}
+
+// -----------------------------------------------------------------------------
+void input2x2(const double* d, const std::size_t in, double* v, const std::size_t out) noexcept
+{
+    // B^T = [1 0 -1 0; 0 1 1 0; 0 -1 1 0; 0 1 0 -1].
+    const auto d0{d[0U]}, d1{d[in]}, d2{d[2U * in]}, d3{d[3U * in]};
+    v[0U]       = d0 - d2;
+    v[out]      = d1 + d2;
+    v[2U * out] = d2 - d1;
+    v[3U * out] = d1 - d3;
+}
+
+// -----------------------------------------------------------------------------
+void input4x4(const double* d, const std::size_t in, double* v, const std::size_t out) noexcept
+{
+    // B^T = [4 0 -5 0 1 0; 0 -4 -4 1 1 0; 0 4 -4 -1 1 0;
+    //        0 -2 -1 2 1 0; 0 2 -1 -2 1 0; 0 4 0 -5 0 1].
+    const auto d0{d[0U]}, d1{d[in]}, d2{d[2U * in]}, d3{d[3U * in]}, d4{d[4U * in]};
+    const auto d5{d[5U * in]};
+    v[0U]       = 4.0 * d0 - 5.0 * d2 + d4;
+    v[out]      = d3 + d4 - 4.0 * (d1 + d2);
+    v[2U * out] = d4 - d3 + 4.0 * (d1 - d2);
+    v[3U * out] = d4 - d2 + 2.0 * (d3 - d1);
+    v[4U * out] = d4 - d2 + 2.0 * (d1 - d3);
+    v[5U * out] = 4.0 * d1 - 5.0 * d3 + d5;
+}
+
+// -----------------------------------------------------------------------------
+void output2x2(const double* m, const std::size_t in, double* y, const std::size_t out) noexcept
+{
+    // A^T = [1 1 1 0; 0 1 -1 -1].
+    y[0U]  = m[0U] + m[in] + m[2U * in];
+    y[out] = m[in] - m[2U * in] - m[3U * in];
+}
+
+// -----------------------------------------------------------------------------
+void output4x4(const double* m, const std::size_t in, double* y, const std::size_t out) noexcept
+{
+    // A^T = [1 1 1 1 1 0; 0 1 -1 2 -2 0; 0 1 1 4 4 0; 0 1 -1 8 -8 1].
+    const auto sum12{m[in] + m[2U * in]}, diff12{m[in] - m[2U * in]};
+    const auto sum34{m[3U * in] + m[4U * in]}, diff34{m[3U * in] - m[4U * in]};
+    y[0U]       = m[0U] + sum12 + sum34;
+    y[out]      = diff12 + 2.0 * diff34;
+    y[2U * out] = sum12 + 4.0 * sum34;
+    y[3U * out] = diff12 + 8.0 * diff34 + m[5U * in];
+}
+
+// -----------------------------------------------------------------------------
+template <typename Transform>
+void transform2d(Transform&& transform, const double* in, const std::size_t inSize,
+                 const std::size_t outSize, double* out) noexcept
+{
+    // Transform the columns (inSize x inSize => outSize x inSize), then the rows of the result.
+    double columns[MaxTileSize * MaxTileSize]{};
+    for (std::size_t j{}; j < inSize; ++j) { transform(in + j, inSize, columns + j, inSize); }
+    for (std::size_t i{}; i < outSize; ++i)
+    {
+        transform(columns + i * inSize, 1U, out + i * outSize, 1U);
+    }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+void transformKernel(const Variant variant, const double* kernel, double* transformed) noexcept
+{
+    // Transform the columns (3x3 => alpha x 3), then the rows of the result (=> alpha x alpha).
+    const auto size{inputTileSize(variant)};
+    const auto transform{Variant::F2x2 == variant ? kernel2x2 : kernel4x4};
+    double columns[MaxTileSize * KernelSize]{};
+
+    for (std::size_t j{}; j < KernelSize; ++j)
+    {
+        transform(kernel + j, KernelSize, columns + j, KernelSize);
+    }
+    for (std::size_t i{}; i < size; ++i)
+    {
+        transform(columns + i * KernelSize, 1U, transformed + i * size, 1U);
+    }
+}
+
+// -----------------------------------------------------------------------------
+void transformInput(const Variant variant, const double* tile, double* transformed) noexcept
+{
+    const auto size{inputTileSize(variant)};
+    if (Variant::F2x2 == variant) { transform2d(input2x2, tile, size, size, transformed); }
+    else { transform2d(input4x4, tile, size, size, transformed); }
+}
+
+// -----------------------------------------------------------------------------
+void transformOutput(const Variant variant, const double* product, double* tile) noexcept
+{
+    const auto size{inputTileSize(variant)};
+    const auto tileSize{outputTileSize(variant)};
+    if (Variant::F2x2 == variant) { transform2d(output2x2, product, size, tileSize, tile); }
+    else { transform2d(output4x4, product, size, tileSize, tile); }
+}
+} // namespace ml::winograd
@@ -0,0 +1,81 @@
+/**
+ * @brief Winograd minimal filtering for 3x3 kernels.
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace ml::winograd
+{
+/**
+ * @brief Enumeration of Winograd variants.
+ * 
+ *        F(m x m, 3x3) computes an m x m output tile from an (m + 2) x (m + 2) input tile with
+ *        (m + 2)^2 multiplications instead of 9m^2, once the kernel has been transformed. The
+ *        transforms add more additions than the multiplications they save, which only pays off
+ *        when they are shared between many channels and filters.
+ */
+enum class Variant
+{
+    F2x2, ///< F(2x2, 3x3): 16 instead of 36 multiplications per tile (2.25x fewer).
+    F4x4, ///< F(4x4, 3x3): 36 instead of 144 multiplications per tile (4x fewer).
+};
+
+/** The kernel size supported by the transforms. */
+constexpr std::size_t KernelSize{3U};
+
+/**
+ * @brief Get the size of the output tiles of the given variant.
+ * 
+ * @param[in] variant The Winograd variant.
+ * 
+ * @return The output tile size (2 or 4).
+ */
+constexpr std::size_t outputTileSize(const Variant variant) noexcept
+{
+    return Variant::F2x2 == variant ? 2U : 4U;
+}
+
+/**
+ * @brief Get the size of the input tiles (and the transformed tiles) of the given variant.
+ * 
+ * @param[in] variant The Winograd variant.
+ * 
+ * @return The input tile size (4 or 6).
+ */
+constexpr std::size_t inputTileSize(const Variant variant) noexcept
+{
+    return outputTileSize(variant) + KernelSize - 1U;
+}
+
+/**
+ * @brief Transform a 3x3 kernel: U = G * kernel * G^T.
+ * 
+ *        The transformed kernel only changes when the kernel does, so it should be computed
+ *        once and reused for every tile.
+ * 
+ * @param[in] variant The Winograd variant.
+ * @param[in] kernel The 3x3 kernel, stored row-major.
+ * @param[out] transformed The transformed kernel, inputTileSize x inputTileSize row-major.
+ */
+void transformKernel(Variant variant, const double* kernel, double* transformed) noexcept;
+
+/**
+ * @brief Transform an input tile: V = B^T * tile * B.
+ * 
+ * @param[in] variant The Winograd variant.
+ * @param[in] tile The input tile, inputTileSize x inputTileSize row-major.
+ * @param[out] transformed The transformed tile, inputTileSize x inputTileSize row-major.
+ */
+void transformInput(Variant variant, const double* tile, double* transformed) noexcept;
+
+/**
+ * @brief Transform the element-wise product of the transformed kernel and input tile back to
+ *        an output tile: Y = A^T * product * A.
+ * 
+ * @param[in] variant The Winograd variant.
+ * @param[in] product The element-wise product, inputTileSize x inputTileSize row-major.
+ * @param[out] tile The output tile, outputTileSize x outputTileSize row-major.
+ */
+void transformOutput(Variant variant, const double* product, double* tile) noexcept;
+} // namespace ml::winograd
@@ -10,86 +10,179 @@
 /** Matrix structure. */
 typedef struct matrix matrix_t;
 
+/** Alignment of the matrix rows in bytes (the size of a cache line). */
+#define MATRIX_ALIGNMENT 64U
+
 /**
- * @brief Create a new matrix.
- * 
- * @param[in] size Size of the matrix.
- * 
+ * @brief Create a new matrix initialized with zeros.
+ *
+ *        Each row starts at a MATRIX_ALIGNMENT-byte boundary, so the row stride may exceed the
+ *        number of columns. The padding at the end of each row is kept zero.
+ *
+ * @param[in] rows The number of rows. Must exceed 0.
+ * @param[in] cols The number of columns. Must exceed 0.
+ *
  * @return Pointer to the new matrix, or a nullptr on failure.
  */
-matrix_t* matrix_new(size_t size);
+matrix_t* matrix_new(size_t rows, size_t cols);
 
 /**
  * @brief Delete given matrix.
- * 
+ *
  *        Release allocated resources and set the associated pointer to null.
- * 
+ *
  * @param[in] self Double pointer to the matrix to delete.
  */
 void matrix_del(matrix_t** self);
 
-/** 
+/**
+ * @brief Get the number of rows of the matrix.
+ *
+ * @param[in] self Pointer to the matrix.
+ *
+ * @return The number of rows, or 0 if the matrix is invalid.
+ */
+size_t matrix_rows(const matrix_t* self);
+
+/**
+ * @brief Get the number of columns of the matrix.
+ *
+ * @param[in] self Pointer to the matrix.
+ *
+ * @return The number of columns, or 0 if the matrix is invalid.
+ */
+size_t matrix_cols(const matrix_t* self);
+
+/**
+ * @brief Get the row stride of the matrix.
+ *
+ * @param[in] self Pointer to the matrix.
+ *
+ * @return The distance between the starts of two consecutive rows in elements, or 0 if the
+ *         matrix is invalid.
+ */
+size_t matrix_stride(const matrix_t* self);
+
+/**
  * @brief Get matrix size.
- * 
+ *
  * @param[in] self Pointer to the matrix.
- * 
- * @return The size of the matrix.
- * 
- * @note Ensure that the matrix is valid before invoking this function.
+ *
+ * @return The number of elements of the matrix (rows * columns), excluding the row padding.
  */
 size_t matrix_size(const matrix_t* self);
 
-/** 
+/**
+ * @brief Check whether the matrix has the given shape.
+ *
+ * @param[in] self Pointer to the matrix.
+ * @param[in] rows The expected number of rows.
+ * @param[in] cols The expected number of columns.
+ *
+ * @return True if the matrix is valid and has the given shape, false otherwise.
+ */
+bool matrix_has_shape(const matrix_t* self, size_t rows, size_t cols);
+
+/**
  * @brief Get matrix data.
- * 
+ *
+ *        Element [i][j] is located at index i * matrix_stride(self) + j.
+ *
  * @param[in] self Pointer to the matrix.
- * 
+ *
  * @return Pointer to the matrix data.
- * 
+ *
  * @note Ensure that the matrix is valid before invoking this function.
  */
 double* matrix_data(matrix_t* self);
 
-/** 
+/**
  * @brief Get matrix data (read-only).
- * 
+ *
+ *        Element [i][j] is located at index i * matrix_stride(self) + j.
+ *
  * @param[in] self Pointer to the matrix.
- * 
+ *
  * @return Pointer to the matrix data.
- * 
+ *
  * @note Ensure that the matrix is valid before invoking this function.
  */
 const double* matrix_data_const(const matrix_t* self);
 
-/** 
+/**
+ * @brief Get a row of the matrix.
+ *
+ * @param[in] self Pointer to the matrix.
+ * @param[in] row The row index.
+ *
+ * @return Pointer to the first element of the row (aligned to MATRIX_ALIGNMENT bytes).
+ *
+ * @note Ensure that the matrix is valid and that the row index is in range before invoking
+ *       this function.
+ */
+double* matrix_row(matrix_t* self, size_t row);
+
+/**
+ * @brief Get a row of the matrix (read-only).
+ *
+ * @param[in] self Pointer to the matrix.
+ * @param[in] row The row index.
+ *
+ * @return Pointer to the first element of the row (aligned to MATRIX_ALIGNMENT bytes).
+ *
+ * @note Ensure that the matrix is valid and that the row index is in range before invoking
+ *       this function.
+ */
+const double* matrix_row_const(const matrix_t* self, size_t row);
+
+/**
  * @brief Check whether given matrix is empty.
- * 
+ *
  * @param[in] self Pointer to the matrix.
- * 
+ *
  * @return True if the matrix is empty, false otherwise.
  */
 bool matrix_empty(const matrix_t* self);
 
 /**
  * @brief Initialize given matrix with zeros.
- * 
+ *
  * @param[in] self Matrix to initialize.
  */
 void matrix_init(matrix_t* self);
 
-/** 
+/**
+ * @brief Fill given matrix with a value.
+ *
+ * @param[in] self Matrix to fill.
+ * @param[in] value The value to fill the matrix with.
+ */
+void matrix_fill(matrix_t* self, double value);
+
+/**
+ * @brief Copy the contents of a matrix to another matrix of the same shape.
+ *
+ * @param[in] self Matrix to copy to.
+ * @param[in] source Matrix to copy from.
+ *
+ * @return True on success, false if the shapes don't match.
+ */
+bool matrix_assign(matrix_t* self, const matrix_t* source);
+
+/**
  * @brief Create a new matrix by copying given data.
- * 
- * @param[in] buffer Buffer holding the data to copy.
- * @param[in] bytes Size of the buffer in bytes.
- * 
+ *
+ * @param[in] buffer Buffer holding rows * cols values stored row-major without padding.
+ * @param[in] rows The number of rows.
+ * @param[in] cols The number of columns.
+ *
  * @return Pointer to the new matrix, or a nullptr on failure.
  */
-matrix_t* matrix_copy(const void* buffer, size_t bytes);
+matrix_t* matrix_copy(const void* buffer, size_t rows, size_t cols);
 
 /**
  * @brief Print the contents of given matrix to the terminal.
- * 
+ *
  * @param[in] self The matrix to print.
  * @param[in] print2d True to print the matrix as a 2D matrix.
  */
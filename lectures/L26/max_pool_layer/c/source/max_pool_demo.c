@@ -21,14 +21,14 @@ int main(void)
         {1, 2, 4, 5},
         {3, 4, 7, 7},
     };
-    matrix_t* input = matrix_copy(input_data, sizeof(input_data));
+    matrix_t* input = matrix_copy(input_data, INPUT_SIZE, INPUT_SIZE);
 
     // Example output gradients (same shape as pooling output, used for backpropagation demo).
     const double gradients[POOL_SIZE][POOL_SIZE] = {
         {1, 2},
         {3, 4},
     };
-    matrix_t* output_gradients = matrix_copy(gradients, sizeof(gradients));
+    matrix_t* output_gradients = matrix_copy(gradients, POOL_SIZE, POOL_SIZE);
 
     // Create a max pooling layer: 4x4 input, 2x2 pooling regions, produces 2x2 output.
     max_pool_layer_t* pool_layer = max_pool_layer_new(INPUT_SIZE, POOL_SIZE);
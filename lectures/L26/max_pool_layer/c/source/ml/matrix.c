@@ -1,79 +1,89 @@
 /**
  * @brief Matrix implementation details.
  */
-#include <math.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "ml/matrix.h"
 
-/** 
- * @brief Matrix structure. 
+/**
+ * @brief Matrix structure.
  */
 typedef struct matrix
 {
-    /** Matrix data. */
+    /** Matrix data, each row aligned to MATRIX_ALIGNMENT bytes. */
     double* data;
 
-    /** Matrix size. */
-    size_t size;
+    /** The number of rows. */
+    size_t rows;
+
+    /** The number of columns. */
+    size_t cols;
+
+    /** The distance between the starts of two consecutive rows in elements. */
+    size_t stride;
 } matrix_t;
 
 // -----------------------------------------------------------------------------
-static void matrix_print1d(const matrix_t* self)
+static size_t matrix_aligned_stride(const size_t cols)
 {
-    const size_t n = self->size;
-    const size_t last_num = 0U == n ? 0U : n - 1U;
+    // Round the row length up to a whole number of alignment blocks.
+    const size_t block = MATRIX_ALIGNMENT / sizeof(double);
+    return (cols + block - 1U) / block * block;
+}
 
+// -----------------------------------------------------------------------------
+static void matrix_print1d(const matrix_t* self)
+{
     // Print the matrix contents on a single row.
-    for (size_t i = 0U; i < n; ++i)
+    for (size_t i = 0U; i < self->rows; ++i)
     {
-        const double num = self->data[i];
+        const double* row = matrix_row_const(self, i);
 
-        // Separate each number in the row with a comma.
-        if (i < last_num) { printf("%.1f, ", num); }
-        else { printf("%.1f\n\n", num); }
+        for (size_t j = 0U; j < self->cols; ++j)
+        {
+            // Separate each number with a comma.
+            if ((i + 1U < self->rows) || (j + 1U < self->cols)) { printf("%.1f, ", row[j]); }
+            else { printf("%.1f\n\n", row[j]); }
+        }
     }
 }
 
 // -----------------------------------------------------------------------------
 static void matrix_print2d(const matrix_t* self)
 {
-    const size_t n = sqrt(self->size);
-
     // Print the matrix contents row by row.
-    for (size_t i = 0U; i < n; ++i)
+    for (size_t i = 0U; i < self->rows; ++i)
     {
-        const size_t last_num = 0U == n ? 0U : n - 1U;
+        const double* row = matrix_row_const(self, i);
         printf("\t");
-        
-        for (size_t j = 0U; j < n; ++j)
-        {
-            const double num = self->data[i * n + j];
 
+        for (size_t j = 0U; j < self->cols; ++j)
+        {
             // Separate each number in the row with a comma.
-            if (j < last_num) { printf("%.1f, ", num); }
-            else { printf("%.1f\n", num); }
+            if (j + 1U < self->cols) { printf("%.1f, ", row[j]); }
+            else { printf("%.1f\n", row[j]); }
         }
     }
     printf("\n");
 }
 
-
 // -----------------------------------------------------------------------------
-matrix_t* matrix_new(const size_t size)
+matrix_t* matrix_new(const size_t rows, const size_t cols)
 {
+    // Check the dimensions, return null if invalid.
+    if ((0U == rows) || (0U == cols)) { return NULL; }
+
     // Create the new matrix, return null on failure.
     matrix_t* self = (matrix_t*)(malloc(sizeof(matrix_t)));
     if (NULL == self) { return NULL; }
 
-    // Initialize the matrix.
-    self->data = NULL;
-    self->size = 0U;
-
-    // Resize the data field, return null on failure.
-    self->data = (double*)(malloc(sizeof(double) * size));
+    // Allocate aligned storage, return null on failure. The size is a multiple of the alignment,
+    // since the stride is.
+    const size_t stride = matrix_aligned_stride(cols);
+    self->data = (double*)(aligned_alloc(MATRIX_ALIGNMENT, sizeof(double) * rows * stride));
 
     if (NULL == self->data)
     {
@@ -82,7 +92,9 @@ matrix_t* matrix_new(const size_t size)
     }
 
     // Initialize the matrix with zeros, then return it.
-    self->size = size;
+    self->rows   = rows;
+    self->cols   = cols;
+    self->stride = stride;
     matrix_init(self);
     return self;
 }
@@ -100,10 +112,25 @@ void matrix_del(matrix_t** self)
 }
 
 // -----------------------------------------------------------------------------
-bool matrix_empty(const matrix_t* self) { return NULL == self ? true : 0U == self->size; }
+bool matrix_empty(const matrix_t* self) { return 0U == matrix_size(self); }
+
+// -----------------------------------------------------------------------------
+size_t matrix_rows(const matrix_t* self) { return NULL == self ? 0U : self->rows; }
+
+// -----------------------------------------------------------------------------
+size_t matrix_cols(const matrix_t* self) { return NULL == self ? 0U : self->cols; }
+
+// -----------------------------------------------------------------------------
+size_t matrix_stride(const matrix_t* self) { return NULL == self ? 0U : self->stride; }
+
+// -----------------------------------------------------------------------------
+size_t matrix_size(const matrix_t* self) { return NULL == self ? 0U : self->rows * self->cols; }
 
 // -----------------------------------------------------------------------------
-size_t matrix_size(const matrix_t* self) { return NULL == self ? 0U : self->size; }
+bool matrix_has_shape(const matrix_t* self, const size_t rows, const size_t cols)
+{
+    return (NULL != self) && (rows == self->rows) && (cols == self->cols);
+}
 
 // -----------------------------------------------------------------------------
 double* matrix_data(matrix_t* self) { return NULL == self ? NULL : self->data; }
@@ -111,31 +138,67 @@ double* matrix_data(matrix_t* self) { return NULL == self ? NULL : self->data; }
 // -----------------------------------------------------------------------------
 const double* matrix_data_const(const matrix_t* self) { return NULL == self ? NULL : self->data; }
 
+// -----------------------------------------------------------------------------
+double* matrix_row(matrix_t* self, const size_t row) { return self->data + row * self->stride; }
+
+// -----------------------------------------------------------------------------
+const double* matrix_row_const(const matrix_t* self, const size_t row)
+{
+    return self->data + row * self->stride;
+}
+
 // -----------------------------------------------------------------------------
 void matrix_init(matrix_t* self)
 {
     // Check the matrix, terminate the function on failure.
     if (NULL == self) { return; }
 
-    // Fill the matrix with zeros.
-    for (size_t i = 0U; i < self->size; ++i) { self->data[i] = 0.0; }
+    // Fill the matrix with zeros, including the row padding.
+    memset(self->data, 0, sizeof(double) * self->rows * self->stride);
+}
+
+// -----------------------------------------------------------------------------
+void matrix_fill(matrix_t* self, const double value)
+{
+    // Check the matrix, terminate the function on failure.
+    if (NULL == self) { return; }
+
+    // Fill each row, the padding is left as is.
+    for (size_t i = 0U; i < self->rows; ++i)
+    {
+        double* row = matrix_row(self, i);
+        for (size_t j = 0U; j < self->cols; ++j) { row[j] = value; }
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool matrix_assign(matrix_t* self, const matrix_t* source)
+{
+    // Check the shapes, return false on mismatch.
+    if ((NULL == source) || !matrix_has_shape(self, source->rows, source->cols)) { return false; }
+
+    // Both matrices have the same stride, so copy the data as a single block.
+    memcpy(self->data, source->data, sizeof(double) * self->rows * self->stride);
+    return true;
 }
 
 // -----------------------------------------------------------------------------
-matrix_t* matrix_copy(const void* buffer, const size_t bytes)
+matrix_t* matrix_copy(const void* buffer, const size_t rows, const size_t cols)
 {
-    double* data      = (double*)(buffer);
-    const size_t size = bytes / sizeof(double);
+    const double* data = (const double*)(buffer);
 
     // Check the buffer content, return null if invalid.
     if (NULL == data) { return NULL; }
 
     // Create the new matrix, return null on failure.
-    matrix_t* self = matrix_new(size);
+    matrix_t* self = matrix_new(rows, cols);
     if (NULL == self) { return NULL; }
 
-    // Copy from the given buffer, then return the matrix.
-    for (size_t i = 0; i < size; ++i) { self->data[i] = data[i]; }
+    // Copy from the given buffer row by row, then return the matrix.
+    for (size_t i = 0U; i < rows; ++i)
+    {
+        memcpy(matrix_row(self, i), data + i * cols, sizeof(double) * cols);
+    }
     return self;
 }
 
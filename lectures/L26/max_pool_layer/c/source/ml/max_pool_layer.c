@@ -1,7 +1,6 @@
 /**
  * @brief Max pooling layer implementation details.
  */
-#include <math.h>
 #include <stdbool.h>
 #include <stdlib.h>
 
@@ -24,37 +23,21 @@ typedef struct max_pool_layer
 } max_pool_layer_t;
 
 // -----------------------------------------------------------------------------
-static size_t max_pool_layer_input_size(const max_pool_layer_t* self) 
-{ 
-    return sqrt(matrix_size(self->input)); 
-}
-
-// -----------------------------------------------------------------------------
-static size_t max_pool_layer_output_size(const max_pool_layer_t* self) 
-{ 
-    return sqrt(matrix_size(self->output)); 
+static size_t max_pool_layer_input_size(const max_pool_layer_t* self)
+{
+    return matrix_rows(self->input);
 }
 
 // -----------------------------------------------------------------------------
-static size_t max_pool_layer_pool_size(const max_pool_layer_t* self) 
-{ 
-    return max_pool_layer_input_size(self) / max_pool_layer_output_size(self);
+static size_t max_pool_layer_output_size(const max_pool_layer_t* self)
+{
+    return matrix_rows(self->output);
 }
 
 // -----------------------------------------------------------------------------
-static void max_pool_layer_copy_input(max_pool_layer_t* self, const matrix_t* input)
+static size_t max_pool_layer_pool_size(const max_pool_layer_t* self)
 {
-    const size_t input_size = max_pool_layer_input_size(self);
-    const double* source    = matrix_data_const(input);
-    double* copy            = matrix_data(self->input);
-
-    for (size_t i = 0U; i < input_size; ++i)
-    {
-        for (size_t j = 0U; j < input_size; ++j)
-        {
-            copy[i * input_size + j] = source[i * input_size + j];
-        }
-    }
+    return max_pool_layer_input_size(self) / max_pool_layer_output_size(self);
 }
 
 // -----------------------------------------------------------------------------
@@ -73,9 +56,9 @@ max_pool_layer_t* max_pool_layer_new(const size_t input_size, const size_t pool_
     const size_t output_size = input_size / pool_size;
 
     // Initialize the member variables.
-    self->input           = matrix_new(input_size * input_size);
-    self->input_gradients = matrix_new(input_size * input_size);
-    self->output          = matrix_new(output_size * output_size);
+    self->input           = matrix_new(input_size, input_size);
+    self->input_gradients = matrix_new(input_size, input_size);
+    self->output          = matrix_new(output_size, output_size);
 
     // Check whether the member variables were initialize correctly, return null on failure.
     if ((NULL == self->input) || (NULL == self->input_gradients) || (NULL == self->output))
@@ -119,39 +102,38 @@ bool max_pool_layer_feedforward(max_pool_layer_t* self, const matrix_t* input)
 {
     // Check the input parameters, return false on failure.
     if ((NULL == self) || (NULL == input)) { return false; }
-    if ((matrix_size(input) != matrix_size(self->input))) { return false; }
 
-    const size_t input_size  = max_pool_layer_input_size(self);
+    // Save the input for future backpropagation, return false if the shape doesn't match.
+    if (!matrix_assign(self->input, input)) { return false; }
+
     const size_t output_size = max_pool_layer_output_size(self);
     const size_t pool_size   = max_pool_layer_pool_size(self);
 
-    const double* indata = matrix_data_const(input);
-    double* output       = matrix_data(self->output);
-
     // Perform feedforward - extract the max value of each region.
     for (size_t i = 0U; i < output_size; ++i)
     {
+        double* output = matrix_row(self->output, i);
+
         for (size_t j = 0U; j < output_size; ++j)
         {
             const size_t row = i * pool_size;
             const size_t col = j * pool_size;
-            double max_val   = indata[row * input_size + col];
+            double max_val   = matrix_row_const(self->input, row)[col];
 
             // Find the max value of each region.
             for (size_t pi = 0U; pi < pool_size; ++pi)
             {
+                const double* input_row = matrix_row_const(self->input, row + pi) + col;
+
                 for (size_t pj = 0U; pj < pool_size; ++pj)
                 {
-                    const size_t input_idx = (row + pi) * input_size + (col + pj); 
-                    const double val = indata[input_idx];
-                    if (val > max_val) { max_val = val; }
+                    if (input_row[pj] > max_val) { max_val = input_row[pj]; }
                 }
             }
-            output[i * output_size + j] = max_val;
+            output[j] = max_val;
         }
     }
-    // Save the input for future backpropagation, then return true to indicate success.
-    max_pool_layer_copy_input(self, input);
+    // Return true to indicate success.
     return true;
 }
 
@@ -160,27 +142,24 @@ bool max_pool_layer_backpropagate(max_pool_layer_t* self, const matrix_t* output
 {
     // Check the input parameters, return false on failure.
     if ((NULL == self) || (NULL == output_gradients)) { return false; }
-    if (matrix_size(output_gradients) != matrix_size(self->output)) { return false; }
-
-    // Reinitialize gradients with zeros.
-    matrix_init(self->input_gradients);
 
-    const size_t input_size  = max_pool_layer_input_size(self);
     const size_t output_size = max_pool_layer_output_size(self);
     const size_t pool_size   = max_pool_layer_pool_size(self);
+    if (!matrix_has_shape(output_gradients, output_size, output_size)) { return false; }
 
-    const double* gradients = matrix_data_const(output_gradients);
-    const double* input     = matrix_data_const(self->input);
-    const double* output    = matrix_data_const(self->output);
-    double* input_gradients = matrix_data(self->input_gradients);
+    // Reinitialize gradients with zeros.
+    matrix_init(self->input_gradients);
 
     // Perform backpropagation - feed back the gradient to the max values.
     for (size_t i = 0U; i < output_size; ++i)
     {
+        const double* output    = matrix_row_const(self->output, i);
+        const double* gradients = matrix_row_const(output_gradients, i);
+
         for (size_t j = 0U; j < output_size; ++j)
         {
             // Find the first position of the max value in the input.
-            const double max_val = output[i * output_size + j];
+            const double max_val = output[j];
             const size_t row     = i * pool_size;
             const size_t col     = j * pool_size;
 
@@ -190,12 +169,11 @@ bool max_pool_layer_backpropagate(max_pool_layer_t* self, const matrix_t* output
             
             for (size_t pi = 0U; pi < pool_size; ++pi)
             {
+                const double* input_row = matrix_row_const(self->input, row + pi) + col;
+
                 for (size_t pj = 0U; pj < pool_size; ++pj)
                 {
-                    const size_t input_idx = (row + pi) * input_size + (col + pj);
-                    const double val       = input[input_idx];
-
-                    if (!found && (val == max_val))
+                    if (!found && (input_row[pj] == max_val))
                     {
                         max_row = row + pi;
                         max_col = col + pj;
@@ -205,7 +183,7 @@ bool max_pool_layer_backpropagate(max_pool_layer_t* self, const matrix_t* output
                 if (found) { break; }
             }
             // Feed back the gradient to the max position only.
-            input_gradients[max_row * input_size + max_col] = gradients[i * output_size + j];
+            matrix_row(self->input_gradients, max_row)[max_col] = gradients[j];
         }
     }        
     // Return true to indicate success.
@@ -1,177 +1,160 @@
 /**
  * @brief Simple max pooling layer demo.
  */
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
 #include <iomanip>
 #include <iostream>
 #include <stdexcept>
 #include <vector>
 
-namespace
-{
-/** One-dimensional matrix. */
-using Matrix1d = std::vector<double>;
-
-/** Two-dimensional matrix. */
-using Matrix2d = std::vector<Matrix1d>;
+#include "ml/tensor.h"
 
-/**
- * @brief Initialize matrix with zeros.
- * 
- * @param[in] matrix The matrix to initialize.
- */
-void initMatrix(Matrix2d& matrix) noexcept
-{
-    // Fill the matrix with zeros.
-    for (auto& row : matrix)
-    {
-        for (auto& num : row) { num = 0.0; }
-    }
-}
-
-/**
- * @brief Initialize matrix with zeros.
- * 
- * @param[in] matrix The matrix to initialize.
- * @param[in] size The desired size of the matrix.
- */
-void initMatrix(Matrix2d& matrix, const std::size_t size)
+namespace
 {
-    // Resize the matrix if necessary, then fill the matrix with zeros.
-    matrix.resize(size, Matrix1d(size));
-    initMatrix(matrix);
-}
-
 /**
- * @brief Check whether given matrix is square.
+ * @brief Create a single-channel image holding the given values.
  * 
- * @param[in] matrix The matrix to check.
+ * @param[in] height The height of the image.
+ * @param[in] width The width of the image.
+ * @param[in] values The values of the image, stored row by row.
  * 
- * @return True if the matrix is square, false otherwise.
+ * @return Tensor holding the image.
  */
-bool isMatrixSquare(const Matrix2d& matrix) noexcept
+ml::Tensor createImage(const std::size_t height, const std::size_t width,
+                       const std::initializer_list<double> values)
 {
-    // Check the matrix row by row.
-    for (const auto& row: matrix)
-    {
-        // Return false if the matrix isn't square.
-        if (row.size() != matrix.size()) { return false; }
-    }
-    // Return true to indicate that the matrix is square.
-    return true;
+    ml::Tensor image{1U, 1U, height, width};
+    std::copy_n(values.begin(), std::min(values.size(), image.size()), image.data());
+    return image;
 }
 
 /**
- * @brief Print the contents of given matrix.
+ * @brief Print the contents of given tensor, one matrix per image and channel.
  * 
- * @param[in] matrix The matrix to print.
+ * @param[in] tensor The tensor to print.
  * @param[in] precision Decimal precision (default = 1).
  * @param[in] ostream Output stream (default = terminal print).
  */
-void printMatrix(const Matrix2d& matrix, const std::size_t precision = 1U,
+void printTensor(const ml::Tensor& tensor, const std::size_t precision = 1U,
                  std::ostream& ostream = std::cout) noexcept
 {
     // Set the decimal precision.
     ostream << std::fixed << std::setprecision(precision);
 
-    // Print the matrix contents row by row.
-    for (const auto& row : matrix)
+    // Print each feature map row by row.
+    for (std::size_t n{}; n < tensor.batchCount(); ++n)
     {
-        const auto* lastNum{row.empty() ? nullptr : &row[row.size() - 1U]};
-        ostream << "\t";
-
-        // Separate each number in the row with a comma.
-        for (const auto& num : row)
+        for (std::size_t c{}; c < tensor.channelCount(); ++c)
         {
-            ostream << num;
-            if (&num < lastNum) { ostream << ", "; }
+            for (std::size_t i{}; i < tensor.height(); ++i)
+            {
+                ostream << "\t";
+
+                // Separate each number in the row with a comma.
+                for (std::size_t j{}; j < tensor.width(); ++j)
+                {
+                    ostream << tensor(n, c, i, j);
+                    if (j + 1U < tensor.width()) { ostream << ", "; }
+                }
+                ostream << "\n";
+            }
+            ostream << "\n";
         }
-        ostream << "\n";
     }
-    ostream << "\n";
 }
+} // namespace
 
 namespace ml
 {
 /**
  * @brief Max pooling layer structure.
  * 
- * @todo Implement this structure!
+ *        The layer pools each channel of each image separately. The data is stored in tensors
+ *        (NCHW layout), so the input doesn't have to be square and the dimensions of each
+ *        argument are checked in constant time.
+ * 
+ *        Instead of a copy of the input, the position of the max value within each pool is
+ *        stored (one byte per output value), so the backpropagation scatters each output
+ *        gradient directly to its position without searching the pool again.
  */
 struct MaxPoolLayer final
 {
     /**
      * @brief Constructor.
      * 
-     * @param[in] inputSize Input size. Must be greater than 0.
-     * @param[in] poolSize Pool size. Must divide the input size.
+     * @param[in] channelCount The number of channels per image. Must be greater than 0.
+     * @param[in] inputHeight Input height. Must be greater than 0.
+     * @param[in] inputWidth Input width. Must be greater than 0.
+     * @param[in] poolSize Pool size. Must divide the input height and width and not exceed 16.
+     * @param[in] batchCount The number of images per batch (default = 1).
      */
-    explicit MaxPoolLayer(const std::size_t inputSize, const std::size_t poolSize)
-        : input{}
-        , inputGradients{}
-        , output{}
-    {
-        // Check the input arguments, throw an exception if invalid.
-        if ((0U == inputSize) || (0U == poolSize) || (0U != (inputSize % poolSize)))
-        {
-            throw std::invalid_argument(
-                "Cannot create max pooling layer: invalid input arguments!");
-        }
-        
-        // Compute the output size.
-        const std::size_t outputSize{inputSize / poolSize};
-
-        // Initialize the matrices.
-        initMatrix(input, inputSize);
-        initMatrix(inputGradients, inputSize);
-        initMatrix(output, outputSize);
-    }
+    explicit MaxPoolLayer(const std::size_t channelCount, const std::size_t inputHeight,
+                          const std::size_t inputWidth, const std::size_t poolSize,
+                          const std::size_t batchCount = 1U)
+        : inputGradients{batchCount, channelCount, inputHeight, inputWidth}
+        , output{batchCount, channelCount, outputSize(inputHeight, poolSize),
+                 outputSize(inputWidth, poolSize)}
+        , maxIndices(output.size())
+    {}
 
     /**
      * @brief Perform feedforward operation.
      * 
-     * @param[in] input Matrix holding input data.
+     * @param[in] input Tensor holding input data, any layout.
      * 
      * @return True on success, false on failure.
      */
-    bool feedforward(const Matrix2d& input) noexcept
+    bool feedforward(const Tensor& input) noexcept
     {
-        // Check the input matrix, return false on dimension mismatch.
-        if ((input.size() != this->input.size()) || !isMatrixSquare(input)) { return false; }
+        // Check the input tensor, return false on dimension mismatch.
+        if (!input.hasShape(inputGradients)) { return false; }
 
         // Calculate the pool size.
-        const std::size_t poolSize{input.size() / output.size()};
+        const std::size_t poolSize{input.height() / output.height()};
 
-        // Iterate through the image pool by pool, find and store the max value.
-        for (std::size_t i{}; i < output.size(); ++i)
+        // Iterate through each feature map pool by pool, find and store the max value.
+        for (std::size_t n{}; n < output.batchCount(); ++n)
         {
-            for (std::size_t j{}; j < output.size(); ++j)
+            for (std::size_t c{}; c < output.channelCount(); ++c)
             {
-                // Get the input row and column.
-                const std::size_t inRow{i * poolSize};
-                const std::size_t inCol{j * poolSize};
-
-                // Use the first value as max value, compare with the other values in the pool.
-                double maxVal{input[inRow][inCol]};
-
-                // Iterate through the pool.
-                for (std::size_t pi{}; pi < poolSize; ++pi)
+                for (std::size_t i{}; i < output.height(); ++i)
                 {
-                    for (std::size_t pj{}; pj < poolSize; ++pj)
+                    for (std::size_t j{}; j < output.width(); ++j)
                     {
-                        // Get the value at the current cell.
-                        const auto val{input[inRow + pi][inCol + pj]};
+                        // Get the input row and column.
+                        const std::size_t inRow{i * poolSize};
+                        const std::size_t inCol{j * poolSize};
 
-                        // Compare the value with the local max, store the bigger one.
-                        if (val > maxVal) { maxVal = val; }
+                        // Use the first value as max value, compare with the other values.
+                        double maxVal{input(n, c, inRow, inCol)};
+                        std::size_t maxIndex{};
+
+                        // Iterate through the pool.
+                        for (std::size_t pi{}; pi < poolSize; ++pi)
+                        {
+                            for (std::size_t pj{}; pj < poolSize; ++pj)
+                            {
+                                // Get the value at the current cell.
+                                const auto val{input(n, c, inRow + pi, inCol + pj)};
+
+                                // Compare the value with the local max, store the bigger one
+                                // along with its position within the pool.
+                                if (val > maxVal)
+                                {
+                                    maxVal   = val;
+                                    maxIndex = pi * poolSize + pj;
+                                }
+                            }
+                        }
+                        // Store the max value and its position (used for backpropagation).
+                        output(n, c, i, j)                   = maxVal;
+                        maxIndices[output.index(n, c, i, j)] = static_cast<std::uint8_t>(maxIndex);
                     }
                 }
-                // Store the max value in the output matrix.
-                output[i][j] = maxVal;
             }
         }
-        // Store the input for backpropagation.
-        this->input = input;
-
         // Return true to indicate success.
         return true;
     }
@@ -179,84 +162,74 @@ struct MaxPoolLayer final
     /**
      * @brief Perform backpropagation.
      * 
-     * @param[in] outputGradients Matrix holding gradients from the next layer.
+     * @param[in] outputGradients Tensor holding gradients from the next layer, any layout.
      * 
      * @return True on success, false on failure.
      */
-    bool backpropagate(const Matrix2d& outputGradients) noexcept
+    bool backpropagate(const Tensor& outputGradients) noexcept
     {
-        // Check the output gradient matrix, return false on dimension mismatch.
-        if ((outputGradients.size() != output.size()) || !isMatrixSquare(outputGradients))
-        {
-            return false;
-        }
+        // Check the output gradient tensor, return false on dimension mismatch.
+        if (!outputGradients.hasShape(output)) { return false; }
 
         // Calculate the pool size.
-        const std::size_t poolSize{input.size() / output.size()};
+        const std::size_t poolSize{inputGradients.height() / output.height()};
+
+        // Reinitialize input gradients with zeros (remove leftovers from previous backpropagation).
+        inputGradients.fill();
 
-        // Reinitialize input matrix with zeros (remove leftovers from previous backpropagation).
-        initMatrix(inputGradients);
-        
-        // Locate the max value coordinates (row, col) and place the gradients there.
-        for (std::size_t i{}; i < output.size(); ++i)
+        // Write each output gradient to the position of the max value stored during feedforward.
+        for (std::size_t n{}; n < output.batchCount(); ++n)
         {
-            for (std::size_t j{}; j < output.size(); ++j)
+            for (std::size_t c{}; c < output.channelCount(); ++c)
             {
-                // Compute the input row and column.
-                const std::size_t inRow{i * poolSize};
-                const std::size_t inCol{j * poolSize};
-
-                // Get the max value for comparison.
-                const auto maxVal{output[i][j]};
-
-                // Variables holding the max coordinates (start with the first call of the pool).
-                std::size_t maxRow{inRow};
-                std::size_t maxCol{inCol};
-
-                // Indicate whether the max value has been found.
-                bool found{false};
-
-                for (std::size_t pi{}; pi < poolSize; ++pi)
+                for (std::size_t i{}; i < output.height(); ++i)
                 {
-                    for (std::size_t pj{}; pj < poolSize; ++pj)
+                    for (std::size_t j{}; j < output.width(); ++j)
                     {
-                        // Get the value of the current cell.
-                        const auto val{input[inRow + pi][inCol + pj]};
-
-                        // If this is the max value, store the coordinates.
-                        if (val == maxVal)
-                        {
-                            // Store the coordinates of the max value.
-                            maxRow = inRow + pi;
-                            maxCol = inCol + pj;
-
-                            // Indicate that the value has been found and break the 'pj' loop.
-                            found = true;
-                            break;
-                        }
+                        const std::size_t maxIndex{maxIndices[output.index(n, c, i, j)]};
+                        const std::size_t maxRow{i * poolSize + maxIndex / poolSize};
+                        const std::size_t maxCol{j * poolSize + maxIndex % poolSize};
+                        inputGradients(n, c, maxRow, maxCol) = outputGradients(n, c, i, j);
                     }
-                    // Break the 'pi' loop if the max value has been found.
-                    if (found) { break; }
                 }
-                // Write the output gradient to the max value position.
-                inputGradients[maxRow][maxCol] = outputGradients[i][j];
             }
         }
         // Return true to indicate success.
         return true;
     }
 
-    /** Input matrix. */
-    Matrix2d input;
+    /** Input gradient tensor. */
+    Tensor inputGradients;
 
-    /** Input gradient matrix. */
-    Matrix2d inputGradients;
+    /** Output tensor. */
+    Tensor output;
 
-    /** Output matrix. */
-    Matrix2d output;
+    /** Position of the max value within each pool (pi * poolSize + pj), one per output value. */
+    std::vector<std::uint8_t> maxIndices;
+
+private:
+    /**
+     * @brief Compute the output size of given dimension.
+     * 
+     * @param[in] inputSize Input size of the dimension. Must be greater than 0.
+     * @param[in] poolSize Pool size. Must divide the input size and not exceed 16 (so that each
+     *                     position within a pool fits in one byte).
+     * 
+     * @return The output size.
+     */
+    static std::size_t outputSize(const std::size_t inputSize, const std::size_t poolSize)
+    {
+        // Check the input arguments, throw an exception if invalid.
+        if ((0U == inputSize) || (0U == poolSize) || (16U < poolSize) ||
+            (0U != (inputSize % poolSize)))
+        {
+            throw std::invalid_argument(
+                "Cannot create max pooling layer: invalid input arguments!");
+        }
+        return inputSize / poolSize;
+    }
 };
 } // namespace ml
-} // namespace 
 
 /**
  * @brief Create and demonstrate a simple max pooling layer.
@@ -264,38 +237,65 @@ struct MaxPoolLayer final
  * @return 0 on success, -1 on failure.
  */
 int main()
-{   
-    // Example 4x4 input matrix (could represent an image or feature map).
-    const Matrix2d input{{2, 1, 6, 1},
-                         {3, 0, 4, 6},
-                         {1, 2, 4, 5},
-                         {3, 4, 7, 7}};
-        
+{
+    // Example 4x4 input (could represent an image or feature map).
+    const auto input{createImage(4U, 4U, {2, 1, 6, 1,
+                                          3, 0, 4, 6,
+                                          1, 2, 4, 5,
+                                          3, 4, 7, 7})};
+
     // Example output gradients (same shape as pooling output, used for backpropagation demo).
-    const Matrix2d outputGradients{{1, 2},
-                                   {3, 4}};
+    const auto outputGradients{createImage(2U, 2U, {1, 2,
+                                                    3, 4})};
+
+    // Create a max pooling layer: one channel, 4x4 input, 2x2 pooling regions, 2x2 output.
+    ml::MaxPoolLayer poolLayer{1U, 4U, 4U, 2U};
 
-    // Create a max pooling layer: 4x4 input, 2x2 pooling regions, produces 2x2 output.
-    constexpr std::size_t inputSize{4U};
-    constexpr std::size_t poolSize{2U};
-    ml::MaxPoolLayer poolLayer{inputSize, poolSize};
-    
-    // Show the input matrix.
+    // Show the input.
     std::cout << "Pooling input data (2D):\n";
-    printMatrix(input);
+    printTensor(input);
 
     // Perform feedforward (pooling).
     poolLayer.feedforward(input);
     std::cout << "Pooled output (2D):\n";
-    printMatrix(poolLayer.output);
+    printTensor(poolLayer.output);
+
+    // Show the position of the max value within each pool.
+    std::cout << "Max value positions within each pool (row * 2 + col):\n";
+    for (std::size_t i{}; i < poolLayer.output.height(); ++i)
+    {
+        std::cout << "\t";
+        for (std::size_t j{}; j < poolLayer.output.width(); ++j)
+        {
+            std::cout << static_cast<unsigned>(
+                poolLayer.maxIndices[poolLayer.output.index(0U, 0U, i, j)]);
+            if (j + 1U < poolLayer.output.width()) { std::cout << ", "; }
+        }
+        std::cout << "\n";
+    }
+    std::cout << "\n";
 
     // Show the output gradients.
     std::cout << "Pooling output gradients (2D):\n";
-    printMatrix(outputGradients);
+    printTensor(outputGradients);
 
     // Perform backpropagation.
     poolLayer.backpropagate(outputGradients);
     std::cout << "Input gradients after backpropagation (2D):\n";
-    printMatrix(poolLayer.inputGradients);
+    printTensor(poolLayer.inputGradients);
+
+    // Pool a non-square input with two channels: 2 x 2x6 input, 2x2 pooling regions.
+    ml::Tensor channelInput{1U, 2U, 2U, 6U};
+    for (std::size_t k{}; k < channelInput.size(); ++k)
+    {
+        channelInput.data()[k] = static_cast<double>((k * 5U) % 17U);
+    }
+    ml::MaxPoolLayer channelLayer{2U, 2U, 6U, 2U};
+    channelLayer.feedforward(channelInput);
+
+    std::cout << "Pooling input data (2 channels, 2x6):\n";
+    printTensor(channelInput);
+    std::cout << "Pooled output (2 channels, 1x3):\n";
+    printTensor(channelLayer.output);
     return 0;
 }
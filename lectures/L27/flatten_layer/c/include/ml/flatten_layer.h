@@ -36,7 +36,7 @@ void flatten_layer_del(flatten_layer_t** self);
  * 
  * @param[in] self Pointer to the flatten layer.
  * 
- * @return Pointer to matrix holding the flatten layer output.
+ * @return Pointer to matrix holding the flatten layer output (a single row).
  */
 const matrix_t* flatten_layer_output(const flatten_layer_t* self);
 
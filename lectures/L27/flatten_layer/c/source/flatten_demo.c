@@ -21,11 +21,11 @@ int main(void)
         {1, 2, 4, 5},
         {3, 4, 7, 7},
     };
-    matrix_t* input = matrix_copy(input_data, sizeof(input_data));
+    matrix_t* input = matrix_copy(input_data, INPUT_SIZE, INPUT_SIZE);
 
     // Example output gradients (same shape as flattened output, used for backpropagation demo).
     const double gradients[OUTPUT_SIZE] = {1, 2, 3, 4, 8, 7, 6, 5, 0, 2, 4, 8, 9, 7, 5, 3};
-    matrix_t* output_gradients = matrix_copy(gradients, sizeof(gradients));
+    matrix_t* output_gradients = matrix_copy(gradients, 1U, OUTPUT_SIZE);
 
     // Create a flatten layer: 4x4 input, produces 1x16 output.
     flatten_layer_t* flatten_layer = flatten_layer_new(INPUT_SIZE);
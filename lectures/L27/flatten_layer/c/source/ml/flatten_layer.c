@@ -1,9 +1,9 @@
 /**
  * @brief Flatten layer implementation details.
  */
-#include <math.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "ml/flatten_layer.h"
 #include "ml/matrix.h"
@@ -21,9 +21,9 @@ typedef struct flatten_layer
 } flatten_layer_t;
 
 // -----------------------------------------------------------------------------
-static size_t flatten_layer_input_size(const flatten_layer_t* self) 
-{ 
-    return sqrt(matrix_size(self->input_gradients)); 
+static size_t flatten_layer_input_size(const flatten_layer_t* self)
+{
+    return matrix_rows(self->input_gradients);
 }
 
 // -----------------------------------------------------------------------------
@@ -37,8 +37,8 @@ flatten_layer_t* flatten_layer_new(const size_t input_size)
     if (NULL == self) { return false; }
 
     // Initialize the member variables.
-    self->input_gradients = matrix_new(input_size * input_size);
-    self->output          = matrix_new(input_size * input_size);
+    self->input_gradients = matrix_new(input_size, input_size);
+    self->output          = matrix_new(1U, input_size * input_size);
 
     // Check whether the member variables were initialize correctly, return null on failure.
     if ((NULL == self->input_gradients) || (NULL == self->output))
@@ -81,21 +81,17 @@ bool flatten_layer_feedforward(flatten_layer_t* self, const matrix_t* input)
 {
     // Check the input parameters, return false on failure.
     if ((NULL == self) || (NULL == input)) { return false; }
-    if (matrix_size(input) != matrix_size(self->input_gradients)) { return false; }
 
-    // Note: Flattening is merely simulated here, since the matrix structure is one-dimensional.
-    // We pretend that the input is two-dimensional anyway.
     const size_t input_size = flatten_layer_input_size(self);
-    const double* indata    = matrix_data_const(input);
-    double* output          = matrix_data(self->output);
+    if (!matrix_has_shape(input, input_size, input_size)) { return false; }
+
+    // Perform feedforward - flatten the input by copying each row (without the row padding)
+    // into the single output row.
+    double* output = matrix_row(self->output, 0U);
 
-    // Perform feedforward - flatten the input.
     for (size_t i = 0U; i < input_size; ++i)
     {
-        for (size_t j = 0U; j < input_size; ++j)
-        {
-            output[i * input_size + j] = indata[i * input_size + j];
-        }
+        memcpy(output + i * input_size, matrix_row_const(input, i), sizeof(double) * input_size);
     }
     // Return true to indicate success.
     return true;
@@ -106,21 +102,19 @@ bool flatten_layer_backpropagate(flatten_layer_t* self, const matrix_t* output_g
 {
     // Check the input parameters, return false on failure.
     if ((NULL == self) || (NULL == output_gradients)) { return false; }
-    if (matrix_size(output_gradients) != matrix_size(self->output)) { return false; }
 
-    // Note: Unflattening is merely simulated here, since the matrix structure is one-dimensional.
     const size_t input_size = flatten_layer_input_size(self);
-    const double* gradients = matrix_data_const(output_gradients);
-    double* input_gradients = matrix_data(self->input_gradients);
+    if (!matrix_has_shape(output_gradients, 1U, input_size * input_size)) { return false; }
+
+    // Perform backpropagation - unflatten the gradients by splitting the single row into the
+    // rows of the input gradients.
+    const double* gradients = matrix_row_const(output_gradients, 0U);
 
-    // Perform backpropagation - feed back the gradient to the max values.
     for (size_t i = 0U; i < input_size; ++i)
     {
-        for (size_t j = 0U; j < input_size; ++j)
-        {
-            input_gradients[i * input_size + j] = gradients[i * input_size + j];
-        }
-    }        
+        memcpy(matrix_row(self->input_gradients, i), gradients + i * input_size,
+               sizeof(double) * input_size);
+    }
     // Return true to indicate success.
     return true;
 }
@@ -0,0 +1,334 @@
+/** 
+ * @brief Training of a small convolutional neural network.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "ml/cnn.h"
+#include "ml/conv_layer.h"
+#include "ml/quantized_conv_layer.h"
+#include "ml/tensor.h"
+
+namespace
+{
+/** The number of memory allocations performed by the program. */
+std::size_t allocationCount{};
+
+/** The number of classes (horizontal, vertical and diagonal lines). */
+constexpr std::size_t ClassCount{3U};
+
+/**
+ * @brief Generate images holding a line at a random position plus noise.
+ * 
+ * @param[in] sampleCount The number of images to generate.
+ * @param[in] imageSize The height and width of each image.
+ * @param[out] inputs Vector to store the images in.
+ * @param[out] references Vector to store the one-hot encoded class of each image in.
+ * @param[in] generator Random generator to use.
+ */
+void generateImages(const std::size_t sampleCount, const std::size_t imageSize,
+                    std::vector<ml::Tensor>& inputs, std::vector<std::vector<double>>& references,
+                    std::mt19937& generator)
+{
+    std::uniform_real_distribution<double> noise{0.0, 0.3};
+    std::uniform_int_distribution<std::size_t> position{0U, imageSize - 1U};
+
+    for (std::size_t k{}; k < sampleCount; ++k)
+    {
+        const auto line{k % ClassCount};
+        const auto offset{position(generator)};
+        ml::Tensor image{1U, 1U, imageSize, imageSize};
+
+        for (std::size_t i{}; i < imageSize; ++i)
+        {
+            for (std::size_t j{}; j < imageSize; ++j)
+            {
+                // Class 0: horizontal line, class 1: vertical line, class 2: diagonal line.
+                const auto onLine{0U == line   ? i == offset
+                                  : 1U == line ? j == offset
+                                               : (i + offset) % imageSize == j};
+                image(0U, 0U, i, j) = (onLine ? 1.0 : 0.0) + noise(generator);
+            }
+        }
+        inputs.push_back(image);
+        references.push_back(std::vector<double>(ClassCount, 0.0));
+        references.back()[line] = 1.0;
+    }
+}
+
+/**
+ * @brief Compute the share of images the network classifies correctly.
+ * 
+ * @param[in] network The network to use.
+ * @param[in] inputs The images to classify.
+ * @param[in] references The one-hot encoded class of each image.
+ * 
+ * @return The accuracy in percent.
+ */
+double accuracy(ml::Cnn& network, const std::vector<ml::Tensor>& inputs,
+                const std::vector<std::vector<double>>& references)
+{
+    std::size_t correctCount{};
+
+    for (std::size_t k{}; k < inputs.size(); ++k)
+    {
+        network.feedforward(inputs[k]);
+        const auto& output{network.output()};
+        const auto predicted{std::max_element(output.begin(), output.end()) - output.begin()};
+        if (1.0 == references[k][static_cast<std::size_t>(predicted)]) { ++correctCount; }
+    }
+    return 100.0 * correctCount / inputs.size();
+}
+/**
+ * @brief Get the largest magnitude of the values of the given tensor.
+ * 
+ * @param[in] tensor The tensor holding the values.
+ * 
+ * @return The largest magnitude.
+ */
+double maxMagnitude(const ml::Tensor& tensor) noexcept
+{
+    double result{};
+    for (std::size_t k{}; k < tensor.size(); ++k)
+    {
+        result = std::max(result, std::abs(tensor.data()[k]));
+    }
+    return result;
+}
+
+/**
+ * @brief Add the errors of the dequantized output of a quantized layer.
+ * 
+ * @param[in] reference The output of the double layer.
+ * @param[in] quantized The quantized layer.
+ * @param[out] dequantized Tensor to store the dequantized output in, same shape as the reference.
+ * @param[in,out] maxError The max error to update.
+ * @param[in,out] errorSum The sum of the errors to update.
+ */
+void addQuantizationErrors(const ml::Tensor& reference, const ml::QuantizedConvLayer& quantized,
+                           ml::Tensor& dequantized, double& maxError, double& errorSum) noexcept
+{
+    quantized.dequantizeOutput(dequantized);
+
+    for (std::size_t k{}; k < reference.size(); ++k)
+    {
+        const auto error{std::abs(dequantized.data()[k] - reference.data()[k])};
+        maxError = std::max(maxError, error);
+        errorSum += error;
+    }
+}
+
+/**
+ * @brief Get the median time of five runs of the given function.
+ * 
+ * @param[in] function The function to run.
+ * 
+ * @return The median time in milliseconds.
+ */
+template <typename Function>
+double medianTime(Function&& function)
+{
+    std::vector<double> times{};
+
+    for (std::size_t run{}; run < 5U; ++run)
+    {
+        const auto start{std::chrono::steady_clock::now()};
+        function();
+        const std::chrono::duration<double, std::milli> duration{
+            std::chrono::steady_clock::now() - start};
+        times.push_back(duration.count());
+    }
+    std::nth_element(times.begin(), times.begin() + 2U, times.end());
+    return times[2U];
+}
+
+/**
+ * @brief Compare the int8 quantized convolution with the double one on a larger layer.
+ * 
+ *        The layer is initialized randomly and the input holds random values in [0.0, 1.0].
+ *        The output scale is calibrated on the same input.
+ * 
+ * @param[in] channelCount The number of input channels.
+ * @param[in] filterCount The number of filters.
+ * @param[in] inputSize The height and width of the input.
+ * @param[in] kernelSize The kernel size.
+ */
+void compareQuantized(const std::size_t channelCount, const std::size_t filterCount,
+                      const std::size_t inputSize, const std::size_t kernelSize)
+{
+    std::mt19937 generator{2025U};
+    std::uniform_real_distribution<double> distribution{0.0, 1.0};
+    ml::Tensor input{1U, channelCount, inputSize, inputSize};
+    for (std::size_t k{}; k < input.size(); ++k) { input.data()[k] = distribution(generator); }
+
+    ml::ConvLayer layer{channelCount, filterCount, inputSize, inputSize, kernelSize};
+    layer.feedforward(input);
+    ml::QuantizedConvLayer quantized{layer, 1.0 / 127.0, maxMagnitude(layer.output()) / 127.0};
+
+    const auto doubleTime{medianTime([&]() { layer.feedforward(input); })};
+    const auto quantizedTime{medianTime([&]() { quantized.feedforward(input); })};
+
+    ml::Tensor dequantized{layer.output()};
+    double maxError{}, errorSum{};
+    addQuantizationErrors(layer.output(), quantized, dequantized, maxError, errorSum);
+
+    std::cout << std::fixed << std::setprecision(2) << "\t" << channelCount << " x " << inputSize
+              << "x" << inputSize << " input, " << filterCount << " filters " << kernelSize << "x"
+              << kernelSize << ": double " << doubleTime << " ms, int8 " << quantizedTime
+              << " ms (speedup " << doubleTime / quantizedTime << "x), max error "
+              << 100.0 * maxError / maxMagnitude(layer.output()) << " %, mean error "
+              << 100.0 * errorSum / layer.output().size() / maxMagnitude(layer.output())
+              << " % of the output range\n";
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+void* operator new(const std::size_t size)
+{
+    // Count each allocation to verify that no memory is allocated during training.
+    ++allocationCount;
+    if (auto* block{std::malloc(0U < size ? size : 1U)}) { return block; }
+    throw std::bad_alloc{};
+}
+
+// -----------------------------------------------------------------------------
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+    // Count each aligned allocation (used by the tensors), round the size to the alignment.
+    ++allocationCount;
+    const auto align{static_cast<std::size_t>(alignment)};
+    const auto alignedSize{(0U < size ? size + align - 1U : align) / align * align};
+    if (auto* block{std::aligned_alloc(align, alignedSize)}) { return block; }
+    throw std::bad_alloc{};
+}
+
+// -----------------------------------------------------------------------------
+void operator delete(void* block) noexcept
+{
+    // Both replaced operator new allocate via the C library, so all four operator delete
+    // overloads (plain, sized, aligned, sized aligned) are replaced to release via free.
+    std::free(block);
+}
+
+// -----------------------------------------------------------------------------
+void operator delete(void* block, std::size_t) noexcept { std::free(block); }
+
+// -----------------------------------------------------------------------------
+void operator delete(void* block, std::align_val_t) noexcept { std::free(block); }
+
+// -----------------------------------------------------------------------------
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+
+/**
+ * @brief Train a CNN to classify images of lines.
+ * 
+ * @return 0 on success, -1 on failure.
+ */
+int main()
+{
+    // Network parameters: 8x8 input, 4 filters of size 3x3, 2x2 pooling and 3 classes.
+    constexpr std::size_t imageSize{8U};
+    constexpr std::size_t filterCount{4U};
+    constexpr std::size_t kernelSize{3U};
+    constexpr std::size_t poolSize{2U};
+
+    // Training parameters.
+    constexpr std::size_t trainCount{150U};
+    constexpr std::size_t testCount{60U};
+    constexpr std::size_t epochCount{20U};
+    constexpr double learningRate{0.05};
+
+    std::mt19937 generator{2025U};
+    std::vector<ml::Tensor> trainInputs{}, testInputs{};
+    std::vector<std::vector<double>> trainReferences{}, testReferences{};
+    generateImages(trainCount, imageSize, trainInputs, trainReferences, generator);
+    generateImages(testCount, imageSize, testInputs, testReferences, generator);
+
+    ml::Cnn network{1U, imageSize, imageSize, filterCount, kernelSize, poolSize, ClassCount};
+    const auto& pooled{network.poolLayer().output()};
+
+    std::cout << "Training a CNN to classify " << imageSize << "x" << imageSize
+              << " images of horizontal, vertical and diagonal lines:\n";
+    std::cout << "\tconv:        1 x " << imageSize << "x" << imageSize << " => " << filterCount
+              << " x " << imageSize << "x" << imageSize << " (" << kernelSize << "x"
+              << kernelSize << " kernels, ReLU)\n";
+    std::cout << "\tmax pooling: " << filterCount << " x " << imageSize << "x" << imageSize
+              << " => " << filterCount << " x " << pooled.height() << "x" << pooled.width()
+              << "\n";
+    std::cout << "\tflatten:     " << filterCount << " x " << pooled.height() << "x"
+              << pooled.width() << " => " << network.flattenLayer().size()
+              << " (view of the pooled output: "
+              << (network.flattenLayer().data() == pooled.data() ? "yes" : "no") << ")\n";
+    std::cout << "\tdense:       " << network.flattenLayer().size() << " => " << ClassCount
+              << " (tanh)\n\n";
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Epoch 0: training accuracy " << accuracy(network, trainInputs, trainReferences)
+              << " %, test accuracy " << accuracy(network, testInputs, testReferences) << " %\n";
+
+    // Train one epoch at a time, count the allocations after the first epoch (which creates the
+    // sample order of the network).
+    std::size_t trainingAllocations{};
+
+    for (std::size_t epoch{1U}; epoch <= epochCount; ++epoch)
+    {
+        const auto allocationsBefore{allocationCount};
+
+        if (!network.train(trainInputs, trainReferences, 1U, learningRate))
+        {
+            std::cout << "Training failed!\n";
+            return -1;
+        }
+        if (1U < epoch) { trainingAllocations += allocationCount - allocationsBefore; }
+
+        if (0U == epoch % 5U)
+        {
+            std::cout << "Epoch " << epoch << ": training accuracy "
+                      << accuracy(network, trainInputs, trainReferences) << " %, test accuracy "
+                      << accuracy(network, testInputs, testReferences) << " %\n";
+        }
+    }
+    std::cout << "\nMemory allocations during epochs 2-" << epochCount << " ("
+              << (epochCount - 1U) * trainCount << " samples): " << trainingAllocations << "\n";
+
+    // Quantize the trained conv layer to int8, with the input and output scales calibrated on
+    // the training images.
+    double inputMax{}, outputMax{};
+
+    for (const auto& input : trainInputs)
+    {
+        network.feedforward(input);
+        inputMax  = std::max(inputMax, maxMagnitude(input));
+        outputMax = std::max(outputMax, maxMagnitude(network.convLayer().output()));
+    }
+    ml::QuantizedConvLayer quantized{network.convLayer(), inputMax / 127.0, outputMax / 127.0};
+    ml::Tensor dequantized{network.convLayer().output()};
+    double maxError{}, errorSum{};
+
+    for (const auto& input : testInputs)
+    {
+        network.feedforward(input);
+        quantized.feedforward(input);
+        addQuantizationErrors(network.convLayer().output(), quantized, dequantized, maxError,
+                              errorSum);
+    }
+    const auto valueCount{testInputs.size() * dequantized.size()};
+
+    std::cout << "\nInt8 quantized conv layer (test images, output range " << std::setprecision(2)
+              << outputMax << "): max error " << maxError << " (" << 100.0 * maxError / outputMax
+              << " %), mean error " << std::setprecision(4) << errorSum / valueCount << " ("
+              << 100.0 * errorSum / valueCount / outputMax << " %)\n";
+
+    std::cout << "\nInt8 quantized versus double convolution:\n";
+    compareQuantized(3U, 16U, 112U, 3U);
+    compareQuantized(16U, 32U, 56U, 3U);
+    compareQuantized(8U, 16U, 56U, 5U);
+    return 0;
+}
@@ -1,194 +1,125 @@
 /** 
  * @brief Simple flatten layer demo.
  */
+#include <algorithm>
+#include <initializer_list>
 #include <iomanip>
 #include <iostream>
-#include <stdexcept>
-#include <vector>
 
-namespace
-{
-/** One-dimensional matrix. */
-using Matrix1d = std::vector<double>;
-
-/** Two-dimensional matrix. */
-using Matrix2d = std::vector<Matrix1d>;
-
-/**
- * @brief Initialize matrix with zeros.
- * 
- * @param[in] matrix The matrix to initialize.
- */
-void initMatrix(Matrix1d& matrix) noexcept
-{
-    // Fill the matrix with zeros.
-    for (auto& num : matrix) { num = 0.0; }
-}
-
-/**
- * @brief Initialize matrix with zeros.
- * 
- * @param[in] matrix The matrix to initialize.
- */
-void initMatrix(Matrix2d& matrix) noexcept
-{
-    // Fill the matrix with zeros.
-    for (auto& row : matrix)
-    {
-        for (auto& num : row) { num = 0.0; }
-    }
-}
+#include "ml/tensor.h"
 
-/**
- * @brief Initialize matrix with zeros.
- * 
- * @param[in] matrix The matrix to initialize.
- * @param[in] size The desired size of the matrix.
- */
-void initMatrix(Matrix1d& matrix, const std::size_t size)
-{
-    // Resize the matrix if necessary, then fill the matrix with zeros.
-    matrix.resize(size);
-    initMatrix(matrix);
-}
-
-/**
- * @brief Initialize matrix with zeros.
- * 
- * @param[in] matrix The matrix to initialize.
- * @param[in] size The desired size of the matrix.
- */
-void initMatrix(Matrix2d& matrix, const std::size_t size)
+namespace
 {
-    // Resize the matrix if necessary, then fill the matrix with zeros.
-    matrix.resize(size, Matrix1d(size));
-    initMatrix(matrix);
-}
-
 /**
- * @brief Check whether given matrix is square.
+ * @brief Create a single-channel image holding the given values.
  * 
- * @param[in] matrix The matrix to check.
+ * @param[in] height The height of the image.
+ * @param[in] width The width of the image.
+ * @param[in] values The values of the image, stored row by row.
  * 
- * @return True if the matrix is square, false otherwise.
+ * @return Tensor holding the image.
  */
-bool isMatrixSquare(const Matrix2d& matrix) noexcept
+ml::Tensor createImage(const std::size_t height, const std::size_t width,
+                       const std::initializer_list<double> values)
 {
-    // Check the matrix row by row.
-    for (const auto& row: matrix)
-    {
-        // Return false if the matrix isn't square.
-        if (row.size() != matrix.size()) { return false; }
-    }
-    // Return true to indicate that the matrix is square.
-    return true;
+    ml::Tensor image{1U, 1U, height, width};
+    std::copy_n(values.begin(), std::min(values.size(), image.size()), image.data());
+    return image;
 }
 
 /**
- * @brief Print the contents of given matrix.
+ * @brief Print the contents of given tensor, one matrix per image and channel.
  * 
- * @param[in] matrix The matrix to print.
+ * @param[in] tensor The tensor to print.
  * @param[in] precision Decimal precision (default = 1).
  * @param[in] ostream Output stream (default = terminal print).
  */
-void printMatrix(const Matrix1d& matrix, const std::size_t precision = 1U,
-                 std::ostream& ostream = std::cout) noexcept
-{
-    // Set the decimal precision.
-    ostream << std::fixed << std::setprecision(precision) << "\t";
-
-    const auto* lastNum{matrix.empty() ? nullptr : &matrix[matrix.size() - 1U]};
-
-    // Print the matrix contents on a single row.
-    for (const auto& num : matrix)
-    {
-        // Separate each number in the row with a comma.
-        ostream << num;
-        if (&num < lastNum) { ostream << ", "; }
-    }
-    ostream << "\n";
-}
-
-/**
- * @brief Print the contents of given matrix.
- * 
- * @param[in] matrix The matrix to print.
- * @param[in] precision Decimal precision (default = 1).
- * @param[in] ostream Output stream (default = terminal print).
- */
-void printMatrix(const Matrix2d& matrix, const std::size_t precision = 1U,
+void printTensor(const ml::Tensor& tensor, const std::size_t precision = 1U,
                  std::ostream& ostream = std::cout) noexcept
 {
     // Set the decimal precision.
     ostream << std::fixed << std::setprecision(precision);
 
-    // Print the matrix contents row by row.
-    for (const auto& row : matrix)
+    // Print each feature map row by row.
+    for (std::size_t n{}; n < tensor.batchCount(); ++n)
     {
-        const auto* lastNum{row.empty() ? nullptr : &row[row.size() - 1U]};
-        ostream << "\t";
-
-        // Separate each number in the row with a comma.
-        for (const auto& num : row)
+        for (std::size_t c{}; c < tensor.channelCount(); ++c)
         {
-            ostream << num;
-            if (&num < lastNum) { ostream << ", "; }
+            for (std::size_t i{}; i < tensor.height(); ++i)
+            {
+                ostream << "\t";
+
+                // Separate each number in the row with a comma.
+                for (std::size_t j{}; j < tensor.width(); ++j)
+                {
+                    ostream << tensor(n, c, i, j);
+                    if (j + 1U < tensor.width()) { ostream << ", "; }
+                }
+                ostream << "\n";
+            }
+            ostream << "\n";
         }
-        ostream << "\n";
     }
-    ostream << "\n";
 }
+} // namespace
 
 namespace ml
 {
 /**
  * @brief Flatten layer structure.
  * 
- * @todo Implement this structure!
+ *        The layer flattens each image of a batch, including all of its channels, to a single
+ *        row. The data is stored in tensors (NCHW layout), so the input doesn't have to be square
+ *        and the dimensions of each argument are checked in constant time.
  */
 struct FlattenLayer final
 {
     /**
      * @brief Constructor.
      * 
-     * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] channelCount The number of channels per image. Must be greater than 0.
+     * @param[in] inputHeight Input height. Must be greater than 0.
+     * @param[in] inputWidth Input width. Must be greater than 0.
+     * @param[in] batchCount The number of images per batch (default = 1).
      */
-    explicit FlattenLayer(const std::size_t inputSize)
-        : inputGradients{}
-        , output{}
-    {
-        // Check the input size, throw if invalid.
-        if (0U == inputSize)
-        {
-            throw std::invalid_argument("Cannot create flatten layer: invalid input size!");
-        }
-
-        // Initialize the matrices - set output size to input size ^ 2.
-        initMatrix(inputGradients, inputSize);
-        initMatrix(output, inputSize * inputSize);
-    }
+    explicit FlattenLayer(const std::size_t channelCount, const std::size_t inputHeight,
+                          const std::size_t inputWidth, const std::size_t batchCount = 1U)
+        : inputGradients{batchCount, channelCount, inputHeight, inputWidth}
+        , output{batchCount, 1U, 1U, channelCount * inputHeight * inputWidth}
+    {}
 
     /**
      * @brief Flatten the input from 2D to 1D.
      * 
-     * @param[in] input Matrix holding input data.
+     * @param[in] input Tensor holding input data, any layout.
      * 
      * @return True on success, false on failure.
      */
-    bool feedforward(const Matrix2d& input) noexcept
+    bool feedforward(const Tensor& input) noexcept
     {
-        // Get the input size.
-        const std::size_t inputSize{inputGradients.size()};
+        // Check the input tensor, return false on dimension mismatch.
+        if (!input.hasShape(inputGradients)) { return false; }
 
-        // Check the input matrix, return false on dimension mismatch.
-        if ((input.size() != inputSize) || !isMatrixSquare(input)) { return false; }
+        // In the NCHW layout the values are already stored in flattened order, copy as a block.
+        if (Layout::Nchw == input.layout())
+        {
+            std::copy_n(input.data(), input.size(), output.data());
+            return true;
+        }
 
-        // Flatten the input: [i][j] => [inputSize * i + j].
-        for (std::size_t i{}; i < inputSize; ++i)
+        // Flatten the input otherwise: [c][i][j] => [(c * height + i) * width + j].
+        for (std::size_t n{}; n < input.batchCount(); ++n)
         {
-            for (std::size_t j{}; j < inputSize; ++j)
+            for (std::size_t c{}; c < input.channelCount(); ++c)
             {
-                output[inputSize * i + j] = input[i][j];
+                for (std::size_t i{}; i < input.height(); ++i)
+                {
+                    for (std::size_t j{}; j < input.width(); ++j)
+                    {
+                        const auto index{(c * input.height() + i) * input.width() + j};
+                        output(n, 0U, 0U, index) = input(n, c, i, j);
+                    }
+                }
             }
         }
         // Return true to indicate success.
@@ -198,38 +129,31 @@ struct FlattenLayer final
     /**
      * @brief Unflatten the output gradients from 1D to 2D.
      * 
-     * @param[in] outputGradients Matrix holding output gradients.
+     * @param[in] outputGradients Tensor holding output gradients, any layout.
      * 
      * @return True on success, false on failure.
      */
-    bool backpropagate(const Matrix1d& outputGradients) noexcept
+    bool backpropagate(const Tensor& outputGradients) noexcept
     {
-        // Check the output matrix, return false on dimension mismatch.
-        if (outputGradients.size() != output.size()) { return false; }
+        // Check the output tensor, return false on dimension mismatch.
+        if (!outputGradients.hasShape(output)) { return false; }
 
-        // Get the input size.
-        const std::size_t inputSize{inputGradients.size()};
+        // Unflatten the gradients: [(c * height + i) * width + j] => [c][i][j]. Both tensors
+        // store the values in this order (a single row per image is stored the same way in
+        // both layouts), so they're copied as a single block.
+        std::copy_n(outputGradients.data(), outputGradients.size(), inputGradients.data());
 
-        // Unflatten the input: [inputSize * i + j] => [i][j].
-        for (std::size_t i{}; i < inputSize; ++i)
-        {
-            for (std::size_t j{}; j < inputSize; ++j)
-            {
-                inputGradients[i][j] = outputGradients[inputSize * i + j];
-            }
-        }
         // Return true to indicate success.
         return true;
     }
 
     /** Unflattened input gradients (to pass to the previous layer). */
-    Matrix2d inputGradients;
+    Tensor inputGradients;
 
-    /** Flattened output (to pass to the next layer). */
-    Matrix1d output;
+    /** Flattened output, one row per image (to pass to the next layer). */
+    Tensor output;
 };
 } // namespace ml
-} // namespace 
 
 /**
  * @brief Create and demonstrate a simple flatten layer.
@@ -238,31 +162,45 @@ struct FlattenLayer final
  */
 int main()
 {
-    // Example 4x4 input matrix (could represent an image or feature map).
-    const Matrix2d input{{2, 1, 6, 1},
-                         {3, 0, 4, 6},
-                         {1, 2, 4, 5},
-                         {3, 4, 7, 7}};
+    // Example 4x4 input (could represent an image or feature map).
+    const auto input{createImage(4U, 4U, {2, 1, 6, 1,
+                                          3, 0, 4, 6,
+                                          1, 2, 4, 5,
+                                          3, 4, 7, 7})};
 
     // Example output gradients (same shape as flattened output, used for backpropagation demo).
-    const Matrix1d outputGradients{1, 2, 3, 4, 8, 7, 6, 5, 0, 2, 4, 8, 9, 7, 5, 3};
+    const auto outputGradients{
+        createImage(1U, 16U, {1, 2, 3, 4, 8, 7, 6, 5, 0, 2, 4, 8, 9, 7, 5, 3})};
 
-    // Create a flatten layer: 4x4 input, produces 1x16 output.
-    constexpr std::size_t inputSize{4U};
-    ml::FlattenLayer flattenLayer{inputSize};
+    // Create a flatten layer: one channel, 4x4 input, produces 1x16 output.
+    ml::FlattenLayer flattenLayer{1U, 4U, 4U};
 
     // Perform feedforward (flatten the input), print the result.
     std::cout << "Flattening input data (2D -> 1D):\n";
-    printMatrix(input);
+    printTensor(input);
     flattenLayer.feedforward(input);
     std::cout << "Resulting flattened output (1D):\n";
-    printMatrix(flattenLayer.output);
+    printTensor(flattenLayer.output);
 
     // Perform backpropagation (unflatten the output), print the result.
-    std::cout << "\nApplying backpropagation (1D -> 2D):\n";
-    printMatrix(outputGradients);
+    std::cout << "Applying backpropagation (1D -> 2D):\n";
+    printTensor(outputGradients);
     flattenLayer.backpropagate(outputGradients);
-    std::cout << "\nResulting unflattened input gradients (2D):\n";
-    printMatrix(flattenLayer.inputGradients);
+    std::cout << "Resulting unflattened input gradients (2D):\n";
+    printTensor(flattenLayer.inputGradients);
+
+    // Flatten a non-square input with two channels: 2 x 2x3 input, produces 1x12 output.
+    ml::Tensor channelInput{1U, 2U, 2U, 3U};
+    for (std::size_t k{}; k < channelInput.size(); ++k)
+    {
+        channelInput.data()[k] = static_cast<double>(k);
+    }
+    ml::FlattenLayer channelLayer{2U, 2U, 3U};
+    channelLayer.feedforward(channelInput);
+
+    std::cout << "Flattening input data (2 channels, 2x3):\n";
+    printTensor(channelInput);
+    std::cout << "Resulting flattened output (1D):\n";
+    printTensor(channelLayer.output);
     return 0;
-}
\ No newline at end of file
+}
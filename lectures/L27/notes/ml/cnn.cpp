@@ -0,0 +1,105 @@
+/**
+ * @brief Convolutional neural network implementation details.
+ */
+#include <algorithm>
+#include <numeric>
+
+#include "ml/cnn.h"
+
+namespace ml
+{
+// -----------------------------------------------------------------------------
+Cnn::Cnn(const std::size_t channelCount, const std::size_t inputHeight,
+         const std::size_t inputWidth, const std::size_t filterCount,
+         const std::size_t kernelSize, const std::size_t poolSize,
+         const std::size_t outputCount, const unsigned seed)
+    : myConvLayer{channelCount, filterCount, inputHeight, inputWidth, kernelSize, seed}
+    , myPoolLayer{filterCount, inputHeight, inputWidth, poolSize}
+    , myPoolGradients{myPoolLayer.output()}
+    , myFlattenLayer{myPoolLayer.output()}
+    , myFlattenGradients{myPoolGradients}
+    , myDenseLayer{outputCount, myFlattenLayer.size(), ActFunc::Tanh, seed}
+    , myInput{nullptr}
+    , myOrder{}
+    , myGenerator{seed}
+{}
+
+// -----------------------------------------------------------------------------
+const ConvLayer& Cnn::convLayer() const noexcept { return myConvLayer; }
+
+// -----------------------------------------------------------------------------
+const MaxPoolLayer& Cnn::poolLayer() const noexcept { return myPoolLayer; }
+
+// -----------------------------------------------------------------------------
+const FlattenView<const double>& Cnn::flattenLayer() const noexcept { return myFlattenLayer; }
+
+// -----------------------------------------------------------------------------
+const DenseLayer& Cnn::denseLayer() const noexcept { return myDenseLayer; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& Cnn::output() const noexcept { return myDenseLayer.output(); }
+
+// -----------------------------------------------------------------------------
+bool Cnn::feedforward(const Tensor& input) noexcept
+{
+    // Feed the input through the layers, each layer reads the output of the previous one.
+    if (!myConvLayer.feedforward(input) || !myPoolLayer.feedforward(myConvLayer.output()) ||
+        !myDenseLayer.feedforward(myFlattenLayer))
+    {
+        myInput = nullptr;
+        return false;
+    }
+    // Remember the input, since the conv layer needs it during backpropagation.
+    myInput = &input;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Cnn::backpropagate(const std::vector<double>& reference) noexcept
+{
+    // Return false if no valid feedforward has been performed.
+    if (nullptr == myInput) { return false; }
+
+    // The dense layer writes its input gradients straight into the pooled gradients.
+    return myDenseLayer.backpropagate(reference) &&
+        myDenseLayer.backpropagateInput(myFlattenGradients) &&
+        myPoolLayer.backpropagate(myPoolGradients) &&
+        myConvLayer.backpropagate(*myInput, myPoolLayer.inputGradients());
+}
+
+// -----------------------------------------------------------------------------
+bool Cnn::optimize(const double learningRate) noexcept
+{
+    // The flatten layer still refers to the pooled output of the latest feedforward.
+    return myConvLayer.optimize(learningRate) &&
+        myDenseLayer.optimize(myFlattenLayer, learningRate);
+}
+
+// -----------------------------------------------------------------------------
+bool Cnn::train(const std::vector<Tensor>& inputs,
+                const std::vector<std::vector<double>>& references, const std::size_t epochCount,
+                const double learningRate) noexcept
+{
+    // Check the training data, return false if invalid.
+    if (inputs.empty() || (inputs.size() != references.size())) { return false; }
+
+    // Create the sample order, only allocated the first time (or if the training set grows).
+    myOrder.resize(inputs.size());
+    std::iota(myOrder.begin(), myOrder.end(), 0U);
+
+    for (std::size_t epoch{}; epoch < epochCount; ++epoch)
+    {
+        std::shuffle(myOrder.begin(), myOrder.end(), myGenerator);
+
+        for (const auto& i : myOrder)
+        {
+            if (!feedforward(inputs[i]) || !backpropagate(references[i]) ||
+                !optimize(learningRate))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+} // namespace ml
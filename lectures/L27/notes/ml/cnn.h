@@ -0,0 +1,167 @@
+/**
+ * @brief Convolutional neural network.
+ */
+#pragma once
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "ml/conv_layer.h"
+#include "ml/dense_layer.h"
+#include "ml/flatten_view.h"
+#include "ml/max_pool_layer.h"
+#include "ml/tensor.h"
+
+namespace ml
+{
+/**
+ * @brief Convolutional neural network: conv (ReLU) => max pooling => flatten => dense.
+ * 
+ *        The layers are chained through shared tensors instead of copying data between them:
+ *          - The conv layer reads the input in place, the pooling layer reads the conv output.
+ *          - The flatten layer is a view of the pooled output, which the dense layer reads.
+ *          - The dense layer writes its input gradients through a view of the pooled gradients,
+ *            which the pooling layer routes to the conv layer.
+ * 
+ *        All buffers are allocated when the network is created, so the network can be trained
+ *        without a single memory allocation per sample.
+ */
+class Cnn final
+{
+public:
+    /**
+     * @brief Create a new convolutional neural network.
+     * 
+     * @param[in] channelCount The number of input channels. Must exceed 0.
+     * @param[in] inputHeight The height of the input. Must be divisible by the pool size.
+     * @param[in] inputWidth The width of the input. Must be divisible by the pool size.
+     * @param[in] filterCount The number of filters of the conv layer. Must exceed 0.
+     * @param[in] kernelSize The kernel size. Must exceed 0 and not exceed the input size.
+     * @param[in] poolSize The pool size. Must be in range [1, 16].
+     * @param[in] outputCount The number of outputs (dense nodes). Must exceed 0.
+     * @param[in] seed Seed used to generate the starting parameters (default = 0).
+     */
+    explicit Cnn(std::size_t channelCount, std::size_t inputHeight, std::size_t inputWidth,
+                 std::size_t filterCount, std::size_t kernelSize, std::size_t poolSize,
+                 std::size_t outputCount, unsigned seed = 0U);
+
+    /**
+     * @brief Delete the network.
+     */
+    ~Cnn() noexcept = default;
+
+    /**
+     * @brief Get the conv layer.
+     * 
+     * @return Reference to the conv layer.
+     */
+    const ConvLayer& convLayer() const noexcept;
+
+    /**
+     * @brief Get the max pooling layer.
+     * 
+     * @return Reference to the max pooling layer.
+     */
+    const MaxPoolLayer& poolLayer() const noexcept;
+
+    /**
+     * @brief Get the flatten layer, i.e. the flattened view of the pooled output.
+     * 
+     * @return Reference to the flatten view.
+     */
+    const FlattenView<const double>& flattenLayer() const noexcept;
+
+    /**
+     * @brief Get the dense layer.
+     * 
+     * @return Reference to the dense layer.
+     */
+    const DenseLayer& denseLayer() const noexcept;
+
+    /**
+     * @brief Get the output of the latest feedforward.
+     * 
+     * @return Vector holding the output values.
+     */
+    const std::vector<double>& output() const noexcept;
+
+    /**
+     * @brief Perform feedforward operation.
+     * 
+     *        The input is read in place, so it must be kept unchanged until the network has been
+     *        backpropagated.
+     * 
+     * @param[in] input Tensor holding one image with channelCount channels, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool feedforward(const Tensor& input) noexcept;
+
+    /**
+     * @brief Perform backpropagation through all layers.
+     * 
+     * @param[in] reference Reference values for the input of the latest feedforward.
+     * 
+     * @return True on success, false on dimension mismatch or if no feedforward was performed.
+     */
+    bool backpropagate(const std::vector<double>& reference) noexcept;
+
+    /**
+     * @brief Perform optimization of all layers.
+     * 
+     * @param[in] learningRate Learning rate to use. Must be in range (0.0, 1.0].
+     * 
+     * @return True on success, false on failure.
+     */
+    bool optimize(double learningRate) noexcept;
+
+    /**
+     * @brief Train the network, one sample at a time in random order.
+     * 
+     * @param[in] inputs Training input, one image per sample.
+     * @param[in] references Reference values, one vector per sample.
+     * @param[in] epochCount The number of epochs to train.
+     * @param[in] learningRate Learning rate to use. Must be in range (0.0, 1.0].
+     * 
+     * @return True on success, false on failure.
+     */
+    bool train(const std::vector<Tensor>& inputs,
+               const std::vector<std::vector<double>>& references, std::size_t epochCount,
+               double learningRate) noexcept;
+
+    Cnn()                      = delete; // No default constructor.
+    Cnn(const Cnn&)            = delete; // No copy constructor.
+    Cnn(Cnn&&)                 = delete; // No move constructor.
+    Cnn& operator=(const Cnn&) = delete; // No copy assignment.
+    Cnn& operator=(Cnn&&)      = delete; // No move assignment.
+
+private:
+    /** Conv layer with ReLU activation. */
+    ConvLayer myConvLayer;
+
+    /** Max pooling layer, reading the conv output. */
+    MaxPoolLayer myPoolLayer;
+
+    /** Gradients of the pooled output, written by the dense layer. */
+    Tensor myPoolGradients;
+
+    /** Flatten layer: view of the pooled output. */
+    FlattenView<const double> myFlattenLayer;
+
+    /** Flattened view of the gradients of the pooled output. */
+    FlattenView<double> myFlattenGradients;
+
+    /** Dense output layer, reading the flattened pooled output. */
+    DenseLayer myDenseLayer;
+
+    /** Input of the latest feedforward (read in place). */
+    const Tensor* myInput;
+
+    /** Order in which the training samples are visited (reused between epochs). */
+    std::vector<std::size_t> myOrder;
+
+    /** Generator used to shuffle the training samples. */
+    std::mt19937 myGenerator;
+};
+} // namespace ml
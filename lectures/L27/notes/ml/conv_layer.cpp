@@ -0,0 +1,205 @@
+/**
+ * @brief Convolutional layer implementation details.
+ */
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "ml/conv_layer.h"
+
+namespace ml
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+constexpr double reluOutput(const double input) noexcept { return 0.0 < input ? input : 0.0; }
+
+// -----------------------------------------------------------------------------
+constexpr double reluDelta(const double output) noexcept { return 0.0 < output ? 1.0 : 0.0; }
+
+// -----------------------------------------------------------------------------
+void validColumns(const std::size_t width, const std::size_t pad, const std::size_t kj,
+                  std::size_t& first, std::size_t& last) noexcept
+{
+    // Get the output columns [first, last) for which kernel column kj hits the input.
+    first = std::min(width, pad > kj ? pad - kj : 0U);
+    last  = std::max(first, std::min(width, width + pad - kj));
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+ConvLayer::ConvLayer(const std::size_t inputChannelCount, const std::size_t filterCount,
+                     const std::size_t inputHeight, const std::size_t inputWidth,
+                     const std::size_t kernelSize, const unsigned seed)
+    : myKernel{filterCount, inputChannelCount, kernelSize, kernelSize}
+    , myKernelGradients{filterCount, inputChannelCount, kernelSize, kernelSize}
+    , myOutput{1U, filterCount, inputHeight, inputWidth}
+    , myBias(filterCount)
+    , myBiasGradients(filterCount)
+    , myDeltas(inputWidth)
+{
+    // Check the kernel size, throw if invalid.
+    if ((kernelSize > inputHeight) || (kernelSize > inputWidth))
+    {
+        throw std::invalid_argument("Cannot create conv layer: invalid kernel size!");
+    }
+
+    // Initialize the kernel with values scaled to the number of inputs per filter.
+    const auto limit{std::sqrt(6.0 / myKernel.imageSize())};
+    std::mt19937 generator{seed};
+    std::uniform_real_distribution<double> distribution{-limit, limit};
+    for (std::size_t k{}; k < myKernel.size(); ++k)
+    {
+        myKernel.data()[k] = distribution(generator);
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t ConvLayer::inputChannelCount() const noexcept { return myKernel.channelCount(); }
+
+// -----------------------------------------------------------------------------
+std::size_t ConvLayer::filterCount() const noexcept { return myOutput.channelCount(); }
+
+// -----------------------------------------------------------------------------
+std::size_t ConvLayer::kernelSize() const noexcept { return myKernel.height(); }
+
+// -----------------------------------------------------------------------------
+const Tensor& ConvLayer::output() const noexcept { return myOutput; }
+
+// -----------------------------------------------------------------------------
+const Tensor& ConvLayer::kernel() const noexcept { return myKernel; }
+
+// -----------------------------------------------------------------------------
+const Tensor& ConvLayer::kernelGradients() const noexcept { return myKernelGradients; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& ConvLayer::bias() const noexcept { return myBias; }
+
+// -----------------------------------------------------------------------------
+bool ConvLayer::feedforward(const Tensor& input) noexcept
+{
+    // Check the input, return false on dimension mismatch.
+    if (!isInputValid(input)) { return false; }
+
+    const auto height{myOutput.height()}, width{myOutput.width()};
+    const auto size{kernelSize()}, pad{kernelSize() / 2U};
+
+    for (std::size_t f{}; f < filterCount(); ++f)
+    {
+        for (std::size_t i{}; i < height; ++i)
+        {
+            auto* output{&myOutput(0U, f, i, 0U)};
+            std::fill(output, output + width, myBias[f]);
+
+            // Add each kernel row that hits the input, one whole output row per weight.
+            for (std::size_t ki{}; ki < size; ++ki)
+            {
+                if ((i + ki < pad) || (i + ki - pad >= height)) { continue; }
+
+                for (std::size_t kj{}; kj < size; ++kj)
+                {
+                    std::size_t first{}, last{};
+                    validColumns(width, pad, kj, first, last);
+
+                    for (std::size_t c{}; c < inputChannelCount(); ++c)
+                    {
+                        const auto weight{myKernel(f, c, ki, kj)};
+
+                        for (auto j{first}; j < last; ++j)
+                        {
+                            output[j] += weight * input(0U, c, i + ki - pad, j + kj - pad);
+                        }
+                    }
+                }
+            }
+            for (std::size_t j{}; j < width; ++j) { output[j] = reluOutput(output[j]); }
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ConvLayer::backpropagate(const Tensor& input, const Tensor& outputGradients) noexcept
+{
+    // Check the dimensions, return false on mismatch.
+    if (!isInputValid(input) || !outputGradients.hasShape(myOutput)) { return false; }
+
+    const auto height{myOutput.height()}, width{myOutput.width()};
+    const auto size{kernelSize()}, pad{kernelSize() / 2U};
+
+    // Reset the gradients, since the contributions of all output values are accumulated.
+    myKernelGradients.fill();
+    std::fill(myBiasGradients.begin(), myBiasGradients.end(), 0.0);
+
+    for (std::size_t f{}; f < filterCount(); ++f)
+    {
+        for (std::size_t i{}; i < height; ++i)
+        {
+            // Compute the gradients of the weighted sums of the row, skip the row if all are 0,
+            // which is common, since only the max value of each pooling window has a gradient.
+            bool rowActive{false};
+
+            for (std::size_t j{}; j < width; ++j)
+            {
+                myDeltas[j] = outputGradients(0U, f, i, j) * reluDelta(myOutput(0U, f, i, j));
+                myBiasGradients[f] += myDeltas[j];
+                rowActive = rowActive || (0.0 != myDeltas[j]);
+            }
+            if (!rowActive) { continue; }
+
+            for (std::size_t ki{}; ki < size; ++ki)
+            {
+                if ((i + ki < pad) || (i + ki - pad >= height)) { continue; }
+
+                for (std::size_t kj{}; kj < size; ++kj)
+                {
+                    std::size_t first{}, last{};
+                    validColumns(width, pad, kj, first, last);
+
+                    for (std::size_t c{}; c < inputChannelCount(); ++c)
+                    {
+                        double sum{};
+
+                        for (auto j{first}; j < last; ++j)
+                        {
+                            sum += myDeltas[j] * input(0U, c, i + ki - pad, j + kj - pad);
+                        }
+                        myKernelGradients(f, c, ki, kj) += sum;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ConvLayer::optimize(const double learningRate) noexcept
+{
+    // Check the learning rate, return false if out of range.
+    if ((0.0 >= learningRate) || (1.0 < learningRate)) { return false; }
+
+    // Adjust the parameters in the opposite direction of the gradients.
+    for (std::size_t f{}; f < myBias.size(); ++f)
+    {
+        myBias[f] -= myBiasGradients[f] * learningRate;
+    }
+
+    auto* kernel{myKernel.data()};
+    const auto* kernelGradients{myKernelGradients.data()};
+
+    for (std::size_t k{}; k < myKernel.size(); ++k)
+    {
+        kernel[k] -= kernelGradients[k] * learningRate;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ConvLayer::isInputValid(const Tensor& input) const noexcept
+{
+    return (1U == input.batchCount()) && (inputChannelCount() == input.channelCount()) &&
+        (myOutput.height() == input.height()) && (myOutput.width() == input.width());
+}
+} // namespace ml
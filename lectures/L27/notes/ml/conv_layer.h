@@ -0,0 +1,157 @@
+/**
+ * @brief Convolutional layer with ReLU activation.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "ml/tensor.h"
+
+namespace ml
+{
+/**
+ * @brief Convolutional layer with ReLU activation, used as the first layer of a CNN.
+ * 
+ *        Each filter covers all input channels and generates one output channel. The input is
+ *        zero padded implicitly, so each output channel has the same size as the input. The
+ *        input is read in place instead of being copied, which is why it must be passed again
+ *        to the backpropagation. Since the layer is the first layer of the network, no input
+ *        gradients are computed.
+ * 
+ *        All buffers are allocated when the layer is created, none during training.
+ */
+class ConvLayer final
+{
+public:
+    /**
+     * @brief Create a new convolutional layer.
+     * 
+     * @param[in] inputChannelCount The number of input channels. Must exceed 0.
+     * @param[in] filterCount The number of filters (output channels). Must exceed 0.
+     * @param[in] inputHeight The height of the input. Must exceed 0.
+     * @param[in] inputWidth The width of the input. Must exceed 0.
+     * @param[in] kernelSize The kernel size. Must exceed 0 and not exceed the input size.
+     * @param[in] seed Seed used to generate the starting kernel values (default = 0).
+     */
+    explicit ConvLayer(std::size_t inputChannelCount, std::size_t filterCount,
+                       std::size_t inputHeight, std::size_t inputWidth, std::size_t kernelSize,
+                       unsigned seed = 0U);
+
+    /**
+     * @brief Delete the convolutional layer.
+     */
+    ~ConvLayer() noexcept = default;
+
+    /**
+     * @brief Get the number of input channels.
+     * 
+     * @return The number of input channels.
+     */
+    std::size_t inputChannelCount() const noexcept;
+
+    /**
+     * @brief Get the number of filters (output channels).
+     * 
+     * @return The number of filters.
+     */
+    std::size_t filterCount() const noexcept;
+
+    /**
+     * @brief Get the kernel size.
+     * 
+     * @return The kernel size.
+     */
+    std::size_t kernelSize() const noexcept;
+
+    /**
+     * @brief Get the output of the latest feedforward.
+     * 
+     * @return Tensor holding filterCount feature maps, same size as the input.
+     */
+    const Tensor& output() const noexcept;
+
+    /**
+     * @brief Get the kernel.
+     * 
+     * @return Tensor holding filterCount x inputChannelCount x kernelSize x kernelSize weights.
+     */
+    const Tensor& kernel() const noexcept;
+
+    /**
+     * @brief Get the kernel gradients of the latest backpropagation.
+     * 
+     * @return Tensor holding the kernel gradients, same shape as the kernel.
+     */
+    const Tensor& kernelGradients() const noexcept;
+
+    /**
+     * @brief Get the bias values, one per filter.
+     * 
+     * @return Vector holding the bias values.
+     */
+    const std::vector<double>& bias() const noexcept;
+
+    /**
+     * @brief Perform feedforward operation.
+     * 
+     * @param[in] input Tensor holding one image with inputChannelCount channels, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool feedforward(const Tensor& input) noexcept;
+
+    /**
+     * @brief Perform backpropagation.
+     * 
+     * @param[in] input The input of the latest feedforward.
+     * @param[in] outputGradients Tensor holding the gradients of the output, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool backpropagate(const Tensor& input, const Tensor& outputGradients) noexcept;
+
+    /**
+     * @brief Perform optimization.
+     * 
+     * @param[in] learningRate Learning rate to use. Must be in range (0.0, 1.0].
+     * 
+     * @return True on success, false on failure.
+     */
+    bool optimize(double learningRate) noexcept;
+
+    ConvLayer()                            = delete; // No default constructor.
+    ConvLayer(const ConvLayer&)            = delete; // No copy constructor.
+    ConvLayer(ConvLayer&&)                 = delete; // No move constructor.
+    ConvLayer& operator=(const ConvLayer&) = delete; // No copy assignment.
+    ConvLayer& operator=(ConvLayer&&)      = delete; // No move assignment.
+
+private:
+    /**
+     * @brief Check whether the given tensor holds a valid input.
+     * 
+     * @param[in] input The tensor to check.
+     * 
+     * @return True if the tensor holds one image of the input size, false otherwise.
+     */
+    bool isInputValid(const Tensor& input) const noexcept;
+
+    /** Kernel: filterCount x inputChannelCount x kernelSize x kernelSize. */
+    Tensor myKernel;
+
+    /** Kernel gradients. */
+    Tensor myKernelGradients;
+
+    /** Output feature maps. */
+    Tensor myOutput;
+
+    /** Bias values, one per filter. */
+    std::vector<double> myBias;
+
+    /** Bias gradients, one per filter. */
+    std::vector<double> myBiasGradients;
+
+    /** Gradients of the weighted sums of one output row. */
+    std::vector<double> myDeltas;
+};
+} // namespace ml
@@ -0,0 +1,142 @@
+/**
+ * @brief Dense layer implementation details.
+ */
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "ml/dense_layer.h"
+
+namespace ml
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+double actFuncOutput(const ActFunc actFunc, const double input) noexcept
+{
+    return ActFunc::Tanh == actFunc ? std::tanh(input) : (0.0 < input ? input : 0.0);
+}
+
+// -----------------------------------------------------------------------------
+double actFuncDelta(const ActFunc actFunc, const double output) noexcept
+{
+    // Compute the derivative from the output, which is all that is stored after feedforward.
+    return ActFunc::Tanh == actFunc ? 1.0 - output * output : (0.0 < output ? 1.0 : 0.0);
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+DenseLayer::DenseLayer(const std::size_t nodeCount, const std::size_t weightCount,
+                       const ActFunc actFunc, const unsigned seed)
+    : myOutput(nodeCount)
+    , myGradients(nodeCount)
+    , myBias(nodeCount)
+    , myWeights(nodeCount * weightCount)
+    , myActFunc{actFunc}
+{
+    // Make sure we have at least 1 node and 1 weight per node.
+    if ((0U == nodeCount) || (0U == weightCount))
+    {
+        throw std::invalid_argument("Cannot create dense layer: invalid dimensions!");
+    }
+
+    // Initialize the weights with values scaled to the number of weights per node.
+    const auto limit{std::sqrt(6.0 / weightCount)};
+    std::mt19937 generator{seed};
+    std::uniform_real_distribution<double> distribution{-limit, limit};
+    for (auto& weight : myWeights) { weight = distribution(generator); }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t DenseLayer::nodeCount() const noexcept { return myOutput.size(); }
+
+// -----------------------------------------------------------------------------
+std::size_t DenseLayer::weightCount() const noexcept { return myWeights.size() / nodeCount(); }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& DenseLayer::output() const noexcept { return myOutput; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& DenseLayer::gradients() const noexcept { return myGradients; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& DenseLayer::bias() const noexcept { return myBias; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& DenseLayer::weights() const noexcept { return myWeights; }
+
+// -----------------------------------------------------------------------------
+bool DenseLayer::feedforward(const FlattenView<const double>& input) noexcept
+{
+    // Check the input, return false on dimension mismatch.
+    if (input.size() != weightCount()) { return false; }
+
+    for (std::size_t i{}; i < nodeCount(); ++i)
+    {
+        const auto* weights{&myWeights[i * weightCount()]};
+        auto sum{myBias[i]};
+
+        for (std::size_t j{}; j < weightCount(); ++j) { sum += input[j] * weights[j]; }
+        myOutput[i] = actFuncOutput(myActFunc, sum);
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool DenseLayer::backpropagate(const std::vector<double>& reference) noexcept
+{
+    // Check the reference values, return false on dimension mismatch.
+    if (reference.size() != nodeCount()) { return false; }
+
+    // Compute the gradient of the squared error with respect to each weighted sum.
+    for (std::size_t i{}; i < nodeCount(); ++i)
+    {
+        myGradients[i] = (myOutput[i] - reference[i]) * actFuncDelta(myActFunc, myOutput[i]);
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool DenseLayer::backpropagateInput(const FlattenView<double>& inputGradients) const noexcept
+{
+    // Check the input gradients, return false on dimension mismatch.
+    if (inputGradients.size() != weightCount()) { return false; }
+
+    // Accumulate the contribution of each node, node by node to read the weights in order.
+    std::fill(inputGradients.data(), inputGradients.data() + weightCount(), 0.0);
+
+    for (std::size_t i{}; i < nodeCount(); ++i)
+    {
+        const auto* weights{&myWeights[i * weightCount()]};
+
+        for (std::size_t j{}; j < weightCount(); ++j)
+        {
+            inputGradients[j] += myGradients[i] * weights[j];
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool DenseLayer::optimize(const FlattenView<const double>& input,
+                          const double learningRate) noexcept
+{
+    // Check the learning rate and the input, return false if invalid.
+    if ((0.0 >= learningRate) || (1.0 < learningRate) || (input.size() != weightCount()))
+    {
+        return false;
+    }
+
+    // Adjust the parameters in the opposite direction of the gradients.
+    for (std::size_t i{}; i < nodeCount(); ++i)
+    {
+        auto* weights{&myWeights[i * weightCount()]};
+        const auto delta{myGradients[i] * learningRate};
+        myBias[i] -= delta;
+
+        for (std::size_t j{}; j < weightCount(); ++j) { weights[j] -= delta * input[j]; }
+    }
+    return true;
+}
+} // namespace ml
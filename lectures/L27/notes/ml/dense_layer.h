@@ -0,0 +1,144 @@
+/**
+ * @brief Dense layer reading flattened input in place.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "ml/flatten_view.h"
+#include "ml/types.h"
+
+namespace ml
+{
+/**
+ * @brief Dense layer, used as the output layer of a CNN.
+ * 
+ *        The input is passed as a flattened view of a tensor, so the output of the previous
+ *        layer is read in place. The gradients of the input are written through a view in the
+ *        same way, which means that they never have to be unflattened. The weights of all nodes
+ *        are stored in a single contiguous block, node by node.
+ * 
+ *        All buffers are allocated when the layer is created, none during training.
+ */
+class DenseLayer final
+{
+public:
+    /**
+     * @brief Create a new dense layer.
+     * 
+     * @param[in] nodeCount The number of nodes in the layer. Must exceed 0.
+     * @param[in] weightCount The number of weights per node. Must exceed 0.
+     * @param[in] actFunc The activation function to use (default = ReLU).
+     * @param[in] seed Seed used to generate the starting weights (default = 0).
+     */
+    explicit DenseLayer(std::size_t nodeCount, std::size_t weightCount,
+                        ActFunc actFunc = ActFunc::Relu, unsigned seed = 0U);
+
+    /**
+     * @brief Delete the dense layer.
+     */
+    ~DenseLayer() noexcept = default;
+
+    /**
+     * @brief Get the number of nodes in the layer.
+     * 
+     * @return The number of nodes.
+     */
+    std::size_t nodeCount() const noexcept;
+
+    /**
+     * @brief Get the number of weights per node.
+     * 
+     * @return The number of weights per node.
+     */
+    std::size_t weightCount() const noexcept;
+
+    /**
+     * @brief Get the output of the latest feedforward.
+     * 
+     * @return Vector holding one output value per node.
+     */
+    const std::vector<double>& output() const noexcept;
+
+    /**
+     * @brief Get the gradients of the weighted sums of the latest backpropagation.
+     * 
+     * @return Vector holding one gradient per node.
+     */
+    const std::vector<double>& gradients() const noexcept;
+
+    /**
+     * @brief Get the bias values, one per node.
+     * 
+     * @return Vector holding the bias values.
+     */
+    const std::vector<double>& bias() const noexcept;
+
+    /**
+     * @brief Get the weights.
+     * 
+     * @return Vector holding the weights: [i * weightCount + j] => node i, weight j.
+     */
+    const std::vector<double>& weights() const noexcept;
+
+    /**
+     * @brief Perform feedforward operation.
+     * 
+     * @param[in] input Flattened view of the input.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool feedforward(const FlattenView<const double>& input) noexcept;
+
+    /**
+     * @brief Perform backpropagation with the given reference values (mean squared error).
+     * 
+     * @param[in] reference Reference values, one per node.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool backpropagate(const std::vector<double>& reference) noexcept;
+
+    /**
+     * @brief Compute the gradients of the input of the latest backpropagation.
+     * 
+     * @param[out] inputGradients Flattened view to write the input gradients to.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool backpropagateInput(const FlattenView<double>& inputGradients) const noexcept;
+
+    /**
+     * @brief Perform optimization.
+     * 
+     * @param[in] input Flattened view of the input of the latest feedforward.
+     * @param[in] learningRate Learning rate to use. Must be in range (0.0, 1.0].
+     * 
+     * @return True on success, false on failure.
+     */
+    bool optimize(const FlattenView<const double>& input, double learningRate) noexcept;
+
+    DenseLayer()                             = delete; // No default constructor.
+    DenseLayer(const DenseLayer&)            = delete; // No copy constructor.
+    DenseLayer(DenseLayer&&)                 = delete; // No move constructor.
+    DenseLayer& operator=(const DenseLayer&) = delete; // No copy assignment.
+    DenseLayer& operator=(DenseLayer&&)      = delete; // No move assignment.
+
+private:
+    /** Output values, one per node. */
+    std::vector<double> myOutput;
+
+    /** Gradients of the weighted sums, one per node. */
+    std::vector<double> myGradients;
+
+    /** Bias values, one per node. */
+    std::vector<double> myBias;
+
+    /** Weights, stored node by node. */
+    std::vector<double> myWeights;
+
+    /** The activation function of the layer. */
+    ActFunc myActFunc;
+};
+} // namespace ml
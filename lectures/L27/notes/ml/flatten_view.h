@@ -0,0 +1,92 @@
+/**
+ * @brief Flattened view of an image stored in a tensor.
+ */
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "ml/tensor.h"
+
+namespace ml
+{
+/**
+ * @brief Flattened view of one image of a tensor, used as the flatten layer of a CNN.
+ * 
+ *        In the NCHW layout the values of each image are already stored in flattened order
+ *        ([c][i][j] => [(c * height + i) * width + j]), so flattening is only a reshape. The
+ *        view points into the tensor and holds no values of its own: nothing is copied when the
+ *        view is created, and values written through a mutable view land directly in the tensor.
+ * 
+ * @tparam T The value type, double for a mutable view and const double for a read-only view.
+ */
+template <typename T>
+class FlattenView final
+{
+    static_assert(std::is_same<std::remove_const_t<T>, double>::value,
+                  "Flatten views can only refer to tensor values!");
+
+public:
+    /**
+     * @brief Create a flattened view of the given image.
+     * 
+     * @tparam TensorType The tensor type, const Tensor for a read-only view.
+     * 
+     * @param[in] tensor The tensor to view. Must use the NCHW layout and outlive the view.
+     * @param[in] image The image index (default = 0).
+     */
+    template <typename TensorType>
+    explicit FlattenView(TensorType& tensor, const std::size_t image = 0U)
+        : myData{tensor.image(image)}
+        , mySize{tensor.imageSize()}
+    {
+        // Check the layout and the image index, throw if invalid.
+        if ((Layout::Nchw != tensor.layout()) || (image >= tensor.batchCount()))
+        {
+            throw std::invalid_argument("Cannot create flatten view: invalid tensor or image!");
+        }
+    }
+
+    /**
+     * @brief Delete the view (the viewed tensor is left unchanged).
+     */
+    ~FlattenView() noexcept = default;
+
+    /**
+     * @brief Get the number of values in the view.
+     * 
+     * @return The number of values, i.e. channelCount x height x width of the image.
+     */
+    std::size_t size() const noexcept { return mySize; }
+
+    /**
+     * @brief Get a pointer to the first value of the view.
+     * 
+     * @return Pointer to the first value.
+     */
+    T* data() const noexcept { return myData; }
+
+    /**
+     * @brief Get the given value.
+     * 
+     * @param[in] index The index of the value in flattened order.
+     * 
+     * @return Reference to the value.
+     */
+    T& operator[](const std::size_t index) const noexcept { return myData[index]; }
+
+    FlattenView()                              = delete;  // No default constructor.
+    FlattenView(const FlattenView&)            = default; // Copy constructor.
+    FlattenView(FlattenView&&)                 = default; // Move constructor.
+    FlattenView& operator=(const FlattenView&) = default; // Copy assignment.
+    FlattenView& operator=(FlattenView&&)      = default; // Move assignment.
+
+private:
+    /** Pointer to the first value of the viewed image. */
+    T* myData;
+
+    /** The number of values in the view. */
+    std::size_t mySize;
+};
+} // namespace ml
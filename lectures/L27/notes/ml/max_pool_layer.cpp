@@ -0,0 +1,110 @@
+/**
+ * @brief Max pooling layer implementation details.
+ */
+#include <stdexcept>
+
+#include "ml/max_pool_layer.h"
+
+namespace ml
+{
+namespace
+{
+/** The largest pool size whose window positions fit in one byte. */
+constexpr std::size_t MaxPoolSize{16U};
+
+// -----------------------------------------------------------------------------
+std::size_t pooledSize(const std::size_t size, const std::size_t poolSize)
+{
+    // Check the pool size, throw if invalid (the other dimensions are checked by the tensors).
+    if ((0U == poolSize) || (MaxPoolSize < poolSize) || (0U != (size % poolSize)))
+    {
+        throw std::invalid_argument("Cannot create max pooling layer: invalid pool size!");
+    }
+    return size / poolSize;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+MaxPoolLayer::MaxPoolLayer(const std::size_t channelCount, const std::size_t inputHeight,
+                           const std::size_t inputWidth, const std::size_t poolSize)
+    : myInputGradients{1U, channelCount, inputHeight, inputWidth}
+    , myOutput{1U, channelCount, pooledSize(inputHeight, poolSize),
+               pooledSize(inputWidth, poolSize)}
+    , myMaxIndices(myOutput.size())
+    , myPoolSize{poolSize}
+{}
+
+// -----------------------------------------------------------------------------
+std::size_t MaxPoolLayer::poolSize() const noexcept { return myPoolSize; }
+
+// -----------------------------------------------------------------------------
+const Tensor& MaxPoolLayer::output() const noexcept { return myOutput; }
+
+// -----------------------------------------------------------------------------
+const Tensor& MaxPoolLayer::inputGradients() const noexcept { return myInputGradients; }
+
+// -----------------------------------------------------------------------------
+bool MaxPoolLayer::feedforward(const Tensor& input) noexcept
+{
+    // Check the input, return false on dimension mismatch.
+    if (!input.hasShape(myInputGradients)) { return false; }
+
+    const auto pool{myPoolSize};
+
+    for (std::size_t c{}; c < myOutput.channelCount(); ++c)
+    {
+        for (std::size_t i{}; i < myOutput.height(); ++i)
+        {
+            for (std::size_t j{}; j < myOutput.width(); ++j)
+            {
+                // Reduce the window to its first max value and the position of that value.
+                auto maxValue{input(0U, c, i * pool, j * pool)};
+                std::size_t maxIndex{};
+
+                for (std::size_t pi{}; pi < pool; ++pi)
+                {
+                    for (std::size_t pj{}; pj < pool; ++pj)
+                    {
+                        const auto value{input(0U, c, i * pool + pi, j * pool + pj)};
+
+                        if (value > maxValue)
+                        {
+                            maxValue = value;
+                            maxIndex = pi * pool + pj;
+                        }
+                    }
+                }
+                myOutput(0U, c, i, j)                      = maxValue;
+                myMaxIndices[myOutput.index(0U, c, i, j)] = static_cast<std::uint8_t>(maxIndex);
+            }
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool MaxPoolLayer::backpropagate(const Tensor& outputGradients) noexcept
+{
+    // Check the output gradients, return false on dimension mismatch.
+    if (!outputGradients.hasShape(myOutput)) { return false; }
+
+    const auto pool{myPoolSize};
+
+    // Only the max value of each window has a gradient, all other input gradients are 0.
+    myInputGradients.fill();
+
+    for (std::size_t c{}; c < myOutput.channelCount(); ++c)
+    {
+        for (std::size_t i{}; i < myOutput.height(); ++i)
+        {
+            for (std::size_t j{}; j < myOutput.width(); ++j)
+            {
+                const auto maxIndex{myMaxIndices[myOutput.index(0U, c, i, j)]};
+                myInputGradients(0U, c, i * pool + maxIndex / pool, j * pool + maxIndex % pool) =
+                    outputGradients(0U, c, i, j);
+            }
+        }
+    }
+    return true;
+}
+} // namespace ml
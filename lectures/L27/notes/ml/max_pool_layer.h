@@ -0,0 +1,100 @@
+/**
+ * @brief Max pooling layer.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ml/tensor.h"
+
+namespace ml
+{
+/**
+ * @brief Max pooling layer with non-overlapping pooling windows.
+ * 
+ *        The input is read in place instead of being copied. The position of the max value
+ *        within each window (one byte per window) is recorded during feedforward, so the
+ *        backpropagation routes each gradient without visiting the input.
+ * 
+ *        All buffers are allocated when the layer is created, none during training.
+ */
+class MaxPoolLayer final
+{
+public:
+    /**
+     * @brief Create a new max pooling layer.
+     * 
+     * @param[in] channelCount The number of channels. Must exceed 0.
+     * @param[in] inputHeight The height of the input. Must be divisible by the pool size.
+     * @param[in] inputWidth The width of the input. Must be divisible by the pool size.
+     * @param[in] poolSize The pool size. Must be in range [1, 16].
+     */
+    explicit MaxPoolLayer(std::size_t channelCount, std::size_t inputHeight,
+                          std::size_t inputWidth, std::size_t poolSize);
+
+    /**
+     * @brief Delete the max pooling layer.
+     */
+    ~MaxPoolLayer() noexcept = default;
+
+    /**
+     * @brief Get the pool size.
+     * 
+     * @return The pool size.
+     */
+    std::size_t poolSize() const noexcept;
+
+    /**
+     * @brief Get the pooled output of the latest feedforward.
+     * 
+     * @return Tensor holding the pooled feature maps.
+     */
+    const Tensor& output() const noexcept;
+
+    /**
+     * @brief Get the input gradients of the latest backpropagation.
+     * 
+     * @return Tensor holding the input gradients, same shape as the input.
+     */
+    const Tensor& inputGradients() const noexcept;
+
+    /**
+     * @brief Perform feedforward operation.
+     * 
+     * @param[in] input Tensor holding one image with channelCount channels, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool feedforward(const Tensor& input) noexcept;
+
+    /**
+     * @brief Perform backpropagation.
+     * 
+     * @param[in] outputGradients Tensor holding the gradients of the pooled output, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool backpropagate(const Tensor& outputGradients) noexcept;
+
+    MaxPoolLayer()                               = delete; // No default constructor.
+    MaxPoolLayer(const MaxPoolLayer&)            = delete; // No copy constructor.
+    MaxPoolLayer(MaxPoolLayer&&)                 = delete; // No move constructor.
+    MaxPoolLayer& operator=(const MaxPoolLayer&) = delete; // No copy assignment.
+    MaxPoolLayer& operator=(MaxPoolLayer&&)      = delete; // No move assignment.
+
+private:
+    /** Input gradients. */
+    Tensor myInputGradients;
+
+    /** Pooled output feature maps. */
+    Tensor myOutput;
+
+    /** Position of the max value within each pooling window, as poolRow * poolSize + poolCol. */
+    std::vector<std::uint8_t> myMaxIndices;
+
+    /** The pool size. */
+    std::size_t myPoolSize;
+};
+} // namespace ml
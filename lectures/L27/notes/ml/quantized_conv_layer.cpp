@@ -0,0 +1,235 @@
+/**
+ * @brief Int8 quantized convolutional layer implementation details.
+ */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "ml/quantized_conv_layer.h"
+
+namespace ml
+{
+namespace
+{
+/** The largest magnitude of a quantized value (the range is symmetric). */
+constexpr double MaxQuantized{127.0};
+
+// -----------------------------------------------------------------------------
+std::int16_t quantize(const double value, const double scale) noexcept
+{
+    return static_cast<std::int16_t>(
+        std::lround(std::clamp(value / scale, -MaxQuantized, MaxQuantized)));
+}
+
+// -----------------------------------------------------------------------------
+double checkScale(const double scale)
+{
+    // Check the scale, throw if invalid.
+    if (!(0.0 < scale) || !std::isfinite(scale))
+    {
+        throw std::invalid_argument("Cannot create quantized conv layer: invalid scale!");
+    }
+    return scale;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+QuantizedConvLayer::QuantizedConvLayer(const ConvLayer& layer, const double inputScale,
+                                       const double outputScale)
+    : myKernel(layer.kernel().size())
+    , myKernelScales(layer.filterCount())
+    , myBias(layer.filterCount())
+    , myMultipliers(layer.filterCount())
+    , myInput(layer.inputChannelCount() * (layer.output().height() + layer.kernelSize() - 1U) *
+              (layer.output().width() + layer.kernelSize() - 1U))
+    , myAccumulator(layer.output().width())
+    , myOutput(layer.output().size())
+    , myInputChannelCount{layer.inputChannelCount()}
+    , myFilterCount{layer.filterCount()}
+    , myKernelSize{layer.kernelSize()}
+    , myHeight{layer.output().height()}
+    , myWidth{layer.output().width()}
+    , myInputScale{checkScale(inputScale)}
+    , myOutputScale{checkScale(outputScale)}
+{
+    const auto& kernel{layer.kernel()};
+    const auto filterSize{kernel.imageSize()};
+
+    for (std::size_t f{}; f < myFilterCount; ++f)
+    {
+        // Scale the weights of the filter so that the largest one is mapped to 127.
+        const auto* weights{kernel.image(f)};
+        double maxWeight{};
+        for (std::size_t k{}; k < filterSize; ++k)
+        {
+            maxWeight = std::max(maxWeight, std::abs(weights[k]));
+        }
+        myKernelScales[f] = 0.0 < maxWeight ? maxWeight / MaxQuantized : 1.0;
+
+        for (std::size_t c{}; c < myInputChannelCount; ++c)
+        {
+            for (std::size_t ki{}; ki < myKernelSize; ++ki)
+            {
+                for (std::size_t kj{}; kj < myKernelSize; ++kj)
+                {
+                    const auto index{((f * myInputChannelCount + c) * myKernelSize + ki) *
+                                         myKernelSize + kj};
+                    myKernel[index] = quantize(kernel(f, c, ki, kj), myKernelScales[f]);
+                }
+            }
+        }
+
+        // Store the bias in the scale of the accumulator, requantize the sums to the output.
+        const auto accumulatorScale{myInputScale * myKernelScales[f]};
+        constexpr double maxBias{std::numeric_limits<std::int32_t>::max()};
+        myBias[f] = static_cast<std::int32_t>(
+            std::lround(std::clamp(layer.bias()[f] / accumulatorScale, -maxBias, maxBias)));
+        myMultipliers[f] = accumulatorScale / myOutputScale;
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t QuantizedConvLayer::inputChannelCount() const noexcept { return myInputChannelCount; }
+
+// -----------------------------------------------------------------------------
+std::size_t QuantizedConvLayer::filterCount() const noexcept { return myFilterCount; }
+
+// -----------------------------------------------------------------------------
+std::size_t QuantizedConvLayer::kernelSize() const noexcept { return myKernelSize; }
+
+// -----------------------------------------------------------------------------
+double QuantizedConvLayer::inputScale() const noexcept { return myInputScale; }
+
+// -----------------------------------------------------------------------------
+double QuantizedConvLayer::outputScale() const noexcept { return myOutputScale; }
+
+// -----------------------------------------------------------------------------
+const std::vector<double>& QuantizedConvLayer::kernelScales() const noexcept
+{
+    return myKernelScales;
+}
+
+// -----------------------------------------------------------------------------
+const std::vector<std::int8_t>& QuantizedConvLayer::output() const noexcept { return myOutput; }
+
+// -----------------------------------------------------------------------------
+bool QuantizedConvLayer::feedforward(const Tensor& input) noexcept
+{
+    // Check the input, return false on dimension mismatch.
+    if ((1U != input.batchCount()) || (myInputChannelCount != input.channelCount()) ||
+        (myHeight != input.height()) || (myWidth != input.width()))
+    {
+        return false;
+    }
+    quantizeInput(input);
+
+    for (std::size_t f{}; f < myFilterCount; ++f)
+    {
+        const auto multiplier{myMultipliers[f]};
+
+        for (std::size_t i{}; i < myHeight; ++i)
+        {
+            accumulateRow(f, i);
+            auto* output{&myOutput[(f * myHeight + i) * myWidth]};
+
+            // Requantize the sums to the output scale, apply ReLU by clamping to [0, 127].
+            for (std::size_t j{}; j < myWidth; ++j)
+            {
+                const auto sum{0 < myAccumulator[j] ? myAccumulator[j] * multiplier + 0.5 : 0.0};
+                output[j] = static_cast<std::int8_t>(std::min(sum, MaxQuantized));
+            }
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool QuantizedConvLayer::dequantizeOutput(Tensor& output) const noexcept
+{
+    // Check the output, return false on dimension mismatch.
+    if ((1U != output.batchCount()) || (myFilterCount != output.channelCount()) ||
+        (myHeight != output.height()) || (myWidth != output.width()))
+    {
+        return false;
+    }
+
+    for (std::size_t f{}; f < myFilterCount; ++f)
+    {
+        for (std::size_t i{}; i < myHeight; ++i)
+        {
+            const auto* values{&myOutput[(f * myHeight + i) * myWidth]};
+
+            for (std::size_t j{}; j < myWidth; ++j)
+            {
+                output(0U, f, i, j) = values[j] * myOutputScale;
+            }
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void QuantizedConvLayer::quantizeInput(const Tensor& input) noexcept
+{
+    // Only the inner values are written, so the zero border is kept from the construction.
+    const auto pad{myKernelSize / 2U};
+    const auto paddedHeight{myHeight + myKernelSize - 1U}, paddedWidth{myWidth + myKernelSize - 1U};
+
+    for (std::size_t c{}; c < myInputChannelCount; ++c)
+    {
+        for (std::size_t i{}; i < myHeight; ++i)
+        {
+            auto* row{&myInput[(c * paddedHeight + i + pad) * paddedWidth + pad]};
+
+            for (std::size_t j{}; j < myWidth; ++j)
+            {
+                row[j] = quantize(input(0U, c, i, j), myInputScale);
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void QuantizedConvLayer::accumulateRow(const std::size_t filter, const std::size_t row) noexcept
+{
+    const auto paddedHeight{myHeight + myKernelSize - 1U}, paddedWidth{myWidth + myKernelSize - 1U};
+    auto* sums{myAccumulator.data()};
+    std::fill(myAccumulator.begin(), myAccumulator.end(), myBias[filter]);
+
+    // The input is padded, so every kernel row and column hits the input.
+    for (std::size_t c{}; c < myInputChannelCount; ++c)
+    {
+        for (std::size_t ki{}; ki < myKernelSize; ++ki)
+        {
+            const auto* input{&myInput[(c * paddedHeight + row + ki) * paddedWidth]};
+            const auto* weights{
+                &myKernel[((filter * myInputChannelCount + c) * myKernelSize + ki) * myKernelSize]};
+            std::size_t kj{};
+
+            // Apply two kernel columns per pass: the sum of two int8 products fits in 16 bits.
+            for (; kj + 1U < myKernelSize; kj += 2U)
+            {
+                const auto w0{weights[kj]}, w1{weights[kj + 1U]};
+                const auto* x{input + kj};
+
+                for (std::size_t j{}; j < myWidth; ++j)
+                {
+                    sums[j] += static_cast<std::int16_t>(w0 * x[j] + w1 * x[j + 1U]);
+                }
+            }
+
+            // Apply the last kernel column if the kernel size is odd.
+            if (kj < myKernelSize)
+            {
+                const auto w{weights[kj]};
+                const auto* x{input + kj};
+                for (std::size_t j{}; j < myWidth; ++j)
+                {
+                    sums[j] += static_cast<std::int16_t>(w * x[j]);
+                }
+            }
+        }
+    }
+}
+} // namespace ml
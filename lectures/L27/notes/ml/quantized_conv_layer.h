@@ -0,0 +1,192 @@
+/**
+ * @brief Int8 quantized convolutional layer with ReLU activation (inference only).
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ml/conv_layer.h"
+#include "ml/tensor.h"
+
+namespace ml
+{
+/**
+ * @brief Int8 quantized copy of a trained convolutional layer, used for inference.
+ * 
+ *        Each real value x is represented as an 8-bit integer q = round(x / scale), clamped to
+ *        [-127, 127] (the range is symmetric, so zero is represented exactly):
+ *          - The weights of each filter have their own scale, max |w| / 127, so that filters
+ *            with small weights keep their precision.
+ *          - The input and the output have one scale each, which is selected from the value
+ *            ranges seen during calibration (e.g. max |x| / 127 over the training images).
+ * 
+ *        Products of int8 values are accumulated in 32-bit integers. The bias of each filter is
+ *        stored in the scale of the accumulator (inputScale * kernelScale). Each sum is then
+ *        requantized to the output scale, and the ReLU activation function is applied in the
+ *        same pass by clamping to [0, 127].
+ * 
+ *        The quantized input is stored in 16-bit integers with a zero border of kernelSize / 2
+ *        values, so the inner loop has no edge cases. Since |q| <= 127, the sum of two products
+ *        fits in 16 bits (2 * 127 * 127 < 2^15), so two kernel columns are applied per pass with
+ *        16-bit multiply-adds, which are only widened to 32 bits when they are accumulated. The
+ *        compiler vectorizes the loop, eight 16-bit lanes per 128-bit register.
+ * 
+ *        All buffers are allocated when the layer is created, none during feedforward.
+ */
+class QuantizedConvLayer final
+{
+public:
+    /**
+     * @brief Create a new quantized convolutional layer from a trained layer.
+     * 
+     * @param[in] layer The trained layer, whose kernel and bias values are quantized.
+     * @param[in] inputScale The scale of the input. Must exceed 0.
+     * @param[in] outputScale The scale of the output. Must exceed 0.
+     */
+    explicit QuantizedConvLayer(const ConvLayer& layer, double inputScale, double outputScale);
+
+    /**
+     * @brief Delete the quantized layer.
+     */
+    ~QuantizedConvLayer() noexcept = default;
+
+    /**
+     * @brief Get the number of input channels.
+     * 
+     * @return The number of input channels.
+     */
+    std::size_t inputChannelCount() const noexcept;
+
+    /**
+     * @brief Get the number of filters (output channels).
+     * 
+     * @return The number of filters.
+     */
+    std::size_t filterCount() const noexcept;
+
+    /**
+     * @brief Get the kernel size.
+     * 
+     * @return The kernel size.
+     */
+    std::size_t kernelSize() const noexcept;
+
+    /**
+     * @brief Get the scale of the input.
+     * 
+     * @return The input scale.
+     */
+    double inputScale() const noexcept;
+
+    /**
+     * @brief Get the scale of the output.
+     * 
+     * @return The output scale.
+     */
+    double outputScale() const noexcept;
+
+    /**
+     * @brief Get the kernel scales, one per filter.
+     * 
+     * @return Vector holding the kernel scales.
+     */
+    const std::vector<double>& kernelScales() const noexcept;
+
+    /**
+     * @brief Get the quantized output of the latest feedforward.
+     * 
+     *        The output is stored in the NCHW layout, i.e. output value (f, i, j) is stored at
+     *        offset (f * height + i) * width + j. Multiply by the output scale to get real values.
+     * 
+     * @return Vector holding filterCount quantized feature maps, same size as the input.
+     */
+    const std::vector<std::int8_t>& output() const noexcept;
+
+    /**
+     * @brief Perform feedforward operation.
+     * 
+     *        The input is quantized with the input scale before the convolution.
+     * 
+     * @param[in] input Tensor holding one image with inputChannelCount channels, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool feedforward(const Tensor& input) noexcept;
+
+    /**
+     * @brief Convert the quantized output of the latest feedforward to real values.
+     * 
+     * @param[out] output Tensor to store the output in. Must hold one image with filterCount
+     *                    channels of the input size, any layout.
+     * 
+     * @return True on success, false on dimension mismatch.
+     */
+    bool dequantizeOutput(Tensor& output) const noexcept;
+
+    QuantizedConvLayer()                                     = delete; // No default constructor.
+    QuantizedConvLayer(const QuantizedConvLayer&)            = delete; // No copy constructor.
+    QuantizedConvLayer(QuantizedConvLayer&&)                 = delete; // No move constructor.
+    QuantizedConvLayer& operator=(const QuantizedConvLayer&) = delete; // No copy assignment.
+    QuantizedConvLayer& operator=(QuantizedConvLayer&&)      = delete; // No move assignment.
+
+private:
+    /**
+     * @brief Quantize the input into the padded input buffer.
+     * 
+     * @param[in] input The input to quantize.
+     */
+    void quantizeInput(const Tensor& input) noexcept;
+
+    /**
+     * @brief Accumulate one output row of a filter in the row accumulator.
+     * 
+     * @param[in] filter The filter index.
+     * @param[in] row The output row.
+     */
+    void accumulateRow(std::size_t filter, std::size_t row) noexcept;
+
+    /** Quantized kernel: filterCount x inputChannelCount x kernelSize x kernelSize. */
+    std::vector<std::int16_t> myKernel;
+
+    /** Kernel scales, one per filter. */
+    std::vector<double> myKernelScales;
+
+    /** Bias values in the scale of the accumulator, one per filter. */
+    std::vector<std::int32_t> myBias;
+
+    /** Requantization multipliers (accumulator scale / output scale), one per filter. */
+    std::vector<double> myMultipliers;
+
+    /** Quantized input with a zero border of kernelSize / 2 values on each edge. */
+    std::vector<std::int16_t> myInput;
+
+    /** Accumulator of one output row. */
+    std::vector<std::int32_t> myAccumulator;
+
+    /** Quantized output feature maps. */
+    std::vector<std::int8_t> myOutput;
+
+    /** The number of input channels. */
+    std::size_t myInputChannelCount;
+
+    /** The number of filters. */
+    std::size_t myFilterCount;
+
+    /** The kernel size. */
+    std::size_t myKernelSize;
+
+    /** The height of the input and output. */
+    std::size_t myHeight;
+
+    /** The width of the input and output. */
+    std::size_t myWidth;
+
+    /** The scale of the input. */
+    double myInputScale;
+
+    /** The scale of the output. */
+    double myOutputScale;
+};
+} // namespace ml
@@ -0,0 +1,89 @@
+/**
+ * @brief Four-dimensional tensor implementation details.
+ */
+#include <algorithm>
+#include <stdexcept>
+
+#include "ml/tensor.h"
+
+namespace ml
+{
+// -----------------------------------------------------------------------------
+Tensor::Tensor(const std::size_t batchCount, const std::size_t channelCount,
+               const std::size_t height, const std::size_t width, const Layout layout)
+    : myData(batchCount * channelCount * height * width)
+    , myBatchCount{batchCount}
+    , myChannelCount{channelCount}
+    , myHeight{height}
+    , myWidth{width}
+    , myLayout{layout}
+    , myBatchStride{channelCount * height * width}
+    , myChannelStride{Layout::Nchw == layout ? height * width : 1U}
+    , myRowStride{Layout::Nchw == layout ? width : width * channelCount}
+    , myColStride{Layout::Nchw == layout ? 1U : channelCount}
+{
+    // Check the dimensions, throw if invalid.
+    if ((0U == batchCount) || (0U == channelCount) || (0U == height) || (0U == width))
+    {
+        throw std::invalid_argument("Cannot create tensor: invalid dimensions!");
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool Tensor::hasShape(const Tensor& other) const noexcept
+{
+    return (myBatchCount == other.myBatchCount) && (myChannelCount == other.myChannelCount) &&
+        (myHeight == other.myHeight) && (myWidth == other.myWidth);
+}
+
+// -----------------------------------------------------------------------------
+void Tensor::fill(const double value) noexcept
+{
+    std::fill(myData.begin(), myData.end(), value);
+}
+
+// -----------------------------------------------------------------------------
+bool Tensor::copyFrom(const Tensor& source) noexcept
+{
+    // Check the dimensions, return false on mismatch.
+    if (!hasShape(source)) { return false; }
+
+    // Copy the values as a single block if the layouts match.
+    if (myLayout == source.myLayout)
+    {
+        std::copy(source.myData.begin(), source.myData.end(), myData.begin());
+        return true;
+    }
+
+    // Rearrange the values otherwise, reading the source sequentially.
+    const double* value{source.data()};
+
+    for (std::size_t n{}; n < myBatchCount; ++n)
+    {
+        if (Layout::Nchw == source.myLayout)
+        {
+            for (std::size_t c{}; c < myChannelCount; ++c)
+            {
+                for (std::size_t i{}; i < myHeight; ++i)
+                {
+                    for (std::size_t j{}; j < myWidth; ++j) { (*this)(n, c, i, j) = *value++; }
+                }
+            }
+        }
+        else
+        {
+            for (std::size_t i{}; i < myHeight; ++i)
+            {
+                for (std::size_t j{}; j < myWidth; ++j)
+                {
+                    for (std::size_t c{}; c < myChannelCount; ++c)
+                    {
+                        (*this)(n, c, i, j) = *value++;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+} // namespace ml